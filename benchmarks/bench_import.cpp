@@ -0,0 +1,70 @@
+// Throughput benchmark for bulk recipe import.
+// Generates synthetic JSON Lines recipes (default 1M) and imports them into a fresh file database with
+// RecipeImporter, then times the same rows through addRecipe one at a time on a smaller sample (default
+// 5000) for comparison. Reports rows/sec for both.
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "recipeImporter.h"
+#include "recipeManagerSQLite.h"
+
+namespace {
+
+std::string recipeLine(size_t i) {
+    return R"({"id": "bulk_)" + std::to_string(i) + R"(", "title": "Recipe )" + std::to_string(i) +
+           R"(", "ingredients": "flour, water, salt, ingredient)" + std::to_string(i % 5000) +
+           R"(", "instructions": "Mix everything. Rest for an hour. Bake until golden.", "servingSize": ")" +
+           std::to_string(1 + i % 8) + R"( servings", "cookTime": ")" + std::to_string(10 + i % 90) +
+           R"( min", "category": "Category )" + std::to_string(i % 40) + R"(", "type": "Type )" +
+           std::to_string(i % 12) + R"("})";
+}
+
+std::string freshDatabase(const char* name) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::filesystem::remove(path);
+    return path;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t sample = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000;
+    unsigned threads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 0;
+
+    std::stringstream input;
+    for (size_t i = 0; i < rows; ++i) {
+        input << recipeLine(i) << '\n';
+    }
+    std::cout << "Generated " << rows << " rows (" << input.str().size() / (1024 * 1024) << " MiB)" << std::endl;
+
+    {
+        std::string path = freshDatabase("bench_import.db");
+        RecipeManagerSQLite manager(path);
+        RecipeImporter::Options options;
+        options.threads = threads;
+        RecipeImporter::Result result = RecipeImporter(manager, options).run(input);
+        std::cout << "bulk import:      " << result.imported << " rows in " << std::fixed << std::setprecision(2)
+                  << result.seconds << " s, " << std::setprecision(0) << result.rows / result.seconds << " rows/s"
+                  << std::endl;
+        std::filesystem::remove(path);
+    }
+
+    {
+        std::string path = freshDatabase("bench_import_single.db");
+        RecipeManagerSQLite manager(path);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sample; ++i) {
+            manager.addRecipe(recipe::fromJson(recipeLine(i)));
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "addRecipe per row: " << sample << " rows in " << std::fixed << std::setprecision(2) << seconds
+                  << " s, " << std::setprecision(0) << sample / seconds << " rows/s" << std::endl;
+        std::filesystem::remove(path);
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Latency benchmark for pantry matching.
+// Builds a PantryMatcher over synthetic recipes (default 1M, 4-12 ingredients drawn from a skewed
+// vocabulary) and reports build time and per-query latency for top-K pantry matches.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "pantryMatcher.h"
+
+int main(int argc, char* argv[]) {
+    size_t recipeCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t vocabulary = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 50;
+
+    std::mt19937 rng(7);
+    // Zipf-like skew: a few staples (salt, butter, eggs) appear in most recipes
+    std::vector<double> weights(vocabulary);
+    for (size_t i = 0; i < vocabulary; ++i) {
+        weights[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    std::discrete_distribution<size_t> pickIngredient(weights.begin(), weights.end());
+    std::uniform_int_distribution<int> ingredientCount(4, 12);
+    auto ingredientName = [](size_t i) { return "ingredient" + std::string(1, static_cast<char>('a' + i % 26)) +
+                                                std::string(1, static_cast<char>('a' + (i / 26) % 26)) +
+                                                std::string(1, static_cast<char>('a' + (i / 676) % 26)); };
+
+    std::vector<std::pair<std::string, std::string>> rows;
+    rows.reserve(recipeCount);
+    for (size_t r = 0; r < recipeCount; ++r) {
+        std::string ingredients;
+        for (int i = ingredientCount(rng); i > 0; --i) {
+            ingredients += ingredientName(pickIngredient(rng)) + ", ";
+        }
+        rows.emplace_back("recipe_" + std::to_string(r), std::move(ingredients));
+    }
+
+    PantryMatcher matcher;
+    auto buildStart = std::chrono::steady_clock::now();
+    matcher.ensureBuilt([&rows]() { return std::move(rows); });
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+    std::cout << "Recipes: " << matcher.size() << ", build_ms=" << std::fixed << std::setprecision(1) << buildMs << std::endl;
+
+    std::vector<double> latencies;
+    size_t checksum = 0;
+    for (int q = 0; q < queries; ++q) {
+        std::vector<std::string> pantry;
+        for (int i = 0; i < 25; ++i) {
+            pantry.push_back(ingredientName(pickIngredient(rng)));
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto matches = matcher.topMatches(pantry, 20);
+        latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        checksum += matches.size();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "top-20 query p50_ms=" << latencies[latencies.size() / 2]
+              << " p99_ms=" << latencies[latencies.size() * 99 / 100]
+              << " checksum=" << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Allocation-count benchmark for the recipe listing paths.
+// Counts global operator new calls per recipe listed for getAllRecipes() (owning recipe objects)
+// versus getAllRecipeViews() (non-owning views backed by a per-request arena).
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include "recipeManagerSQLite.h"
+
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t alignment = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, ((size + alignment - 1) / alignment) * alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+template <typename Fn>
+static void measure(const char* label, size_t recipeCount, Fn&& fn) {
+    size_t before = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    size_t listed = fn();
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t allocations = g_allocations.load() - before;
+
+    std::cout << std::left << std::setw(22) << label
+              << " listed=" << listed
+              << " allocations=" << allocations
+              << " per_recipe=" << std::fixed << std::setprecision(2)
+              << (recipeCount ? static_cast<double>(allocations) / recipeCount : 0.0)
+              << " time_ms=" << elapsed << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t recipeCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    std::filesystem::path dbPath = std::filesystem::temp_directory_path() / "bench_recipe_alloc.db";
+    std::filesystem::remove(dbPath);
+
+    {
+        RecipeManagerSQLite manager(dbPath.string());
+        if (!manager.isConnected()) {
+            std::cerr << "Failed to open benchmark database" << std::endl;
+            return 1;
+        }
+
+        for (size_t i = 0; i < recipeCount; ++i) {
+            recipe r("Benchmark Recipe " + std::to_string(i),
+                     "200g flour, 2 eggs, 100ml milk, a pinch of salt, butter for the pan",
+                     "Whisk flour, eggs and milk into a smooth batter. Rest for 30 minutes. Fry thin pancakes in butter.",
+                     "4 servings", "45 minutes", "Breakfast", "Pancakes",
+                     "bench_" + std::to_string(i));
+            manager.addRecipe(r);
+        }
+
+        std::cout << "Recipes in database: " << recipeCount << std::endl;
+
+        measure("getAllRecipes", recipeCount, [&manager]() {
+            return manager.getAllRecipes().size();
+        });
+
+        measure("getAllRecipeViews", recipeCount, [&manager]() {
+            RecipeArena arena;
+            return manager.getAllRecipeViews(arena).size();
+        });
+    }
+
+    std::filesystem::remove(dbPath);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Throughput benchmark for recipe JSON parsing.
+// Compares the DOM route recipe::fromJson used to take (nlohmann::json::parse + field lookups)
+// against the streaming RecipeJsonParser, on single documents and on an advanced-search cache array.
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "recipe.h"
+#include "recipeFields.h"
+#include "recipeJsonParser.h"
+
+static recipe parseWithDom(const std::string& json) {
+    nlohmann::json j = nlohmann::json::parse(json);
+    return RecipeFields::build([&j](const auto& field) {
+        return j.value(std::string(field.key), std::string());
+    });
+}
+
+template <typename Fn>
+static void measure(const char* label, size_t documents, size_t bytes, int rounds, Fn&& fn) {
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        checksum += fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::left << std::setw(18) << label << std::fixed << std::setprecision(0)
+              << " docs_per_sec=" << (documents * rounds) / seconds
+              << std::setprecision(1)
+              << " mb_per_sec=" << (bytes * rounds) / seconds / (1024.0 * 1024.0)
+              << " checksum=" << checksum << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t recipeCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<std::string> documents;
+    documents.reserve(recipeCount);
+    size_t totalBytes = 0;
+    std::string cacheArray = "[";
+    for (size_t i = 0; i < recipeCount; ++i) {
+        recipe r("Benchmark Recipe " + std::to_string(i) + " \"Caf\xC3\xA9 style\"",
+                 "200g flour, 2 eggs, 100ml milk, a pinch of salt, butter for the pan",
+                 "Whisk flour, eggs and milk into a smooth batter.\nRest for 30 minutes.\nFry thin pancakes in butter.",
+                 "4 servings", "45 minutes", "Breakfast", "Pancakes", "bench_" + std::to_string(i));
+        documents.push_back(r.toJson());
+        totalBytes += documents.back().size();
+        cacheArray += (i ? "," : "") + documents.back();
+    }
+    cacheArray += ']';
+
+    std::cout << "Documents: " << recipeCount << " (" << totalBytes << " bytes), rounds: " << rounds << std::endl;
+
+    measure("dom fromJson", recipeCount, totalBytes, rounds, [&documents]() {
+        size_t sum = 0;
+        for (const auto& doc : documents) {
+            sum += parseWithDom(doc).getTitle().size();
+        }
+        return sum;
+    });
+
+    measure("streaming fromJson", recipeCount, totalBytes, rounds, [&documents]() {
+        size_t sum = 0;
+        for (const auto& doc : documents) {
+            sum += RecipeJsonParser(doc).parseRecipe().getTitle().size();
+        }
+        return sum;
+    });
+
+    measure("dom array", recipeCount, cacheArray.size(), rounds, [&cacheArray]() {
+        size_t sum = 0;
+        for (const auto& item : nlohmann::json::parse(cacheArray)) {
+            sum += parseWithDom(item.dump()).getTitle().size();
+        }
+        return sum;
+    });
+
+    measure("streaming array", recipeCount, cacheArray.size(), rounds, [&cacheArray]() {
+        size_t sum = 0;
+        for (const auto& r : RecipeJsonParser(cacheArray).parseRecipeArray()) {
+            sum += r.getTitle().size();
+        }
+        return sum;
+    });
+
+    return 0;
+}
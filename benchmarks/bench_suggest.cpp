@@ -0,0 +1,73 @@
+// Latency benchmark for prefix autocomplete.
+// Builds a SuggestIndex over synthetic recipes (default 200k, titles of 2-4 words from a skewed
+// vocabulary) and reports build time and per-keystroke latency for 1-4 character prefixes.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "suggestIndex.h"
+
+int main(int argc, char* argv[]) {
+    size_t recipeCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t vocabulary = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 2000;
+
+    std::mt19937 rng(11);
+    std::vector<double> weights(vocabulary);
+    for (size_t i = 0; i < vocabulary; ++i) {
+        weights[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    std::discrete_distribution<size_t> pickWord(weights.begin(), weights.end());
+    std::uniform_int_distribution<int> wordCount(2, 4);
+    std::uniform_int_distribution<int> letter(0, 25);
+    std::vector<std::string> words(vocabulary);
+    for (auto& word : words) {
+        for (int i = 4 + letter(rng) % 6; i > 0; --i) {
+            word += static_cast<char>('a' + letter(rng));
+        }
+    }
+
+    std::vector<SuggestIndex::Document> documents;
+    documents.reserve(recipeCount);
+    for (size_t r = 0; r < recipeCount; ++r) {
+        std::string title;
+        for (int i = wordCount(rng); i > 0; --i) {
+            title += words[pickWord(rng)] + " ";
+        }
+        std::string ingredients;
+        for (int i = 0; i < 6; ++i) {
+            ingredients += words[pickWord(rng)] + ", ";
+        }
+        documents.push_back({"recipe_" + std::to_string(r), title, words[pickWord(rng) % 20], ingredients});
+    }
+
+    SuggestIndex index;
+    auto buildStart = std::chrono::steady_clock::now();
+    index.ensureBuilt([&documents]() { return std::move(documents); });
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+    std::cout << "Trie nodes: " << index.nodeCount() << ", build_ms=" << std::fixed << std::setprecision(1) << buildMs << std::endl;
+
+    std::vector<double> latencies;
+    size_t checksum = 0;
+    for (int q = 0; q < queries; ++q) {
+        // Simulate typing: every prefix of a random word
+        const std::string& word = words[pickWord(rng)];
+        for (size_t length = 1; length <= std::min<size_t>(4, word.size()); ++length) {
+            auto start = std::chrono::steady_clock::now();
+            auto suggestions = index.suggest(std::string_view(word).substr(0, length), 10);
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            checksum += suggestions.size();
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "top-10 suggest p50_us=" << latencies[latencies.size() / 2]
+              << " p99_us=" << latencies[latencies.size() * 99 / 100]
+              << " max_us=" << latencies.back()
+              << " checksum=" << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Throughput benchmark for small concurrent writes.
+// Several threads insert rating-sized rows into a file database, first each in its own autocommit
+// transaction (one fsync per write), then through a WriteQueue that waits for the commit, then through
+// one that acknowledges on enqueue. Reports writes/sec and, for the queue, the average batch size.
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sqlite3.h>
+#include "writeQueue.h"
+
+namespace {
+
+const char* kSchema = "CREATE TABLE ratings (recipe_id TEXT, user_id TEXT, rating INTEGER, PRIMARY KEY (recipe_id, user_id));";
+
+bool insertRating(sqlite3* db, int thread, int i) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "INSERT OR REPLACE INTO ratings VALUES (?, ?, ?);", -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    std::string recipeId = "recipe" + std::to_string(i % 997);
+    std::string userId = "user" + std::to_string(thread) + "_" + std::to_string(i);
+    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 3, 1 + i % 5);
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+std::string freshDatabase() {
+    std::string path = (std::filesystem::temp_directory_path() / "bench_write_queue.db").string();
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + "-wal");
+    std::filesystem::remove(path + "-shm");
+    sqlite3* db = nullptr;
+    sqlite3_open(path.c_str(), &db);
+    sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+    sqlite3_exec(db, kSchema, nullptr, nullptr, nullptr);
+    sqlite3_close(db);
+    return path;
+}
+
+template <typename Writer>
+double timeWriters(int threads, Writer&& writer) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(writer, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* label, int writes, double seconds) {
+    std::cout << std::left << std::setw(26) << label << std::right << std::setw(12) << std::fixed
+              << std::setprecision(0) << writes / seconds << " writes/s" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : 8;
+    int perThread = argc > 2 ? std::atoi(argv[2]) : 500;
+    int writes = threads * perThread;
+    std::cout << threads << " threads x " << perThread << " writes" << std::endl;
+
+    {
+        std::string path = freshDatabase();
+        std::mutex connectionMutex;  // Mirrors the manager's single shared connection
+        sqlite3* db = nullptr;
+        sqlite3_open(path.c_str(), &db);
+        double seconds = timeWriters(threads, [&](int t) {
+            for (int i = 0; i < perThread; ++i) {
+                std::lock_guard<std::mutex> lock(connectionMutex);
+                insertRating(db, t, i);
+            }
+        });
+        sqlite3_close(db);
+        report("autocommit per write", writes, seconds);
+    }
+
+    for (bool waitForCommit : {true, false}) {
+        std::string path = freshDatabase();
+        double seconds;
+        WriteQueue::Stats stats;
+        {
+            WriteQueue queue(path);
+            seconds = timeWriters(threads, [&](int t) {
+                for (int i = 0; i < perThread; ++i) {
+                    auto result = queue.submit([t, i](void* db) { return insertRating(static_cast<sqlite3*>(db), t, i); },
+                                               waitForCommit ? WriteQueue::Durability::Committed
+                                                             : WriteQueue::Durability::Queued);
+                    if (waitForCommit) {
+                        result.wait();
+                    }
+                }
+                queue.flush();
+            });
+            stats = queue.stats();
+        }
+        report(waitForCommit ? "write queue (committed)" : "write queue (queued)", writes, seconds);
+        std::cout << "  avg batch " << std::setprecision(1)
+                  << static_cast<double>(stats.operations) / static_cast<double>(stats.batches) << std::endl;
+    }
+    return 0;
+}
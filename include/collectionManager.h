@@ -2,15 +2,20 @@
 #define COLLECTION_MANAGER_H
 
 #include "collection.h"
+#include "entityVersions.h"
 #include "recipe.h"
 #include <sqlite3.h>
 #include <vector>
 #include <optional>
 #include <string>
 
+class RecipeManagerSQLite;
+
 class CollectionManager {
 public:
-    explicit CollectionManager(sqlite3* db, const std::string& recipeDbPath = "recipes.db");
+    // recipeManager resolves collection entries to recipes; it is the server's own manager, not a copy, so
+    // reads share its connection and caches. It must outlive this object.
+    CollectionManager(sqlite3* db, RecipeManagerSQLite& recipeManager);
     ~CollectionManager() = default;
 
     // Collection CRUD operations
@@ -31,9 +36,13 @@ public:
     int getCollectionRecipeCount(const std::string& collectionId);
     std::vector<recipe> getCollectionRecipes(const std::string& collectionId);
 
+    // Strong ETag for a collection and its recipe list; changes with every write made through this manager
+    std::string collectionETag(const std::string& collectionId) const;
+
 private:
     sqlite3* db_;
-    std::string recipeDbPath_;
+    RecipeManagerSQLite& recipeManager_;
+    EntityVersions versions_;  // By collection id, bumped by every successful write
 
     // Helper methods
     std::optional<Collection> collectionFromRow(sqlite3_stmt* stmt) const;
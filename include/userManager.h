@@ -12,6 +12,10 @@ public:
     explicit UserManager(sqlite3* db);
     ~UserManager() = default;
 
+    // Brings the users database (users, collections, collection_recipes) to the current schema version;
+    // cheap when it is already there
+    static bool initializeSchema(sqlite3* db);
+
     // User CRUD operations
     bool createUser(const User& user);
     std::optional<User> findUserById(const std::string& id);
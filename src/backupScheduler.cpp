@@ -0,0 +1,269 @@
+#include "backupScheduler.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+constexpr int kBusyTimeoutMs = 5000;
+constexpr size_t kStampLength = 19;  // YYYYMMDD-HHMMSS-mmm
+
+std::string utcTimestamp(const char* format, bool millis) {
+    auto now = std::chrono::system_clock::now();
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+    char buffer[32];
+    size_t length = std::strftime(buffer, sizeof(buffer), format, &utc);
+    std::string text(buffer, length);
+    if (millis) {
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+        std::snprintf(buffer, sizeof(buffer), "-%03d", static_cast<int>(ms));
+        text += buffer;
+    }
+    return text;
+}
+
+std::string snapshotPrefix(const std::string& database) {
+    return std::filesystem::path(database).stem().string() + "-";
+}
+
+// Snapshots of one database in directory, oldest first
+std::vector<std::string> listSnapshots(const std::string& directory, const std::string& prefix) {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::string name = entry.path().filename().string();
+        // The exact length keeps "recipes-" from matching another database's "recipes-old-..." files
+        if (entry.is_regular_file(ec) && name.size() == prefix.size() + kStampLength + 3 &&
+            name.compare(0, prefix.size(), prefix) == 0 && name.compare(name.size() - 3, 3, ".db") == 0) {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+bool quickCheck(sqlite3* db, std::string& error) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA quick_check;", -1, &stmt, nullptr) != SQLITE_OK) {
+        error = sqlite3_errmsg(db);
+        return false;
+    }
+    bool ok = sqlite3_step(stmt) == SQLITE_ROW &&
+              std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))) == "ok";
+    if (!ok) {
+        error = "snapshot failed quick_check";
+    }
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+} // namespace
+
+BackupScheduler::BackupScheduler(std::vector<std::string> databases, Options options)
+    : databases_(std::move(databases)), options_(std::move(options)) {
+    worker_ = std::thread(&BackupScheduler::run, this);
+}
+
+BackupScheduler::~BackupScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;  // Also abandons a copy in progress at its next step
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool BackupScheduler::trigger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (progress_.running || triggered_) {
+            return false;
+        }
+        triggered_ = true;
+    }
+    wake_.notify_one();
+    return true;
+}
+
+bool BackupScheduler::runNow() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (progress_.running) {
+        return false;
+    }
+    return runLocked(lock);
+}
+
+BackupScheduler::Progress BackupScheduler::progress() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return progress_;
+}
+
+std::vector<std::string> BackupScheduler::snapshots() const {
+    std::vector<std::string> files;
+    for (const auto& database : databases_) {
+        auto own = listSnapshots(options_.directory, snapshotPrefix(database));
+        files.insert(files.end(), own.begin(), own.end());
+    }
+    return files;
+}
+
+void BackupScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto due = std::chrono::steady_clock::now() + options_.interval;
+    while (true) {
+        auto requested = [this]() { return stopping_ || triggered_; };
+        if (options_.interval.count() > 0) {
+            wake_.wait_until(lock, due, requested);
+        } else {
+            wake_.wait(lock, requested);
+        }
+        if (stopping_) {
+            return;
+        }
+        triggered_ = false;
+        if (!progress_.running) {
+            runLocked(lock);
+        }
+        due = std::chrono::steady_clock::now() + options_.interval;
+    }
+}
+
+// Called with the lock held and no run in progress; the lock is released while copying
+bool BackupScheduler::runLocked(std::unique_lock<std::mutex>& lock) {
+    progress_.running = true;
+    progress_.lastStarted = utcTimestamp("%Y-%m-%dT%H:%M:%SZ", false);
+    lock.unlock();
+
+    bool ok = true;
+    std::string errors;
+    std::vector<std::string> written;
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    const std::string stamp = utcTimestamp("%Y%m%d-%H%M%S", true);
+
+    for (const auto& database : databases_) {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            progress_.database = database;
+            progress_.pagesDone = 0;
+            progress_.pagesTotal = 0;
+        }
+        std::string prefix = snapshotPrefix(database);
+        std::string target = (std::filesystem::path(options_.directory) / (prefix + stamp + ".db")).string();
+        std::string partial = target + ".partial";
+        std::string error;
+        bool copied = backupDatabase(database, partial, options_, [this](int done, int total) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            progress_.pagesDone = done;
+            progress_.pagesTotal = total;
+            return !stopping_;
+        }, error);
+        if (copied) {
+            std::filesystem::rename(partial, target, ec);
+            if (ec) {
+                copied = false;
+                error = ec.message();
+            }
+        }
+        if (!copied) {
+            std::filesystem::remove(partial, ec);
+            std::cerr << "Backup of " << database << " failed: " << error << std::endl;
+            errors += (errors.empty() ? "" : "; ") + database + ": " + error;
+            ok = false;
+            continue;
+        }
+        written.push_back(target);
+        prune(prefix);
+    }
+
+    lock.lock();
+    progress_.running = false;
+    progress_.database.clear();
+    ++progress_.runs;
+    progress_.lastFinished = utcTimestamp("%Y-%m-%dT%H:%M:%SZ", false);
+    progress_.lastOk = ok;
+    progress_.lastError = errors;
+    progress_.lastSnapshots = std::move(written);
+    return ok;
+}
+
+void BackupScheduler::prune(const std::string& prefix) const {
+    if (options_.keep == 0) {
+        return;
+    }
+    auto files = listSnapshots(options_.directory, prefix);
+    for (size_t i = 0; i + options_.keep < files.size(); ++i) {
+        std::error_code ec;
+        std::filesystem::remove(files[i], ec);
+    }
+}
+
+bool BackupScheduler::backupDatabase(const std::string& source, const std::string& destination,
+                                     const Options& options, const StepCallback& onStep, std::string& error) {
+    sqlite3* src = nullptr;
+    if (sqlite3_open_v2(source.c_str(), &src, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        error = sqlite3_errmsg(src);
+        sqlite3_close(src);
+        return false;
+    }
+    sqlite3_busy_timeout(src, kBusyTimeoutMs);
+    sqlite3* dst = nullptr;
+    if (sqlite3_open_v2(destination.c_str(), &dst, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        error = sqlite3_errmsg(dst);
+        sqlite3_close(dst);
+        sqlite3_close(src);
+        return false;
+    }
+
+    bool ok = false;
+    sqlite3_backup* backup = sqlite3_backup_init(dst, "main", src, "main");
+    if (!backup) {
+        error = sqlite3_errmsg(dst);
+    } else {
+        int restarts = 0;
+        int lastDone = 0;
+        bool cancelled = false;
+        int rc;
+        do {
+            // Past maxRestarts, finish in one step instead of starting over after every write
+            rc = sqlite3_backup_step(backup, restarts >= options.maxRestarts ? -1 : std::max(options.pagesPerStep, 1));
+            int total = sqlite3_backup_pagecount(backup);
+            int done = total - sqlite3_backup_remaining(backup);
+            if (rc == SQLITE_OK && done <= lastDone) {
+                ++restarts;  // Another connection wrote to the source, so SQLite started the copy again
+            }
+            lastDone = done;
+            if (onStep && !onStep(done, total)) {
+                cancelled = true;
+                break;
+            }
+            if (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+                std::this_thread::sleep_for(options.pause);
+            }
+        } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+        int finishRc = sqlite3_backup_finish(backup);
+        if (cancelled) {
+            error = "backup cancelled";
+        } else if (rc != SQLITE_DONE || finishRc != SQLITE_OK) {
+            error = sqlite3_errstr(rc != SQLITE_DONE ? rc : finishRc);
+        } else {
+            ok = quickCheck(dst, error);
+        }
+    }
+
+    sqlite3_close(dst);
+    sqlite3_close(src);
+    return ok;
+}
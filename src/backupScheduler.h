@@ -0,0 +1,86 @@
+#ifndef BACKUP_SCHEDULER_H
+#define BACKUP_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Online snapshots of live SQLite databases through the backup API.
+// Each database is copied on its own read-only connection pagesPerStep pages at a time, pausing between
+// steps so the source lock is only held briefly and writers keep going. A write from another connection
+// makes SQLite restart the copy; after maxRestarts restarts the rest is copied in a single step rather
+// than chasing a busy database forever.
+// Snapshots are written as <directory>/<name>-YYYYMMDD-HHMMSS-mmm.db (UTC, so names sort by age) via a
+// .partial file that is renamed once the copy passes quick_check. Only the newest keep per database stay.
+// With a non-zero interval a background thread takes a snapshot of every database each interval;
+// trigger() starts one immediately.
+class BackupScheduler {
+public:
+    struct Options {
+        std::string directory;
+        std::chrono::minutes interval{0};         // 0 = only when triggered
+        size_t keep = 7;                          // Snapshots retained per database; 0 = all
+        int pagesPerStep = 256;
+        std::chrono::milliseconds pause{10};      // Between steps, with the source unlocked
+        int maxRestarts = 3;
+    };
+
+    struct Progress {
+        bool running = false;
+        std::string database;                     // Being copied now
+        int pagesDone = 0;
+        int pagesTotal = 0;
+        uint64_t runs = 0;                        // Completed runs, successful or not
+        std::string lastStarted;                  // ISO 8601 UTC; "" before the first run
+        std::string lastFinished;
+        bool lastOk = false;
+        std::string lastError;
+        std::vector<std::string> lastSnapshots;   // Files written by the last run
+    };
+
+    // Called after every step; false abandons the copy
+    using StepCallback = std::function<bool(int pagesDone, int pagesTotal)>;
+
+    BackupScheduler(std::vector<std::string> databases, Options options);
+    ~BackupScheduler();
+
+    BackupScheduler(const BackupScheduler&) = delete;
+    BackupScheduler& operator=(const BackupScheduler&) = delete;
+
+    // Starts a run on the background thread; false if one is already running
+    bool trigger();
+    // Runs on the calling thread and returns whether every database was backed up; false straight away
+    // if a run is already in progress
+    bool runNow();
+
+    Progress progress() const;
+    // Retained snapshot files, database by database, oldest first
+    std::vector<std::string> snapshots() const;
+
+    // Copies one database into destination (overwritten); error is set on failure
+    static bool backupDatabase(const std::string& source, const std::string& destination, const Options& options,
+                               const StepCallback& onStep, std::string& error);
+
+private:
+    const std::vector<std::string> databases_;
+    const Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    Progress progress_;
+    bool triggered_ = false;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    void run();
+    bool runLocked(std::unique_lock<std::mutex>& lock);
+    void prune(const std::string& name) const;
+};
+
+#endif // BACKUP_SCHEDULER_H
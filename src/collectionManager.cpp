@@ -4,8 +4,8 @@
 #include <iostream>
 #include <sstream>
 
-CollectionManager::CollectionManager(sqlite3* db, const std::string& recipeDbPath)
-    : db_(db), recipeDbPath_(recipeDbPath) {}
+CollectionManager::CollectionManager(sqlite3* db, RecipeManagerSQLite& recipeManager)
+    : db_(db), recipeManager_(recipeManager) {}
 
 bool CollectionManager::createCollection(const Collection& collection) {
     const std::string query = R"(
@@ -128,13 +128,21 @@ bool CollectionManager::updateCollection(const Collection& collection) {
         collection.getId()
     };
 
-    return executeQuery(query, params);
+    if (!executeQuery(query, params)) {
+        return false;
+    }
+    versions_.bump(collection.getId());
+    return true;
 }
 
 bool CollectionManager::deleteCollection(const std::string& id) {
     const std::string query = "DELETE FROM collections WHERE id = ?";
     std::vector<std::string> params = {id};
-    return executeQuery(query, params);
+    if (!executeQuery(query, params)) {
+        return false;
+    }
+    versions_.bump(id);
+    return true;
 }
 
 bool CollectionManager::addRecipeToCollection(const std::string& collectionId, const std::string& recipeId) {
@@ -144,7 +152,11 @@ bool CollectionManager::addRecipeToCollection(const std::string& collectionId, c
     )";
 
     std::vector<std::string> params = {collectionId, recipeId};
-    return executeQuery(query, params);
+    if (!executeQuery(query, params)) {
+        return false;
+    }
+    versions_.bump(collectionId);
+    return true;
 }
 
 bool CollectionManager::removeRecipeFromCollection(const std::string& collectionId, const std::string& recipeId) {
@@ -154,7 +166,11 @@ bool CollectionManager::removeRecipeFromCollection(const std::string& collection
     )";
 
     std::vector<std::string> params = {collectionId, recipeId};
-    return executeQuery(query, params);
+    if (!executeQuery(query, params)) {
+        return false;
+    }
+    versions_.bump(collectionId);
+    return true;
 }
 
 std::vector<std::string> CollectionManager::getRecipeIdsInCollection(const std::string& collectionId) {
@@ -305,6 +321,10 @@ std::optional<std::string> CollectionManager::executeScalarQuery(const std::stri
     return result;
 }
 
+std::string CollectionManager::collectionETag(const std::string& collectionId) const {
+    return versions_.etag(collectionId);
+}
+
 // Alias methods for compatibility
 std::optional<Collection> CollectionManager::getCollectionById(const std::string& id) {
     return findCollectionById(id);
@@ -322,14 +342,13 @@ int CollectionManager::getCollectionRecipeCount(const std::string& collectionId)
 std::vector<recipe> CollectionManager::getCollectionRecipes(const std::string& collectionId) {
     auto recipeIds = getRecipeIdsInCollection(collectionId);
     std::vector<recipe> recipes;
+    recipes.reserve(recipeIds.size());
 
     // Use RecipeManagerSQLite to get full recipe objects
-    RecipeManagerSQLite recipeManager(recipeDbPath_);
-
     for (const auto& recipeId : recipeIds) {
-        auto recipePtr = recipeManager.getRecipe(recipeId);
+        auto recipePtr = recipeManager_.getRecipe(recipeId);
         if (recipePtr) {
-            recipes.push_back(*recipePtr);
+            recipes.push_back(std::move(*recipePtr));
         }
     }
 
@@ -0,0 +1,203 @@
+#include "databaseMaintenance.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// First column of the first row, -1 on failure
+int64_t queryInt(sqlite3* db, const char* sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int64_t value = -1;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+bool exec(sqlite3* db, const char* sql, std::string& error) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        error = std::string(sql) + ": " + (errMsg ? errMsg : sqlite3_errmsg(db));
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+DatabaseMaintenance::DatabaseMaintenance(const std::vector<std::string>& databases, Options options)
+    : options_(options) {
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& path : databases) {
+        Database database;
+        database.path = path;
+        database.stats.database = path;
+        database.lastOptimize = database.lastAnalyze = database.lastVacuum = now;
+        sqlite3* db = nullptr;
+        if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+            database.stats.lastError = sqlite3_errmsg(db);
+            std::cerr << "Maintenance can't open database " << path << ": " << database.stats.lastError << std::endl;
+            sqlite3_close(db);
+        } else {
+            sqlite3_busy_timeout(db, static_cast<int>(options_.busyTimeout.count()));
+            // A connection only learns the database is in WAL mode once it reads it; until then checkpoints no-op
+            sqlite3_exec(db, "PRAGMA journal_mode;", nullptr, nullptr, nullptr);
+            database.db = db;
+        }
+        databases_.push_back(std::move(database));
+    }
+    worker_ = std::thread(&DatabaseMaintenance::run, this);
+}
+
+DatabaseMaintenance::~DatabaseMaintenance() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    for (auto& database : databases_) {
+        if (database.db) {
+            sqlite3_close(static_cast<sqlite3*>(database.db));
+        }
+    }
+}
+
+void DatabaseMaintenance::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto stopping = [this]() { return stopping_; };
+    if (options_.checkpointInterval.count() <= 0) {
+        wake_.wait(lock, stopping);
+        return;
+    }
+    while (!wake_.wait_for(lock, options_.checkpointInterval, stopping)) {
+        lock.unlock();
+        runNow();
+        lock.lock();
+    }
+}
+
+void DatabaseMaintenance::runNow() {
+    std::lock_guard<std::mutex> pass(passMutex_);
+    auto now = std::chrono::steady_clock::now();
+    for (auto& database : databases_) {
+        if (database.db) {
+            // Tasks first, so whatever they wrote to the WAL is checkpointed in the same pass
+            runDueTasks(database, now);
+            checkpoint(database);
+        }
+    }
+}
+
+std::vector<DatabaseMaintenance::Stats> DatabaseMaintenance::stats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    std::vector<Stats> all;
+    all.reserve(databases_.size());
+    for (const auto& database : databases_) {
+        all.push_back(database.stats);
+    }
+    return all;
+}
+
+void DatabaseMaintenance::checkpoint(Database& database) {
+    sqlite3* db = static_cast<sqlite3*>(database.db);
+    const std::string walPath = database.path + "-wal";
+    std::error_code ec;
+    uint64_t walSize = std::filesystem::file_size(walPath, ec);
+    auto walWritten = ec ? std::filesystem::file_time_type{} : std::filesystem::last_write_time(walPath, ec);
+    if (ec) {
+        walSize = 0;  // No WAL: not in WAL mode, or nothing written since the last connection closed
+    }
+
+    const bool truncate = walSize > 0 && walSize >= options_.truncateWalBytes;
+    if (!truncate && (walSize == 0 || (walSize == database.walSize && walWritten == database.walWritten))) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        database.stats.walBytes = walSize;
+        return;
+    }
+
+    int frames = 0;
+    int copied = 0;
+    auto start = std::chrono::steady_clock::now();
+    int rc = sqlite3_wal_checkpoint_v2(db, nullptr, truncate ? SQLITE_CHECKPOINT_TRUNCATE : SQLITE_CHECKPOINT_PASSIVE,
+                                       &frames, &copied);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    uint64_t walAfter = std::filesystem::file_size(walPath, ec);
+    if (ec) {
+        walAfter = 0;
+    }
+
+    // Frames still waiting on a reader keep the WAL marked as changed, so the next pass tries again
+    if (rc == SQLITE_OK && copied >= frames) {
+        database.walSize = walAfter;
+        database.walWritten = walAfter ? std::filesystem::last_write_time(walPath, ec) : std::filesystem::file_time_type{};
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        Stats& stats = database.stats;
+        stats.walBytes = walAfter;
+        if (rc == SQLITE_OK) {
+            ++stats.checkpoints;
+            stats.truncations += truncate;
+            stats.partialCheckpoints += copied < frames;
+            stats.lastCheckpointFrames = frames;
+            stats.lastCheckpointMs = ms;
+            stats.maxCheckpointMs = std::max(stats.maxCheckpointMs, ms);
+            stats.totalCheckpointMs += ms;
+        } else if (rc == SQLITE_BUSY) {
+            ++stats.busyCheckpoints;
+        } else {
+            stats.lastError = sqlite3_errmsg(db);
+        }
+    }
+
+    if (ms > static_cast<double>(options_.slowCheckpoint.count())) {
+        std::cerr << "Slow WAL checkpoint on " << database.path << ": " << static_cast<long>(ms) << " ms for "
+                  << frames << " frames (" << (truncate ? "truncate" : "passive") << ")" << std::endl;
+    }
+}
+
+void DatabaseMaintenance::runDueTasks(Database& database, std::chrono::steady_clock::time_point now) {
+    sqlite3* db = static_cast<sqlite3*>(database.db);
+    auto due = [now](std::chrono::milliseconds interval, std::chrono::steady_clock::time_point& last) {
+        if (interval.count() <= 0 || now - last < interval) {
+            return false;
+        }
+        last = now;
+        return true;
+    };
+    std::string error;
+    uint64_t optimized = 0;
+    uint64_t analyzed = 0;
+    uint64_t vacuumed = 0;
+
+    // Cheap: only re-analyzes tables whose statistics have drifted
+    if (due(options_.optimizeInterval, database.lastOptimize)) {
+        optimized = exec(db, "PRAGMA optimize;", error);
+    }
+    if (due(options_.analyzeInterval, database.lastAnalyze)) {
+        analyzed = exec(db, "ANALYZE;", error);
+    }
+    // 2 = INCREMENTAL; other databases have no free pages to hand back without a full VACUUM
+    if (due(options_.vacuumInterval, database.lastVacuum) && queryInt(db, "PRAGMA auto_vacuum;") == 2) {
+        int64_t freePages = queryInt(db, "PRAGMA freelist_count;");
+        if (freePages > options_.vacuumFreePages && exec(db, "PRAGMA incremental_vacuum;", error)) {
+            int64_t left = queryInt(db, "PRAGMA freelist_count;");
+            vacuumed = static_cast<uint64_t>(freePages - std::max<int64_t>(left, 0));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    database.stats.optimizeRuns += optimized;
+    database.stats.analyzeRuns += analyzed;
+    database.stats.vacuumedPages += vacuumed;
+    if (!error.empty()) {
+        database.stats.lastError = error;
+    }
+}
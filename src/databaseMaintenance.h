@@ -0,0 +1,91 @@
+#ifndef DATABASE_MAINTENANCE_H
+#define DATABASE_MAINTENANCE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Housekeeping for WAL-mode SQLite databases on one background thread, so none of it lands on a request.
+// Every checkpointInterval each database whose WAL has been written since the last pass gets a PASSIVE
+// checkpoint, which copies what it can without waiting on readers or writers. Once the WAL file reaches
+// truncateWalBytes the checkpoint is a TRUNCATE instead: it waits up to busyTimeout for readers to move
+// on, then empties the file. Meant to run with the connections' own auto-checkpoints switched off
+// (RecipeManagerSQLite::setAutoCheckpoint(0), sqlite3_wal_autocheckpoint).
+// Less often it runs PRAGMA optimize, ANALYZE, and PRAGMA incremental_vacuum on databases created with
+// auto_vacuum = INCREMENTAL once their freelist passes vacuumFreePages. A zero interval disables a task.
+// The thread starts with the constructor; runNow() does a pass on the caller's thread.
+class DatabaseMaintenance {
+public:
+    struct Options {
+        std::chrono::milliseconds checkpointInterval{1000};
+        uint64_t truncateWalBytes = 64ull * 1024 * 1024;
+        std::chrono::milliseconds busyTimeout{250};           // TRUNCATE and vacuum wait this long for locks
+        std::chrono::milliseconds slowCheckpoint{100};        // Logged when a checkpoint takes longer
+        std::chrono::milliseconds optimizeInterval = std::chrono::hours(1);
+        std::chrono::milliseconds analyzeInterval = std::chrono::hours(24);
+        std::chrono::milliseconds vacuumInterval = std::chrono::minutes(10);
+        int64_t vacuumFreePages = 1024;
+    };
+
+    // Per database, since the scheduler started
+    struct Stats {
+        std::string database;
+        uint64_t walBytes = 0;             // WAL file size after the last pass
+        uint64_t checkpoints = 0;          // Completed, PASSIVE or TRUNCATE
+        uint64_t truncations = 0;
+        uint64_t partialCheckpoints = 0;   // PASSIVE checkpoints that left frames behind for active readers
+        uint64_t busyCheckpoints = 0;      // TRUNCATE checkpoints that gave up waiting; retried next pass
+        int lastCheckpointFrames = 0;      // WAL frames at the last checkpoint
+        double lastCheckpointMs = 0.0;
+        double maxCheckpointMs = 0.0;
+        double totalCheckpointMs = 0.0;
+        uint64_t optimizeRuns = 0;
+        uint64_t analyzeRuns = 0;
+        uint64_t vacuumedPages = 0;
+        std::string lastError;
+    };
+
+    DatabaseMaintenance(const std::vector<std::string>& databases, Options options);
+    ~DatabaseMaintenance();
+
+    DatabaseMaintenance(const DatabaseMaintenance&) = delete;
+    DatabaseMaintenance& operator=(const DatabaseMaintenance&) = delete;
+
+    // One pass on the calling thread: checkpoints where needed, plus whatever other task is due
+    void runNow();
+
+    std::vector<Stats> stats() const;
+
+private:
+    struct Database {
+        std::string path;
+        void* db = nullptr;  // sqlite3*, used only by whichever thread holds passMutex_
+        std::filesystem::file_time_type walWritten{};  // WAL file as of the last checkpoint
+        uint64_t walSize = 0;
+        std::chrono::steady_clock::time_point lastOptimize;
+        std::chrono::steady_clock::time_point lastAnalyze;
+        std::chrono::steady_clock::time_point lastVacuum;
+        Stats stats;
+    };
+
+    const Options options_;
+    std::vector<Database> databases_;
+
+    std::mutex passMutex_;           // One pass at a time
+    mutable std::mutex statsMutex_;  // Guards every Database::stats
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    void run();
+    void checkpoint(Database& database);
+    void runDueTasks(Database& database, std::chrono::steady_clock::time_point now);
+};
+
+#endif // DATABASE_MAINTENANCE_H
@@ -0,0 +1,76 @@
+#include "entityVersions.h"
+#include <cstdio>
+#include <mutex>
+#include <random>
+
+namespace {
+
+uint64_t randomEpoch() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Opaque part of an entity tag: no W/ prefix, no quotes
+std::string_view opaque(std::string_view tag) {
+    if (tag.substr(0, 2) == "W/") {
+        tag.remove_prefix(2);
+    }
+    if (tag.size() >= 2 && tag.front() == '"' && tag.back() == '"') {
+        tag = tag.substr(1, tag.size() - 2);
+    }
+    return tag;
+}
+
+} // namespace
+
+EntityVersions::EntityVersions() : epoch_(randomEpoch()) {}
+
+void EntityVersions::bump(const std::string& key) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    ++versions_[key];
+}
+
+uint64_t EntityVersions::version(const std::string& key) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = versions_.find(key);
+    return it == versions_.end() ? 0 : it->second;
+}
+
+std::string EntityVersions::etag(const std::string& key) const {
+    char tag[48];
+    std::snprintf(tag, sizeof(tag), "\"%016llx-%llu\"", static_cast<unsigned long long>(epoch_),
+                  static_cast<unsigned long long>(version(key)));
+    return tag;
+}
+
+std::string EntityVersions::match(std::string_view ifNoneMatch, std::string_view etag) {
+    std::string_view wanted = opaque(etag);
+    if (wanted.empty()) {
+        return "";
+    }
+    while (!ifNoneMatch.empty()) {
+        size_t comma = ifNoneMatch.find(',');
+        std::string_view tag = trim(ifNoneMatch.substr(0, comma));
+        ifNoneMatch = comma == std::string_view::npos ? std::string_view() : ifNoneMatch.substr(comma + 1);
+        if (tag == "*") {
+            return std::string(etag);
+        }
+        std::string_view candidate = opaque(tag);
+        if (candidate == wanted ||
+            (candidate.size() > wanted.size() + 1 && candidate.substr(0, wanted.size()) == wanted &&
+             candidate[wanted.size()] == '-' && candidate.find('-', wanted.size() + 1) == std::string_view::npos)) {
+            return std::string(tag);
+        }
+    }
+    return "";
+}
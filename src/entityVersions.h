@@ -0,0 +1,37 @@
+#ifndef ENTITY_VERSIONS_H
+#define ENTITY_VERSIONS_H
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Change counters behind HTTP validators (ETag / If-None-Match). Each key - an entity id, or the id a
+// listing hangs off - has a version that bump() advances after every committed change to it, and etag()
+// turns it into a strong entity tag without reading the entity. Counters live in memory, so tags also
+// carry an epoch drawn at random at construction: a restarted server never reissues a tag for different
+// content. Only writes made through this process are seen. Safe to share between threads.
+class EntityVersions {
+public:
+    EntityVersions();
+
+    EntityVersions(const EntityVersions&) = delete;
+    EntityVersions& operator=(const EntityVersions&) = delete;
+
+    void bump(const std::string& key);
+    uint64_t version(const std::string& key) const;  // 0 until the first bump
+    std::string etag(const std::string& key) const;  // Quoted: "<epoch>-<version>"
+
+    // The entity tag in an If-None-Match header that etag satisfies, "" if none does. Comparison is weak,
+    // as RFC 9110 requires for If-None-Match, and also accepts etag with a "-<coding>" suffix, which is
+    // how a response compressed after the tag was set marks its own representation. "*" returns etag.
+    static std::string match(std::string_view ifNoneMatch, std::string_view etag);
+
+private:
+    const uint64_t epoch_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, uint64_t> versions_;
+};
+
+#endif // ENTITY_VERSIONS_H
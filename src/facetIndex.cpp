@@ -0,0 +1,217 @@
+#include "facetIndex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// Lowercased with surrounding whitespace removed, so "Dessert " and "dessert" share a code
+std::string normalizeValue(std::string_view value) {
+    size_t begin = value.find_first_not_of(" \t\r\n");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    size_t end = value.find_last_not_of(" \t\r\n");
+    std::string normalized(value.substr(begin, end - begin + 1));
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return normalized;
+}
+
+} // namespace
+
+uint8_t FacetIndex::cookTimeBucket(std::string_view cookTime) {
+    // Sums "<n> hour(s)" / "<n> min(utes)" pairs ("1 hour 30 minutes" -> 90); for a range such as
+    // "20-30 minutes" only the number next to the unit counts. A bare number is minutes.
+    long minutes = 0;
+    long bareNumber = -1;
+    bool anyUnit = false;
+    size_t pos = 0;
+    while (pos < cookTime.size()) {
+        if (!std::isdigit(static_cast<unsigned char>(cookTime[pos]))) {
+            ++pos;
+            continue;
+        }
+        long amount = 0;
+        for (; pos < cookTime.size() && std::isdigit(static_cast<unsigned char>(cookTime[pos])); ++pos) {
+            amount = std::min(amount * 10 + (cookTime[pos] - '0'), 100000L);
+        }
+        if (bareNumber < 0) {
+            bareNumber = amount;
+        }
+        size_t unit = cookTime.find_first_not_of(' ', pos);
+        if (unit == std::string_view::npos) {
+            break;
+        }
+        char c = static_cast<char>(std::tolower(static_cast<unsigned char>(cookTime[unit])));
+        if (c == 'h') {
+            minutes += amount * 60;
+            anyUnit = true;
+        } else if (c == 'm') {
+            minutes += amount;
+            anyUnit = true;
+        }
+    }
+    if (!anyUnit) {
+        if (bareNumber < 0) {
+            return 0;
+        }
+        minutes = bareNumber;
+    }
+
+    if (minutes <= 15) return 1;
+    if (minutes <= 30) return 2;
+    if (minutes <= 60) return 3;
+    return 4;
+}
+
+const char* FacetIndex::cookTimeLabel(uint8_t bucket) {
+    static const char* const labels[kCookTimeBuckets] = {"unknown", "0-15", "16-30", "31-60", "60+"};
+    return bucket < kCookTimeBuckets ? labels[bucket] : "unknown";
+}
+
+uint32_t FacetIndex::Dictionary::encode(std::string_view value) {
+    auto [it, inserted] = codes.emplace(normalizeValue(value), static_cast<uint32_t>(values.size()));
+    if (inserted) {
+        size_t begin = value.find_first_not_of(" \t\r\n");
+        size_t end = value.find_last_not_of(" \t\r\n");
+        values.emplace_back(begin == std::string_view::npos ? std::string_view() : value.substr(begin, end - begin + 1));
+    }
+    return it->second;
+}
+
+uint32_t FacetIndex::Dictionary::find(std::string_view value) const {
+    auto it = codes.find(normalizeValue(value));
+    return it == codes.end() ? kDeleted : it->second;
+}
+
+FacetIndex::Histogram FacetIndex::Dictionary::histogram(const std::vector<uint32_t>& counts) const {
+    Histogram histogram;
+    for (uint32_t code = 0; code < counts.size(); ++code) {
+        if (counts[code] > 0) {
+            histogram.emplace_back(values[code], counts[code]);
+        }
+    }
+    std::sort(histogram.begin(), histogram.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return histogram;
+}
+
+FacetIndex::Counter::Counter(const FacetIndex& index)
+    : index_(index),
+      lock_(index.mutex_),
+      categories_(index.categories_.values.size(), 0),
+      types_(index.types_.values.size(), 0),
+      cookTimes_(kCookTimeBuckets, 0) {}
+
+void FacetIndex::Counter::add(const std::string& recipeId) {
+    auto it = index_.ordinals_.find(recipeId);
+    if (it == index_.ordinals_.end()) {
+        return;
+    }
+    const Row& row = index_.rows_[it->second];
+    ++categories_[row.category];
+    ++types_[row.type];
+    ++cookTimes_[row.cookTime];
+}
+
+FacetIndex::Counts FacetIndex::Counter::finish() const {
+    Counts counts;
+    counts.categories = index_.categories_.histogram(categories_);
+    counts.types = index_.types_.histogram(types_);
+    // Buckets stay in their natural order for the UI
+    for (uint8_t bucket = 1; bucket <= kCookTimeBuckets; ++bucket) {
+        uint8_t slot = bucket % kCookTimeBuckets; // "unknown" last
+        if (cookTimes_[slot] > 0) {
+            counts.cookTimes.emplace_back(cookTimeLabel(slot), cookTimes_[slot]);
+        }
+    }
+    return counts;
+}
+
+bool FacetIndex::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+void FacetIndex::upsert(const Document& document) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        upsertLocked(document);
+    }
+}
+
+void FacetIndex::remove(const std::string& recipeId) {
+    std::unique_lock lock(mutex_);
+    auto it = ordinals_.find(recipeId);
+    if (!built_ || it == ordinals_.end()) {
+        return;
+    }
+    rows_[it->second] = Row{};
+    rowIds_[it->second].clear();
+    freeRows_.push_back(it->second);
+    ordinals_.erase(it);
+}
+
+void FacetIndex::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    categories_ = Dictionary{};
+    types_ = Dictionary{};
+    rows_.clear();
+    rowIds_.clear();
+    ordinals_.clear();
+    freeRows_.clear();
+}
+
+void FacetIndex::upsertLocked(const Document& document) {
+    uint32_t ordinal;
+    auto it = ordinals_.find(document.recipeId);
+    if (it != ordinals_.end()) {
+        ordinal = it->second;
+    } else if (!freeRows_.empty()) {
+        ordinal = freeRows_.back();
+        freeRows_.pop_back();
+        rowIds_[ordinal] = document.recipeId;
+        ordinals_.emplace(document.recipeId, ordinal);
+    } else {
+        ordinal = static_cast<uint32_t>(rows_.size());
+        rows_.emplace_back();
+        rowIds_.push_back(document.recipeId);
+        ordinals_.emplace(document.recipeId, ordinal);
+    }
+
+    Row& row = rows_[ordinal];
+    row.category = categories_.encode(document.category);
+    row.type = types_.encode(document.type);
+    row.cookTime = cookTimeBucket(document.cookTime);
+}
+
+FacetIndex::Counts FacetIndex::countAll() const {
+    Counter counter(*this);
+    // Straight pass over the columns, no id lookups
+    for (const Row& row : rows_) {
+        if (row.category != kDeleted) {
+            ++counter.categories_[row.category];
+            ++counter.types_[row.type];
+            ++counter.cookTimes_[row.cookTime];
+        }
+    }
+    return counter.finish();
+}
+
+std::vector<std::string> FacetIndex::recipesWith(Dimension dimension, std::string_view value) const {
+    std::shared_lock lock(mutex_);
+    std::vector<std::string> ids;
+    uint32_t code = (dimension == Dimension::Category ? categories_ : types_).find(value);
+    if (code == kDeleted) {
+        return ids;
+    }
+    for (uint32_t ordinal = 0; ordinal < rows_.size(); ++ordinal) {
+        const Row& row = rows_[ordinal];
+        if (row.category != kDeleted && (dimension == Dimension::Category ? row.category : row.type) == code) {
+            ids.push_back(rowIds_[ordinal]);
+        }
+    }
+    return ids;
+}
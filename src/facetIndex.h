@@ -0,0 +1,120 @@
+#ifndef FACET_INDEX_H
+#define FACET_INDEX_H
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Dictionary-encoded facet columns (category, type, cook-time bucket) for every recipe.
+// Category and type values are interned case-insensitively into dense codes, so a recipe's facets are a
+// 9-byte row and a histogram over any result set is one array increment per row and dimension.
+// Counter accumulates histograms row by row while a search streams its results.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class FacetIndex {
+public:
+    enum class Dimension { Category, Type };
+
+    struct Document {
+        std::string recipeId;
+        std::string category;
+        std::string type;
+        std::string cookTime;
+    };
+
+    // (display value, count), most frequent first
+    using Histogram = std::vector<std::pair<std::string, uint32_t>>;
+
+    struct Counts {
+        Histogram categories;
+        Histogram types;
+        Histogram cookTimes;
+    };
+
+    static constexpr uint8_t kCookTimeBuckets = 5;
+    static uint8_t cookTimeBucket(std::string_view cookTime);
+    static const char* cookTimeLabel(uint8_t bucket);
+
+    // Histograms over the rows passed to add(); holds a shared lock until destroyed
+    class Counter {
+    public:
+        explicit Counter(const FacetIndex& index);
+        void add(const std::string& recipeId);
+        Counts finish() const;
+
+    private:
+        friend class FacetIndex;
+        const FacetIndex& index_;
+        std::shared_lock<std::shared_mutex> lock_;
+        std::vector<uint32_t> categories_;
+        std::vector<uint32_t> types_;
+        std::vector<uint32_t> cookTimes_;
+    };
+
+    bool isBuilt() const;
+
+    // Build once from loadDocuments() -> vector<Document>; no-op if already built
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadDocuments) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (built_) {
+            return;
+        }
+        for (const auto& document : loadDocuments()) {
+            upsertLocked(document);
+        }
+        built_ = true;
+    }
+
+    // Incremental maintenance; ignored until the index has been built
+    void upsert(const Document& document);
+    void remove(const std::string& recipeId);
+    void invalidate();
+
+    Counter counter() const { return Counter(*this); }
+    Counts countAll() const;
+
+    // Recipes whose category/type equals value, ignoring case and surrounding whitespace
+    std::vector<std::string> recipesWith(Dimension dimension, std::string_view value) const;
+
+private:
+    static constexpr uint32_t kDeleted = UINT32_MAX;
+
+    struct Dictionary {
+        std::unordered_map<std::string, uint32_t> codes;  // Normalized value -> code
+        std::vector<std::string> values;                   // Code -> display value (first spelling seen)
+        uint32_t encode(std::string_view value);
+        uint32_t find(std::string_view value) const;
+        Histogram histogram(const std::vector<uint32_t>& counts) const;
+    };
+
+    struct Row {
+        uint32_t category = kDeleted;  // kDeleted marks a free row
+        uint32_t type = 0;
+        uint8_t cookTime = 0;
+    };
+
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    Dictionary categories_;
+    Dictionary types_;
+    std::vector<Row> rows_;
+    std::vector<std::string> rowIds_;
+    std::unordered_map<std::string, uint32_t> ordinals_;
+    std::vector<uint32_t> freeRows_;
+
+    void upsertLocked(const Document& document);
+};
+
+#endif // FACET_INDEX_H
@@ -0,0 +1,75 @@
+#include "gzipWriter.h"
+#include <zlib.h>
+
+namespace {
+
+constexpr int kGzipWindowBits = 15 + 16;  // Maximum window, gzip header and trailer instead of zlib's
+constexpr int kMemLevel = 8;
+
+} // namespace
+
+GzipWriter::GzipWriter(Sink sink, int level) : stream_(new z_stream()), sink_(std::move(sink)) {
+    auto* stream = static_cast<z_stream*>(stream_);
+    ok_ = deflateInit2(stream, level, Z_DEFLATED, kGzipWindowBits, kMemLevel, Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+GzipWriter::~GzipWriter() {
+    auto* stream = static_cast<z_stream*>(stream_);
+    deflateEnd(stream);
+    delete stream;
+}
+
+bool GzipWriter::write(std::string_view data) {
+    if (!ok_ || finished_) {
+        return false;
+    }
+    auto* stream = static_cast<z_stream*>(stream_);
+    stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream->avail_in = static_cast<uInt>(data.size());
+    return deflateInto(Z_NO_FLUSH);
+}
+
+bool GzipWriter::finish() {
+    if (!ok_ || finished_) {
+        return ok_;
+    }
+    finished_ = true;
+    auto* stream = static_cast<z_stream*>(stream_);
+    stream->next_in = nullptr;
+    stream->avail_in = 0;
+    return deflateInto(Z_FINISH);
+}
+
+bool GzipWriter::deflateInto(int flush) {
+    auto* stream = static_cast<z_stream*>(stream_);
+    char buffer[kChunkBytes];
+    int rc;
+    do {
+        stream->next_out = reinterpret_cast<Bytef*>(buffer);
+        stream->avail_out = sizeof(buffer);
+        rc = deflate(stream, flush);
+        if (rc == Z_STREAM_ERROR) {
+            ok_ = false;
+            return false;
+        }
+        size_t produced = sizeof(buffer) - stream->avail_out;
+        if (produced > 0 && !sink_(std::string_view(buffer, produced))) {
+            ok_ = false;
+            return false;
+        }
+        // Z_FINISH is done at Z_STREAM_END; otherwise deflate is done once it leaves output space unused
+    } while (flush == Z_FINISH ? rc != Z_STREAM_END : stream->avail_out == 0);
+    return true;
+}
+
+std::string GzipWriter::compress(std::string_view data, int level) {
+    std::string out;
+    GzipWriter writer([&out](std::string_view chunk) {
+        out.append(chunk);
+        return true;
+    }, level);
+    if (!writer.write(data) || !writer.finish()) {
+        return {};
+    }
+    return out;
+}
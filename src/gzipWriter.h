@@ -0,0 +1,38 @@
+#ifndef GZIP_WRITER_H
+#define GZIP_WRITER_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Incremental gzip (RFC 1952) compression into a byte sink.
+// Input is deflated as it arrives and handed to the sink in chunks of at most kChunkBytes, so a
+// stream of any length is compressed in constant memory. finish() writes the trailer.
+class GzipWriter {
+public:
+    using Sink = std::function<bool(std::string_view data)>;  // false aborts the stream
+
+    static constexpr size_t kChunkBytes = 64 * 1024;
+
+    explicit GzipWriter(Sink sink, int level = 6);
+    ~GzipWriter();
+
+    GzipWriter(const GzipWriter&) = delete;
+    GzipWriter& operator=(const GzipWriter&) = delete;
+
+    bool write(std::string_view data);
+    bool finish();
+
+    // Whole-buffer convenience for small payloads
+    static std::string compress(std::string_view data, int level = 6);
+
+private:
+    void* stream_;  // z_stream*
+    Sink sink_;
+    bool ok_;
+    bool finished_ = false;
+
+    bool deflateInto(int flush);
+};
+
+#endif // GZIP_WRITER_H
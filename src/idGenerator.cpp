@@ -0,0 +1,96 @@
+#include "idGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace {
+
+constexpr char kAlphabet[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";  // Crockford: no I, L, O, U
+
+// Timestamp in the top 48 bits, sequence in the low 16
+std::atomic<uint64_t> lastTick{0};
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Seeded once per thread rather than once per id
+uint64_t randomBits() {
+    thread_local uint64_t state = [] {
+        std::random_device device;
+        uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+        seed ^= std::hash<std::thread::id>{}(std::this_thread::get_id());
+        seed ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        return seed;
+    }();
+    return splitmix64(state);
+}
+
+uint64_t nextTick() {
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::system_clock::now().time_since_epoch())
+                                             .count());
+    uint64_t candidate = now << 16;
+    uint64_t last = lastTick.load(std::memory_order_relaxed);
+    uint64_t tick;
+    do {
+        tick = std::max(candidate, last + 1);
+    } while (!lastTick.compare_exchange_weak(last, tick, std::memory_order_relaxed));
+    return tick;
+}
+
+int decode(char c) {
+    if (c >= 'a' && c <= 'z') {
+        c = static_cast<char>(c - 'a' + 'A');
+    }
+    for (int i = 0; i < 32; ++i) {
+        if (kAlphabet[i] == c) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+std::string IdGenerator::next() {
+    return next({});
+}
+
+std::string IdGenerator::next(std::string_view prefix) {
+    uint64_t high = nextTick();
+    uint64_t low = randomBits();
+    std::string id(prefix.size() + kLength, '0');
+    std::copy(prefix.begin(), prefix.end(), id.begin());
+    // 128 bits as 26 five-bit digits, least significant last
+    for (size_t i = id.size(); i-- > prefix.size();) {
+        id[i] = kAlphabet[low & 31];
+        low = (low >> 5) | (high << 59);
+        high >>= 5;
+    }
+    return id;
+}
+
+int64_t IdGenerator::timestampMs(std::string_view id) {
+    if (id.size() < kLength) {
+        return -1;
+    }
+    id.remove_prefix(id.size() - kLength);
+    int64_t ms = 0;
+    for (char c : id) {
+        if (decode(c) < 0) {
+            return -1;
+        }
+    }
+    // The first ten digits are the two leading zero bits and the 48-bit timestamp
+    for (size_t i = 0; i < 10; ++i) {
+        ms = (ms << 5) | decode(id[i]);
+    }
+    return ms;
+}
@@ -0,0 +1,28 @@
+#ifndef ID_GENERATOR_H
+#define ID_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Time-ordered unique ids (ULIDs) shared by recipes, reviews, users and collections.
+// An id is 26 Crockford base32 characters: a 48-bit millisecond timestamp, a 16-bit sequence and 64
+// random bits. Ids sort lexicographically in creation order, so new rows land at the right edge of
+// the primary-key B-tree instead of on random pages.
+// Within a process the timestamp and sequence come from one atomic compare-and-swap, so ids are
+// strictly increasing across threads without a lock; a clock that steps back or a burst of more than
+// 65536 ids in a millisecond borrows from the next millisecond rather than repeating. The random bits
+// keep ids from separate processes, or from before a restart, apart.
+class IdGenerator {
+public:
+    static std::string next();
+    // prefix + id, e.g. "recipe_01J9..."; ids with the same prefix still sort by time
+    static std::string next(std::string_view prefix);
+
+    // Milliseconds since the epoch encoded in an id (prefix included or not); -1 if it is not one
+    static int64_t timestampMs(std::string_view id);
+
+    static constexpr size_t kLength = 26;
+};
+
+#endif // ID_GENERATOR_H
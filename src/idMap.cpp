@@ -0,0 +1,122 @@
+#include "idMap.h"
+#include <sqlite3.h>
+#include <iostream>
+#include <mutex>
+
+IdMap::IdMap(std::string table) : table_(std::move(table)) {}
+
+int64_t IdMap::pk(sqlite3* db, const std::string& id) {
+    if (id.empty()) {
+        return 0;
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = pks_.find(id);
+        if (it != pks_.end()) {
+            return it->second;
+        }
+    }
+    int64_t pk = lookupPk(db, id);
+    if (pk > 0 && sqlite3_get_autocommit(db)) {
+        remember(pk, id);
+    }
+    return pk;
+}
+
+int64_t IdMap::refresh(sqlite3* db, const std::string& id) {
+    if (id.empty()) {
+        return 0;
+    }
+    int64_t pk = lookupPk(db, id);
+    if (pk > 0 && sqlite3_get_autocommit(db)) {
+        remember(pk, id);
+    } else {
+        forget(id);  // Inside a transaction pk() then looks the id up until a lookup outside one caches it
+    }
+    return pk;
+}
+
+std::string IdMap::id(sqlite3* db, int64_t pk) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(pk);
+        if (it != ids_.end()) {
+            return *it->second;
+        }
+    }
+    std::string id;
+    const std::string sql = "SELECT id FROM " + table_ + " WHERE pk = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return id;
+    }
+    sqlite3_bind_int64(stmt, 1, pk);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        id = text ? text : "";
+    }
+    sqlite3_finalize(stmt);
+    if (!id.empty() && sqlite3_get_autocommit(db)) {
+        remember(pk, id);
+    }
+    return id;
+}
+
+int64_t IdMap::intern(sqlite3* db, const std::string& id) {
+    int64_t existing = pk(db, id);
+    if (existing > 0 || id.empty()) {
+        return existing;
+    }
+    const std::string sql = "INSERT OR IGNORE INTO " + table_ + " (id) VALUES (?);";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return 0;
+    }
+    sqlite3_bind_text(stmt, 1, id.c_str(), static_cast<int>(id.size()), SQLITE_STATIC);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        return 0;
+    }
+    // Looked up rather than taken from last_insert_rowid, which a concurrent insert of the same id skips
+    return pk(db, id);
+}
+
+void IdMap::remember(int64_t pk, const std::string& id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto [it, inserted] = pks_.try_emplace(id, pk);
+    if (!inserted && it->second != pk) {
+        ids_.erase(it->second);  // The id was deleted and added again under a new pk
+        it->second = pk;
+    }
+    ids_[pk] = &it->first;
+}
+
+void IdMap::forget(const std::string& id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = pks_.find(id);
+    if (it != pks_.end()) {
+        ids_.erase(it->second);
+        pks_.erase(it);
+    }
+}
+
+size_t IdMap::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return pks_.size();
+}
+
+int64_t IdMap::lookupPk(sqlite3* db, const std::string& id) const {
+    const std::string sql = "SELECT pk FROM " + table_ + " WHERE id = ?;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return 0;
+    }
+    sqlite3_bind_text(stmt, 1, id.c_str(), static_cast<int>(id.size()), SQLITE_STATIC);
+    int64_t pk = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int64(stmt, 0) : 0;
+    sqlite3_finalize(stmt);
+    return pk;
+}
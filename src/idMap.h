@@ -0,0 +1,49 @@
+#ifndef ID_MAP_H
+#define ID_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+struct sqlite3;
+
+// Bidirectional cache between the public string ids of a table and its INTEGER PRIMARY KEY.
+// The table needs a "pk INTEGER PRIMARY KEY AUTOINCREMENT" and a "id TEXT NOT NULL UNIQUE" column.
+// AUTOINCREMENT never hands a pk out twice, so pk -> id, once committed, stays true. id -> pk does
+// not: another process (an import with explicit ids, say) can delete a row and add the same id
+// again under a new pk, and this process only hears of deletes it makes itself. pk() trusts the
+// cache, so callers whose lookup by pk found nothing call refresh(), which drops a stale pk and
+// looks the id up again, and retry if the pk changed. A lookup made while the connection is inside
+// a transaction is answered but not cached, since the row it found may still be rolled back.
+class IdMap {
+public:
+    explicit IdMap(std::string table);
+
+    // 0 when id has no row (pks start at 1)
+    int64_t pk(sqlite3* db, const std::string& id);
+    // pk() read from the table rather than the cache, replacing or dropping the cached pk when they differ
+    int64_t refresh(sqlite3* db, const std::string& id);
+    // "" when pk has no row
+    std::string id(sqlite3* db, int64_t pk);
+    // pk of id, inserting a row for it first if there is none (dictionary tables such as user_ids);
+    // 0 if the insert failed
+    int64_t intern(sqlite3* db, const std::string& id);
+
+    // Called once the transaction that inserted or deleted the row has committed
+    void remember(int64_t pk, const std::string& id);
+    void forget(const std::string& id);
+
+    size_t size() const;
+
+private:
+    std::string table_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, int64_t> pks_;
+    std::unordered_map<int64_t, const std::string*> ids_;  // Points at the keys of pks_
+
+    int64_t lookupPk(sqlite3* db, const std::string& id) const;
+};
+
+#endif // ID_MAP_H
@@ -0,0 +1,199 @@
+#include "ingredientIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+namespace {
+
+// Quantities, units and preparation words that say nothing about the ingredient itself
+const std::unordered_set<std::string_view>& ignoredWords() {
+    static const std::unordered_set<std::string_view> words = {
+        "a", "an", "the", "of", "and", "or", "to", "for", "with", "some", "few", "about",
+        "g", "kg", "mg", "ml", "l", "oz", "lb", "lbs", "cup", "cups", "tbsp", "tsp", "tablespoon",
+        "tablespoons", "teaspoon", "teaspoons", "pinch", "dash", "handful", "can", "cans", "piece", "pieces",
+        "large", "small", "medium", "fresh", "chopped", "diced", "minced", "sliced", "grated", "optional", "taste"};
+    return words;
+}
+
+// Conservative English singularization so "eggs" matches "egg" and "tomatoes" matches "tomato"
+std::string singular(std::string word) {
+    size_t n = word.size();
+    if (n > 4 && word.compare(n - 3, 3, "ies") == 0) {
+        word.replace(n - 3, 3, "y");
+    } else if (n > 4 && word.compare(n - 3, 3, "oes") == 0) {
+        word.resize(n - 2);
+    } else if (n > 3 && word[n - 1] == 's' && word[n - 2] != 's' && word[n - 2] != 'u' && word[n - 2] != 'i') {
+        word.resize(n - 1);
+    }
+    return word;
+}
+
+} // namespace
+
+std::vector<std::string> IngredientIndex::tokenize(std::string_view ingredients) {
+    std::vector<std::string> terms;
+    std::string word;
+
+    auto flush = [&terms, &word]() {
+        bool hasDigit = std::any_of(word.begin(), word.end(), [](unsigned char c) { return std::isdigit(c); });
+        if (!word.empty() && !hasDigit && !ignoredWords().count(word)) {
+            terms.push_back(singular(word));
+        }
+        word.clear();
+    };
+
+    for (char ch : ingredients) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        // Bytes >= 0x80 are part of UTF-8 letters ("jalapeño"), keep them inside the word
+        if (std::isalnum(c) || c >= 0x80) {
+            word.push_back(static_cast<char>(std::tolower(c)));
+        } else {
+            flush();
+        }
+    }
+    flush();
+
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+bool IngredientIndex::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+void IngredientIndex::upsert(const std::string& id, std::string_view ingredients) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        upsertLocked(id, ingredients);
+    }
+}
+
+void IngredientIndex::remove(const std::string& id) {
+    std::unique_lock lock(mutex_);
+    auto it = ordinals_.find(id);
+    if (!built_ || it == ordinals_.end()) {
+        return;
+    }
+    uint32_t ordinal = it->second;
+    removeTermsLocked(ordinal);
+    live_.remove(ordinal);
+    ids_[ordinal].clear();
+    freeOrdinals_.push_back(ordinal);
+    ordinals_.erase(it);
+}
+
+void IngredientIndex::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    postings_.clear();
+    ordinals_.clear();
+    ids_.clear();
+    terms_.clear();
+    live_.clear();
+    freeOrdinals_.clear();
+}
+
+void IngredientIndex::upsertLocked(const std::string& id, std::string_view ingredients) {
+    uint32_t ordinal;
+    auto it = ordinals_.find(id);
+    if (it != ordinals_.end()) {
+        ordinal = it->second;
+        removeTermsLocked(ordinal);
+    } else if (!freeOrdinals_.empty()) {
+        // Reuse deleted slots so the bitmaps stay dense
+        ordinal = freeOrdinals_.back();
+        freeOrdinals_.pop_back();
+        ids_[ordinal] = id;
+        ordinals_.emplace(id, ordinal);
+    } else {
+        ordinal = static_cast<uint32_t>(ids_.size());
+        ids_.push_back(id);
+        terms_.emplace_back();
+        ordinals_.emplace(id, ordinal);
+    }
+
+    terms_[ordinal] = tokenize(ingredients);
+    for (const auto& term : terms_[ordinal]) {
+        postings_[term].add(ordinal);
+    }
+    live_.add(ordinal);
+}
+
+void IngredientIndex::removeTermsLocked(uint32_t ordinal) {
+    for (const auto& term : terms_[ordinal]) {
+        auto posting = postings_.find(term);
+        if (posting != postings_.end()) {
+            posting->second.remove(ordinal);
+            if (posting->second.empty()) {
+                postings_.erase(posting);
+            }
+        }
+    }
+    terms_[ordinal].clear();
+}
+
+bool IngredientIndex::termsBitmapLocked(const std::string& entry, RoaringBitmap& out) const {
+    std::vector<std::string> terms = tokenize(entry);
+    if (terms.empty()) {
+        return false;
+    }
+
+    std::vector<const RoaringBitmap*> postings;
+    for (const auto& term : terms) {
+        auto it = postings_.find(term);
+        if (it == postings_.end()) {
+            out.clear();
+            return true;
+        }
+        postings.push_back(&it->second);
+    }
+
+    // Intersect smallest first so the working set only shrinks
+    std::sort(postings.begin(), postings.end(),
+              [](const RoaringBitmap* a, const RoaringBitmap* b) { return a->cardinality() < b->cardinality(); });
+    out = *postings.front();
+    for (size_t i = 1; i < postings.size() && !out.empty(); ++i) {
+        out &= *postings[i];
+    }
+    return true;
+}
+
+std::vector<std::string> IngredientIndex::match(const std::vector<std::string>& required,
+                                                const std::vector<std::string>& excluded) const {
+    std::shared_lock lock(mutex_);
+
+    RoaringBitmap result;
+    bool constrained = false;
+    for (const auto& entry : required) {
+        RoaringBitmap entryBitmap;
+        if (!termsBitmapLocked(entry, entryBitmap)) {
+            continue;
+        }
+        if (constrained) {
+            result &= entryBitmap;
+        } else {
+            result = std::move(entryBitmap);
+            constrained = true;
+        }
+        if (result.empty()) {
+            return {};
+        }
+    }
+    if (!constrained) {
+        result = live_;
+    }
+
+    for (const auto& entry : excluded) {
+        RoaringBitmap entryBitmap;
+        if (termsBitmapLocked(entry, entryBitmap) && !entryBitmap.empty()) {
+            result.andNot(entryBitmap);
+        }
+    }
+
+    std::vector<std::string> ids;
+    ids.reserve(static_cast<size_t>(result.cardinality()));
+    result.forEach([this, &ids](uint32_t ordinal) { ids.push_back(ids_[ordinal]); });
+    return ids;
+}
@@ -0,0 +1,73 @@
+#ifndef INGREDIENT_INDEX_H
+#define INGREDIENT_INDEX_H
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "roaringBitmap.h"
+
+// In-memory inverted index from normalized ingredient terms to recipe ordinals.
+// Ingredients text is tokenized at write time ("2 cups chopped Tomatoes" -> "tomato"); each term maps to a
+// RoaringBitmap of recipe ordinals, so "all of X, Y" / "none of W" queries are bitmap AND / ANDNOT.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class IngredientIndex {
+public:
+    // Normalized, de-duplicated terms for an ingredients string (or a query ingredient)
+    static std::vector<std::string> tokenize(std::string_view ingredients);
+
+    bool isBuilt() const;
+
+    // Build once from loadRows() -> vector<pair<id, ingredients>>; no-op if already built.
+    // The loader runs under the write lock so concurrent upserts cannot be lost.
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadRows) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (built_) {
+            return;
+        }
+        for (const auto& [id, ingredients] : loadRows()) {
+            upsertLocked(id, ingredients);
+        }
+        built_ = true;
+    }
+
+    // Incremental maintenance; ignored until the index has been built
+    void upsert(const std::string& id, std::string_view ingredients);
+    void remove(const std::string& id);
+
+    // Drop everything; the next query rebuilds from the database
+    void invalidate();
+
+    // Ids of recipes whose ingredients contain every entry of required and no entry of excluded.
+    // A multi-word entry ("olive oil") matches when all of its terms are present.
+    std::vector<std::string> match(const std::vector<std::string>& required,
+                                   const std::vector<std::string>& excluded) const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    std::unordered_map<std::string, RoaringBitmap> postings_;
+    std::unordered_map<std::string, uint32_t> ordinals_;
+    std::vector<std::string> ids_;                  // ordinal -> recipe id ("" once deleted)
+    std::vector<std::vector<std::string>> terms_;   // ordinal -> indexed terms, for removal
+    RoaringBitmap live_;
+    std::vector<uint32_t> freeOrdinals_;
+
+    void upsertLocked(const std::string& id, std::string_view ingredients);
+    void removeTermsLocked(uint32_t ordinal);
+    bool termsBitmapLocked(const std::string& entry, RoaringBitmap& out) const;
+};
+
+#endif // INGREDIENT_INDEX_H
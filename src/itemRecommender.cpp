@@ -0,0 +1,512 @@
+#include "itemRecommender.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+constexpr char kMagic[4] = {'R', 'F', 'N', 'B'};
+constexpr uint32_t kFileVersion = 1;
+
+template <typename T>
+void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+void writeString(std::ostream& out, const std::string& text) {
+    writeValue(out, static_cast<uint32_t>(text.size()));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+bool readString(std::istream& in, std::string& text) {
+    uint32_t size = 0;
+    if (!readValue(in, size) || size > (1u << 20)) {
+        return false;
+    }
+    text.resize(size);
+    return static_cast<bool>(in.read(text.data(), size));
+}
+
+} // namespace
+
+bool ItemRecommender::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+size_t ItemRecommender::recipeCount() const {
+    std::shared_lock lock(mutex_);
+    return itemIndex_.size();
+}
+
+bool ItemRecommender::rebuild(const std::vector<Rating>& ratings, const std::string& neighborsPath) {
+    std::unique_lock lock(mutex_);
+    return buildLocked(ratings, neighborsPath, true);
+}
+
+void ItemRecommender::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    itemIndex_.clear();
+    items_.clear();
+    userIndex_.clear();
+    users_.clear();
+    itemRatings_.clear();
+    userRatings_.clear();
+    userMeans_.clear();
+    itemSquares_.clear();
+    neighbors_.clear();
+    dirty_.clear();
+}
+
+bool ItemRecommender::buildLocked(const std::vector<Rating>& ratings, const std::string& neighborsPath, bool forceCompute) {
+    itemIndex_.clear();
+    items_.clear();
+    userIndex_.clear();
+    users_.clear();
+    itemRatings_.clear();
+    userRatings_.clear();
+    userMeans_.clear();
+    itemSquares_.clear();
+    neighbors_.clear();
+    dirty_.clear();
+
+    std::string watermark;
+    for (const auto& rating : ratings) {
+        uint32_t item = itemLocked(rating.recipeId);
+        uint32_t user = userLocked(rating.userId);
+        itemRatings_[item].push_back({user, static_cast<uint8_t>(rating.rating)});
+        userRatings_[user].push_back({item, static_cast<uint8_t>(rating.rating)});
+        watermark = std::max(watermark, rating.updatedAt);
+    }
+    for (uint32_t user = 0; user < users_.size(); ++user) {
+        attachUserLocked(user);  // Means, and the squares accumulated from zero
+    }
+
+    built_ = true;
+    std::string fileWatermark;
+    if (!forceCompute && loadNeighborsLocked(neighborsPath, fileWatermark)) {
+        // Ratings written since the file was produced (same second included) are recomputed lazily
+        for (const auto& rating : ratings) {
+            if (rating.updatedAt >= fileWatermark) {
+                dirty_.insert(itemIndex_[rating.recipeId]);
+            }
+        }
+        return true;
+    }
+
+    computeAllLocked();
+    return saveNeighborsLocked(neighborsPath, watermark);
+}
+
+uint32_t ItemRecommender::itemLocked(const std::string& recipeId) {
+    auto [it, inserted] = itemIndex_.emplace(recipeId, static_cast<uint32_t>(items_.size()));
+    if (inserted) {
+        items_.push_back(recipeId);
+        itemRatings_.emplace_back();
+        itemSquares_.push_back(0.0);
+        neighbors_.emplace_back();
+    }
+    return it->second;
+}
+
+uint32_t ItemRecommender::userLocked(const std::string& userId) {
+    auto [it, inserted] = userIndex_.emplace(userId, static_cast<uint32_t>(users_.size()));
+    if (inserted) {
+        users_.push_back(userId);
+        userRatings_.emplace_back();
+        userMeans_.push_back(0.0);
+    }
+    return it->second;
+}
+
+void ItemRecommender::detachUserLocked(uint32_t user) {
+    double mean = userMeans_[user];
+    for (const Entry& entry : userRatings_[user]) {
+        double centred = entry.rating - mean;
+        itemSquares_[entry.index] = std::max(0.0, itemSquares_[entry.index] - centred * centred);
+    }
+}
+
+void ItemRecommender::attachUserLocked(uint32_t user) {
+    const auto& row = userRatings_[user];
+    double sum = 0.0;
+    for (const Entry& entry : row) {
+        sum += entry.rating;
+    }
+    double mean = row.empty() ? 0.0 : sum / static_cast<double>(row.size());
+    userMeans_[user] = mean;
+    for (const Entry& entry : row) {
+        double centred = entry.rating - mean;
+        itemSquares_[entry.index] += centred * centred;
+    }
+}
+
+void ItemRecommender::refreshSquaresLocked(uint32_t item) {
+    double sum = 0.0;
+    for (const Entry& entry : itemRatings_[item]) {
+        double centred = entry.rating - userMeans_[entry.index];
+        sum += centred * centred;
+    }
+    itemSquares_[item] = sum;
+}
+
+void ItemRecommender::setRatingLocked(uint32_t item, uint32_t user, int rating) {
+    auto upsert = [rating](std::vector<Entry>& row, uint32_t index) {
+        auto it = std::find_if(row.begin(), row.end(), [index](const Entry& e) { return e.index == index; });
+        if (it != row.end()) {
+            it->rating = static_cast<uint8_t>(rating);
+        } else {
+            row.push_back({index, static_cast<uint8_t>(rating)});
+        }
+    };
+    upsert(itemRatings_[item], user);
+    upsert(userRatings_[user], item);
+}
+
+bool ItemRecommender::eraseRatingLocked(uint32_t item, uint32_t user) {
+    auto erase = [](std::vector<Entry>& row, uint32_t index) {
+        auto it = std::find_if(row.begin(), row.end(), [index](const Entry& e) { return e.index == index; });
+        if (it == row.end()) {
+            return false;
+        }
+        *it = row.back();
+        row.pop_back();
+        return true;
+    };
+    bool erased = erase(itemRatings_[item], user);
+    erase(userRatings_[user], item);
+    return erased;
+}
+
+void ItemRecommender::setRating(const std::string& recipeId, const std::string& userId, int rating) {
+    std::unique_lock lock(mutex_);
+    if (!built_) {
+        return;
+    }
+    uint32_t item = itemLocked(recipeId);
+    uint32_t user = userLocked(userId);
+    detachUserLocked(user);
+    setRatingLocked(item, user, rating);
+    attachUserLocked(user);
+    dirty_.insert(item);
+}
+
+void ItemRecommender::removeRating(const std::string& recipeId, const std::string& userId) {
+    std::unique_lock lock(mutex_);
+    auto item = itemIndex_.find(recipeId);
+    auto user = userIndex_.find(userId);
+    if (!built_ || item == itemIndex_.end() || user == userIndex_.end()) {
+        return;
+    }
+    detachUserLocked(user->second);
+    bool erased = eraseRatingLocked(item->second, user->second);
+    attachUserLocked(user->second);
+    if (erased) {
+        dirty_.insert(item->second);
+    }
+}
+
+void ItemRecommender::removeRecipe(const std::string& recipeId) {
+    std::unique_lock lock(mutex_);
+    auto it = itemIndex_.find(recipeId);
+    if (!built_ || it == itemIndex_.end()) {
+        return;
+    }
+    uint32_t item = it->second;
+    for (const Entry& entry : std::vector<Entry>(itemRatings_[item])) {
+        detachUserLocked(entry.index);
+        eraseRatingLocked(item, entry.index);
+        attachUserLocked(entry.index);
+    }
+    for (const Similar& neighbor : neighbors_[item]) {
+        offerLocked(neighbors_[neighbor.item], item, 0.0f);
+    }
+    neighbors_[item].clear();
+    itemSquares_[item] = 0.0;
+    items_[item].clear();  // Lists that still reference it are filtered when read
+    itemIndex_.erase(it);
+    dirty_.erase(item);
+}
+
+std::vector<ItemRecommender::Similar> ItemRecommender::computeRowLocked(uint32_t item, std::vector<double>& dot,
+                                                                         std::vector<uint32_t>& common) const {
+    std::vector<uint32_t> touched;
+    for (const Entry& rater : itemRatings_[item]) {
+        const auto& row = userRatings_[rater.index];
+        if (row.size() > kMaxUserRatings) {
+            continue;
+        }
+        double mean = userMeans_[rater.index];
+        double centred = rater.rating - mean;
+        for (const Entry& other : row) {
+            if (other.index == item) {
+                continue;
+            }
+            if (common[other.index]++ == 0) {
+                touched.push_back(other.index);
+            }
+            dot[other.index] += centred * (other.rating - mean);
+        }
+    }
+
+    std::vector<Similar> row;
+    for (uint32_t other : touched) {
+        double norms = std::sqrt(itemSquares_[item] * itemSquares_[other]);
+        if (norms > 0.0 && dot[other] > 0.0 && !items_[other].empty()) {
+            double shrink = common[other] / (common[other] + kShrinkage);
+            row.push_back({other, static_cast<float>(dot[other] / norms * shrink)});
+        }
+        dot[other] = 0.0;
+        common[other] = 0;
+    }
+
+    auto stronger = [](const Similar& a, const Similar& b) {
+        return a.similarity != b.similarity ? a.similarity > b.similarity : a.item < b.item;
+    };
+    size_t kept = std::min(row.size(), kNeighbors);
+    std::partial_sort(row.begin(), row.begin() + kept, row.end(), stronger);
+    row.resize(kept);
+    return row;
+}
+
+void ItemRecommender::computeAllLocked() {
+    const uint32_t itemCount = static_cast<uint32_t>(items_.size());
+    // Rows are independent: workers claim items from a shared counter and own their scratch buffers
+    std::atomic<uint32_t> next{0};
+    auto worker = [this, itemCount, &next]() {
+        std::vector<double> dot(itemCount, 0.0);
+        std::vector<uint32_t> common(itemCount, 0);
+        for (uint32_t item = next++; item < itemCount; item = next++) {
+            neighbors_[item] = computeRowLocked(item, dot, common);
+        }
+    };
+
+    unsigned workers = std::max(1u, std::min(std::thread::hardware_concurrency(), itemCount / 256));
+    std::vector<std::future<void>> futures;
+    for (unsigned w = 1; w < workers; ++w) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+void ItemRecommender::offerLocked(std::vector<Similar>& list, uint32_t item, float similarity) {
+    list.erase(std::remove_if(list.begin(), list.end(), [item](const Similar& s) { return s.item == item; }), list.end());
+    if (similarity <= 0.0f) {
+        return;
+    }
+    auto position = std::find_if(list.begin(), list.end(), [similarity](const Similar& s) { return s.similarity < similarity; });
+    if (position == list.end() && list.size() >= kNeighbors) {
+        return;
+    }
+    list.insert(position, {item, similarity});
+    if (list.size() > kNeighbors) {
+        list.pop_back();
+    }
+}
+
+void ItemRecommender::refreshDirtyLocked() {
+    std::vector<double> dot(items_.size(), 0.0);
+    std::vector<uint32_t> common(items_.size(), 0);
+    for (uint32_t item : dirty_) {
+        refreshSquaresLocked(item);  // Drops drift from the incremental updates
+    }
+    for (uint32_t item : dirty_) {
+        std::vector<Similar> row = computeRowLocked(item, dot, common);
+        // Pairs that fell out of the row lose their symmetric entry; the rest are re-offered
+        for (const Similar& old : neighbors_[item]) {
+            offerLocked(neighbors_[old.item], item, 0.0f);
+        }
+        for (const Similar& fresh : row) {
+            offerLocked(neighbors_[fresh.item], item, fresh.similarity);
+        }
+        neighbors_[item] = std::move(row);
+    }
+    dirty_.clear();
+}
+
+std::vector<ItemRecommender::Recommendation> ItemRecommender::recommend(const std::string& userId, size_t limit) {
+    {
+        std::unique_lock lock(mutex_);
+        if (!dirty_.empty()) {
+            refreshDirtyLocked();
+        }
+    }
+
+    std::shared_lock lock(mutex_);
+    std::vector<Recommendation> recommendations;
+    auto user = userIndex_.find(userId);
+    if (user == userIndex_.end() || limit == 0) {
+        return recommendations;
+    }
+
+    const auto& rated = userRatings_[user->second];
+    std::unordered_set<uint32_t> seen;
+    for (const Entry& entry : rated) {
+        seen.insert(entry.index);
+    }
+
+    // Liked recipes (above 3 stars) pull their neighbours up, disliked ones push them down
+    std::unordered_map<uint32_t, double> scores;
+    for (const Entry& entry : rated) {
+        double weight = static_cast<double>(entry.rating) - 3.0;
+        if (weight == 0.0) {
+            continue;
+        }
+        for (const Similar& neighbor : neighbors_[entry.index]) {
+            if (!seen.count(neighbor.item) && !items_[neighbor.item].empty()) {
+                scores[neighbor.item] += neighbor.similarity * weight;
+            }
+        }
+    }
+
+    std::vector<std::pair<double, uint32_t>> ranked;
+    for (const auto& [item, score] : scores) {
+        if (score > 0.0) {
+            ranked.emplace_back(score, item);
+        }
+    }
+    auto ahead = [this](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : items_[a.second] < items_[b.second];
+    };
+    size_t kept = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + kept, ranked.end(), ahead);
+    for (size_t i = 0; i < kept; ++i) {
+        recommendations.push_back({items_[ranked[i].second], ranked[i].first});
+    }
+    return recommendations;
+}
+
+std::vector<ItemRecommender::Neighbor> ItemRecommender::neighbors(const std::string& recipeId) {
+    {
+        std::unique_lock lock(mutex_);
+        if (!dirty_.empty()) {
+            refreshDirtyLocked();
+        }
+    }
+
+    std::shared_lock lock(mutex_);
+    std::vector<Neighbor> result;
+    auto it = itemIndex_.find(recipeId);
+    if (it == itemIndex_.end()) {
+        return result;
+    }
+    for (const Similar& neighbor : neighbors_[it->second]) {
+        if (!items_[neighbor.item].empty()) {
+            result.push_back({items_[neighbor.item], neighbor.similarity});
+        }
+    }
+    return result;
+}
+
+// File layout (native endianness): "RFNB", version, watermark, item count, item ids,
+// then per item a neighbour count followed by (item ordinal, similarity) pairs
+bool ItemRecommender::saveNeighborsLocked(const std::string& path, const std::string& watermark) const {
+    if (path.empty()) {
+        return false;
+    }
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Failed to write neighbour file: " << tempPath << std::endl;
+            return false;
+        }
+        out.write(kMagic, sizeof(kMagic));
+        writeValue(out, kFileVersion);
+        writeString(out, watermark);
+        writeValue(out, static_cast<uint32_t>(items_.size()));
+        for (const auto& id : items_) {
+            writeString(out, id);
+        }
+        for (const auto& list : neighbors_) {
+            writeValue(out, static_cast<uint32_t>(list.size()));
+            for (const Similar& neighbor : list) {
+                writeValue(out, neighbor.item);
+                writeValue(out, neighbor.similarity);
+            }
+        }
+        if (!out) {
+            std::cerr << "Failed to write neighbour file: " << tempPath << std::endl;
+            return false;
+        }
+    }
+    // Readers never see a half-written file
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to replace neighbour file: " << path << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ItemRecommender::loadNeighborsLocked(const std::string& path, std::string& watermark) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    uint32_t fileItems = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kMagic) ||
+        !readValue(in, version) || version != kFileVersion || !readString(in, watermark) ||
+        !readValue(in, fileItems)) {
+        return false;
+    }
+
+    // File ordinals -> current item indexes (recipes nobody rates any more map to nothing)
+    constexpr uint32_t kUnknown = UINT32_MAX;
+    std::vector<uint32_t> mapping(fileItems, kUnknown);
+    std::string id;
+    for (uint32_t i = 0; i < fileItems; ++i) {
+        if (!readString(in, id)) {
+            return false;
+        }
+        auto it = itemIndex_.find(id);
+        if (it != itemIndex_.end()) {
+            mapping[i] = it->second;
+        }
+    }
+
+    std::vector<std::vector<Similar>> loaded(items_.size());
+    std::vector<bool> covered(items_.size(), false);
+    for (uint32_t i = 0; i < fileItems; ++i) {
+        uint32_t count = 0;
+        if (!readValue(in, count) || count > kNeighbors) {
+            return false;
+        }
+        for (uint32_t n = 0; n < count; ++n) {
+            Similar neighbor{};
+            if (!readValue(in, neighbor.item) || !readValue(in, neighbor.similarity) || neighbor.item >= fileItems) {
+                return false;
+            }
+            if (mapping[i] != kUnknown && mapping[neighbor.item] != kUnknown) {
+                loaded[mapping[i]].push_back({mapping[neighbor.item], neighbor.similarity});
+            }
+        }
+        if (mapping[i] != kUnknown) {
+            covered[mapping[i]] = true;
+        }
+    }
+
+    neighbors_ = std::move(loaded);
+    for (uint32_t item = 0; item < items_.size(); ++item) {
+        if (!covered[item]) {
+            dirty_.insert(item);
+        }
+    }
+    return true;
+}
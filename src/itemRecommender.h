@@ -0,0 +1,121 @@
+#ifndef ITEM_RECOMMENDER_H
+#define ITEM_RECOMMENDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Item-item collaborative filtering over the ratings table.
+// Ratings are held in memory as sparse user and item rows. Similarity between two recipes is the
+// adjusted cosine of their ratings (each rating minus the user's mean), shrunk toward zero when few
+// users rated both. Only the top kNeighbors per recipe are kept. The batch build splits recipes across
+// cores, and the result is written to a compact binary file so a restart only recomputes recipes
+// whose ratings changed since the file's watermark.
+// New ratings mark their recipe dirty; dirty rows (and the symmetric entries in their neighbours'
+// lists) are recomputed before the next recommendation is served.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class ItemRecommender {
+public:
+    static constexpr size_t kNeighbors = 50;
+    static constexpr size_t kMaxUserRatings = 2000;  // Heavier raters only count toward norms
+    static constexpr double kShrinkage = 5.0;
+
+    struct Rating {
+        std::string recipeId;
+        std::string userId;
+        int rating;
+        std::string updatedAt;  // "YYYY-MM-DD HH:MM:SS", used as the file watermark
+    };
+
+    struct Neighbor {
+        std::string recipeId;
+        double similarity;
+    };
+
+    struct Recommendation {
+        std::string recipeId;
+        double score;  // Similarity-weighted sum of the user's (rating - 3) over recipes they rated
+    };
+
+    bool isBuilt() const;
+
+    // Build once: ratings from loadRatings(), neighbours from neighborsPath when the file is usable,
+    // otherwise computed in full and written back. No-op if already built.
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadRatings, const std::string& neighborsPath) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (!built_) {
+            buildLocked(loadRatings(), neighborsPath, false);
+        }
+    }
+
+    // Batch job: recompute every neighbour list in parallel and write the file
+    bool rebuild(const std::vector<Rating>& ratings, const std::string& neighborsPath);
+
+    // Incremental maintenance; ignored until the recommender has been built
+    void setRating(const std::string& recipeId, const std::string& userId, int rating);
+    void removeRating(const std::string& recipeId, const std::string& userId);
+    void removeRecipe(const std::string& recipeId);
+    void invalidate();
+
+    // Unrated recipes with a positive score for userId, best first
+    std::vector<Recommendation> recommend(const std::string& userId, size_t limit);
+    std::vector<Neighbor> neighbors(const std::string& recipeId);
+
+    size_t recipeCount() const;
+
+private:
+    struct Entry {
+        uint32_t index;  // User index in item rows, item index in user rows
+        uint8_t rating;
+    };
+    struct Similar {
+        uint32_t item;
+        float similarity;
+    };
+
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    std::unordered_map<std::string, uint32_t> itemIndex_;
+    std::vector<std::string> items_;  // "" once removed
+    std::unordered_map<std::string, uint32_t> userIndex_;
+    std::vector<std::string> users_;
+    std::vector<std::vector<Entry>> itemRatings_;  // item -> (user, rating)
+    std::vector<std::vector<Entry>> userRatings_;  // user -> (item, rating)
+    std::vector<double> userMeans_;
+    std::vector<double> itemSquares_;              // Sum of squared centred ratings (squared norm)
+    std::vector<std::vector<Similar>> neighbors_;  // Sorted by similarity, at most kNeighbors
+    std::unordered_set<uint32_t> dirty_;
+
+    bool buildLocked(const std::vector<Rating>& ratings, const std::string& neighborsPath, bool forceCompute);
+    uint32_t itemLocked(const std::string& recipeId);
+    uint32_t userLocked(const std::string& userId);
+    void setRatingLocked(uint32_t item, uint32_t user, int rating);
+    bool eraseRatingLocked(uint32_t item, uint32_t user);
+    // A user's mean feeds the norm of every recipe they rated: detach their contribution before
+    // changing their ratings and attach it again (with the new mean) afterwards
+    void detachUserLocked(uint32_t user);
+    void attachUserLocked(uint32_t user);
+    void refreshSquaresLocked(uint32_t item);
+    std::vector<Similar> computeRowLocked(uint32_t item, std::vector<double>& dot, std::vector<uint32_t>& common) const;
+    void computeAllLocked();
+    void refreshDirtyLocked();
+    static void offerLocked(std::vector<Similar>& list, uint32_t item, float similarity);
+    bool loadNeighborsLocked(const std::string& path, std::string& watermark);
+    bool saveNeighborsLocked(const std::string& path, const std::string& watermark) const;
+};
+
+#endif // ITEM_RECOMMENDER_H
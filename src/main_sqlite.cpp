@@ -1,8 +1,174 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <string>
 #include "recipeManagerSQLite.h"
+#include "recipeImporter.h"
+#include "recipeExporter.h"
+#include "backupScheduler.h"
 #include "recipe.h"
 
-int main() {
+// Batch job: recompute the item-item neighbour lists for every rated recipe and write them
+// next to the database, where the web server picks them up on its next start
+static int buildRecommendations(const std::string& dbPath) {
+    RecipeManagerSQLite manager(dbPath);
+    if (!manager.isConnected()) {
+        std::cerr << "Error: Failed to connect to SQLite database" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!manager.rebuildRecommendations()) {
+        std::cerr << "Error: Failed to build recommendation neighbours" << std::endl;
+        return 1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Recommendation neighbours written to " << dbPath << ".neighbors in " << elapsed.count() << " ms"
+              << std::endl;
+    return 0;
+}
+
+// Batch job: bulk-load recipes from a JSON Lines or CSV file (format chosen by extension)
+static int importRecipes(const std::string& path, const std::string& dbPath) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        std::cerr << "Error: Cannot open " << path << std::endl;
+        return 1;
+    }
+    RecipeManagerSQLite manager(dbPath);
+    if (!manager.isConnected()) {
+        std::cerr << "Error: Failed to connect to SQLite database" << std::endl;
+        return 1;
+    }
+
+    RecipeImporter::Options options;
+    options.format = RecipeImporter::formatForPath(path);
+    RecipeImporter::Result result = RecipeImporter(manager, options).run(input);
+
+    for (const auto& error : result.errors) {
+        std::cerr << "Skipped " << error << std::endl;
+    }
+    std::cout << "Read " << result.rows << " rows: " << result.imported << " imported, " << result.duplicates
+              << " duplicates, " << result.invalid << " invalid in " << std::fixed << std::setprecision(2)
+              << result.seconds << " s (" << std::setprecision(0)
+              << (result.seconds > 0 ? static_cast<double>(result.rows) / result.seconds : 0.0) << " rows/s)"
+              << std::endl;
+    if (!result.ok) {
+        std::cerr << "Error: " << result.failure << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Batch job: stream recipes, ratings and reviews as NDJSON to a file ("-" for stdout), gzipped if the
+// name ends in .gz; since limits the dump to rows changed from that timestamp on
+static int exportRecipes(const std::string& path, const std::string& dbPath, const std::string& since) {
+    RecipeManagerSQLite manager(dbPath);
+    if (!manager.isConnected()) {
+        std::cerr << "Error: Failed to connect to SQLite database" << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (path != "-") {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Error: Cannot write " << path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = path == "-" ? std::cout : file;
+
+    RecipeExporter::Options options;
+    options.since = since;
+    options.gzip = path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+    auto start = std::chrono::steady_clock::now();
+    RecipeExporter::Result result = RecipeExporter::run(manager, options, [&output](std::string_view data) {
+        output.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(output);
+    });
+    output.flush();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!result.ok || !output) {
+        std::cerr << "Error: Export failed" << (since.empty() ? "" : " (check the since timestamp)") << std::endl;
+        return 1;
+    }
+    // stdout may be carrying the export itself
+    std::cerr << "Exported " << result.rows << " rows in " << std::fixed << std::setprecision(2) << seconds << " s"
+              << std::endl;
+    return 0;
+}
+
+// Batch job: consistent snapshot of a database into directory through the online backup API, safe while
+// the web server is writing to it; keeps the newest seven snapshots there
+static int backupDatabase(const std::string& directory, const std::string& dbPath) {
+    BackupScheduler::Options options;
+    options.directory = directory;
+    BackupScheduler scheduler({dbPath}, options);
+    auto start = std::chrono::steady_clock::now();
+    if (!scheduler.runNow()) {
+        std::cerr << "Error: Backup failed: " << scheduler.progress().lastError << std::endl;
+        return 1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Backed up " << dbPath << " to " << scheduler.progress().lastSnapshots.front() << " in "
+              << elapsed.count() << " ms" << std::endl;
+    return 0;
+}
+
+// Batch job: train a compression dictionary on the stored ingredients and instructions and rewrite every
+// recipe with it; running web servers find the new dictionary in the database
+static int compressRecipeText(const std::string& dbPath) {
+    RecipeManagerSQLite manager(dbPath);
+    if (!manager.isConnected()) {
+        std::cerr << "Error: Failed to connect to SQLite database" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto stats = manager.compressRecipeText();
+    if (!stats) {
+        std::cerr << "Error: Compression failed (too few recipes to train a dictionary?)" << std::endl;
+        return 1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Dictionary version " << stats->dictionaryVersion << ": rewrote " << stats->rows << " recipes, text "
+              << stats->textBytes << " -> " << stats->storedBytes << " bytes in " << elapsed.count() << " ms"
+              << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "build-recommendations") {
+        return buildRecommendations(argc > 2 ? argv[2] : "recipes.db");
+    }
+    if (argc > 1 && std::string(argv[1]) == "import") {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0] << " import <recipes.jsonl|recipes.csv> [database]" << std::endl;
+            return 1;
+        }
+        return importRecipes(argv[2], argc > 3 ? argv[3] : "recipes.db");
+    }
+    if (argc > 1 && std::string(argv[1]) == "export") {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0] << " export <out.ndjson|out.ndjson.gz|-> [database] [since]" << std::endl;
+            return 1;
+        }
+        return exportRecipes(argv[2], argc > 3 ? argv[3] : "recipes.db", argc > 4 ? argv[4] : "");
+    }
+    if (argc > 1 && std::string(argv[1]) == "compress") {
+        return compressRecipeText(argc > 2 ? argv[2] : "recipes.db");
+    }
+    if (argc > 1 && std::string(argv[1]) == "backup") {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0] << " backup <directory> [database]" << std::endl;
+            return 1;
+        }
+        return backupDatabase(argv[2], argc > 3 ? argv[3] : "recipes.db");
+    }
+
     try {
         // Use SQLite instead of MongoDB
         RecipeManagerSQLite manager("recipes.db");
@@ -0,0 +1,287 @@
+#include "pantryMatcher.h"
+#include "ingredientIndex.h"
+#include <algorithm>
+#include <bit>
+#include <future>
+#include <queue>
+#include <thread>
+
+namespace {
+
+struct Candidate {
+    uint32_t matched;
+    uint32_t total;
+    uint32_t row;
+};
+
+// True when a ranks ahead of b; coverage compared exactly by cross-multiplying
+bool ranksAhead(const Candidate& a, const Candidate& b) {
+    uint64_t lhs = static_cast<uint64_t>(a.matched) * b.total;
+    uint64_t rhs = static_cast<uint64_t>(b.matched) * a.total;
+    if (lhs != rhs) {
+        return lhs > rhs;
+    }
+    if (a.matched != b.matched) {
+        return a.matched > b.matched;
+    }
+    return a.row < b.row;
+}
+
+} // namespace
+
+bool PantryMatcher::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+size_t PantryMatcher::size() const {
+    std::shared_lock lock(mutex_);
+    return rows_.size();
+}
+
+void PantryMatcher::upsert(const std::string& id, std::string_view ingredients) {
+    std::vector<std::string> terms = IngredientIndex::tokenize(ingredients);
+    std::unique_lock lock(mutex_);
+    if (!built_) {
+        return;
+    }
+    removeRowLocked(id);
+    appendRowLocked(id, terms);
+    if (deadRows_ > 1024 && deadRows_ * 4 > rowTotals_.size()) {
+        compactLocked();
+    }
+}
+
+void PantryMatcher::remove(const std::string& id) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        removeRowLocked(id);
+    }
+}
+
+void PantryMatcher::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    termIds_.clear();
+    terms_.clear();
+    rowHeads_.clear();
+    rowOffsets_.assign(1, 0);
+    tailTerms_.clear();
+    rowTotals_.clear();
+    rowIds_.clear();
+    rows_.clear();
+    deadRows_ = 0;
+}
+
+void PantryMatcher::buildLocked(const std::vector<std::pair<std::string, std::string>>& rows) {
+    std::vector<std::vector<std::string>> rowTerms;
+    rowTerms.reserve(rows.size());
+    std::unordered_map<std::string, uint32_t> frequency;
+    for (const auto& [id, ingredients] : rows) {
+        rowTerms.push_back(IngredientIndex::tokenize(ingredients));
+        for (const auto& term : rowTerms.back()) {
+            ++frequency[term];
+        }
+    }
+
+    // Most frequent terms get the lowest ids, so common ingredients share the first few words
+    std::vector<std::pair<std::string, uint32_t>> byFrequency(frequency.begin(), frequency.end());
+    std::sort(byFrequency.begin(), byFrequency.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    for (const auto& entry : byFrequency) {
+        termIdLocked(entry.first);
+    }
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        removeRowLocked(rows[i].first);
+        appendRowLocked(rows[i].first, rowTerms[i]);
+    }
+    built_ = true;
+}
+
+uint32_t PantryMatcher::termIdLocked(const std::string& term) {
+    auto [it, inserted] = termIds_.emplace(term, static_cast<uint32_t>(terms_.size()));
+    if (inserted) {
+        terms_.push_back(term);
+    }
+    return it->second;
+}
+
+void PantryMatcher::appendRowLocked(const std::string& id, const std::vector<std::string>& terms) {
+    if (terms.empty()) {
+        return; // Nothing a pantry could cover
+    }
+
+    std::vector<uint32_t> termIds;
+    termIds.reserve(terms.size());
+    for (const auto& term : terms) {
+        termIds.push_back(termIdLocked(term));
+    }
+    std::sort(termIds.begin(), termIds.end());
+
+    uint64_t head = 0;
+    for (uint32_t termId : termIds) {
+        if (termId < 64) {
+            head |= uint64_t{1} << termId;
+        } else {
+            tailTerms_.push_back(termId);
+        }
+    }
+
+    rows_[id] = static_cast<uint32_t>(rowTotals_.size());
+    rowHeads_.push_back(head);
+    rowOffsets_.push_back(static_cast<uint32_t>(tailTerms_.size()));
+    rowTotals_.push_back(static_cast<uint16_t>(std::min<size_t>(termIds.size(), UINT16_MAX)));
+    rowIds_.push_back(id);
+}
+
+void PantryMatcher::removeRowLocked(const std::string& id) {
+    auto it = rows_.find(id);
+    if (it == rows_.end()) {
+        return;
+    }
+    rowTotals_[it->second] = 0;
+    rowIds_[it->second].clear();
+    rows_.erase(it);
+    ++deadRows_;
+}
+
+void PantryMatcher::compactLocked() {
+    std::vector<uint64_t> heads;
+    std::vector<uint32_t> offsets{0};
+    std::vector<uint32_t> tail;
+    std::vector<uint16_t> totals;
+    std::vector<std::string> ids;
+    heads.reserve(rows_.size());
+    offsets.reserve(rows_.size() + 1);
+    totals.reserve(rows_.size());
+    ids.reserve(rows_.size());
+
+    for (size_t row = 0; row < rowTotals_.size(); ++row) {
+        if (rowTotals_[row] == 0) {
+            continue;
+        }
+        tail.insert(tail.end(), tailTerms_.begin() + rowOffsets_[row], tailTerms_.begin() + rowOffsets_[row + 1]);
+        rows_[rowIds_[row]] = static_cast<uint32_t>(totals.size());
+        heads.push_back(rowHeads_[row]);
+        offsets.push_back(static_cast<uint32_t>(tail.size()));
+        totals.push_back(rowTotals_[row]);
+        ids.push_back(std::move(rowIds_[row]));
+    }
+
+    rowHeads_ = std::move(heads);
+    rowOffsets_ = std::move(offsets);
+    tailTerms_ = std::move(tail);
+    rowTotals_ = std::move(totals);
+    rowIds_ = std::move(ids);
+    deadRows_ = 0;
+}
+
+std::vector<PantryMatcher::Match> PantryMatcher::topMatches(const std::vector<std::string>& pantry, size_t limit,
+                                                            double minCoverage) const {
+    std::shared_lock lock(mutex_);
+    std::vector<Match> matches;
+    if (limit == 0) {
+        return matches;
+    }
+
+    // Pantry as a bitset over term ids; terms no recipe uses are irrelevant
+    std::vector<uint64_t> pantryBits((terms_.size() + 63) / 64, 0);
+    bool anyKnown = false;
+    for (const auto& entry : pantry) {
+        for (const auto& term : IngredientIndex::tokenize(entry)) {
+            auto it = termIds_.find(term);
+            if (it != termIds_.end()) {
+                pantryBits[it->second >> 6] |= uint64_t{1} << (it->second & 63);
+                anyKnown = true;
+            }
+        }
+    }
+    if (!anyKnown) {
+        return matches;
+    }
+
+    auto inPantry = [&pantryBits](uint32_t termId) { return (pantryBits[termId >> 6] >> (termId & 63)) & 1; };
+    const uint64_t pantryHead = pantryBits.empty() ? 0 : pantryBits[0];
+    const uint64_t* heads = rowHeads_.data();
+    const uint32_t* offsets = rowOffsets_.data();
+    const uint32_t* tail = tailTerms_.data();
+    const uint16_t* totals = rowTotals_.data();
+
+    // Score rows [begin, end) into a bounded heap whose top is the weakest kept candidate
+    auto scanRange = [&](uint32_t begin, uint32_t end) {
+        auto worseOnTop = [](const Candidate& a, const Candidate& b) { return ranksAhead(a, b); };
+        std::priority_queue<Candidate, std::vector<Candidate>, decltype(worseOnTop)> heap(worseOnTop);
+        for (uint32_t row = begin; row < end; ++row) {
+            uint32_t total = totals[row];
+            if (total == 0) {
+                continue;
+            }
+            uint32_t matched = static_cast<uint32_t>(std::popcount(heads[row] & pantryHead));
+            for (uint32_t p = offsets[row]; p < offsets[row + 1]; ++p) {
+                matched += static_cast<uint32_t>(inPantry(tail[p]));
+            }
+            if (matched == 0 || static_cast<double>(matched) < minCoverage * total) {
+                continue;
+            }
+
+            Candidate candidate{matched, total, row};
+            if (heap.size() < limit) {
+                heap.push(candidate);
+            } else if (ranksAhead(candidate, heap.top())) {
+                heap.pop();
+                heap.push(candidate);
+            }
+        }
+        std::vector<Candidate> kept;
+        kept.reserve(heap.size());
+        for (; !heap.empty(); heap.pop()) {
+            kept.push_back(heap.top());
+        }
+        return kept;
+    };
+
+    // Large tables are scanned in parallel partitions, each keeping its own top K
+    const uint32_t rowCount = static_cast<uint32_t>(rowTotals_.size());
+    unsigned partitions = std::max(1u, std::min(std::thread::hardware_concurrency(), rowCount / kRowsPerPartition));
+    std::vector<Candidate> candidates;
+    if (partitions == 1) {
+        candidates = scanRange(0, rowCount);
+    } else {
+        std::vector<std::future<std::vector<Candidate>>> futures;
+        uint32_t chunk = (rowCount + partitions - 1) / partitions;
+        for (uint32_t begin = 0; begin < rowCount; begin += chunk) {
+            futures.push_back(std::async(std::launch::async, scanRange, begin, std::min(rowCount, begin + chunk)));
+        }
+        for (auto& future : futures) {
+            auto kept = future.get();
+            candidates.insert(candidates.end(), kept.begin(), kept.end());
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), ranksAhead);
+    candidates.resize(std::min(candidates.size(), limit));
+
+    matches.resize(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const Candidate& best = candidates[i];
+        Match& match = matches[i];
+        match.recipeId = rowIds_[best.row];
+        match.matched = best.matched;
+        match.total = best.total;
+        match.coverage = static_cast<double>(best.matched) / best.total;
+        uint64_t missingHead = heads[best.row] & ~pantryHead;
+        while (missingHead) {
+            match.missing.push_back(terms_[std::countr_zero(missingHead)]);
+            missingHead &= missingHead - 1;
+        }
+        for (uint32_t p = offsets[best.row]; p < offsets[best.row + 1]; ++p) {
+            if (!inPantry(tail[p])) {
+                match.missing.push_back(terms_[tail[p]]);
+            }
+        }
+        std::sort(match.missing.begin(), match.missing.end());
+    }
+    return matches;
+}
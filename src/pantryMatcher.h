@@ -0,0 +1,82 @@
+#ifndef PANTRY_MATCHER_H
+#define PANTRY_MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Ranks recipes by how much of their ingredient list a pantry covers.
+// Ingredient terms (IngredientIndex::tokenize) get dense ids, most frequent first. Each recipe stores the
+// 64 most frequent terms as one 64-bit head mask and any rarer terms as a short run of ids in a flat
+// tail array, so scoring a pantry is popcount(head & pantryHead) plus a few bit tests per recipe over
+// contiguous memory, and a bounded min-heap keeps the top K.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class PantryMatcher {
+public:
+    struct Match {
+        std::string recipeId;
+        uint32_t matched = 0;  // Recipe ingredient terms present in the pantry
+        uint32_t total = 0;    // Recipe ingredient terms
+        double coverage = 0.0; // matched / total
+        std::vector<std::string> missing;
+    };
+
+    bool isBuilt() const;
+
+    // Build once from loadRows() -> vector<pair<id, ingredients>>; no-op if already built
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadRows) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (!built_) {
+            buildLocked(loadRows());
+        }
+    }
+
+    // Incremental maintenance; ignored until the matcher has been built
+    void upsert(const std::string& id, std::string_view ingredients);
+    void remove(const std::string& id);
+    void invalidate();
+
+    // Best `limit` recipes by coverage (ties: more matched terms first), skipping recipes below minCoverage
+    std::vector<Match> topMatches(const std::vector<std::string>& pantry, size_t limit, double minCoverage = 0.0) const;
+
+    size_t size() const;
+
+private:
+    static constexpr uint32_t kRowsPerPartition = 1 << 16;
+
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    std::unordered_map<std::string, uint32_t> termIds_;
+    std::vector<std::string> terms_;  // term id -> term
+
+    // Row storage: row r has head mask rowHeads_[r] and tail terms [rowOffsets_[r], rowOffsets_[r + 1])
+    std::vector<uint64_t> rowHeads_;
+    std::vector<uint32_t> rowOffsets_{0};
+    std::vector<uint32_t> tailTerms_;
+    std::vector<uint16_t> rowTotals_;  // 0 marks a deleted row
+    std::vector<std::string> rowIds_;
+    std::unordered_map<std::string, uint32_t> rows_;
+    size_t deadRows_ = 0;
+
+    void buildLocked(const std::vector<std::pair<std::string, std::string>>& rows);
+    uint32_t termIdLocked(const std::string& term);
+    void appendRowLocked(const std::string& id, const std::vector<std::string>& terms);
+    void removeRowLocked(const std::string& id);
+    void compactLocked();
+};
+
+#endif // PANTRY_MATCHER_H
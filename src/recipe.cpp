@@ -1,198 +1,118 @@
 #include "recipe.h"
+#include "recipeFields.h"
+#include "recipeJsonParser.h"
 #include <algorithm>
 #include <cctype>
-#include <nlohmann/json.hpp>
-
-recipe::recipe(const std::string& title, const std::string& ingredients, const std::string& instructions,
-               const std::string& servingSize, const std::string& cookTime,
-               const std::string& category, const std::string& type, const std::string& id)
+#include <utility>
+
+recipe::recipe(std::string title, std::string ingredients, std::string instructions,
+               std::string servingSize, std::string cookTime,
+               std::string category, std::string type, std::string id)
+    : id(std::move(id)), title(std::move(title)), ingredients(std::move(ingredients)),
+      instructions(std::move(instructions)), servingSize(std::move(servingSize)),
+      cookTime(std::move(cookTime)), category(std::move(category)), type(std::move(type))
 {
-    // Validate all input parameters
-    validateTitle(title);
-    validateIngredients(ingredients);
-    validateInstructions(instructions);
-    validateServingSize(servingSize);
-    validateCookTime(cookTime);
-    validateCategory(category);
-    validateType(type);
-
-    // Assign validated values
-    this->title = title;
-    this->ingredients = ingredients;
-    this->instructions = instructions;
-    this->servingSize = servingSize;
-    this->cookTime = cookTime;
-    this->category = category;
-    this->type = type;
-    this->id = id;
-}
-
-std::string recipe::getId() const { return id; }
-std::string recipe::getTitle() const { return title; }
-std::string recipe::getIngredients() const { return ingredients; }
-std::string recipe::getInstructions() const { return instructions; }
-std::string recipe::getServingSize() const { return servingSize; }
-std::string recipe::getCookTime() const { return cookTime; }
-std::string recipe::getCategory() const { return category; }
-std::string recipe::getType() const { return type; }
-
-void recipe::setTitle(const std::string& title) {
-    validateTitle(title);
-    this->title = title;
-}
-
-void recipe::setIngredients(const std::string& ingredients) {
-    validateIngredients(ingredients);
-    this->ingredients = ingredients;
-}
-
-void recipe::setInstructions(const std::string& instructions) {
-    validateInstructions(instructions);
-    this->instructions = instructions;
+    // Validate all fields; a throw here means the object is never constructed
+    validate();
 }
 
-void recipe::setServingSize(const std::string& servingSize) {
-    validateServingSize(servingSize);
-    this->servingSize = servingSize;
-}
-
-void recipe::setCookTime(const std::string& cookTime) {
-    validateCookTime(cookTime);
-    this->cookTime = cookTime;
-}
+const std::string& recipe::getId() const { return id; }
+const std::string& recipe::getTitle() const { return title; }
+const std::string& recipe::getIngredients() const { return ingredients; }
+const std::string& recipe::getInstructions() const { return instructions; }
+const std::string& recipe::getServingSize() const { return servingSize; }
+const std::string& recipe::getCookTime() const { return cookTime; }
+const std::string& recipe::getCategory() const { return category; }
+const std::string& recipe::getType() const { return type; }
 
-void recipe::setCategory(const std::string& category) {
-    validateCategory(category);
-    this->category = category;
+void recipe::setTitle(std::string title) {
+    RecipeFields::validate(RecipeFields::title, title);
+    this->title = std::move(title);
 }
 
-void recipe::setType(const std::string& type) {
-    validateType(type);
-    this->type = type;
+void recipe::setIngredients(std::string ingredients) {
+    RecipeFields::validate(RecipeFields::ingredients, ingredients);
+    this->ingredients = std::move(ingredients);
 }
 
-// Validation helper methods implementation
-void recipe::validateTitle(const std::string& title) const {
-    if (title.empty()) {
-        throw ValidationError("Recipe title cannot be empty");
-    }
-    if (title.length() > 100) {
-        throw ValidationError("Recipe title cannot exceed 100 characters");
-    }
-    // Check for only whitespace
-    if (title.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
-        throw ValidationError("Recipe title cannot contain only whitespace");
-    }
-}
-
-void recipe::validateIngredients(const std::string& ingredients) const {
-    if (ingredients.empty()) {
-        throw ValidationError("Recipe ingredients cannot be empty");
-    }
-    if (ingredients.length() > 1000) {
-        throw ValidationError("Recipe ingredients cannot exceed 1000 characters");
-    }
-    // Check for only whitespace
-    if (ingredients.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
-        throw ValidationError("Recipe ingredients cannot contain only whitespace");
-    }
+void recipe::setInstructions(std::string instructions) {
+    RecipeFields::validate(RecipeFields::instructions, instructions);
+    this->instructions = std::move(instructions);
 }
 
-void recipe::validateInstructions(const std::string& instructions) const {
-    if (instructions.empty()) {
-        throw ValidationError("Recipe instructions cannot be empty");
-    }
-    if (instructions.length() > 2000) {
-        throw ValidationError("Recipe instructions cannot exceed 2000 characters");
-    }
-    // Check for only whitespace
-    if (instructions.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
-        throw ValidationError("Recipe instructions cannot contain only whitespace");
-    }
+void recipe::setServingSize(std::string servingSize) {
+    RecipeFields::validate(RecipeFields::servingSize, servingSize);
+    this->servingSize = std::move(servingSize);
 }
 
-void recipe::validateServingSize(const std::string& servingSize) const {
-    if (servingSize.empty()) {
-        throw ValidationError("Recipe serving size cannot be empty");
-    }
-    if (servingSize.length() > 50) {
-        throw ValidationError("Recipe serving size cannot exceed 50 characters");
-    }
+void recipe::setCookTime(std::string cookTime) {
+    RecipeFields::validate(RecipeFields::cookTime, cookTime);
+    this->cookTime = std::move(cookTime);
 }
 
-void recipe::validateCookTime(const std::string& cookTime) const {
-    if (cookTime.empty()) {
-        throw ValidationError("Recipe cook time cannot be empty");
-    }
-    if (cookTime.length() > 50) {
-        throw ValidationError("Recipe cook time cannot exceed 50 characters");
-    }
+void recipe::setCategory(std::string category) {
+    RecipeFields::validate(RecipeFields::category, category);
+    this->category = std::move(category);
 }
 
-void recipe::validateCategory(const std::string& category) const {
-    if (category.empty()) {
-        throw ValidationError("Recipe category cannot be empty");
-    }
-    if (category.length() > 50) {
-        throw ValidationError("Recipe category cannot exceed 50 characters");
-    }
+void recipe::setType(std::string type) {
+    RecipeFields::validate(RecipeFields::type, type);
+    this->type = std::move(type);
 }
 
-void recipe::validateType(const std::string& type) const {
-    if (type.empty()) {
-        throw ValidationError("Recipe type cannot be empty");
-    }
-    if (type.length() > 50) {
-        throw ValidationError("Recipe type cannot exceed 50 characters");
-    }
+void recipe::validate() const {
+    RecipeFields::forEach([this](const auto& field) {
+        RecipeFields::validate(field, field.get(*this));
+    });
 }
 
 // JSON serialization implementation
 std::string recipe::toJson() const {
-    return "{"
-           "\"id\":\"" + escapeJsonString(id) + "\","
-           "\"title\":\"" + escapeJsonString(title) + "\","
-           "\"ingredients\":\"" + escapeJsonString(ingredients) + "\","
-           "\"instructions\":\"" + escapeJsonString(instructions) + "\","
-           "\"servingSize\":\"" + escapeJsonString(servingSize) + "\","
-           "\"cookTime\":\"" + escapeJsonString(cookTime) + "\","
-           "\"category\":\"" + escapeJsonString(category) + "\","
-           "\"type\":\"" + escapeJsonString(type) + "\""
-           "}";
+    return toJsonWithId(id);
+}
+
+std::string recipe::toJsonWithId(const std::string& idOverride) const {
+    std::string json;
+    json.reserve(128 + idOverride.size() + title.size() + ingredients.size() + instructions.size() +
+                 servingSize.size() + cookTime.size() + category.size() + type.size());
+    json += '{';
+    RecipeFields::forEach([this, &json, &idOverride](const auto& field) {
+        if (json.size() > 1) {
+            json += ',';
+        }
+        json += '"';
+        json += field.key;
+        json += "\":\"";
+        if constexpr (std::decay_t<decltype(field)>::member == &recipe::id) {
+            appendJsonEscaped(json, idOverride);
+        } else {
+            appendJsonEscaped(json, field.get(*this));
+        }
+        json += '"';
+    });
+    json += '}';
+    return json;
 }
 
 recipe recipe::fromJson(const std::string& jsonStr) {
     try {
-        nlohmann::json j = nlohmann::json::parse(jsonStr);
-        
-        std::string id = j.value("id", "");
-        std::string title = j.value("title", "");
-        std::string ingredients = j.value("ingredients", "");
-        std::string instructions = j.value("instructions", "");
-        std::string servingSize = j.value("servingSize", "");
-        std::string cookTime = j.value("cookTime", "");
-        std::string category = j.value("category", "");
-        std::string type = j.value("type", "");
-        
-        return recipe(title, ingredients, instructions, servingSize, cookTime, category, type, id);
+        return RecipeJsonParser(jsonStr).parseRecipe();
     } catch (const std::exception& e) {
         throw ValidationError("Invalid JSON format: " + std::string(e.what()));
     }
 }
 
-std::string recipe::escapeJsonString(const std::string& str) const {
-    std::string escaped;
+void recipe::appendJsonEscaped(std::string& out, const std::string& str) {
     for (char c : str) {
         switch (c) {
-            case '"': escaped += "\\\""; break;
-            case '\\': escaped += "\\\\"; break;
-            case '\n': escaped += "\\n"; break;
-            case '\r': escaped += "\\r"; break;
-            case '\t': escaped += "\\t"; break;
-            default: escaped += c; break;
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: out += c; break;
         }
     }
-    return escaped;
 }
 
 std::string recipe::unescapeJsonString(const std::string& str) {
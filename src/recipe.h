@@ -13,32 +13,38 @@ public:
         explicit ValidationError(const std::string& message) : std::runtime_error(message) {}
     };
 
-    recipe(const std::string& title, const std::string& ingredients, const std::string& instructions,
-           const std::string& servingSize, const std::string& cookTime,
-           const std::string& category, const std::string& type, const std::string& id = "");
+    // Arguments are taken by value so callers can move temporaries straight into the members
+    recipe(std::string title, std::string ingredients, std::string instructions,
+           std::string servingSize, std::string cookTime,
+           std::string category, std::string type, std::string id = "");
 
-    std::string getId() const;
-    std::string getTitle() const;
-    std::string getIngredients() const;
-    std::string getInstructions() const;
-    std::string getServingSize() const;
-    std::string getCookTime() const;
-    std::string getCategory() const;
-    std::string getType() const;
+    const std::string& getId() const;
+    const std::string& getTitle() const;
+    const std::string& getIngredients() const;
+    const std::string& getInstructions() const;
+    const std::string& getServingSize() const;
+    const std::string& getCookTime() const;
+    const std::string& getCategory() const;
+    const std::string& getType() const;
 
-    void setTitle(const std::string& title);
-    void setIngredients(const std::string& ingredients);
-    void setInstructions(const std::string& instructions);
-    void setServingSize(const std::string& servingSize);
-    void setCookTime(const std::string& cookTime);
-    void setCategory(const std::string& category);
-    void setType(const std::string& type);
+    void setTitle(std::string title);
+    void setIngredients(std::string ingredients);
+    void setInstructions(std::string instructions);
+    void setServingSize(std::string servingSize);
+    void setCookTime(std::string cookTime);
+    void setCategory(std::string category);
+    void setType(std::string type);
 
     // JSON serialization methods
     std::string toJson() const;
+    std::string toJsonWithId(const std::string& idOverride) const; // Serialize under a different id without copying the recipe
     static recipe fromJson(const std::string& jsonStr);
 
 private:
+    friend struct RecipeFields; // Field table (recipeFields.h) maps these members at compile time
+
+    recipe() = default;
+
     std::string id;
     std::string title;
     std::string ingredients;
@@ -48,17 +54,11 @@ private:
     std::string category;
     std::string type;
 
-    // Validation helper methods
-    void validateTitle(const std::string& title) const;
-    void validateIngredients(const std::string& ingredients) const;
-    void validateInstructions(const std::string& instructions) const;
-    void validateServingSize(const std::string& servingSize) const;
-    void validateCookTime(const std::string& cookTime) const;
-    void validateCategory(const std::string& category) const;
-    void validateType(const std::string& type) const;
+    // Validate every field against its descriptor in RecipeFields
+    void validate() const;
 
     // JSON helper methods
-    std::string escapeJsonString(const std::string& str) const;
+    static void appendJsonEscaped(std::string& out, const std::string& str);
     static std::string unescapeJsonString(const std::string& str);
 };
 
@@ -0,0 +1,51 @@
+#include "recipeExporter.h"
+#include "gzipWriter.h"
+#include <memory>
+
+bool RecipeExporter::parseTable(const std::string& name, RecipeManagerSQLite::ExportTable& table) {
+    if (name == "recipes") {
+        table = RecipeManagerSQLite::ExportTable::Recipes;
+    } else if (name == "ratings") {
+        table = RecipeManagerSQLite::ExportTable::Ratings;
+    } else if (name == "reviews") {
+        table = RecipeManagerSQLite::ExportTable::Reviews;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+RecipeExporter::Result RecipeExporter::run(RecipeManagerSQLite& manager, const Options& options, const Writer& write) {
+    Result result;
+    std::unique_ptr<GzipWriter> gzip;
+    if (options.gzip) {
+        gzip = std::make_unique<GzipWriter>(write);
+    }
+
+    // Lines are gathered into one buffer per page so the writer (or deflate) sees a few large writes
+    std::string buffer;
+    auto flush = [&]() {
+        bool ok = buffer.empty() || (gzip ? gzip->write(buffer) : write(buffer));
+        buffer.clear();
+        return ok;
+    };
+
+    for (auto table : options.tables) {
+        int64_t cursor = 0;
+        do {
+            auto page = manager.exportPage(table, options.since, cursor, options.pageRows, [&buffer](std::string_view line) {
+                buffer.append(line);
+                buffer += '\n';
+                return true;
+            });
+            if (!page || !flush()) {
+                return result;
+            }
+            result.rows += page->rows;
+            cursor = page->nextCursor;
+        } while (cursor != 0);
+    }
+
+    result.ok = !gzip || gzip->finish();
+    return result;
+}
@@ -0,0 +1,38 @@
+#ifndef RECIPE_EXPORTER_H
+#define RECIPE_EXPORTER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "recipeManagerSQLite.h"
+
+// Streaming export of the catalogue as NDJSON (one JSON object per line, tagged with its table).
+// Each table is walked page by page through RecipeManagerSQLite::exportPage and every line is passed
+// straight to the writer, optionally through gzip, so memory use does not grow with the table size.
+class RecipeExporter {
+public:
+    using Writer = std::function<bool(std::string_view data)>;  // Receives the output in order; false aborts
+
+    struct Options {
+        std::vector<RecipeManagerSQLite::ExportTable> tables{RecipeManagerSQLite::ExportTable::Recipes,
+                                                            RecipeManagerSQLite::ExportTable::Ratings,
+                                                            RecipeManagerSQLite::ExportTable::Reviews};
+        std::string since;  // Only rows created or updated at or after this timestamp; "" = everything
+        bool gzip = false;
+        size_t pageRows = 1000;
+    };
+
+    struct Result {
+        bool ok = false;  // False if since is invalid, a query failed or the writer gave up
+        size_t rows = 0;
+    };
+
+    static Result run(RecipeManagerSQLite& manager, const Options& options, const Writer& write);
+
+    // "recipes" / "ratings" / "reviews"; false for anything else
+    static bool parseTable(const std::string& name, RecipeManagerSQLite::ExportTable& table);
+};
+
+#endif // RECIPE_EXPORTER_H
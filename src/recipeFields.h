@@ -0,0 +1,104 @@
+#ifndef RECIPE_FIELDS_H
+#define RECIPE_FIELDS_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "recipe.h"
+#include "recipeView.h"
+
+// Compile-time descriptor for one persisted recipe field.
+// Member/ViewMember are the recipe and RecipeView member pointers, so JSON serialization,
+// SQLite row mapping, validation and HTTP responses are all generated from one table.
+template <auto Member, auto ViewMember>
+struct RecipeField {
+    std::string_view key;    // JSON key (also the '$.key' SQLite JSON path)
+    std::string_view label;  // Prefix for validation messages
+    std::size_t maxLength;   // 0 = not validated (e.g. id)
+    bool rejectBlank;        // Reject whitespace-only values
+
+    static constexpr auto member = Member;
+    static constexpr auto viewMember = ViewMember;
+
+    static const std::string& get(const recipe& r) { return r.*Member; }
+    static std::string_view get(const RecipeView& v) { return v.*ViewMember; }
+    constexpr bool validated() const { return maxLength != 0; }
+};
+
+// The single source of truth for recipe fields, in serialization order
+struct RecipeFields {
+    static constexpr RecipeField<&recipe::id, &RecipeView::id> id{"id", "Recipe id", 0, false};
+    static constexpr RecipeField<&recipe::title, &RecipeView::title> title{"title", "Recipe title", 100, true};
+    static constexpr RecipeField<&recipe::ingredients, &RecipeView::ingredients> ingredients{"ingredients", "Recipe ingredients", 1000, true};
+    static constexpr RecipeField<&recipe::instructions, &RecipeView::instructions> instructions{"instructions", "Recipe instructions", 2000, true};
+    static constexpr RecipeField<&recipe::servingSize, &RecipeView::servingSize> servingSize{"servingSize", "Recipe serving size", 50, false};
+    static constexpr RecipeField<&recipe::cookTime, &RecipeView::cookTime> cookTime{"cookTime", "Recipe cook time", 50, false};
+    static constexpr RecipeField<&recipe::category, &RecipeView::category> category{"category", "Recipe category", 50, false};
+    static constexpr RecipeField<&recipe::type, &RecipeView::type> type{"type", "Recipe type", 50, false};
+
+    static constexpr auto all = std::make_tuple(id, title, ingredients, instructions, servingSize, cookTime, category, type);
+    static constexpr std::size_t count = std::tuple_size_v<decltype(all)>;
+
+    // Invoke fn(field) for every field; fully unrolled at compile time
+    template <typename Fn>
+    static constexpr void forEach(Fn&& fn) {
+        std::apply([&fn](const auto&... field) { (fn(field), ...); }, all);
+    }
+
+    // Invoke fn(field, index) for every field, index being the field's position in the table
+    template <typename Fn>
+    static constexpr void forEachIndexed(Fn&& fn) {
+        forEachIndexedImpl(fn, std::make_index_sequence<count>{});
+    }
+
+    // Throws recipe::ValidationError if value violates the field's constraints
+    template <typename Field>
+    static void validate(const Field& field, const std::string& value) {
+        if (!field.validated()) {
+            return;
+        }
+        if (value.empty()) {
+            throw recipe::ValidationError(std::string(field.label) + " cannot be empty");
+        }
+        if (value.length() > field.maxLength) {
+            throw recipe::ValidationError(std::string(field.label) + " cannot exceed " +
+                                          std::to_string(field.maxLength) + " characters");
+        }
+        if (field.rejectBlank && value.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
+            throw recipe::ValidationError(std::string(field.label) + " cannot contain only whitespace");
+        }
+    }
+
+    // Build a validated recipe, taking each field's value from valueFor(field)
+    template <typename ValueFn>
+    static recipe build(ValueFn&& valueFor) {
+        recipe r;
+        forEach([&r, &valueFor](const auto& field) {
+            r.*std::decay_t<decltype(field)>::member = valueFor(field);
+        });
+        r.validate();
+        return r;
+    }
+
+    // Build a validated recipe by moving in one value per field, in table order
+    static recipe build(std::array<std::string, count>&& values) {
+        recipe r;
+        forEachIndexed([&r, &values](const auto& field, std::size_t index) {
+            r.*std::decay_t<decltype(field)>::member = std::move(values[index]);
+        });
+        r.validate();
+        return r;
+    }
+
+private:
+    template <typename Fn, std::size_t... Index>
+    static constexpr void forEachIndexedImpl(Fn& fn, std::index_sequence<Index...>) {
+        (fn(std::get<Index>(all), Index), ...);
+    }
+};
+
+#endif // RECIPE_FIELDS_H
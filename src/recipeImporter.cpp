@@ -0,0 +1,219 @@
+#include "recipeImporter.h"
+#include "recipeJsonParser.h"
+#include "recipeManagerSQLite.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
+
+RecipeImporter::Format RecipeImporter::formatForPath(const std::string& path) {
+    std::string extension = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".csv" ? Format::Csv : Format::JsonLines;
+}
+
+RecipeImporter::RecipeImporter(RecipeManagerSQLite& manager, Options options)
+    : manager_(manager), options_(options) {}
+
+// Reads the next non-blank record. A CSV record continues onto the next line while a quoted field is open.
+bool RecipeImporter::readRecord(std::istream& input, Format format, size_t& line, Record& record) {
+    std::string text;
+    while (std::getline(input, text)) {
+        ++line;
+        if (!text.empty() && text.back() == '\r') {
+            text.pop_back();
+        }
+        if (text.find_first_not_of(" \t") == std::string::npos) {
+            continue;
+        }
+        record.line = line;
+        record.text = std::move(text);
+        if (format == Format::Csv) {
+            // Every quote toggles the state, "" escapes included
+            bool quoted = std::count(record.text.begin(), record.text.end(), '"') % 2 != 0;
+            while (quoted && std::getline(input, text)) {
+                ++line;
+                if (!text.empty() && text.back() == '\r') {
+                    text.pop_back();
+                }
+                record.text += '\n';
+                record.text += text;
+                quoted = (std::count(text.begin(), text.end(), '"') % 2 != 0) != quoted;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+std::vector<std::string> RecipeImporter::splitCsv(const std::string& text) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (quoted) {
+            if (c != '"') {
+                fields.back() += c;
+            } else if (i + 1 < text.size() && text[i + 1] == '"') {
+                fields.back() += '"';
+                ++i;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+RecipeImporter::Parsed RecipeImporter::parseChunk(const std::vector<Record>& records, Format format,
+                                                  const ColumnMap& columns, size_t maxErrors) {
+    Parsed parsed;
+    parsed.recipes.reserve(records.size());
+    for (const auto& record : records) {
+        try {
+            if (format == Format::JsonLines) {
+                parsed.recipes.push_back(RecipeJsonParser(record.text).parseRecipe());
+            } else {
+                std::vector<std::string> fields = splitCsv(record.text);
+                std::array<std::string, RecipeFields::count> values;
+                for (size_t i = 0; i < values.size(); ++i) {
+                    if (columns[i] >= 0 && static_cast<size_t>(columns[i]) < fields.size()) {
+                        values[i] = std::move(fields[static_cast<size_t>(columns[i])]);
+                    }
+                }
+                parsed.recipes.push_back(RecipeFields::build(std::move(values)));
+            }
+        } catch (const std::exception& e) {
+            ++parsed.invalid;
+            if (parsed.errors.size() < maxErrors) {
+                parsed.errors.push_back("line " + std::to_string(record.line) + ": " + e.what());
+            }
+        }
+    }
+    return parsed;
+}
+
+RecipeImporter::Result RecipeImporter::run(std::istream& input) {
+    Result result;
+    auto start = std::chrono::steady_clock::now();
+    auto finish = [&result, start](const std::string& failure) {
+        result.ok = failure.empty();
+        result.failure = failure;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    };
+
+    size_t line = 0;
+    ColumnMap columns;
+    columns.fill(-1);
+    if (options_.format == Format::Csv) {
+        Record header;
+        if (!readRecord(input, Format::Csv, line, header)) {
+            return finish("CSV input has no header row");
+        }
+        std::vector<std::string> names = splitCsv(header.text);
+        for (size_t column = 0; column < names.size(); ++column) {
+            std::string name = names[column];
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+            RecipeFields::forEachIndexed([&](const auto& field, size_t index) {
+                if (field.key == name) {
+                    columns[index] = static_cast<int>(column);
+                }
+            });
+        }
+        if (std::count(columns.begin(), columns.end(), -1) == static_cast<long>(columns.size())) {
+            return finish("CSV header names no recipe fields");
+        }
+    }
+
+    unsigned threads = options_.threads ? options_.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkRows = std::max<size_t>(options_.chunkRows, 1);
+    std::deque<std::future<Parsed>> inFlight;
+    // Held across chunks so commitRows rows share one commit
+    std::unique_ptr<RecipeManagerSQLite::Transaction> transaction;
+    size_t uncommitted = 0;          // Rows sent since the last commit
+    size_t uncommittedImported = 0;  // Of those, rows inserted
+
+    auto insertNext = [&]() {
+        Parsed parsed = inFlight.front().get();
+        inFlight.pop_front();
+        result.invalid += parsed.invalid;
+        for (auto& error : parsed.errors) {
+            if (result.errors.size() < options_.maxErrors) {
+                result.errors.push_back(std::move(error));
+            }
+        }
+        if (parsed.recipes.empty()) {
+            return true;
+        }
+
+        if (!transaction) {
+            transaction = std::make_unique<RecipeManagerSQLite::Transaction>(manager_);
+        }
+        size_t inserted = 0;
+        if (!*transaction || !manager_.addRecipes(parsed.recipes, &inserted)) {
+            return false;
+        }
+        result.imported += inserted;
+        result.duplicates += parsed.recipes.size() - inserted;
+        uncommitted += parsed.recipes.size();
+        uncommittedImported += inserted;
+        if (uncommitted >= options_.commitRows) {
+            bool committed = transaction->commit();
+            transaction.reset();
+            uncommitted = 0;
+            if (committed) {
+                uncommittedImported = 0;
+            }
+            return committed;
+        }
+        return true;
+    };
+
+    // Keep every parser busy while this thread writes; the window bounds memory
+    const size_t window = static_cast<size_t>(threads) * 2;
+    bool reading = true;
+    while (reading || !inFlight.empty()) {
+        if (reading) {
+            std::vector<Record> records;
+            records.reserve(chunkRows);
+            Record record;
+            while (records.size() < chunkRows && readRecord(input, options_.format, line, record)) {
+                records.push_back(std::move(record));
+            }
+            reading = records.size() == chunkRows;
+            result.rows += records.size();
+            if (!records.empty()) {
+                inFlight.push_back(std::async(std::launch::async, parseChunk, std::move(records), options_.format,
+                                              columns, options_.maxErrors));
+            }
+        }
+        while (!inFlight.empty() && (inFlight.size() >= window || !reading)) {
+            if (!insertNext()) {
+                // Let the parsers finish before the stack unwinds; uncommitted rows are rolled back
+                for (auto& pending : inFlight) {
+                    pending.wait();
+                }
+                result.imported -= uncommittedImported;
+                return finish("Database write failed; rows after the last commit were rolled back");
+            }
+        }
+    }
+
+    if (transaction && !transaction->commit()) {
+        result.imported -= uncommittedImported;
+        return finish("Database commit failed; rows after the last commit were rolled back");
+    }
+    return finish(input.bad() ? "Failed reading input" : "");
+}
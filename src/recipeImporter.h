@@ -0,0 +1,70 @@
+#ifndef RECIPE_IMPORTER_H
+#define RECIPE_IMPORTER_H
+
+#include <array>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include "recipeFields.h"
+
+class RecipeManagerSQLite;
+
+// Bulk import of recipes from JSON Lines (one recipe object per line) or CSV (a header row naming
+// recipe fields, RFC 4180 quoting, quoted fields may span lines).
+// The calling thread cuts the input into chunks of records; worker threads parse and validate chunks
+// in parallel while the calling thread inserts finished chunks, in input order, through
+// RecipeManagerSQLite::addRecipes, committing once every commitRows rows. Invalid records are counted
+// and the first few reported with their line number; they do not stop the import.
+class RecipeImporter {
+public:
+    enum class Format { JsonLines, Csv };
+
+    struct Options {
+        Format format = Format::JsonLines;
+        unsigned threads = 0;       // Parser threads; 0 = one per hardware thread
+        size_t chunkRows = 4096;    // Records per parse task
+        size_t commitRows = 200000; // Rows per transaction
+        size_t maxErrors = 20;      // Invalid records reported in Result::errors
+    };
+
+    struct Result {
+        bool ok = false;            // False if the input or the database failed; rows already committed stay
+        std::string failure;
+        size_t rows = 0;            // Records read (excluding a CSV header)
+        size_t imported = 0;
+        size_t duplicates = 0;      // Skipped: a recipe with the same id already exists
+        size_t invalid = 0;
+        std::vector<std::string> errors;  // "line N: message"
+        double seconds = 0.0;
+    };
+
+    // .csv (any case) is CSV, anything else JSON Lines
+    static Format formatForPath(const std::string& path);
+
+    RecipeImporter(RecipeManagerSQLite& manager, Options options);
+
+    Result run(std::istream& input);
+
+private:
+    struct Record {
+        size_t line;  // 1-based line where the record starts
+        std::string text;
+    };
+    struct Parsed {
+        std::vector<recipe> recipes;
+        std::vector<std::string> errors;
+        size_t invalid = 0;
+    };
+    using ColumnMap = std::array<int, RecipeFields::count>;  // CSV column per field, -1 if absent
+
+    RecipeManagerSQLite& manager_;
+    const Options options_;
+
+    static bool readRecord(std::istream& input, Format format, size_t& line, Record& record);
+    static std::vector<std::string> splitCsv(const std::string& text);
+    static Parsed parseChunk(const std::vector<Record>& records, Format format, const ColumnMap& columns,
+                             size_t maxErrors);
+};
+
+#endif // RECIPE_IMPORTER_H
@@ -0,0 +1,442 @@
+#include "recipeJsonParser.h"
+#include <cmath>
+#include <cstdlib>
+
+recipe RecipeJsonParser::parseRecipe() {
+    skipBom();
+    skipWhitespace();
+    recipe result = parseRecipeObject();
+    expectEnd();
+    return result;
+}
+
+std::vector<recipe> RecipeJsonParser::parseRecipeArray() {
+    std::vector<recipe> recipes;
+    skipBom();
+    skipWhitespace();
+    expect('[');
+    skipWhitespace();
+    if (peek() == ']') {
+        ++pos_;
+        expectEnd();
+        return recipes;
+    }
+
+    while (true) {
+        skipWhitespace();
+        recipes.push_back(parseRecipeObject());
+        skipWhitespace();
+        char c = peek();
+        ++pos_;
+        if (c == ']') {
+            break;
+        }
+        if (c != ',') {
+            --pos_;
+            fail("expected ',' or ']'");
+        }
+    }
+
+    expectEnd();
+    return recipes;
+}
+
+recipe RecipeJsonParser::parseRecipeObject() {
+    FieldValues values;
+    std::array<bool, RecipeFields::count> wrongType{};
+    std::string keyScratch;
+
+    expect('{');
+    skipWhitespace();
+    if (peek() == '}') {
+        ++pos_;
+    } else {
+        while (true) {
+            skipWhitespace();
+            std::string_view key = parseKey(keyScratch);
+            skipWhitespace();
+            expect(':');
+            skipWhitespace();
+
+            // Known-key dispatch against the compile-time field table
+            size_t slot = RecipeFields::count;
+            RecipeFields::forEachIndexed([&slot, key](const auto& field, size_t index) {
+                if (slot == RecipeFields::count && field.key == key) {
+                    slot = index;
+                }
+            });
+
+            if (slot == RecipeFields::count) {
+                skipValue();
+            } else if (peek() == '"') {
+                // Duplicate keys keep the last value, matching the DOM parser
+                values[slot].clear();
+                scanString(&values[slot]);
+                wrongType[slot] = false;
+            } else {
+                skipValue();
+                wrongType[slot] = true;
+            }
+
+            skipWhitespace();
+            char c = peek();
+            ++pos_;
+            if (c == '}') {
+                break;
+            }
+            if (c != ',') {
+                --pos_;
+                fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    RecipeFields::forEachIndexed([this, &wrongType](const auto& field, size_t index) {
+        if (wrongType[index]) {
+            fail("field '" + std::string(field.key) + "' must be a string");
+        }
+    });
+
+    return RecipeFields::build(std::move(values));
+}
+
+std::string_view RecipeJsonParser::parseKey(std::string& scratch) {
+    if (peek() != '"') {
+        fail("expected string key");
+    }
+    // Fast path: keys without escapes are returned as views into the input
+    size_t end = input_.find_first_of("\"\\", pos_ + 1);
+    if (end != std::string_view::npos && input_[end] == '"') {
+        size_t start = pos_ + 1;
+        scanString(nullptr);
+        return input_.substr(start, end - start);
+    }
+    scratch.clear();
+    scanString(&scratch);
+    return scratch;
+}
+
+void RecipeJsonParser::skipMemberKey() {
+    if (peek() != '"') {
+        fail("expected string key");
+    }
+    scanString(nullptr);
+    skipWhitespace();
+    expect(':');
+}
+
+void RecipeJsonParser::scanString(std::string* out) {
+    ++pos_; // opening quote
+    size_t runStart = pos_;
+
+    while (true) {
+        if (pos_ >= input_.size()) {
+            fail("unterminated string");
+        }
+        unsigned char c = static_cast<unsigned char>(input_[pos_]);
+
+        if (c == '"') {
+            if (out) {
+                out->append(input_.data() + runStart, pos_ - runStart);
+            }
+            ++pos_;
+            return;
+        }
+
+        if (c == '\\') {
+            if (out) {
+                out->append(input_.data() + runStart, pos_ - runStart);
+            }
+            ++pos_;
+            if (pos_ >= input_.size()) {
+                fail("unterminated escape sequence");
+            }
+            char escape = input_[pos_++];
+            char decoded = 0;
+            switch (escape) {
+                case '"': decoded = '"'; break;
+                case '\\': decoded = '\\'; break;
+                case '/': decoded = '/'; break;
+                case 'b': decoded = '\b'; break;
+                case 'f': decoded = '\f'; break;
+                case 'n': decoded = '\n'; break;
+                case 'r': decoded = '\r'; break;
+                case 't': decoded = '\t'; break;
+                case 'u': {
+                    unsigned codePoint = parseHex4();
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                        if (input_.substr(pos_, 2) != "\\u") {
+                            fail("surrogate U+D800..U+DBFF must be followed by U+DC00..U+DFFF");
+                        }
+                        pos_ += 2;
+                        unsigned low = parseHex4();
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            fail("surrogate U+D800..U+DBFF must be followed by U+DC00..U+DFFF");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                        fail("surrogate U+DC00..U+DFFF must follow U+D800..U+DBFF");
+                    }
+                    if (out) {
+                        appendCodePoint(*out, codePoint);
+                    }
+                    break;
+                }
+                default:
+                    --pos_;
+                    fail("invalid escape sequence");
+            }
+            if (decoded && out) {
+                out->push_back(decoded);
+            }
+            runStart = pos_;
+            continue;
+        }
+
+        if (c < 0x20) {
+            fail("control character must be escaped");
+        }
+        if (c < 0x80) {
+            ++pos_;
+        } else {
+            consumeUtf8Sequence();
+        }
+    }
+}
+
+void RecipeJsonParser::skipValue() {
+    // Iterative so deeply nested unknown values cannot exhaust the stack
+    std::string closers;
+
+    while (true) {
+        skipWhitespace();
+        bool opened = false;
+        switch (peek()) {
+            case '{':
+                ++pos_;
+                skipWhitespace();
+                if (peek() == '}') {
+                    ++pos_;
+                } else {
+                    closers.push_back('}');
+                    skipMemberKey();
+                    opened = true;
+                }
+                break;
+            case '[':
+                ++pos_;
+                skipWhitespace();
+                if (peek() == ']') {
+                    ++pos_;
+                } else {
+                    closers.push_back(']');
+                    opened = true;
+                }
+                break;
+            case '"': scanString(nullptr); break;
+            case 't': skipLiteral("true"); break;
+            case 'f': skipLiteral("false"); break;
+            case 'n': skipLiteral("null"); break;
+            default: skipNumber(); break;
+        }
+
+        if (opened) {
+            continue;
+        }
+
+        // Close finished containers until one expects another element
+        while (true) {
+            if (closers.empty()) {
+                return;
+            }
+            skipWhitespace();
+            char c = peek();
+            ++pos_;
+            if (c == ',') {
+                if (closers.back() == '}') {
+                    skipWhitespace();
+                    skipMemberKey();
+                }
+                break;
+            }
+            if (c == closers.back()) {
+                closers.pop_back();
+                continue;
+            }
+            --pos_;
+            fail(std::string("expected ',' or '") + closers.back() + "'");
+        }
+    }
+}
+
+void RecipeJsonParser::skipNumber() {
+    auto isDigit = [this]() { return pos_ < input_.size() && input_[pos_] >= '0' && input_[pos_] <= '9'; };
+    size_t start = pos_;
+
+    if (pos_ < input_.size() && input_[pos_] == '-') {
+        ++pos_;
+    }
+    if (pos_ < input_.size() && input_[pos_] == '0') {
+        ++pos_;
+    } else if (isDigit()) {
+        while (isDigit()) ++pos_;
+    } else {
+        fail("invalid literal");
+    }
+
+    bool isFloat = false;
+    if (pos_ < input_.size() && input_[pos_] == '.') {
+        ++pos_;
+        if (!isDigit()) fail("invalid number; expected digit after '.'");
+        while (isDigit()) ++pos_;
+        isFloat = true;
+    }
+    if (pos_ < input_.size() && (input_[pos_] == 'e' || input_[pos_] == 'E')) {
+        ++pos_;
+        if (pos_ < input_.size() && (input_[pos_] == '+' || input_[pos_] == '-')) ++pos_;
+        if (!isDigit()) fail("invalid number; expected digit after exponent");
+        while (isDigit()) ++pos_;
+        isFloat = true;
+    }
+
+    // Floats and integers beyond 64 bits become doubles in the DOM parser, which rejects infinities
+    if (isFloat || pos_ - start > 18) {
+        std::string number(input_.substr(start, pos_ - start));
+        if (!std::isfinite(std::strtod(number.c_str(), nullptr))) {
+            fail("number overflow");
+        }
+    }
+}
+
+void RecipeJsonParser::skipLiteral(std::string_view literal) {
+    if (input_.substr(pos_, literal.size()) != literal) {
+        fail("invalid literal");
+    }
+    pos_ += literal.size();
+}
+
+unsigned RecipeJsonParser::parseHex4() {
+    if (pos_ + 4 > input_.size()) {
+        fail("'\\u' must be followed by 4 hex digits");
+    }
+    unsigned value = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = input_[pos_++];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<unsigned>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<unsigned>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<unsigned>(c - 'A' + 10);
+        else fail("'\\u' must be followed by 4 hex digits");
+    }
+    return value;
+}
+
+void RecipeJsonParser::consumeUtf8Sequence() {
+    auto continuation = [this](size_t offset, unsigned char low, unsigned char high) {
+        if (pos_ + offset >= input_.size()) {
+            fail("invalid UTF-8 byte sequence");
+        }
+        unsigned char c = static_cast<unsigned char>(input_[pos_ + offset]);
+        if (c < low || c > high) {
+            fail("invalid UTF-8 byte sequence");
+        }
+    };
+
+    // Same well-formed ranges as RFC 3629 / the DOM parser's lexer
+    unsigned char lead = static_cast<unsigned char>(input_[pos_]);
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        continuation(1, 0x80, 0xBF);
+        pos_ += 2;
+    } else if (lead == 0xE0) {
+        continuation(1, 0xA0, 0xBF);
+        continuation(2, 0x80, 0xBF);
+        pos_ += 3;
+    } else if ((lead >= 0xE1 && lead <= 0xEC) || lead == 0xEE || lead == 0xEF) {
+        continuation(1, 0x80, 0xBF);
+        continuation(2, 0x80, 0xBF);
+        pos_ += 3;
+    } else if (lead == 0xED) {
+        continuation(1, 0x80, 0x9F);
+        continuation(2, 0x80, 0xBF);
+        pos_ += 3;
+    } else if (lead == 0xF0) {
+        continuation(1, 0x90, 0xBF);
+        continuation(2, 0x80, 0xBF);
+        continuation(3, 0x80, 0xBF);
+        pos_ += 4;
+    } else if (lead >= 0xF1 && lead <= 0xF3) {
+        continuation(1, 0x80, 0xBF);
+        continuation(2, 0x80, 0xBF);
+        continuation(3, 0x80, 0xBF);
+        pos_ += 4;
+    } else if (lead == 0xF4) {
+        continuation(1, 0x80, 0x8F);
+        continuation(2, 0x80, 0xBF);
+        continuation(3, 0x80, 0xBF);
+        pos_ += 4;
+    } else {
+        fail("invalid UTF-8 byte sequence");
+    }
+}
+
+void RecipeJsonParser::appendCodePoint(std::string& out, unsigned codePoint) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+void RecipeJsonParser::skipBom() {
+    if (pos_ == 0 && !input_.empty() && static_cast<unsigned char>(input_[0]) == 0xEF) {
+        if (input_.substr(0, 3) != "\xEF\xBB\xBF") {
+            fail("invalid BOM; must be 0xEF 0xBB 0xBF if given");
+        }
+        pos_ = 3;
+    }
+}
+
+void RecipeJsonParser::skipWhitespace() {
+    while (pos_ < input_.size()) {
+        char c = input_[pos_];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return;
+        }
+        ++pos_;
+    }
+}
+
+char RecipeJsonParser::peek() {
+    if (pos_ >= input_.size()) {
+        fail("unexpected end of input");
+    }
+    return input_[pos_];
+}
+
+void RecipeJsonParser::expect(char c) {
+    if (peek() != c) {
+        fail(std::string("expected '") + c + "'");
+    }
+    ++pos_;
+}
+
+void RecipeJsonParser::expectEnd() {
+    skipWhitespace();
+    if (pos_ != input_.size()) {
+        fail("expected end of input");
+    }
+}
+
+void RecipeJsonParser::fail(const std::string& message) const {
+    throw recipe::ValidationError("syntax error at byte " + std::to_string(pos_) + ": " + message);
+}
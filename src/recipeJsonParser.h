@@ -0,0 +1,53 @@
+#ifndef RECIPE_JSON_PARSER_H
+#define RECIPE_JSON_PARSER_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "recipe.h"
+#include "recipeFields.h"
+
+// Streaming (SAX-style) parser for stored recipe JSON.
+// Walks the input once, dispatches known keys against the RecipeFields table and decodes
+// string values straight into the field slots; unknown keys are skipped without building a DOM.
+// Accepts exactly what nlohmann::json::parse accepts (RFC 8259, UTF-8 validated, leading BOM allowed)
+// and mirrors recipe::fromJson's old semantics: missing fields default to "", duplicate keys keep the
+// last value, and a known field holding a non-string value is an error.
+class RecipeJsonParser {
+public:
+    explicit RecipeJsonParser(std::string_view input) : input_(input), pos_(0) {}
+
+    // Parse a single recipe object. Throws recipe::ValidationError on malformed input or invalid fields.
+    recipe parseRecipe();
+
+    // Parse a JSON array of recipe objects (the advanced-search cache format)
+    std::vector<recipe> parseRecipeArray();
+
+private:
+    using FieldValues = std::array<std::string, RecipeFields::count>;
+
+    std::string_view input_;
+    size_t pos_;
+
+    recipe parseRecipeObject();
+    void scanString(std::string* out);  // Decodes into out, or only validates when out is null
+    std::string_view parseKey(std::string& scratch);
+    void skipMemberKey();
+    void skipValue();
+    void skipNumber();
+    void skipLiteral(std::string_view literal);
+    unsigned parseHex4();
+    void consumeUtf8Sequence();
+    static void appendCodePoint(std::string& out, unsigned codePoint);
+
+    void skipBom();
+    void skipWhitespace();
+    char peek();
+    void expect(char c);
+    void expectEnd();
+    [[noreturn]] void fail(const std::string& message) const;
+};
+
+#endif // RECIPE_JSON_PARSER_H
@@ -1,12 +1,33 @@
 #include <sw/redis++/redis++.h>
 #include <sstream>
 #include "recipeManagerSQLite.h"
+#include "recipeFields.h"
+#include "recipeJsonParser.h"
+#include "ingredientIndex.h"
+#include "pantryMatcher.h"
+#include "titleIndex.h"
+#include "suggestIndex.h"
+#include "facetIndex.h"
+#include "similarityIndex.h"
+#include "itemRecommender.h"
+#include "trendingIndex.h"
+#include "writeQueue.h"
+#include "idGenerator.h"
+#include "entityVersions.h"
+#include "idMap.h"
+#include "schemaMigrator.h"
+#include "textCompressor.h"
 #include <sqlite3.h>
 
-#include <nlohmann/json.hpp>
 #include <iostream>
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 
 // Redis connection (singleton for simplicity)
 static sw::redis::Redis& getRedis() {
@@ -14,12 +35,831 @@ static sw::redis::Redis& getRedis() {
     return redis;
 }
 
+// Long text fields that may be stored as a zstd frame in a "<key>_z" BLOB column (see TextCompressor),
+// in which case data holds them as ""
+static constexpr std::array<std::string_view, 2> kPackedFields{RecipeFields::ingredients.key,
+                                                               RecipeFields::instructions.key};
+
+static int packedSlot(std::string_view key) {
+    auto it = std::find(kPackedFields.begin(), kPackedFields.end(), key);
+    return it == kPackedFields.end() ? -1 : static_cast<int>(it - kPackedFields.begin());
+}
+
+// SQLite expression for a field of the recipe row, whose columns table ("" or "t.") prefixes
+static std::string fieldExpression(std::string_view key, const std::string& table) {
+    std::string extract = "json_extract(" + table + "data, '$." + std::string(key) + "')";
+    if (packedSlot(key) < 0) {
+        return extract;
+    }
+    // Rows without a frame never call unpack_text
+    std::string column = table + std::string(key) + "_z";
+    return "CASE WHEN " + column + " IS NULL THEN " + extract + " ELSE unpack_text(" + column + ") END";
+}
+
+// SQLite expression extracting a recipe field
+template <typename Field>
+static std::string jsonExtract(const Field& field) {
+    return fieldExpression(field.key, "");
+}
+
+// SQLite expression for the whole recipe JSON, packed fields filled back in
+static std::string recipeDataExpression(const std::string& table = "") {
+    std::string anyPacked;
+    std::string unpacked = "json_set(" + table + "data";
+    for (std::string_view key : kPackedFields) {
+        anyPacked += (anyPacked.empty() ? "" : " OR ") + table + std::string(key) + "_z IS NOT NULL";
+        unpacked += ", '$." + std::string(key) + "', " + fieldExpression(key, table);
+    }
+    return "CASE WHEN " + anyPacked + " THEN " + unpacked + ") ELSE " + table + "data END";
+}
+
+static const std::string& recipeData() {
+    static const std::string expression = recipeDataExpression();
+    return expression;
+}
+
+// SELECT list covering every recipe field, in RecipeFields order (built once)
+static const std::string& recipeFieldColumns() {
+    static const std::string columns = [] {
+        std::string list;
+        RecipeFields::forEach([&list](const auto& field) {
+            if (!list.empty()) {
+                list += ", ";
+            }
+            list += jsonExtract(field);
+        });
+        return list;
+    }();
+    return columns;
+}
+
+static void appendJsonString(std::string& json, std::string_view value) {
+    json += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            json += '\\';
+            json += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            static const char* hex = "0123456789abcdef";
+            json += "\\u00";
+            json += hex[(c >> 4) & 0xF];
+            json += hex[c & 0xF];
+        } else {
+            json += c;
+        }
+    }
+    json += '"';
+}
+
+// JSON array of strings, bound as a parameter and expanded with json_each() for IN filters
+static std::string jsonStringArray(const std::vector<std::string>& values) {
+    std::string json = "[";
+    for (const auto& value : values) {
+        if (json.size() > 1) {
+            json += ',';
+        }
+        appendJsonString(json, value);
+    }
+    json += ']';
+    return json;
+}
+
+// A recipe as written to its row: the data JSON plus, for each packed field that compression shrank,
+// its frame (the field is then "" in data)
+struct StoredRecipe {
+    std::string data;
+    std::array<std::optional<std::string>, kPackedFields.size()> packed;
+};
+
+static StoredRecipe storeRecipe(const recipe& r, const std::string& id, const TextCompressor& compressor) {
+    StoredRecipe stored;
+    bool anyPacked = false;
+    RecipeFields::forEach([&](const auto& field) {
+        int slot = packedSlot(field.key);
+        if (slot >= 0 && (stored.packed[slot] = compressor.compress(field.get(r)))) {
+            anyPacked = true;
+        }
+    });
+    if (!anyPacked) {
+        stored.data = r.toJsonWithId(id);
+        return stored;
+    }
+    stored.data = "{";
+    RecipeFields::forEach([&](const auto& field) {
+        if (stored.data.size() > 1) {
+            stored.data += ',';
+        }
+        appendJsonString(stored.data, field.key);
+        stored.data += ':';
+        int slot = packedSlot(field.key);
+        if constexpr (std::decay_t<decltype(field)>::member == RecipeFields::id.member) {
+            appendJsonString(stored.data, id);
+        } else if (slot >= 0 && stored.packed[slot]) {
+            stored.data += "\"\"";
+        } else {
+            appendJsonString(stored.data, field.get(r));
+        }
+    });
+    stored.data += '}';
+    return stored;
+}
+
+// Binds the packed columns, in kPackedFields order, from index on
+static void bindPacked(sqlite3_stmt* stmt, int index, const StoredRecipe& stored) {
+    for (const auto& frame : stored.packed) {
+        if (frame) {
+            sqlite3_bind_blob(stmt, index++, frame->data(), static_cast<int>(frame->size()), SQLITE_STATIC);
+        } else {
+            sqlite3_bind_null(stmt, index++);
+        }
+    }
+}
+
+static RecipeManagerSQLite::SearchFacets toSearchFacets(const FacetIndex::Counts& counts) {
+    auto convert = [](const FacetIndex::Histogram& histogram) {
+        std::vector<RecipeManagerSQLite::FacetValue> values;
+        values.reserve(histogram.size());
+        for (const auto& [value, count] : histogram) {
+            values.push_back({value, static_cast<int>(count)});
+        }
+        return values;
+    };
+    return {convert(counts.categories), convert(counts.types), convert(counts.cookTimes)};
+}
+
+static bool execStatement(sqlite3* db, const char* sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Failed to execute \"" << sql << "\": " << (errMsg ? errMsg : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+// BEGIN IMMEDIATE and COMMIT return SQLITE_BUSY once the busy timeout runs out while another connection
+// (the write queue, a CLI run) holds the write lock; back off and try a few more times before giving up
+static bool execRetryingBusy(sqlite3* db, const char* sql) {
+    constexpr int kBusyRetries = 4;
+    for (int attempt = 0;; ++attempt) {
+        int rc = sqlite3_exec(db, sql, nullptr, nullptr, nullptr);
+        if (rc == SQLITE_OK) {
+            return true;
+        }
+        if (rc != SQLITE_BUSY || attempt == kBusyRetries) {
+            std::cerr << "Failed to execute \"" << sql << "\": " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 << attempt));
+    }
+}
+
+// Schema history of the recipes database; append new versions, never edit applied ones.
+// Version 1 is the schema from before versioning, so it must stay IF NOT EXISTS for databases created then.
+static const std::vector<SchemaMigrator::Migration>& recipeMigrations() {
+    static const std::vector<SchemaMigrator::Migration> migrations{
+        {1, "recipes, ratings, reviews and review_votes tables",
+         "CREATE TABLE IF NOT EXISTS recipes ("
+         "id TEXT PRIMARY KEY,"
+         "data TEXT NOT NULL,"
+         "user_id TEXT,"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP"
+         ");"
+         "CREATE TABLE IF NOT EXISTS ratings ("
+         "id TEXT PRIMARY KEY,"
+         "recipe_id TEXT NOT NULL,"
+         "user_id TEXT NOT NULL,"
+         "rating INTEGER NOT NULL CHECK(rating >= 1 AND rating <= 5),"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "FOREIGN KEY(recipe_id) REFERENCES recipes(id),"
+         "UNIQUE(recipe_id, user_id)"
+         ");"
+         "CREATE TABLE IF NOT EXISTS reviews ("
+         "id TEXT PRIMARY KEY,"
+         "recipe_id TEXT NOT NULL,"
+         "user_id TEXT NOT NULL,"
+         "rating INTEGER NOT NULL CHECK(rating >= 1 AND rating <= 5),"
+         "review_text TEXT NOT NULL,"
+         "status TEXT DEFAULT 'pending',"
+         "moderation_reason TEXT,"
+         "helpful_votes INTEGER DEFAULT 0,"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "FOREIGN KEY(recipe_id) REFERENCES recipes(id),"
+         "UNIQUE(recipe_id, user_id)"
+         ");"
+         "CREATE TABLE IF NOT EXISTS review_votes ("
+         "review_id TEXT NOT NULL,"
+         "user_id TEXT NOT NULL,"
+         "vote_type TEXT NOT NULL,"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "PRIMARY KEY(review_id, user_id),"
+         "FOREIGN KEY(review_id) REFERENCES reviews(id)"
+         ");"},
+        // Review listings filter on (recipe_id, status) and page in one of these orders; each index holds the
+        // sort key, created_at and id, so SQLite walks it in order and seeks straight to a keyset cursor
+        {2, "review listing indexes",
+         "CREATE INDEX IF NOT EXISTS idx_reviews_recipe_created ON reviews(recipe_id, status, created_at, id);"
+         "CREATE INDEX IF NOT EXISTS idx_reviews_recipe_rating ON reviews(recipe_id, status, rating, created_at, id);"
+         "CREATE INDEX IF NOT EXISTS idx_reviews_recipe_helpful ON reviews(recipe_id, status, helpful_votes, created_at, id);"},
+        // getRatingsByUser, getReviewsByUser and getRecipesByUser scanned whole tables; the moderation queue
+        // only ever reads pending reviews, oldest first
+        {3, "per-user and moderation queue indexes",
+         "CREATE INDEX IF NOT EXISTS idx_ratings_user ON ratings(user_id, created_at);"
+         "CREATE INDEX IF NOT EXISTS idx_reviews_user ON reviews(user_id, created_at);"
+         "CREATE INDEX IF NOT EXISTS idx_recipes_user ON recipes(user_id, created_at);"
+         "CREATE INDEX IF NOT EXISTS idx_reviews_pending ON reviews(created_at) WHERE status = 'pending';"},
+        // Integer surrogate keys: every table keys on "pk INTEGER PRIMARY KEY" (the rowid itself, so the row
+        // B-tree is the primary index) and references other rows by pk; the public ids stay in a UNIQUE id
+        // column. User ids, which live in the users database, are interned into user_ids. AUTOINCREMENT keeps
+        // a pk from ever being reused, so IdMap can cache pairs. SQLite cannot change a primary key in place,
+        // so each table is rebuilt and renamed; pks take the old rowids so export cursors stay valid. Ratings,
+        // reviews and votes whose recipe or review no longer exists are not carried over.
+        {4, "integer surrogate keys",
+         "CREATE TABLE user_ids ("
+         "pk INTEGER PRIMARY KEY AUTOINCREMENT,"
+         "id TEXT NOT NULL UNIQUE"
+         ");"
+         "INSERT INTO user_ids (id) SELECT user_id FROM recipes WHERE user_id IS NOT NULL AND user_id != ''"
+         " UNION SELECT user_id FROM ratings UNION SELECT user_id FROM reviews UNION SELECT user_id FROM review_votes;"
+         "CREATE TABLE recipes_v4 ("
+         "pk INTEGER PRIMARY KEY AUTOINCREMENT,"
+         "id TEXT NOT NULL UNIQUE,"
+         "data TEXT NOT NULL,"
+         "user_pk INTEGER REFERENCES user_ids(pk),"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP"
+         ");"
+         "INSERT INTO recipes_v4 (pk, id, data, user_pk, created_at, updated_at)"
+         " SELECT t.rowid, t.id, t.data, u.pk, t.created_at, t.updated_at"
+         " FROM recipes t LEFT JOIN user_ids u ON u.id = t.user_id;"
+         "CREATE TABLE ratings_v4 ("
+         "pk INTEGER PRIMARY KEY AUTOINCREMENT,"
+         "recipe_pk INTEGER NOT NULL REFERENCES recipes(pk),"
+         "user_pk INTEGER NOT NULL REFERENCES user_ids(pk),"
+         "rating INTEGER NOT NULL CHECK(rating >= 1 AND rating <= 5),"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "UNIQUE(recipe_pk, user_pk)"
+         ");"
+         "INSERT INTO ratings_v4 (pk, recipe_pk, user_pk, rating, created_at, updated_at)"
+         " SELECT t.rowid, c.pk, u.pk, t.rating, t.created_at, t.updated_at"
+         " FROM ratings t JOIN recipes_v4 c ON c.id = t.recipe_id JOIN user_ids u ON u.id = t.user_id;"
+         "CREATE TABLE reviews_v4 ("
+         "pk INTEGER PRIMARY KEY AUTOINCREMENT,"
+         "id TEXT NOT NULL UNIQUE,"
+         "recipe_pk INTEGER NOT NULL REFERENCES recipes(pk),"
+         "user_pk INTEGER NOT NULL REFERENCES user_ids(pk),"
+         "rating INTEGER NOT NULL CHECK(rating >= 1 AND rating <= 5),"
+         "review_text TEXT NOT NULL,"
+         "status TEXT DEFAULT 'pending',"
+         "moderation_reason TEXT,"
+         "helpful_votes INTEGER DEFAULT 0,"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "UNIQUE(recipe_pk, user_pk)"
+         ");"
+         "INSERT INTO reviews_v4 (pk, id, recipe_pk, user_pk, rating, review_text, status, moderation_reason,"
+         " helpful_votes, created_at, updated_at)"
+         " SELECT t.rowid, t.id, c.pk, u.pk, t.rating, t.review_text, t.status, t.moderation_reason,"
+         " t.helpful_votes, t.created_at, t.updated_at"
+         " FROM reviews t JOIN recipes_v4 c ON c.id = t.recipe_id JOIN user_ids u ON u.id = t.user_id;"
+         // Looked up by its whole primary key only, so the table is the index
+         "CREATE TABLE review_votes_v4 ("
+         "review_pk INTEGER NOT NULL REFERENCES reviews(pk),"
+         "user_pk INTEGER NOT NULL REFERENCES user_ids(pk),"
+         "vote_type TEXT NOT NULL,"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+         "PRIMARY KEY(review_pk, user_pk)"
+         ") WITHOUT ROWID;"
+         "INSERT INTO review_votes_v4 (review_pk, user_pk, vote_type, created_at)"
+         " SELECT r.pk, u.pk, t.vote_type, t.created_at"
+         " FROM review_votes t JOIN reviews_v4 r ON r.id = t.review_id JOIN user_ids u ON u.id = t.user_id;"
+         "DROP TABLE review_votes;"
+         "DROP TABLE reviews;"
+         "DROP TABLE ratings;"
+         "DROP TABLE recipes;"
+         "ALTER TABLE recipes_v4 RENAME TO recipes;"
+         "ALTER TABLE ratings_v4 RENAME TO ratings;"
+         "ALTER TABLE reviews_v4 RENAME TO reviews;"
+         "ALTER TABLE review_votes_v4 RENAME TO review_votes;"
+         // The version 2 and 3 indexes went with the old tables
+         "CREATE INDEX idx_recipes_user ON recipes(user_pk, created_at);"
+         "CREATE INDEX idx_ratings_user ON ratings(user_pk, created_at);"
+         "CREATE INDEX idx_reviews_recipe_created ON reviews(recipe_pk, status, created_at, pk);"
+         "CREATE INDEX idx_reviews_recipe_rating ON reviews(recipe_pk, status, rating, created_at, pk);"
+         "CREATE INDEX idx_reviews_recipe_helpful ON reviews(recipe_pk, status, helpful_votes, created_at, pk);"
+         "CREATE INDEX idx_reviews_user ON reviews(user_pk, created_at);"
+         "CREATE INDEX idx_reviews_pending ON reviews(created_at) WHERE status = 'pending';"},
+        // Ingredients and instructions compressed against a trained dictionary (see TextCompressor); every
+        // dictionary version stays, since rows keep the frames they were written with
+        {5, "compressed recipe text",
+         "ALTER TABLE recipes ADD COLUMN ingredients_z BLOB;"
+         "ALTER TABLE recipes ADD COLUMN instructions_z BLOB;"
+         "CREATE TABLE compression_dicts ("
+         "version INTEGER PRIMARY KEY AUTOINCREMENT,"
+         "dict_id INTEGER NOT NULL UNIQUE,"
+         "dictionary BLOB NOT NULL,"
+         "samples INTEGER NOT NULL,"
+         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
+         ");"},
+    };
+    return migrations;
+}
+
+static int64_t unixNow() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Rows from loadAllRatings(): recipe id, user id, rating, updated_at
+static std::vector<ItemRecommender::Rating> toRecommenderRatings(std::vector<std::vector<std::string>> rows) {
+    std::vector<ItemRecommender::Rating> ratings;
+    ratings.reserve(rows.size());
+    for (auto& row : rows) {
+        ratings.push_back({std::move(row[0]), std::move(row[1]), std::atoi(row[2].c_str()), std::move(row[3])});
+    }
+    return ratings;
+}
+
+// Sort modes for review listings: an optional leading key, then created_at and id as tie-breakers
+struct ReviewOrder {
+    const char* key;  // nullptr when ordering by time alone
+    bool descending;
+};
+
+static ReviewOrder reviewOrder(RecipeManagerSQLite::ReviewSortBy sortBy) {
+    switch (sortBy) {
+        case RecipeManagerSQLite::OLDEST: return {nullptr, false};
+        case RecipeManagerSQLite::HIGHEST_RATED: return {"rating", true};
+        case RecipeManagerSQLite::MOST_HELPFUL: return {"helpful_votes", true};
+        case RecipeManagerSQLite::NEWEST:
+        default: return {nullptr, true};
+    }
+}
+
+// Position after which a page starts: the last row's sort key, created_at and pk
+struct ReviewCursor {
+    int key = 0;
+    std::string createdAt;
+    int64_t pk = 0;
+};
+
+// Cursors are the hex of "<sort>\n<key>\n<created_at>\n<pk>", opaque and URL-safe
+static std::string encodeReviewCursor(RecipeManagerSQLite::ReviewSortBy sortBy, const RecipeManagerSQLite::Review& last,
+                                      int64_t lastPk) {
+    ReviewOrder order = reviewOrder(sortBy);
+    int key = order.key == nullptr ? 0 : (sortBy == RecipeManagerSQLite::HIGHEST_RATED ? last.rating : last.helpfulVotes);
+    std::string raw = std::to_string(static_cast<int>(sortBy)) + "\n" + std::to_string(key) + "\n" + last.createdAt + "\n" +
+                      std::to_string(lastPk);
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(raw.size() * 2);
+    for (unsigned char c : raw) {
+        hex += digits[c >> 4];
+        hex += digits[c & 0x0f];
+    }
+    return hex;
+}
+
+static bool decodeReviewCursor(const std::string& hex, RecipeManagerSQLite::ReviewSortBy sortBy, ReviewCursor& cursor) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    auto nibble = [](char c) {
+        return c >= '0' && c <= '9' ? c - '0' : (c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1);
+    };
+    std::string raw;
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int high = nibble(hex[i]), low = nibble(hex[i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        raw += static_cast<char>(high << 4 | low);
+    }
+
+    std::vector<std::string> parts;
+    std::istringstream stream(raw);
+    for (std::string part; std::getline(stream, part, '\n');) {
+        parts.push_back(part);
+    }
+    // A cursor only continues the listing it came from
+    if (parts.size() != 4 || parts[0] != std::to_string(static_cast<int>(sortBy))) {
+        return false;
+    }
+    char* end = nullptr;
+    long key = std::strtol(parts[1].c_str(), &end, 10);
+    if (parts[1].empty() || *end != '\0') {
+        return false;
+    }
+    long long pk = std::strtoll(parts[3].c_str(), &end, 10);
+    if (parts[3].empty() || *end != '\0' || pk <= 0) {
+        return false;
+    }
+    cursor.key = static_cast<int>(key);
+    cursor.createdAt = parts[2];
+    cursor.pk = pk;
+    return true;
+}
+
+// Review columns in the order readReviews() expects
+static const char* const kReviewColumns =
+    "pk, id, recipe_pk, user_pk, rating, review_text, status, moderation_reason, helpful_votes, created_at, updated_at";
+
+// Steps a prepared review query to the end and finalizes it; recipe and user pks are translated back to
+// their public ids. pks, if given, receives each row's pk.
+static std::vector<RecipeManagerSQLite::Review> readReviews(sqlite3* db, sqlite3_stmt* stmt, IdMap& recipeIds,
+                                                            IdMap& userIds, std::vector<int64_t>* pks = nullptr) {
+    std::vector<RecipeManagerSQLite::Review> reviews;
+    auto text = [stmt](int column) {
+        const char* value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+        return std::string(value ? value : "");
+    };
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        RecipeManagerSQLite::Review& review = reviews.emplace_back();
+        review.id = text(1);
+        review.recipeId = recipeIds.id(db, sqlite3_column_int64(stmt, 2));
+        review.userId = userIds.id(db, sqlite3_column_int64(stmt, 3));
+        review.rating = sqlite3_column_int(stmt, 4);
+        review.reviewText = text(5);
+        review.status = text(6);
+        review.moderationReason = text(7);
+        review.helpfulVotes = sqlite3_column_int(stmt, 8);
+        review.createdAt = text(9);
+        review.updatedAt = text(10);
+        if (pks) {
+            pks->push_back(sqlite3_column_int64(stmt, 0));
+        }
+    }
+    sqlite3_finalize(stmt);
+    return reviews;
+}
+
+// Rating columns in the order readRatings() expects
+static const char* const kRatingColumns = "recipe_pk, user_pk, rating, created_at, updated_at";
+
+static std::vector<RecipeManagerSQLite::Rating> readRatings(sqlite3* db, sqlite3_stmt* stmt, IdMap& recipeIds,
+                                                            IdMap& userIds) {
+    std::vector<RecipeManagerSQLite::Rating> ratings;
+    auto text = [stmt](int column) {
+        const char* value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+        return std::string(value ? value : "");
+    };
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        RecipeManagerSQLite::Rating& rating = ratings.emplace_back();
+        rating.recipeId = recipeIds.id(db, sqlite3_column_int64(stmt, 0));
+        rating.userId = userIds.id(db, sqlite3_column_int64(stmt, 1));
+        rating.id = "rating_" + rating.recipeId + "_" + rating.userId;  // The public id before surrogate keys
+        rating.rating = sqlite3_column_int(stmt, 2);
+        rating.createdAt = text(3);
+        rating.updatedAt = text(4);
+    }
+    sqlite3_finalize(stmt);
+    return ratings;
+}
+
+// Reviews of a recipe in sortBy order, ordered and paged by SQLite. An empty status lists every status.
+// after continues a listing from a cursor; limit < 0 returns everything.
+static std::vector<RecipeManagerSQLite::Review> selectReviews(sqlite3* db, int64_t recipePk,
+                                                              RecipeManagerSQLite::ReviewSortBy sortBy,
+                                                              const std::string& status, const ReviewCursor* after, int limit,
+                                                              IdMap& recipeIds, IdMap& userIds,
+                                                              std::vector<int64_t>* pks = nullptr) {
+    ReviewOrder order = reviewOrder(sortBy);
+    const char* direction = order.descending ? " DESC" : " ASC";
+
+    std::string sql = std::string("SELECT ") + kReviewColumns + " FROM reviews WHERE recipe_pk = ?";
+    if (!status.empty()) {
+        sql += " AND status = ?";
+    }
+    if (after) {
+        sql += order.key ? std::string(" AND (") + order.key + ", created_at, pk)" : std::string(" AND (created_at, pk)");
+        sql += order.descending ? " < " : " > ";
+        sql += order.key ? "(?, ?, ?)" : "(?, ?)";
+    }
+    sql += " ORDER BY ";
+    if (order.key) {
+        sql += std::string(order.key) + direction + ", ";
+    }
+    sql += std::string("created_at") + direction + ", pk" + direction;
+    if (limit >= 0) {
+        sql += " LIMIT ?";
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return {};
+    }
+
+    int index = 1;
+    sqlite3_bind_int64(stmt, index++, recipePk);
+    if (!status.empty()) {
+        sqlite3_bind_text(stmt, index++, status.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    if (after) {
+        if (order.key) {
+            sqlite3_bind_int(stmt, index++, after->key);
+        }
+        sqlite3_bind_text(stmt, index++, after->createdAt.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, index++, after->pk);
+    }
+    if (limit >= 0) {
+        sqlite3_bind_int(stmt, index++, limit);
+    }
+    return readReviews(db, stmt, recipeIds, userIds, pks);
+}
+
+// Write-path statements shared by the write queue's connection and the in-memory fallback. They take pks;
+// callers translate ids through the manager's IdMaps.
+
+static bool writeRating(sqlite3* db, int64_t recipePk, int64_t userPk, int rating) {
+    // An upsert keeps the row's pk and created_at when a user changes their rating. The recipe is checked
+    // under the write lock, since its pk may have been resolved before a concurrent delete committed.
+    const char* sql =
+        "INSERT INTO ratings (recipe_pk, user_pk, rating) SELECT ?1, ?2, ?3 "
+        "WHERE EXISTS (SELECT 1 FROM recipes WHERE pk = ?1) "
+        "ON CONFLICT(recipe_pk, user_pk) DO UPDATE SET rating = excluded.rating, updated_at = CURRENT_TIMESTAMP";
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int64(stmt, 1, recipePk);
+    sqlite3_bind_int64(stmt, 2, userPk);
+    sqlite3_bind_int(stmt, 3, rating);
+
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE && sqlite3_changes(db) > 0;
+}
+
+static bool eraseRating(sqlite3* db, int64_t recipePk, int64_t userPk) {
+    const char* sql = "DELETE FROM ratings WHERE recipe_pk = ? AND user_pk = ?";
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int64(stmt, 1, recipePk);
+    sqlite3_bind_int64(stmt, 2, userPk);
+
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+// "" when the user has not voted on the review
+static std::string readVoteType(sqlite3* db, int64_t reviewPk, int64_t userPk) {
+    const char* sql = "SELECT vote_type FROM review_votes WHERE review_pk = ? AND user_pk = ?";
+
+    sqlite3_stmt* stmt;
+    std::string voteType;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return voteType;
+    }
+
+    sqlite3_bind_int64(stmt, 1, reviewPk);
+    sqlite3_bind_int64(stmt, 2, userPk);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        voteType = text ? text : "";
+    }
+
+    sqlite3_finalize(stmt);
+    return voteType;
+}
+
+static bool adjustHelpfulVotes(sqlite3* db, int64_t reviewPk, int delta) {
+    if (delta == 0) {
+        return true;
+    }
+
+    const char* sql = "UPDATE reviews SET helpful_votes = MAX(helpful_votes + ?, 0) WHERE pk = ?";
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, delta);
+    sqlite3_bind_int64(stmt, 2, reviewPk);
+
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+// Must run inside a write transaction: the previous vote is read under the same lock as the update, so
+// concurrent voters never apply a delta against stale state. A flip between helpful and not_helpful
+// moves the counter by one; a repeated vote leaves it alone. delta receives the change applied.
+static bool writeReviewVote(sqlite3* db, int64_t reviewPk, int64_t userPk, const std::string& voteType, int& delta) {
+    std::string previous = readVoteType(db, reviewPk, userPk);
+
+    // As with ratings, the review may have been deleted since its pk was resolved
+    const char* sql = 
+        "INSERT OR REPLACE INTO review_votes (review_pk, user_pk, vote_type, created_at) "
+        "SELECT ?1, ?2, ?3, CURRENT_TIMESTAMP WHERE EXISTS (SELECT 1 FROM reviews WHERE pk = ?1)";
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int64(stmt, 1, reviewPk);
+    sqlite3_bind_int64(stmt, 2, userPk);
+    sqlite3_bind_text(stmt, 3, voteType.c_str(), -1, SQLITE_TRANSIENT);
+
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE || sqlite3_changes(db) == 0) {
+        return false;
+    }
+    delta = (voteType == "helpful") - (previous == "helpful");
+    return adjustHelpfulVotes(db, reviewPk, delta);
+}
+
+static bool eraseReviewVote(sqlite3* db, int64_t reviewPk, int64_t userPk) {
+    std::string previous = readVoteType(db, reviewPk, userPk);
+
+    const char* sql = "DELETE FROM review_votes WHERE review_pk = ? AND user_pk = ?";
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int64(stmt, 1, reviewPk);
+    sqlite3_bind_int64(stmt, 2, userPk);
+
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    return rc == SQLITE_DONE && adjustHelpfulVotes(db, reviewPk, previous == "helpful" ? -1 : 0);
+}
+
+// Id of the recipe a review belongs to, "" if the review is gone
+static std::string reviewRecipeId(sqlite3* db, IdMap& recipeIds, int64_t reviewPk) {
+    const char* sql = "SELECT recipe_pk FROM reviews WHERE pk = ?";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return "";
+    }
+    sqlite3_bind_int64(stmt, 1, reviewPk);
+    int64_t recipePk = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int64(stmt, 0) : 0;
+    sqlite3_finalize(stmt);
+    return recipePk > 0 ? recipeIds.id(db, recipePk) : "";
+}
+
+// Ratings, reviews and votes hang off a recipe by pk; they go with it (and with a review, its votes)
+static bool eraseRecipeActivity(sqlite3* db, int64_t recipePk) {
+    static const char* const kSql[] = {
+        "DELETE FROM review_votes WHERE review_pk IN (SELECT pk FROM reviews WHERE recipe_pk = ?)",
+        "DELETE FROM reviews WHERE recipe_pk = ?",
+        "DELETE FROM ratings WHERE recipe_pk = ?",
+    };
+    for (const char* sql : kSql) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        sqlite3_bind_int64(stmt, 1, recipePk);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Map a row selected with recipeFieldColumns() onto a RecipeView, copying text into the arena
+static RecipeView recipeViewFromRow(sqlite3_stmt* stmt, RecipeArena& arena) {
+    RecipeView view;
+    int column = 0;
+    RecipeFields::forEach([&view, &column, &arena, stmt](const auto& field) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+        view.*std::decay_t<decltype(field)>::viewMember =
+            arena.store(text, static_cast<size_t>(sqlite3_column_bytes(stmt, column)));
+        ++column;
+    });
+    return view;
+}
+
+// The read-only connections of one manager. Each reading thread keeps its own in a thread_local list,
+// so its reads never share a connection (and a snapshot) with another thread's unfinished statement.
+// A connection is closed when its thread exits, or with the manager if that comes first.
+class RecipeManagerSQLite::ReadConnections {
+public:
+    ReadConnections(std::string path, TextCompressor& compressor) : path_(std::move(path)), compressor_(compressor) {}
+
+    ~ReadConnections() {
+        for (sqlite3* db : open_) {
+            sqlite3_close(db);
+        }
+    }
+
+    // The calling thread's connection to set, opened on first use; nullptr if it cannot be opened
+    static sqlite3* forThisThread(const std::shared_ptr<ReadConnections>& set) {
+        thread_local ThreadConnections connections;
+        auto& entries = connections.entries;
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->first.expired()) {
+                it = entries.erase(it);  // Its manager is gone and has closed the connection
+            } else if (!it->first.owner_before(set) && !set.owner_before(it->first)) {
+                return it->second;
+            } else {
+                ++it;
+            }
+        }
+        sqlite3* db = set->open();
+        if (db) {
+            entries.emplace_back(set, db);
+        }
+        return db;
+    }
+
+private:
+    struct ThreadConnections {
+        std::vector<std::pair<std::weak_ptr<ReadConnections>, sqlite3*>> entries;
+
+        ~ThreadConnections() {
+            for (auto& [set, db] : entries) {
+                if (auto live = set.lock()) {
+                    live->close(db);
+                }
+            }
+        }
+    };
+
+    const std::string path_;
+    TextCompressor& compressor_;
+    std::mutex mutex_;
+    std::vector<sqlite3*> open_;
+
+    sqlite3* open() {
+        sqlite3* db = nullptr;
+        if (sqlite3_open_v2(path_.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to open read connection, reading through the write connection: "
+                      << sqlite3_errmsg(db) << std::endl;
+            sqlite3_close(db);
+            return nullptr;
+        }
+        sqlite3_busy_timeout(db, 5000);
+        compressor_.registerSqlFunction(db);
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_.push_back(db);
+        return db;
+    }
+
+    void close(sqlite3* db) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find(open_.begin(), open_.end(), db);
+        if (it != open_.end()) {
+            open_.erase(it);
+            sqlite3_close(db);
+        }
+    }
+};
+
 RecipeManagerSQLite::RecipeManagerSQLite(const std::string& dbPath)
-    : dbPath_(dbPath), db_(nullptr) {
+    : dbPath_(dbPath), db_(nullptr),
+      recipeIds_(std::make_unique<IdMap>("recipes")),
+      reviewIds_(std::make_unique<IdMap>("reviews")),
+      userIds_(std::make_unique<IdMap>("user_ids")),
+      textCompressor_(std::make_unique<TextCompressor>("compression_dicts")),
+      recipeVersions_(std::make_unique<EntityVersions>()),
+      reviewListVersions_(std::make_unique<EntityVersions>()),
+      ingredientIndex_(std::make_unique<IngredientIndex>()), pantryMatcher_(std::make_unique<PantryMatcher>()),
+      titleIndex_(std::make_unique<TitleIndex>()),
+      suggestIndex_(std::make_unique<SuggestIndex>()),
+      facetIndex_(std::make_unique<FacetIndex>()),
+      similarityIndex_(std::make_unique<SimilarityIndex>()),
+      itemRecommender_(std::make_unique<ItemRecommender>()),
+      trendingIndex_(std::make_unique<TrendingIndex>()) {
     initializeDatabase();
+    // Ratings and votes are group-committed on a second connection; an in-memory database has no second
+    // connection to share, so those writes stay on this one
+    if (db_ && dbPath_ != ":memory:") {
+        writeQueue_ = std::make_unique<WriteQueue>(dbPath_);
+    }
 }
 
 RecipeManagerSQLite::~RecipeManagerSQLite() {
+    writeQueue_.reset(); // Commits anything still queued
+    readers_.reset();    // Closes every reading thread's connection
     if (db_) {
         sqlite3_close(static_cast<sqlite3*>(db_));
         db_ = nullptr;
@@ -37,83 +877,34 @@ void RecipeManagerSQLite::initializeDatabase() {
         db_ = nullptr;
         return;
     }
+    // The write queue commits on its own connection; wait for its lock instead of failing with SQLITE_BUSY
+    sqlite3_busy_timeout(db, 5000);
     db_ = db;
+    textCompressor_->registerSqlFunction(db);
 
-    // Create recipes table
-    const char* createTableSQL = 
-        "CREATE TABLE IF NOT EXISTS recipes ("
-        "id TEXT PRIMARY KEY,"
-        "data TEXT NOT NULL,"
-        "user_id TEXT,"
-        "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-        "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP"
-        ");";
-
-    char* errMsg = nullptr;
-    rc = sqlite3_exec(static_cast<sqlite3*>(db_), createTableSQL, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to create recipes table: " << errMsg << std::endl;
-        sqlite3_free(errMsg);
-    }
-
-    // Create ratings table
-    const char* createRatingsSQL = 
-        "CREATE TABLE IF NOT EXISTS ratings ("
-        "id TEXT PRIMARY KEY,"
-        "recipe_id TEXT NOT NULL,"
-        "user_id TEXT NOT NULL,"
-        "rating INTEGER NOT NULL CHECK(rating >= 1 AND rating <= 5),"
-        "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-        "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-        "FOREIGN KEY(recipe_id) REFERENCES recipes(id),"
-        "UNIQUE(recipe_id, user_id)"
-        ");";
-
-    rc = sqlite3_exec(static_cast<sqlite3*>(db_), createRatingsSQL, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to create ratings table: " << errMsg << std::endl;
-        sqlite3_free(errMsg);
+    // A current database costs one PRAGMA read here
+    if (SchemaMigrator::version(db) < SchemaMigrator::latestVersion(recipeMigrations())) {
+        // WAL lets readers (and the backup copier) run alongside the writer. auto_vacuum only takes effect on
+        // a new database; with it DatabaseMaintenance can hand free pages back a few at a time instead of a
+        // VACUUM. Neither can be changed inside a migration's transaction.
+        sqlite3_exec(db, "PRAGMA auto_vacuum = INCREMENTAL;", nullptr, nullptr, nullptr);
+        sqlite3_exec(db, "PRAGMA journal_mode = WAL;", nullptr, nullptr, nullptr);
+        SchemaMigrator::migrate(db, "recipes", recipeMigrations());
     }
+    textCompressor_->load(db);
 
-    // Create reviews table
-    const char* createReviewsSQL = 
-        "CREATE TABLE IF NOT EXISTS reviews ("
-        "id TEXT PRIMARY KEY,"
-        "recipe_id TEXT NOT NULL,"
-        "user_id TEXT NOT NULL,"
-        "rating INTEGER NOT NULL CHECK(rating >= 1 AND rating <= 5),"
-        "review_text TEXT NOT NULL,"
-        "status TEXT DEFAULT 'pending',"
-        "moderation_reason TEXT,"
-        "helpful_votes INTEGER DEFAULT 0,"
-        "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-        "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-        "FOREIGN KEY(recipe_id) REFERENCES recipes(id),"
-        "UNIQUE(recipe_id, user_id)"
-        ");";
-
-    rc = sqlite3_exec(static_cast<sqlite3*>(db_), createReviewsSQL, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to create reviews table: " << errMsg << std::endl;
-        sqlite3_free(errMsg);
+    // Readers open after the migrations, so none sees an old schema. An in-memory database is private to db.
+    if (dbPath_ != ":memory:") {
+        readers_ = std::make_shared<ReadConnections>(dbPath_, *textCompressor_);
     }
+}
 
-    // Create review_votes table
-    const char* createReviewVotesSQL = 
-        "CREATE TABLE IF NOT EXISTS review_votes ("
-        "review_id TEXT NOT NULL,"
-        "user_id TEXT NOT NULL,"
-        "vote_type TEXT NOT NULL,"
-        "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-        "PRIMARY KEY(review_id, user_id),"
-        "FOREIGN KEY(review_id) REFERENCES reviews(id)"
-        ");";
-
-    rc = sqlite3_exec(static_cast<sqlite3*>(db_), createReviewVotesSQL, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "Failed to create review_votes table: " << errMsg << std::endl;
-        sqlite3_free(errMsg);
+void* RecipeManagerSQLite::readDb() const {
+    if (!readers_ || transactionOwner_.load() == std::this_thread::get_id()) {
+        return db_;
     }
+    sqlite3* reader = ReadConnections::forThisThread(readers_);
+    return reader ? reader : db_;
 }
 
 bool RecipeManagerSQLite::addRecipe(const recipe& recipe) {
@@ -121,9 +912,17 @@ bool RecipeManagerSQLite::addRecipe(const recipe& recipe) {
 }
 
 bool RecipeManagerSQLite::addRecipe(const recipe& recipe, const std::string& userId) {
-    const char* sql = userId.empty() 
-        ? "INSERT INTO recipes (id, data) VALUES (?, ?);"
-        : "INSERT INTO recipes (id, data, user_id) VALUES (?, ?, ?);";
+    const char* sql = "INSERT INTO recipes (id, data, ingredients_z, instructions_z, user_pk) VALUES (?, ?, ?, ?, ?);";
+
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
+
+    int64_t userPk = 0;
+    if (!userId.empty() && (userPk = userIds_->intern(static_cast<sqlite3*>(db_), userId)) == 0) {
+        return false;
+    }
 
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
@@ -133,26 +932,90 @@ bool RecipeManagerSQLite::addRecipe(const recipe& recipe, const std::string& use
     }
 
     std::string id = recipe.getId().empty() ? generateId() : recipe.getId();
-    // Create a copy of the recipe with the generated ID
-    ::recipe recipeWithId(recipe.getTitle(), recipe.getIngredients(), recipe.getInstructions(),
-                       recipe.getServingSize(), recipe.getCookTime(), recipe.getCategory(), 
-                       recipe.getType(), id);
-    std::string jsonData = recipeToJson(recipeWithId);
+    // Serialize under the generated ID without copying the recipe
+    StoredRecipe stored = storeRecipe(recipe, id, *textCompressor_);
 
     sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, jsonData.c_str(), -1, SQLITE_TRANSIENT);
-    if (!userId.empty()) {
-        sqlite3_bind_text(stmt, 3, userId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, stored.data.c_str(), -1, SQLITE_TRANSIENT);
+    bindPacked(stmt, 3, stored);
+    if (userPk > 0) {
+        sqlite3_bind_int64(stmt, 5, userPk);
     }
 
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) {
+        return false;
+    }
+    int64_t pk = sqlite3_last_insert_rowid(static_cast<sqlite3*>(db_));
+    afterCommit([this, id, pk, recipe]() {
+        recipeIds_->remember(pk, id);
+        onRecipeWritten(id, recipe);
+    });
+    return transaction.commit();
+}
+
+bool RecipeManagerSQLite::addRecipes(const std::vector<recipe>& recipes, size_t* inserted) {
+    const char* sql = "INSERT OR IGNORE INTO recipes (id, data, ingredients_z, instructions_z) VALUES (?, ?, ?, ?);";
+    if (inserted) {
+        *inserted = 0;
+    }
+
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
+
+    sqlite3* db = static_cast<sqlite3*>(db_);
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    size_t count = 0;
+    std::string id;
+    StoredRecipe stored;
+    rc = SQLITE_DONE;
+    for (const auto& recipe : recipes) {
+        id = recipe.getId().empty() ? generateId() : recipe.getId();
+        stored = storeRecipe(recipe, id, *textCompressor_);
+        sqlite3_bind_text(stmt, 1, id.c_str(), static_cast<int>(id.size()), SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, stored.data.c_str(), static_cast<int>(stored.data.size()), SQLITE_STATIC);
+        bindPacked(stmt, 3, stored);
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) {
+            std::cerr << "Failed to insert recipe " << id << ": " << sqlite3_errmsg(db) << std::endl;
+            break;
+        }
+        count += static_cast<size_t>(sqlite3_changes(db));
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        return false;
+    }
+    if (count > 0) {
+        // One rebuild on next use instead of an index update per row
+        afterCommit([this]() { invalidateRecipeIndexes(); });
+    }
+    if (inserted) {
+        *inserted = count;
+    }
+    return transaction.commit();
 }
 
 bool RecipeManagerSQLite::updateRecipe(const std::string& id, const recipe& recipe) {
-    const char* sql = "UPDATE recipes SET data = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?;";
+    const char* sql =
+        "UPDATE recipes SET data = ?, ingredients_z = ?, instructions_z = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?;";
+
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
 
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
@@ -161,61 +1024,366 @@ bool RecipeManagerSQLite::updateRecipe(const std::string& id, const recipe& reci
         return false;
     }
 
-    std::string jsonData = recipeToJson(recipe);
+    StoredRecipe stored = storeRecipe(recipe, recipe.getId(), *textCompressor_);
 
-    sqlite3_bind_text(stmt, 1, jsonData.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 1, stored.data.c_str(), -1, SQLITE_TRANSIENT);
+    bindPacked(stmt, 2, stored);
+    sqlite3_bind_text(stmt, 4, id.c_str(), -1, SQLITE_TRANSIENT);
 
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) {
+        return false;
+    }
+    if (sqlite3_changes(static_cast<sqlite3*>(db_)) > 0) {
+        afterCommit([this, id, recipe]() { onRecipeWritten(id, recipe); });
+    }
+    return transaction.commit();
 }
 
 bool RecipeManagerSQLite::updateRecipeByTitle(const std::string& title, const recipe& recipe) {
-    const char* sql = "UPDATE recipes SET data = ?, updated_at = CURRENT_TIMESTAMP WHERE json_extract(data, '$.title') = ?;";
+    const std::string sql = "UPDATE recipes SET data = ?, ingredients_z = ?, instructions_z = ?, updated_at = CURRENT_TIMESTAMP WHERE " +
+                            jsonExtract(RecipeFields::title) + " = ? RETURNING id;";
+
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
         return false;
     }
 
-    std::string jsonData = recipeToJson(recipe);
+    StoredRecipe stored = storeRecipe(recipe, recipe.getId(), *textCompressor_);
 
-    sqlite3_bind_text(stmt, 1, jsonData.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, title.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 1, stored.data.c_str(), -1, SQLITE_TRANSIENT);
+    bindPacked(stmt, 2, stored);
+    sqlite3_bind_text(stmt, 4, title.c_str(), -1, SQLITE_TRANSIENT);
 
-    rc = sqlite3_step(stmt);
+    std::vector<std::string> ids;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        ids.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
     sqlite3_finalize(stmt);
 
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) {
+        return false;
+    }
+    if (!ids.empty()) {
+        // Title may match several rows; rebuild the indexes on next use rather than re-parse each one
+        afterCommit([this, ids = std::move(ids)]() {
+            invalidateRecipeIndexes();
+            for (const auto& id : ids) {
+                recipeVersions_->bump(id);
+            }
+        });
+    }
+    return transaction.commit();
 }
 
 std::string RecipeManagerSQLite::generateId() {
-    // Simple ID generation - in production, use UUID
-    static int counter = 0;
-    return "recipe_" + std::to_string(++counter) + "_" + std::to_string(std::time(nullptr));
+    return IdGenerator::next("recipe_");
 }
 
-std::string RecipeManagerSQLite::recipeToJson(const recipe& recipe) {
-    return recipe.toJson();
+std::optional<RecipeManagerSQLite::ExportPage> RecipeManagerSQLite::exportPage(
+    ExportTable table, const std::string& since, int64_t cursor, size_t limit,
+    const std::function<bool(std::string_view line)>& sink) {
+    // SQLite builds each line (json_object escapes the values); the stored recipe JSON is embedded as is
+    // Keys are joined back to public ids (integer primary-key lookups); ratings get the id they had before
+    static const std::string kSql[] = {
+        "SELECT t.pk, json_object('table', 'recipes', 'id', t.id, 'userId', u.id, 'createdAt', t.created_at, "
+        "'updatedAt', t.updated_at, 'recipe', json(" + recipeDataExpression("t.") + ")) FROM recipes t "
+        "LEFT JOIN user_ids u ON u.pk = t.user_pk ",
+        "SELECT t.pk, json_object('table', 'ratings', 'id', 'rating_' || c.id || '_' || u.id, 'recipeId', c.id, "
+        "'userId', u.id, 'rating', t.rating, 'createdAt', t.created_at, 'updatedAt', t.updated_at) FROM ratings t "
+        "JOIN recipes c ON c.pk = t.recipe_pk JOIN user_ids u ON u.pk = t.user_pk ",
+        "SELECT t.pk, json_object('table', 'reviews', 'id', t.id, 'recipeId', c.id, 'userId', u.id, "
+        "'rating', t.rating, 'reviewText', t.review_text, 'status', t.status, 'moderationReason', t.moderation_reason, "
+        "'helpfulVotes', t.helpful_votes, 'createdAt', t.created_at, 'updatedAt', t.updated_at) FROM reviews t "
+        "JOIN recipes c ON c.pk = t.recipe_pk JOIN user_ids u ON u.pk = t.user_pk ",
+    };
+    // pk order walks the table's own B-tree, so every page is a seek plus limit rows. updated_at is
+    // set on insert and on every edit, so it alone decides whether a row changed since the timestamp.
+    std::string sql = kSql[static_cast<int>(table)] +
+                      "WHERE t.pk > ?1 AND (?2 IS NULL OR t.updated_at >= ?2) ORDER BY t.pk LIMIT ?3;";
+
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    std::string normalizedSince;
+    if (!since.empty()) {
+        // Accept anything datetime() does ("2026-01-31", "2026-01-31T08:00:00Z", ...) and compare in its format
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, "SELECT datetime(?);", -1, &stmt, nullptr) != SQLITE_OK) {
+            return std::nullopt;
+        }
+        sqlite3_bind_text(stmt, 1, since.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+            normalizedSince = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+        if (normalizedSince.empty()) {
+            return std::nullopt;
+        }
+    }
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
+    sqlite3_bind_int64(stmt, 1, cursor);
+    if (!normalizedSince.empty()) {
+        sqlite3_bind_text(stmt, 2, normalizedSince.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(limit));
+
+    ExportPage page;
+    bool stopped = false;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        page.nextCursor = sqlite3_column_int64(stmt, 0);
+        ++page.rows;
+        std::string_view line(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                              static_cast<size_t>(sqlite3_column_bytes(stmt, 1)));
+        if (!sink(line)) {
+            stopped = true;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (!stopped && rc != SQLITE_DONE) {
+        std::cerr << "Export query failed: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
+    if (!stopped && page.rows < limit) {
+        page.nextCursor = 0;  // A short page is the last one
+    }
+    return page;
+}
+
+std::optional<RecipeManagerSQLite::CompressionStats> RecipeManagerSQLite::compressRecipeText(size_t sampleLimit) {
+    sqlite3* db = static_cast<sqlite3*>(db_);
+    if (!db) {
+        return std::nullopt;
+    }
+
+    // Random rows, so the dictionary reflects the whole table rather than its oldest recipes
+    std::vector<std::string> samples;
+    const std::string sampleSql = "SELECT " + jsonExtract(RecipeFields::ingredients) + ", " +
+                                  jsonExtract(RecipeFields::instructions) + " FROM recipes ORDER BY random() LIMIT ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sampleSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(sampleLimit));
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        for (int column = 0; column < 2; ++column) {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+            if (text && *text) {
+                samples.emplace_back(text);
+            }
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    std::string dictionary = TextCompressor::train(samples);
+    if (dictionary.empty()) {
+        return std::nullopt;
+    }
+    CompressionStats stats;
+    {
+        Transaction transaction(*this);
+        if (!transaction || (stats.dictionaryVersion = textCompressor_->save(db, dictionary, samples.size())) == 0 ||
+            !transaction.commit()) {
+            return std::nullopt;
+        }
+    }
+    textCompressor_->load(db);
+
+    // Rewritten in pk batches, one transaction each, so other writers are never held up for long.
+    // The content does not change, so neither does updated_at or any in-memory index.
+    constexpr int kBatchRows = 500;
+    const std::string selectSql = "SELECT pk, id, " + recipeData() + " FROM recipes WHERE pk > ? ORDER BY pk LIMIT ?;";
+    const char* updateSql = "UPDATE recipes SET data = ?, ingredients_z = ?, instructions_z = ? WHERE pk = ?;";
+    int64_t cursor = 0;
+    for (;;) {
+        Transaction transaction(*this);
+        if (!transaction) {
+            return std::nullopt;
+        }
+
+        struct Row {
+            int64_t pk;
+            std::string id;
+            std::string json;
+        };
+        std::vector<Row> rows;
+        if (sqlite3_prepare_v2(db, selectSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            return std::nullopt;
+        }
+        sqlite3_bind_int64(stmt, 1, cursor);
+        sqlite3_bind_int(stmt, 2, kBatchRows);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            rows.push_back({sqlite3_column_int64(stmt, 0), reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2))});
+        }
+        sqlite3_finalize(stmt);
+        if (rows.empty()) {
+            break;
+        }
+
+        if (sqlite3_prepare_v2(db, updateSql, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            return std::nullopt;
+        }
+        for (const Row& row : rows) {
+            std::optional<recipe> parsed;
+            try {
+                parsed.emplace(jsonToRecipe(row.json));
+            } catch (const std::exception& e) {
+                std::cerr << "Left recipe " << row.id << " as it was: " << e.what() << std::endl;
+                continue;
+            }
+            StoredRecipe stored = storeRecipe(*parsed, row.id, *textCompressor_);
+            RecipeFields::forEach([&](const auto& field) {
+                int slot = packedSlot(field.key);
+                if (slot >= 0) {
+                    stats.textBytes += field.get(*parsed).size();
+                    stats.storedBytes += stored.packed[slot] ? stored.packed[slot]->size() : field.get(*parsed).size();
+                }
+            });
+
+            sqlite3_bind_text(stmt, 1, stored.data.c_str(), static_cast<int>(stored.data.size()), SQLITE_STATIC);
+            bindPacked(stmt, 2, stored);
+            sqlite3_bind_int64(stmt, 4, row.pk);
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                std::cerr << "Failed to rewrite recipe " << row.id << ": " << sqlite3_errmsg(db) << std::endl;
+                sqlite3_finalize(stmt);
+                return std::nullopt;
+            }
+            sqlite3_reset(stmt);
+            ++stats.rows;
+        }
+        sqlite3_finalize(stmt);
+        if (!transaction.commit()) {
+            return std::nullopt;
+        }
+        cursor = rows.back().pk;
+    }
+    return stats;
 }
 
 bool RecipeManagerSQLite::isConnected() const {
     return db_ != nullptr;
 }
 
-std::vector<recipe> RecipeManagerSQLite::advancedSearch(const SearchCriteria& criteria) {
+RecipeManagerSQLite::Transaction::Transaction(RecipeManagerSQLite& manager)
+    : manager_(manager), lock_(manager.writeMutex_) {
+    sqlite3* db = static_cast<sqlite3*>(manager_.db_);
+    if (!db) {
+        return;
+    }
+    if (manager_.transactionDepth_ == 0) {
+        open_ = execRetryingBusy(db, "BEGIN IMMEDIATE;");
+    } else {
+        savepoint_ = "scope_" + std::to_string(manager_.transactionDepth_);
+        open_ = execStatement(db, ("SAVEPOINT " + savepoint_ + ";").c_str());
+    }
+    if (open_) {
+        if (manager_.transactionDepth_++ == 0) {
+            manager_.transactionOwner_ = std::this_thread::get_id();
+        }
+        firstAction_ = manager_.afterCommit_.size();
+    }
+}
+
+RecipeManagerSQLite::Transaction::~Transaction() {
+    rollback();
+}
+
+bool RecipeManagerSQLite::Transaction::commit() {
+    if (!open_) {
+        return false;
+    }
+    sqlite3* db = static_cast<sqlite3*>(manager_.db_);
+    if (!savepoint_.empty()) {
+        // The work (and its afterCommit actions) now belongs to the enclosing scope
+        bool released = execStatement(db, ("RELEASE " + savepoint_ + ";").c_str());
+        if (!released) {
+            rollback();
+            return false;
+        }
+        close();
+        lock_.unlock();
+        return true;
+    }
+
+    if (!execRetryingBusy(db, "COMMIT;")) {
+        rollback();
+        return false;
+    }
+    // Still under the write lock, so in-memory indexes see commits in the order SQLite applied them
+    std::vector<std::function<void()>> actions;
+    actions.swap(manager_.afterCommit_);
+    close();
+    for (auto& action : actions) {
+        action();
+    }
+    lock_.unlock();
+    return true;
+}
+
+void RecipeManagerSQLite::Transaction::rollback() {
+    if (!open_) {
+        return;
+    }
+    sqlite3* db = static_cast<sqlite3*>(manager_.db_);
+    if (savepoint_.empty()) {
+        execStatement(db, "ROLLBACK;");
+    } else {
+        execStatement(db, ("ROLLBACK TO " + savepoint_ + ";").c_str());
+        execStatement(db, ("RELEASE " + savepoint_ + ";").c_str());
+    }
+    manager_.afterCommit_.erase(manager_.afterCommit_.begin() + static_cast<std::ptrdiff_t>(firstAction_),
+                                manager_.afterCommit_.end());
+    close();
+    lock_.unlock();
+}
+
+void RecipeManagerSQLite::Transaction::close() {
+    open_ = false;
+    if (--manager_.transactionDepth_ == 0) {
+        manager_.transactionOwner_ = std::thread::id();
+    }
+}
+
+void RecipeManagerSQLite::afterCommit(std::function<void()> action) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+    if (transactionDepth_ == 0) {
+        action();
+    } else {
+        afterCommit_.push_back(std::move(action));
+    }
+}
+
+std::vector<recipe> RecipeManagerSQLite::advancedSearch(const SearchCriteria& criteria, SearchFacets* facets) {
     std::vector<recipe> recipes;
-    std::string sql = "SELECT data FROM recipes WHERE 1=1";
+    std::string sql = "SELECT " + recipeData() + ", id FROM recipes WHERE 1=1";
+    if (facets) {
+        *facets = SearchFacets{};
+    }
     std::vector<std::string> params;
 
     // Determine if this is an expensive query (full-text search or multiple filters)
     bool isExpensive = !criteria.query.empty() ||
                       (!criteria.category.empty() && !criteria.type.empty()) ||
                       (!criteria.ingredient.empty()) ||
+                      (!criteria.includeIngredients.empty() || !criteria.excludeIngredients.empty()) ||
                       (!criteria.cookTimeMax.empty()) ||
                       (!criteria.servingSizeMin.empty() || !criteria.servingSizeMax.empty());
 
@@ -226,14 +1394,25 @@ std::vector<recipe> RecipeManagerSQLite::advancedSearch(const SearchCriteria& cr
         oss << "advsearch:" << criteria.query << ":" << criteria.category << ":" << criteria.type
             << ":" << criteria.ingredient << ":" << criteria.cookTimeMax << ":" << criteria.servingSizeMin
             << ":" << criteria.servingSizeMax << ":" << criteria.sortBy << ":" << criteria.sortOrder;
+        for (const auto& ingredient : criteria.includeIngredients) {
+            oss << ":+" << ingredient;
+        }
+        for (const auto& ingredient : criteria.excludeIngredients) {
+            oss << ":-" << ingredient;
+        }
         cacheKey = oss.str();
         auto& redis = getRedis();
         auto cached = redis.get(cacheKey);
         if (cached) {
             try {
-                nlohmann::json arr = nlohmann::json::parse(*cached);
-                for (const auto& item : arr) {
-                    recipes.push_back(jsonToRecipe(item.dump()));
+                // Single streaming pass over the cached array, no intermediate DOM
+                recipes = RecipeJsonParser(*cached).parseRecipeArray();
+                if (facets) {
+                    FacetIndex::Counter counter = facetIndex().counter();
+                    for (const auto& cachedRecipe : recipes) {
+                        counter.add(cachedRecipe.getId());
+                    }
+                    *facets = toSearchFacets(counter.finish());
                 }
                 return recipes;
             } catch (...) {
@@ -242,48 +1421,70 @@ std::vector<recipe> RecipeManagerSQLite::advancedSearch(const SearchCriteria& cr
         }
     }
 
+    // Field expressions generated from the RecipeFields table
+    const std::string titleExpr = jsonExtract(RecipeFields::title);
+    const std::string ingredientsExpr = jsonExtract(RecipeFields::ingredients);
+    const std::string instructionsExpr = jsonExtract(RecipeFields::instructions);
+    const std::string categoryExpr = jsonExtract(RecipeFields::category);
+    const std::string typeExpr = jsonExtract(RecipeFields::type);
+    // Leading integer of "20 minutes" / "4 servings"
+    const std::string cookTimeMinutes = "CAST(SUBSTR(" + jsonExtract(RecipeFields::cookTime) + ", 1, INSTR(" +
+                                        jsonExtract(RecipeFields::cookTime) + ", ' ') - 1) AS INTEGER)";
+    const std::string servingCount = "CAST(SUBSTR(" + jsonExtract(RecipeFields::servingSize) + ", 1, INSTR(" +
+                                     jsonExtract(RecipeFields::servingSize) + ", ' ') - 1) AS INTEGER)";
+
     // Build WHERE conditions
     if (!criteria.query.empty()) {
         // Full-text search across multiple fields using LIKE
         std::string queryLower = criteria.query;
         std::transform(queryLower.begin(), queryLower.end(), queryLower.begin(), ::tolower);
-        sql += " AND (LOWER(json_extract(data, '$.title')) LIKE ? OR "
-               "LOWER(json_extract(data, '$.ingredients')) LIKE ? OR "
-               "LOWER(json_extract(data, '$.instructions')) LIKE ? OR "
-               "LOWER(json_extract(data, '$.category')) LIKE ? OR "
-               "LOWER(json_extract(data, '$.type')) LIKE ?)";
+        sql += " AND (LOWER(" + titleExpr + ") LIKE ? OR "
+               "LOWER(" + ingredientsExpr + ") LIKE ? OR "
+               "LOWER(" + instructionsExpr + ") LIKE ? OR "
+               "LOWER(" + categoryExpr + ") LIKE ? OR "
+               "LOWER(" + typeExpr + ") LIKE ?)";
         std::string likeQuery = "%" + queryLower + "%";
         params.insert(params.end(), {likeQuery, likeQuery, likeQuery, likeQuery, likeQuery});
     }
 
     if (!criteria.category.empty()) {
-        sql += " AND LOWER(json_extract(data, '$.category')) LIKE ?";
+        sql += " AND LOWER(" + categoryExpr + ") LIKE ?";
         params.push_back("%" + criteria.category + "%");
     }
 
     if (!criteria.type.empty()) {
-        sql += " AND LOWER(json_extract(data, '$.type')) LIKE ?";
+        sql += " AND LOWER(" + typeExpr + ") LIKE ?";
         params.push_back("%" + criteria.type + "%");
     }
 
     if (!criteria.ingredient.empty()) {
-        sql += " AND LOWER(json_extract(data, '$.ingredients')) LIKE ?";
+        sql += " AND LOWER(" + ingredientsExpr + ") LIKE ?";
         params.push_back("%" + criteria.ingredient + "%");
     }
 
+    if (!criteria.includeIngredients.empty() || !criteria.excludeIngredients.empty()) {
+        // Resolve "all of / none of" against the inverted index, then restrict the scan to those ids
+        std::vector<std::string> ids = ingredientIndex().match(criteria.includeIngredients, criteria.excludeIngredients);
+        if (ids.empty()) {
+            return recipes;
+        }
+        sql += " AND id IN (SELECT value FROM json_each(?))";
+        params.push_back(jsonStringArray(ids));
+    }
+
     if (!criteria.cookTimeMax.empty()) {
         // Extract numeric cook time and compare
-        sql += " AND CAST(SUBSTR(json_extract(data, '$.cookTime'), 1, INSTR(json_extract(data, '$.cookTime'), ' ') - 1) AS INTEGER) <= ?";
+        sql += " AND " + cookTimeMinutes + " <= ?";
         params.push_back(criteria.cookTimeMax);
     }
 
     if (!criteria.servingSizeMin.empty()) {
-        sql += " AND CAST(SUBSTR(json_extract(data, '$.servingSize'), 1, INSTR(json_extract(data, '$.servingSize'), ' ') - 1) AS INTEGER) >= ?";
+        sql += " AND " + servingCount + " >= ?";
         params.push_back(criteria.servingSizeMin);
     }
 
     if (!criteria.servingSizeMax.empty()) {
-        sql += " AND CAST(SUBSTR(json_extract(data, '$.servingSize'), 1, INSTR(json_extract(data, '$.servingSize'), ' ') - 1) AS INTEGER) <= ?";
+        sql += " AND " + servingCount + " <= ?";
         params.push_back(criteria.servingSizeMax);
     }
 
@@ -292,24 +1493,24 @@ std::vector<recipe> RecipeManagerSQLite::advancedSearch(const SearchCriteria& cr
         std::string sortOrder = criteria.sortOrder.empty() ? "ASC" : (criteria.sortOrder == "desc" ? "DESC" : "ASC");
 
         if (criteria.sortBy == "title") {
-            sql += " ORDER BY LOWER(json_extract(data, '$.title')) " + sortOrder;
+            sql += " ORDER BY LOWER(" + titleExpr + ") " + sortOrder;
         } else if (criteria.sortBy == "cookTime") {
-            sql += " ORDER BY CAST(SUBSTR(json_extract(data, '$.cookTime'), 1, INSTR(json_extract(data, '$.cookTime'), ' ') - 1) AS INTEGER) " + sortOrder;
+            sql += " ORDER BY " + cookTimeMinutes + " " + sortOrder;
         } else if (criteria.sortBy == "category") {
-            sql += " ORDER BY LOWER(json_extract(data, '$.category')) " + sortOrder;
+            sql += " ORDER BY LOWER(" + categoryExpr + ") " + sortOrder;
         } else if (criteria.sortBy == "createdAt") {
             sql += " ORDER BY created_at " + sortOrder;
         }
     } else {
         // Default sort by title
-        sql += " ORDER BY LOWER(json_extract(data, '$.title')) ASC";
+        sql += " ORDER BY LOWER(" + titleExpr + ") ASC";
     }
 
     // Execute query
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql.c_str(), -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare advanced search statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
+        std::cerr << "Failed to prepare advanced search statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
         return recipes;
     }
 
@@ -318,61 +1519,378 @@ std::vector<recipe> RecipeManagerSQLite::advancedSearch(const SearchCriteria& cr
         sqlite3_bind_text(stmt, static_cast<int>(i + 1), params[i].c_str(), -1, SQLITE_TRANSIENT);
     }
 
-    nlohmann::json resultArr = nlohmann::json::array();
+    // Facet histograms accumulate over the same rows; the counter reads dictionary-encoded columns only
+    std::optional<FacetIndex::Counter> facetCounter;
+    if (facets) {
+        facetCounter.emplace(facetIndex());
+    }
+
+    // Stored documents are already valid JSON, so the cache array is assembled by concatenation
+    std::string resultArr = "[";
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         const unsigned char* data = sqlite3_column_text(stmt, 0);
         if (data) {
             std::string jsonStr = reinterpret_cast<const char*>(data);
             recipes.push_back(jsonToRecipe(jsonStr));
+            if (facetCounter) {
+                const char* id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+                facetCounter->add(id ? id : "");
+            }
             if (isExpensive) {
-                resultArr.push_back(nlohmann::json::parse(jsonStr));
+                if (resultArr.size() > 1) {
+                    resultArr += ',';
+                }
+                resultArr += jsonStr;
             }
         }
     }
+    resultArr += ']';
     sqlite3_finalize(stmt);
+    if (facetCounter) {
+        *facets = toSearchFacets(facetCounter->finish());
+        facetCounter.reset();
+    }
 
     // Cache results for expensive queries
     if (isExpensive && !recipes.empty()) {
         auto& redis = getRedis();
-        redis.set(cacheKey, resultArr.dump());
+        redis.set(cacheKey, resultArr);
         redis.expire(cacheKey, 300); // 5 min TTL
     }
 
     return recipes;
 }
 
+RecipeManagerSQLite::SearchFacets RecipeManagerSQLite::getFacets() {
+    return toSearchFacets(facetIndex().countAll());
+}
+
 bool RecipeManagerSQLite::deleteRecipe(const std::string& id) {
-    const char* deleteSQL = "DELETE FROM recipes WHERE id = ?;";
+    const char* deleteSQL = "DELETE FROM recipes WHERE pk = ?;";
+
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
+
+    sqlite3* db = static_cast<sqlite3*>(db_);
+    // An unknown id deletes nothing, but the in-memory indexes still drop it. Looked up rather than taken
+    // from the cache, which may hold a pk another process has since deleted.
+    if (int64_t pk = recipeIds_->refresh(db, id)) {
+        if (!eraseRecipeActivity(db, pk)) {
+            return false;
+        }
+
+        sqlite3_stmt* stmt = nullptr;
+
+        int rc = sqlite3_prepare_v2(db, deleteSQL, -1, &stmt, nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+
+        sqlite3_bind_int64(stmt, 1, pk);
+
+        rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+
+        if (rc != SQLITE_DONE) {
+            return false;
+        }
+    }
+    afterCommit([this, id]() {
+        recipeIds_->forget(id);
+        onRecipeDeleted(id);
+    });
+    return transaction.commit();
+}
+
+// (id, value) for every recipe, used to build the in-memory indexes
+std::vector<std::pair<std::string, std::string>> RecipeManagerSQLite::loadRecipeColumn(const std::string& expression) {
+    std::vector<std::pair<std::string, std::string>> rows;
+    const std::string selectSQL = "SELECT id, " + expression + " FROM recipes;";
     sqlite3_stmt* stmt = nullptr;
 
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), deleteSQL, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
-        return false;
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
+        return rows;
     }
 
-    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* ingredients = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        rows.emplace_back(id ? id : "", ingredients ? ingredients : "");
+    }
 
-    rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
+    return rows;
+}
 
-    return rc == SQLITE_DONE;
+IngredientIndex& RecipeManagerSQLite::ingredientIndex() {
+    ingredientIndex_->ensureBuilt([this]() { return loadRecipeColumn(jsonExtract(RecipeFields::ingredients)); });
+    return *ingredientIndex_;
+}
+
+PantryMatcher& RecipeManagerSQLite::pantryMatcher() {
+    pantryMatcher_->ensureBuilt([this]() { return loadRecipeColumn(jsonExtract(RecipeFields::ingredients)); });
+    return *pantryMatcher_;
+}
+
+TitleIndex& RecipeManagerSQLite::titleIndex() {
+    titleIndex_->ensureBuilt([this]() { return loadRecipeColumn(jsonExtract(RecipeFields::title)); });
+    return *titleIndex_;
+}
+
+// id followed by each expression for every recipe, used to build the multi-column indexes
+std::vector<std::vector<std::string>> RecipeManagerSQLite::loadRecipeColumns(const std::vector<std::string>& expressions) {
+    std::vector<std::vector<std::string>> rows;
+    std::string selectSQL = "SELECT id";
+    for (const auto& expression : expressions) {
+        selectSQL += ", " + expression;
+    }
+    selectSQL += " FROM recipes;";
+    sqlite3_stmt* stmt = nullptr;
+
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
+        return rows;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::vector<std::string>& row = rows.emplace_back();
+        for (int i = 0; i <= static_cast<int>(expressions.size()); ++i) {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
+            row.emplace_back(text ? text : "");
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+SuggestIndex& RecipeManagerSQLite::suggestIndex() {
+    suggestIndex_->ensureBuilt([this]() {
+        std::vector<SuggestIndex::Document> documents;
+        for (auto& row : loadRecipeColumns({jsonExtract(RecipeFields::title), jsonExtract(RecipeFields::category),
+                                            jsonExtract(RecipeFields::ingredients)})) {
+            documents.push_back({std::move(row[0]), std::move(row[1]), std::move(row[2]), std::move(row[3])});
+        }
+        return documents;
+    });
+    return *suggestIndex_;
+}
+
+FacetIndex& RecipeManagerSQLite::facetIndex() {
+    facetIndex_->ensureBuilt([this]() {
+        std::vector<FacetIndex::Document> documents;
+        for (auto& row : loadRecipeColumns({jsonExtract(RecipeFields::category), jsonExtract(RecipeFields::type),
+                                            jsonExtract(RecipeFields::cookTime)})) {
+            documents.push_back({std::move(row[0]), std::move(row[1]), std::move(row[2]), std::move(row[3])});
+        }
+        return documents;
+    });
+    return *facetIndex_;
+}
+
+SimilarityIndex& RecipeManagerSQLite::similarityIndex() {
+    similarityIndex_->ensureBuilt([this]() { return loadRecipeColumn(jsonExtract(RecipeFields::ingredients)); });
+    return *similarityIndex_;
+}
+
+std::vector<std::vector<std::string>> RecipeManagerSQLite::loadAllRatings() {
+    std::vector<std::vector<std::string>> rows;
+    const char* selectSQL =
+        "SELECT c.id, u.id, t.rating, t.updated_at FROM ratings t "
+        "JOIN recipes c ON c.pk = t.recipe_pk JOIN user_ids u ON u.pk = t.user_pk;";
+    sqlite3_stmt* stmt = nullptr;
+
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
+        return rows;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::vector<std::string>& row = rows.emplace_back();
+        for (int i = 0; i < 4; ++i) {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
+            row.emplace_back(text ? text : "");
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+std::string RecipeManagerSQLite::neighborsPath() const {
+    return dbPath_ == ":memory:" ? std::string() : dbPath_ + ".neighbors";
+}
+
+ItemRecommender& RecipeManagerSQLite::itemRecommender() {
+    itemRecommender_->ensureBuilt([this]() { return toRecommenderRatings(loadAllRatings()); }, neighborsPath());
+    return *itemRecommender_;
+}
+
+// Replays the activity of the last few half-lives; anything older has decayed to nothing
+TrendingIndex& RecipeManagerSQLite::trendingIndex() {
+    trendingIndex_->ensureBuilt([this]() {
+        std::vector<TrendingIndex::Event> events;
+        const std::string since = "datetime('now', '-" + std::to_string(TrendingIndex::kReplayDays) + " days')";
+        const std::string selectSQL =
+            "SELECT c.id, 0, t.updated_at FROM ratings t JOIN recipes c ON c.pk = t.recipe_pk"
+            " WHERE t.updated_at >= " + since +
+            " UNION ALL SELECT c.id, 1, t.created_at FROM reviews t JOIN recipes c ON c.pk = t.recipe_pk"
+            " WHERE t.created_at >= " + since +
+            " UNION ALL SELECT c.id, 2, v.created_at FROM review_votes v JOIN reviews r ON r.pk = v.review_pk"
+            " JOIN recipes c ON c.pk = r.recipe_pk WHERE v.vote_type = 'helpful' AND v.created_at >= " + since + ";";
+        sqlite3_stmt* stmt = nullptr;
+
+        int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL.c_str(), -1, &stmt, nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
+            return events;
+        }
+
+        static const TrendingIndex::Signal signals[] = {TrendingIndex::Signal::Rating, TrendingIndex::Signal::Review,
+                                                        TrendingIndex::Signal::HelpfulVote};
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            const char* timestamp = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+            int64_t time = TrendingIndex::parseTimestamp(timestamp ? timestamp : "");
+            if (recipeId && time >= 0) {
+                events.push_back({recipeId, signals[sqlite3_column_int(stmt, 1)], time});
+            }
+        }
+
+        sqlite3_finalize(stmt);
+        return events;
+    });
+    return *trendingIndex_;
+}
+
+void RecipeManagerSQLite::warmSearchIndexes() {
+    ingredientIndex();
+    pantryMatcher();
+    titleIndex();
+    suggestIndex();
+    facetIndex();
+    similarityIndex();
+    itemRecommender();
+    trendingIndex();
+}
+
+void RecipeManagerSQLite::onRecipeWritten(const std::string& id, const recipe& recipe) {
+    recipeVersions_->bump(id);
+    ingredientIndex_->upsert(id, recipe.getIngredients());
+    pantryMatcher_->upsert(id, recipe.getIngredients());
+    titleIndex_->upsert(id, recipe.getTitle());
+    suggestIndex_->upsert({id, recipe.getTitle(), recipe.getCategory(), recipe.getIngredients()});
+    facetIndex_->upsert({id, recipe.getCategory(), recipe.getType(), recipe.getCookTime()});
+    similarityIndex_->upsert(id, recipe.getIngredients());
+}
+
+void RecipeManagerSQLite::onRecipeDeleted(const std::string& id) {
+    recipeVersions_->bump(id);
+    reviewListVersions_->bump(id);
+    ingredientIndex_->remove(id);
+    pantryMatcher_->remove(id);
+    titleIndex_->remove(id);
+    suggestIndex_->remove(id);
+    facetIndex_->remove(id);
+    similarityIndex_->remove(id);
+    itemRecommender_->removeRecipe(id);
+    trendingIndex_->remove(id);
+}
+
+void RecipeManagerSQLite::onReviewChanged(const std::string& reviewId) {
+    sqlite3* db = static_cast<sqlite3*>(db_);
+    if (sqlite3_changes(db) == 0) {
+        return;
+    }
+    std::string recipeId = reviewRecipeId(db, *recipeIds_, reviewIds_->pk(db, reviewId));
+    afterCommit([this, recipeId]() { reviewListVersions_->bump(recipeId); });
+}
+
+void RecipeManagerSQLite::invalidateRecipeIndexes() {
+    ingredientIndex_->invalidate();
+    pantryMatcher_->invalidate();
+    titleIndex_->invalidate();
+    suggestIndex_->invalidate();
+    facetIndex_->invalidate();
+    similarityIndex_->invalidate();
+}
+
+std::vector<RecipeManagerSQLite::PantryMatch> RecipeManagerSQLite::matchPantry(const std::vector<std::string>& pantry,
+                                                                               size_t limit, double minCoverage) {
+    std::vector<PantryMatch> results;
+    for (auto& match : pantryMatcher().topMatches(pantry, limit, minCoverage)) {
+        results.push_back({std::move(match.recipeId), match.coverage, static_cast<int>(match.matched),
+                           static_cast<int>(match.total), std::move(match.missing)});
+    }
+    return results;
+}
+
+std::vector<RecipeManagerSQLite::SimilarRecipe> RecipeManagerSQLite::findSimilarRecipes(const std::string& recipeId,
+                                                                                       size_t limit, double minSimilarity) {
+    std::vector<SimilarRecipe> results;
+    for (auto& match : similarityIndex().similarTo(recipeId, limit, minSimilarity)) {
+        results.push_back({std::move(match.recipeId), match.similarity});
+    }
+    return results;
+}
+
+std::vector<RecipeManagerSQLite::Recommendation> RecipeManagerSQLite::getRecommendations(const std::string& userId,
+                                                                                       size_t limit) {
+    std::vector<Recommendation> results;
+    for (auto& recommendation : itemRecommender().recommend(userId, limit)) {
+        results.push_back({std::move(recommendation.recipeId), recommendation.score});
+    }
+    return results;
+}
+
+bool RecipeManagerSQLite::rebuildRecommendations() {
+    return itemRecommender_->rebuild(toRecommenderRatings(loadAllRatings()), neighborsPath());
+}
+
+std::vector<RecipeManagerSQLite::TrendingRecipe> RecipeManagerSQLite::getTrendingRecipes(size_t limit) {
+    std::vector<TrendingRecipe> results;
+    for (auto& entry : trendingIndex().top(limit, unixNow())) {
+        results.push_back({std::move(entry.recipeId), entry.score});
+    }
+    return results;
+}
+
+std::vector<RecipeManagerSQLite::Suggestion> RecipeManagerSQLite::suggest(const std::string& prefix, size_t limit) {
+    std::vector<Suggestion> results;
+    for (auto& suggestion : suggestIndex().suggest(prefix, limit)) {
+        results.push_back({std::move(suggestion.text), SuggestIndex::kindName(suggestion.kind),
+                           static_cast<int>(suggestion.weight)});
+    }
+    return results;
 }
 
 
 // User-specific operations
 bool RecipeManagerSQLite::isRecipeOwnedByUser(const std::string& recipeId, const std::string& userId) {
-    const char* selectSQL = "SELECT COUNT(*) FROM recipes WHERE id = ? AND user_id = ?;";
+    const char* selectSQL = "SELECT COUNT(*) FROM recipes WHERE pk = ? AND user_pk = ?;";
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t recipePk = recipeIds_->pk(db, recipeId);
+    int64_t userPk = userIds_->pk(db, userId);
+    if (recipePk == 0 || userPk == 0) {
+        return false;
+    }
     sqlite3_stmt* stmt = nullptr;
 
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), selectSQL, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, selectSQL, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, recipePk);
+    sqlite3_bind_int64(stmt, 2, userPk);
 
     bool owned = false;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -380,21 +1898,29 @@ bool RecipeManagerSQLite::isRecipeOwnedByUser(const std::string& recipeId, const
     }
 
     sqlite3_finalize(stmt);
+    if (!owned && recipeIds_->refresh(db, recipeId) != recipePk) {
+        return isRecipeOwnedByUser(recipeId, userId);  // The cached pk was stale
+    }
     return owned;
 }
 
 bool RecipeManagerSQLite::isRecipeOwnedByUserByTitle(const std::string& recipeTitle, const std::string& userId) {
-    const char* selectSQL = "SELECT COUNT(*) FROM recipes r WHERE json_extract(r.data, '$.title') = ? AND r.user_id = ?;";
+    const std::string selectSQL = "SELECT COUNT(*) FROM recipes WHERE user_pk = ? AND " + jsonExtract(RecipeFields::title) + " = ?;";
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t userPk = userIds_->pk(db, userId);
+    if (userPk == 0) {
+        return false;
+    }
     sqlite3_stmt* stmt = nullptr;
 
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), selectSQL, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, recipeTitle.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, userPk);
+    sqlite3_bind_text(stmt, 2, recipeTitle.c_str(), -1, SQLITE_TRANSIENT);
 
     bool owned = false;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -406,17 +1932,22 @@ bool RecipeManagerSQLite::isRecipeOwnedByUserByTitle(const std::string& recipeTi
 }
 
 std::vector<recipe> RecipeManagerSQLite::getRecipesByUser(const std::string& userId) {
-    const char* selectSQL = "SELECT data FROM recipes WHERE user_id = ? ORDER BY created_at DESC;";
+    const std::string selectSQL = "SELECT " + recipeData() + " FROM recipes WHERE user_pk = ? ORDER BY created_at DESC;";
+    sqlite3* db = static_cast<sqlite3*>(readDb());
     sqlite3_stmt* stmt = nullptr;
     std::vector<recipe> recipes;
+    int64_t userPk = userIds_->pk(db, userId);
+    if (userPk == 0) {
+        return recipes;
+    }
 
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), selectSQL, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
         return recipes;
     }
 
-    sqlite3_bind_text(stmt, 1, userId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, userPk);
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         const void* blobData = sqlite3_column_blob(stmt, 0);
@@ -430,12 +1961,12 @@ std::vector<recipe> RecipeManagerSQLite::getRecipesByUser(const std::string& use
 }
 
 std::unique_ptr<recipe> RecipeManagerSQLite::getRecipe(const std::string& id) {
-    const char* selectSQL = "SELECT data FROM recipes WHERE id = ?;";
+    const std::string selectSQL = "SELECT " + recipeData() + " FROM recipes WHERE id = ?;";
     sqlite3_stmt* stmt = nullptr;
 
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), selectSQL, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
         return nullptr;
     }
 
@@ -445,21 +1976,33 @@ std::unique_ptr<recipe> RecipeManagerSQLite::getRecipe(const std::string& id) {
         const char* jsonData = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
         std::string jsonStr = jsonData ? jsonData : "";
         sqlite3_finalize(stmt);
-                return std::unique_ptr<recipe>(new recipe(jsonToRecipe(jsonStr)));
+        return std::make_unique<recipe>(jsonToRecipe(jsonStr));
     }
 
     sqlite3_finalize(stmt);
     return nullptr;
 }
 
+bool RecipeManagerSQLite::recipeExists(const std::string& id) {
+    return db_ && recipeIds_->refresh(static_cast<sqlite3*>(readDb()), id) > 0;
+}
+
+std::string RecipeManagerSQLite::recipeETag(const std::string& id) const {
+    return recipeVersions_->etag(id);
+}
+
+std::string RecipeManagerSQLite::reviewsETag(const std::string& recipeId) const {
+    return reviewListVersions_->etag(recipeId);
+}
+
 std::vector<recipe> RecipeManagerSQLite::getAllRecipes() {
     std::vector<recipe> recipes;
-    const char* selectSQL = "SELECT data FROM recipes ORDER BY created_at DESC;";
+    const std::string selectSQL = "SELECT " + recipeData() + " FROM recipes ORDER BY created_at DESC;";
     sqlite3_stmt* stmt = nullptr;
 
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), selectSQL, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
         return recipes;
     }
 
@@ -472,152 +2015,204 @@ std::vector<recipe> RecipeManagerSQLite::getAllRecipes() {
     return recipes;
 }
 
+std::pmr::vector<RecipeView> RecipeManagerSQLite::getAllRecipeViews(RecipeArena& arena) {
+    std::pmr::vector<RecipeView> views(arena.resource());
+    // Let SQLite's JSON1 pull the fields out so no DOM is built per row
+    const std::string selectSQL = "SELECT " + recipeFieldColumns() + " FROM recipes ORDER BY created_at DESC;";
+    sqlite3_stmt* stmt = nullptr;
+
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL.c_str(), -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
+        return views;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        views.push_back(recipeViewFromRow(stmt, arena));
+    }
+
+    sqlite3_finalize(stmt);
+    return views;
+}
+
 std::vector<recipe> RecipeManagerSQLite::searchByTitle(const std::string& title) {
     std::vector<recipe> recipes;
-    const char* searchSQL = "SELECT data FROM recipes WHERE data LIKE ?;";
+    if (TitleIndex::normalize(title).empty()) {
+        return getAllRecipes();
+    }
+
+    std::vector<TitleIndex::Match> matches = titleIndex().search(title);
+    if (matches.empty()) {
+        return recipes;
+    }
+
+    std::vector<std::string> ids;
+    ids.reserve(matches.size());
+    for (const auto& match : matches) {
+        ids.push_back(match.recipeId);
+    }
+
+    return getRecipesByIds(ids);
+}
+
+// Recipes for ids, in the order given; ids without a row are skipped
+std::vector<recipe> RecipeManagerSQLite::getRecipesByIds(const std::vector<std::string>& ids) {
+    std::vector<recipe> recipes;
+    if (ids.empty()) {
+        return recipes;
+    }
+
+    const std::string selectSQL = "SELECT id, " + recipeData() + " FROM recipes WHERE id IN (SELECT value FROM json_each(?));";
     sqlite3_stmt* stmt = nullptr;
 
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), searchSQL, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), selectSQL.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(db_)) << std::endl;
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(static_cast<sqlite3*>(readDb())) << std::endl;
         return recipes;
     }
 
-    std::string searchPattern = "%" + title + "%";
-    sqlite3_bind_text(stmt, 1, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
+    std::string idArray = jsonStringArray(ids);
+    sqlite3_bind_text(stmt, 1, idArray.c_str(), -1, SQLITE_TRANSIENT);
 
+    std::unordered_map<std::string, std::string> dataById;
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        const char* jsonData = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        std::string jsonStr = jsonData;
-
-        // Check if title matches (simple string search in JSON)
-        if (jsonStr.find(title) != std::string::npos) {
-            recipes.push_back(jsonToRecipe(jsonStr));
+        const char* id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* jsonData = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        if (id && jsonData) {
+            dataById.emplace(id, jsonData);
         }
     }
-
     sqlite3_finalize(stmt);
+
+    // Return in caller order
+    recipes.reserve(dataById.size());
+    for (const auto& id : ids) {
+        auto it = dataById.find(id);
+        if (it != dataById.end()) {
+            recipes.push_back(jsonToRecipe(it->second));
+        }
+    }
     return recipes;
 }
 
 std::vector<recipe> RecipeManagerSQLite::searchByCategory(const std::string& category) {
-    // Similar implementation to searchByTitle
-    return searchByTitle(category); // Simplified - could be more sophisticated
+    return getRecipesByIds(facetIndex().recipesWith(FacetIndex::Dimension::Category, category));
 }
 
 std::vector<recipe> RecipeManagerSQLite::searchByType(const std::string& type) {
-    // Similar implementation to searchByTitle
-    return searchByTitle(type); // Simplified - could be more sophisticated
+    return getRecipesByIds(facetIndex().recipesWith(FacetIndex::Dimension::Type, type));
 }
 
 // Rating operations
-bool RecipeManagerSQLite::addOrUpdateRating(const std::string& recipeId, const std::string& userId, int rating) {
+bool RecipeManagerSQLite::addOrUpdateRating(const std::string& recipeId, const std::string& userId, int rating,
+                                            WriteDurability durability) {
     if (rating < 1 || rating > 5) {
         return false;
     }
-
-    const char* sql = 
-        "INSERT OR REPLACE INTO ratings (id, recipe_id, user_id, rating, updated_at) "
-        "VALUES (?, ?, ?, ?, CURRENT_TIMESTAMP)";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    int64_t recipePk = recipeIds_->pk(static_cast<sqlite3*>(readDb()), recipeId);
+    if (recipePk == 0) {
         return false;
     }
 
-    std::string ratingId = "rating_" + recipeId + "_" + userId;
-
-    sqlite3_bind_text(stmt, 1, ratingId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, recipeId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, userId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, 4, rating);
-
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    return rc == SQLITE_DONE;
+    return submitWrite(
+        [userIds = userIds_.get(), recipePk, userId, rating](void* db) {
+            int64_t userPk = userIds->intern(static_cast<sqlite3*>(db), userId);
+            return userPk > 0 && writeRating(static_cast<sqlite3*>(db), recipePk, userPk, rating);
+        },
+        [this, recipeId, userId, rating]() {
+            itemRecommender_->setRating(recipeId, userId, rating);
+            trendingIndex_->record(recipeId, TrendingIndex::Signal::Rating, unixNow());
+        },
+        durability);
 }
 
 bool RecipeManagerSQLite::deleteRating(const std::string& recipeId, const std::string& userId) {
-    const char* sql = "DELETE FROM ratings WHERE recipe_id = ? AND user_id = ?";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return false;
-    }
-
-    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
-
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    return rc == SQLITE_DONE;
+    // Through the write path, so the delete lands after any rating for the same pair still queued
+    return submitWrite(
+        [recipeIds = recipeIds_.get(), userIds = userIds_.get(), recipeId, userId](void* db) {
+            int64_t recipePk = recipeIds->pk(static_cast<sqlite3*>(db), recipeId);
+            int64_t userPk = userIds->pk(static_cast<sqlite3*>(db), userId);
+            // Nothing to delete for an unknown recipe or user
+            return recipePk == 0 || userPk == 0 || eraseRating(static_cast<sqlite3*>(db), recipePk, userPk);
+        },
+        [this, recipeId, userId]() { itemRecommender_->removeRating(recipeId, userId); },
+        WriteDurability::Committed);
 }
 
 std::unique_ptr<RecipeManagerSQLite::Rating> RecipeManagerSQLite::getRating(const std::string& recipeId, const std::string& userId) {
-    const char* sql = 
-        "SELECT id, recipe_id, user_id, rating, created_at, updated_at "
-        "FROM ratings WHERE recipe_id = ? AND user_id = ?";
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t recipePk = recipeIds_->pk(db, recipeId);
+    int64_t userPk = userIds_->pk(db, userId);
+    if (recipePk == 0 || userPk == 0) {
+        return nullptr;
+    }
+
+    const std::string sql = std::string("SELECT ") + kRatingColumns + " FROM ratings WHERE recipe_pk = ? AND user_pk = ?";
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         return nullptr;
     }
 
-    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
-
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        auto rating = std::make_unique<Rating>();
-        rating->id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        rating->recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        rating->userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        rating->rating = sqlite3_column_int(stmt, 3);
-        rating->createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        rating->updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+    sqlite3_bind_int64(stmt, 1, recipePk);
+    sqlite3_bind_int64(stmt, 2, userPk);
 
-        sqlite3_finalize(stmt);
-        return rating;
+    std::vector<Rating> ratings = readRatings(db, stmt, *recipeIds_, *userIds_);
+    if (ratings.empty()) {
+        if (recipeIds_->refresh(db, recipeId) != recipePk) {
+            return getRating(recipeId, userId);  // The cached pk was stale
+        }
+        return nullptr;
     }
-
-    sqlite3_finalize(stmt);
-    return nullptr;
+    return std::make_unique<Rating>(std::move(ratings.front()));
 }
 
 double RecipeManagerSQLite::getAverageRating(const std::string& recipeId) {
-    const char* sql = "SELECT AVG(rating) FROM ratings WHERE recipe_id = ?";
+    const char* sql = "SELECT AVG(rating) FROM ratings WHERE recipe_pk = ?";
+
+    int64_t recipePk = recipeIds_->pk(static_cast<sqlite3*>(readDb()), recipeId);
+    if (recipePk == 0) {
+        return 0.0;
+    }
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         return 0.0;
     }
 
-    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, recipePk);
 
     double avg = 0.0;
+    bool rated = false;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
+        rated = sqlite3_column_type(stmt, 0) != SQLITE_NULL;
         avg = sqlite3_column_double(stmt, 0);
     }
 
     sqlite3_finalize(stmt);
+    if (!rated && recipeIds_->refresh(static_cast<sqlite3*>(readDb()), recipeId) != recipePk) {
+        return getAverageRating(recipeId);  // The cached pk was stale
+    }
     return avg;
 }
 
 int RecipeManagerSQLite::getRatingCount(const std::string& recipeId) {
-    const char* sql = "SELECT COUNT(*) FROM ratings WHERE recipe_id = ?";
+    const char* sql = "SELECT COUNT(*) FROM ratings WHERE recipe_pk = ?";
+
+    int64_t recipePk = recipeIds_->pk(static_cast<sqlite3*>(readDb()), recipeId);
+    if (recipePk == 0) {
+        return 0;
+    }
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         return 0;
     }
 
-    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, recipePk);
 
     int count = 0;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -625,67 +2220,52 @@ int RecipeManagerSQLite::getRatingCount(const std::string& recipeId) {
     }
 
     sqlite3_finalize(stmt);
+    if (count == 0 && recipeIds_->refresh(static_cast<sqlite3*>(readDb()), recipeId) != recipePk) {
+        return getRatingCount(recipeId);  // The cached pk was stale
+    }
     return count;
 }
 
 std::vector<RecipeManagerSQLite::Rating> RecipeManagerSQLite::getRatingsByRecipe(const std::string& recipeId) {
-    std::vector<Rating> ratings;
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t recipePk = recipeIds_->pk(db, recipeId);
+    if (recipePk == 0) {
+        return {};
+    }
 
-    const char* sql = 
-        "SELECT id, recipe_id, user_id, rating, created_at, updated_at "
-        "FROM ratings WHERE recipe_id = ? ORDER BY created_at DESC";
+    const std::string sql = std::string("SELECT ") + kRatingColumns + " FROM ratings WHERE recipe_pk = ? ORDER BY created_at DESC";
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        return ratings;
+        return {};
     }
 
-    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Rating rating;
-        rating.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        rating.recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        rating.userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        rating.rating = sqlite3_column_int(stmt, 3);
-        rating.createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        rating.updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        ratings.push_back(rating);
+    sqlite3_bind_int64(stmt, 1, recipePk);
+    std::vector<Rating> ratings = readRatings(db, stmt, *recipeIds_, *userIds_);
+    if (ratings.empty() && recipeIds_->refresh(db, recipeId) != recipePk) {
+        return getRatingsByRecipe(recipeId);  // The cached pk was stale
     }
-
-    sqlite3_finalize(stmt);
     return ratings;
 }
 
 std::vector<RecipeManagerSQLite::Rating> RecipeManagerSQLite::getRatingsByUser(const std::string& userId) {
-    std::vector<Rating> ratings;
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t userPk = userIds_->pk(db, userId);
+    if (userPk == 0) {
+        return {};
+    }
 
-    const char* sql = 
-        "SELECT id, recipe_id, user_id, rating, created_at, updated_at "
-        "FROM ratings WHERE user_id = ? ORDER BY created_at DESC";
+    const std::string sql = std::string("SELECT ") + kRatingColumns + " FROM ratings WHERE user_pk = ? ORDER BY created_at DESC";
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        return ratings;
-    }
-
-    sqlite3_bind_text(stmt, 1, userId.c_str(), -1, SQLITE_TRANSIENT);
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Rating rating;
-        rating.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        rating.recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        rating.userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        rating.rating = sqlite3_column_int(stmt, 3);
-        rating.createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        rating.updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        ratings.push_back(rating);
+        return {};
     }
 
-    sqlite3_finalize(stmt);
-    return ratings;
+    sqlite3_bind_int64(stmt, 1, userPk);
+    return readRatings(db, stmt, *recipeIds_, *userIds_);
 }
 
 // Review operations
@@ -694,21 +2274,38 @@ bool RecipeManagerSQLite::addReview(const Review& review) {
         return false;
     }
 
+    // The recipe is checked inside the transaction so a concurrent delete cannot orphan the review
     const char* sql = 
-        "INSERT INTO reviews (id, recipe_id, user_id, rating, review_text, status) "
-        "VALUES (?, ?, ?, ?, ?, ?)";
+        "INSERT INTO reviews (id, recipe_pk, user_pk, rating, review_text, status) "
+        "SELECT ?1, ?2, ?3, ?4, ?5, ?6 WHERE EXISTS (SELECT 1 FROM recipes WHERE pk = ?2)";
+
+    sqlite3* db = static_cast<sqlite3*>(db_);
+    int64_t recipePk = recipeIds_->refresh(db, review.recipeId);  // Not the cache: its pk may be stale
+    if (recipePk == 0) {
+        return false;
+    }
+
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
+
+    int64_t userPk = userIds_->intern(db, review.userId);
+    if (userPk == 0) {
+        return false;
+    }
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         return false;
     }
 
-    std::string reviewId = "review_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    std::string reviewId = IdGenerator::next("review_");
 
     sqlite3_bind_text(stmt, 1, reviewId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, review.recipeId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, review.userId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 2, recipePk);
+    sqlite3_bind_int64(stmt, 3, userPk);
     sqlite3_bind_int(stmt, 4, review.rating);
     sqlite3_bind_text(stmt, 5, review.reviewText.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 6, review.status.c_str(), -1, SQLITE_TRANSIENT);
@@ -716,7 +2313,15 @@ bool RecipeManagerSQLite::addReview(const Review& review) {
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE || sqlite3_changes(db) == 0) {
+        return false;
+    }
+    afterCommit([this, reviewPk = sqlite3_last_insert_rowid(db), reviewId, recipeId = review.recipeId]() {
+        reviewIds_->remember(reviewPk, reviewId);
+        reviewListVersions_->bump(recipeId);
+        trendingIndex_->record(recipeId, TrendingIndex::Signal::Review, unixNow());
+    });
+    return transaction.commit();
 }
 
 bool RecipeManagerSQLite::updateReview(const std::string& reviewId, const Review& review) {
@@ -728,6 +2333,11 @@ bool RecipeManagerSQLite::updateReview(const std::string& reviewId, const Review
         "UPDATE reviews SET rating = ?, review_text = ?, updated_at = CURRENT_TIMESTAMP "
         "WHERE id = ?";
 
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
+
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
@@ -741,166 +2351,133 @@ bool RecipeManagerSQLite::updateReview(const std::string& reviewId, const Review
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) {
+        return false;
+    }
+    onReviewChanged(reviewId);
+    return transaction.commit();
 }
 
 bool RecipeManagerSQLite::deleteReview(const std::string& reviewId) {
-    const char* sql = "DELETE FROM reviews WHERE id = ?";
+    // Votes first: they reference the review by pk
+    static const char* const kSql[] = {
+        "DELETE FROM review_votes WHERE review_pk = ?",
+        "DELETE FROM reviews WHERE pk = ?",
+    };
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3* db = static_cast<sqlite3*>(db_);
+    int64_t reviewPk = reviewIds_->pk(db, reviewId);
+    if (reviewPk == 0) {
+        return true;  // Already gone
+    }
+
+    Transaction transaction(*this);
+    if (!transaction) {
         return false;
     }
+    std::string recipeId = reviewRecipeId(db, *recipeIds_, reviewPk);
 
-    sqlite3_bind_text(stmt, 1, reviewId.c_str(), -1, SQLITE_TRANSIENT);
+    for (const char* sql : kSql) {
+        sqlite3_stmt* stmt;
+        int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+        if (rc != SQLITE_OK) {
+            return false;
+        }
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+        sqlite3_bind_int64(stmt, 1, reviewPk);
 
-    return rc == SQLITE_DONE;
+        rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            return false;
+        }
+    }
+
+    afterCommit([this, reviewId, recipeId]() {
+        reviewIds_->forget(reviewId);
+        reviewListVersions_->bump(recipeId);
+    });
+    return transaction.commit();
 }
 
 std::unique_ptr<RecipeManagerSQLite::Review> RecipeManagerSQLite::getReview(const std::string& reviewId) {
-    const char* sql = 
-        "SELECT id, recipe_id, user_id, rating, review_text, status, moderation_reason, helpful_votes, created_at, updated_at "
-        "FROM reviews WHERE id = ?";
+    const std::string sql = std::string("SELECT ") + kReviewColumns + " FROM reviews WHERE id = ?";
 
+    sqlite3* db = static_cast<sqlite3*>(readDb());
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         return nullptr;
     }
 
     sqlite3_bind_text(stmt, 1, reviewId.c_str(), -1, SQLITE_TRANSIENT);
 
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        auto review = std::make_unique<Review>();
-        review->id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        review->recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        review->userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        review->rating = sqlite3_column_int(stmt, 3);
-        review->reviewText = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        review->status = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        review->moderationReason = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) ? reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) : "";
-        review->helpfulVotes = sqlite3_column_int(stmt, 7);
-        review->createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
-        review->updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 9));
-
-        sqlite3_finalize(stmt);
-        return review;
+    std::vector<Review> reviews = readReviews(db, stmt, *recipeIds_, *userIds_);
+    if (reviews.empty()) {
+        return nullptr;
     }
-
-    sqlite3_finalize(stmt);
-    return nullptr;
+    return std::make_unique<Review>(std::move(reviews.front()));
 }
 
 std::vector<RecipeManagerSQLite::Review> RecipeManagerSQLite::getReviewsByRecipe(const std::string& recipeId, const std::string& status) {
-    std::vector<Review> reviews;
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t recipePk = recipeIds_->pk(db, recipeId);
+    if (recipePk == 0) {
+        return {};
+    }
 
-    std::string sql = 
-        "SELECT id, recipe_id, user_id, rating, review_text, status, moderation_reason, helpful_votes, created_at, updated_at "
-        "FROM reviews WHERE recipe_id = ?";
-    
+    std::string sql = std::string("SELECT ") + kReviewColumns + " FROM reviews WHERE recipe_pk = ?";
     if (!status.empty()) {
         sql += " AND status = ?";
     }
     sql += " ORDER BY created_at DESC";
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql.c_str(), -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        return reviews;
+        return {};
     }
 
-    sqlite3_bind_text(stmt, 1, recipeId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, recipePk);
     if (!status.empty()) {
         sqlite3_bind_text(stmt, 2, status.c_str(), -1, SQLITE_TRANSIENT);
     }
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Review review;
-        review.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        review.recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        review.userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        review.rating = sqlite3_column_int(stmt, 3);
-        review.reviewText = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        review.status = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        review.moderationReason = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) ? reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) : "";
-        review.helpfulVotes = sqlite3_column_int(stmt, 7);
-        review.createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
-        review.updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 9));
-        reviews.push_back(review);
+    std::vector<Review> reviews = readReviews(db, stmt, *recipeIds_, *userIds_);
+    if (reviews.empty() && recipeIds_->refresh(db, recipeId) != recipePk) {
+        return getReviewsByRecipe(recipeId, status);  // The cached pk was stale
     }
-
-    sqlite3_finalize(stmt);
     return reviews;
 }
 
 std::vector<RecipeManagerSQLite::Review> RecipeManagerSQLite::getReviewsByUser(const std::string& userId) {
-    std::vector<Review> reviews;
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t userPk = userIds_->pk(db, userId);
+    if (userPk == 0) {
+        return {};
+    }
 
-    const char* sql = 
-        "SELECT id, recipe_id, user_id, rating, review_text, status, moderation_reason, helpful_votes, created_at, updated_at "
-        "FROM reviews WHERE user_id = ? ORDER BY created_at DESC";
+    const std::string sql = std::string("SELECT ") + kReviewColumns + " FROM reviews WHERE user_pk = ? ORDER BY created_at DESC";
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        return reviews;
-    }
-
-    sqlite3_bind_text(stmt, 1, userId.c_str(), -1, SQLITE_TRANSIENT);
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Review review;
-        review.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        review.recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        review.userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        review.rating = sqlite3_column_int(stmt, 3);
-        review.reviewText = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        review.status = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        review.moderationReason = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) ? reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) : "";
-        review.helpfulVotes = sqlite3_column_int(stmt, 7);
-        review.createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
-        review.updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 9));
-        reviews.push_back(review);
+        return {};
     }
 
-    sqlite3_finalize(stmt);
-    return reviews;
+    sqlite3_bind_int64(stmt, 1, userPk);
+    return readReviews(db, stmt, *recipeIds_, *userIds_);
 }
 
 std::vector<RecipeManagerSQLite::Review> RecipeManagerSQLite::getPendingReviews() {
-    std::vector<Review> reviews;
-
-    const char* sql = 
-        "SELECT id, recipe_id, user_id, rating, review_text, status, moderation_reason, helpful_votes, created_at, updated_at "
-        "FROM reviews WHERE status = 'pending' ORDER BY created_at ASC";
+    const std::string sql = std::string("SELECT ") + kReviewColumns + " FROM reviews WHERE status = 'pending' ORDER BY created_at ASC";
 
+    sqlite3* db = static_cast<sqlite3*>(readDb());
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
-        return reviews;
-    }
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Review review;
-        review.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        review.recipeId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        review.userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        review.rating = sqlite3_column_int(stmt, 3);
-        review.reviewText = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        review.status = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        review.moderationReason = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) ? reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) : "";
-        review.helpfulVotes = sqlite3_column_int(stmt, 7);
-        review.createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
-        review.updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 9));
-        reviews.push_back(review);
+        return {};
     }
-
-    sqlite3_finalize(stmt);
-    return reviews;
+    return readReviews(db, stmt, *recipeIds_, *userIds_);
 }
 
 bool RecipeManagerSQLite::moderateReview(const std::string& reviewId, const std::string& status, const std::string& reason) {
@@ -912,6 +2489,11 @@ bool RecipeManagerSQLite::moderateReview(const std::string& reviewId, const std:
         "UPDATE reviews SET status = ?, moderation_reason = ?, updated_at = CURRENT_TIMESTAMP "
         "WHERE id = ?";
 
+    Transaction transaction(*this);
+    if (!transaction) {
+        return false;
+    }
+
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
@@ -925,83 +2507,146 @@ bool RecipeManagerSQLite::moderateReview(const std::string& reviewId, const std:
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) {
+        return false;
+    }
+    onReviewChanged(reviewId);
+    return transaction.commit();
 }
 
 // Review voting operations
-bool RecipeManagerSQLite::addOrUpdateReviewVote(const std::string& reviewId, const std::string& userId, const std::string& voteType) {
+bool RecipeManagerSQLite::addOrUpdateReviewVote(const std::string& reviewId, const std::string& userId, const std::string& voteType,
+                                                WriteDurability durability) {
     if (voteType != "helpful" && voteType != "not_helpful") {
         return false;
     }
 
-    const char* sql = 
-        "INSERT OR REPLACE INTO review_votes (review_id, user_id, vote_type, created_at) "
-        "VALUES (?, ?, ?, CURRENT_TIMESTAMP)";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    int64_t reviewPk = reviewIds_->pk(static_cast<sqlite3*>(readDb()), reviewId);
+    if (reviewPk == 0) {
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, reviewId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, voteType.c_str(), -1, SQLITE_TRANSIENT);
+    auto delta = std::make_shared<int>(0);
+    auto recipeId = std::make_shared<std::string>();  // Resolved when the helpful count moves
+    return submitWrite(
+        [userIds = userIds_.get(), recipeIds = recipeIds_.get(), reviewPk, userId, voteType, delta, recipeId](void* db) {
+            auto* connection = static_cast<sqlite3*>(db);
+            int64_t userPk = userIds->intern(connection, userId);
+            if (userPk == 0 || !writeReviewVote(connection, reviewPk, userPk, voteType, *delta)) {
+                return false;
+            }
+            if (*delta != 0) {
+                *recipeId = reviewRecipeId(connection, *recipeIds, reviewPk);
+            }
+            return true;
+        },
+        [this, delta, recipeId]() {
+            if (recipeId->empty()) {
+                return;
+            }
+            reviewListVersions_->bump(*recipeId);
+            if (*delta > 0 && trendingIndex_->isBuilt()) {
+                trendingIndex_->record(*recipeId, TrendingIndex::Signal::HelpfulVote, unixNow());
+            }
+        },
+        durability);
+}
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+bool RecipeManagerSQLite::deleteReviewVote(const std::string& reviewId, const std::string& userId) {
+    auto recipeId = std::make_shared<std::string>();
+    return submitWrite(
+        [reviewIds = reviewIds_.get(), userIds = userIds_.get(), recipeIds = recipeIds_.get(), reviewId, userId,
+         recipeId](void* db) {
+            auto* connection = static_cast<sqlite3*>(db);
+            int64_t reviewPk = reviewIds->pk(connection, reviewId);
+            int64_t userPk = userIds->pk(connection, userId);
+            // Nothing to delete for an unknown review or user
+            if (reviewPk == 0 || userPk == 0) {
+                return true;
+            }
+            if (!eraseReviewVote(connection, reviewPk, userPk)) {
+                return false;
+            }
+            *recipeId = reviewRecipeId(connection, *recipeIds, reviewPk);
+            return true;
+        },
+        [this, recipeId]() {
+            if (!recipeId->empty()) {
+                reviewListVersions_->bump(*recipeId);
+            }
+        },
+        WriteDurability::Committed);
+}
 
-    // Update helpful_votes count in reviews table
-    if (rc == SQLITE_DONE) {
-        updateHelpfulVotesCount(reviewId);
+void RecipeManagerSQLite::setAutoCheckpoint(int frames) {
+    if (db_) {
+        sqlite3_wal_autocheckpoint(static_cast<sqlite3*>(db_), frames);
+    }
+    if (writeQueue_) {
+        writeQueue_->submit([frames](void* db) {
+            sqlite3_wal_autocheckpoint(static_cast<sqlite3*>(db), frames);
+            return true;
+        }).wait();
     }
-
-    return rc == SQLITE_DONE;
 }
 
-bool RecipeManagerSQLite::deleteReviewVote(const std::string& reviewId, const std::string& userId) {
-    const char* sql = "DELETE FROM review_votes WHERE review_id = ? AND user_id = ?";
+void RecipeManagerSQLite::flushWrites() {
+    if (writeQueue_) {
+        writeQueue_->flush();
+    }
+}
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+bool RecipeManagerSQLite::submitWrite(std::function<bool(void*)> operation, std::function<void()> onCommitted,
+                                      WriteDurability durability) {
+    // A caller's open transaction holds the write lock the queue's connection would wait for, so the write
+    // joins that transaction instead
+    bool inTransaction = transactionOwner_.load() == std::this_thread::get_id();
+    if (writeQueue_ && writeQueue_->isOpen() && !inTransaction) {
+        auto result = writeQueue_->submit(std::move(operation),
+                                          durability == WriteDurability::Queued ? WriteQueue::Durability::Queued
+                                                                                : WriteQueue::Durability::Committed,
+                                          std::move(onCommitted));
+        return durability == WriteDurability::Queued || result.get();
+    }
+
+    // Otherwise (also with no second connection to an in-memory database) apply it on this connection
+    Transaction transaction(*this);
+    if (!transaction || !operation(db_)) {
         return false;
     }
-
-    sqlite3_bind_text(stmt, 1, reviewId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
-
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    // Update helpful_votes count in reviews table
-    if (rc == SQLITE_DONE) {
-        updateHelpfulVotesCount(reviewId);
+    if (onCommitted) {
+        afterCommit(std::move(onCommitted));
     }
-
-    return rc == SQLITE_DONE;
+    return transaction.commit();
 }
 
 std::unique_ptr<RecipeManagerSQLite::ReviewVote> RecipeManagerSQLite::getReviewVote(const std::string& reviewId, const std::string& userId) {
     const char* sql = 
-        "SELECT review_id, user_id, vote_type, created_at "
-        "FROM review_votes WHERE review_id = ? AND user_id = ?";
+        "SELECT vote_type, created_at "
+        "FROM review_votes WHERE review_pk = ? AND user_pk = ?";
+
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t reviewPk = reviewIds_->pk(db, reviewId);
+    int64_t userPk = userIds_->pk(db, userId);
+    if (reviewPk == 0 || userPk == 0) {
+        return nullptr;
+    }
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         return nullptr;
     }
 
-    sqlite3_bind_text(stmt, 1, reviewId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, userId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, reviewPk);
+    sqlite3_bind_int64(stmt, 2, userPk);
 
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         auto vote = std::make_unique<ReviewVote>();
-        vote->reviewId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        vote->userId = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        vote->voteType = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        vote->createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        vote->reviewId = reviewId;
+        vote->userId = userId;
+        vote->voteType = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        vote->createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
 
         sqlite3_finalize(stmt);
         return vote;
@@ -1012,15 +2657,20 @@ std::unique_ptr<RecipeManagerSQLite::ReviewVote> RecipeManagerSQLite::getReviewV
 }
 
 int RecipeManagerSQLite::getHelpfulVoteCount(const std::string& reviewId) {
-    const char* sql = "SELECT COUNT(*) FROM review_votes WHERE review_id = ? AND vote_type = 'helpful'";
+    const char* sql = "SELECT COUNT(*) FROM review_votes WHERE review_pk = ? AND vote_type = 'helpful'";
+
+    int64_t reviewPk = reviewIds_->pk(static_cast<sqlite3*>(readDb()), reviewId);
+    if (reviewPk == 0) {
+        return 0;
+    }
 
     sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(readDb()), sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         return 0;
     }
 
-    sqlite3_bind_text(stmt, 1, reviewId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 1, reviewPk);
 
     int count = 0;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -1031,44 +2681,47 @@ int RecipeManagerSQLite::getHelpfulVoteCount(const std::string& reviewId) {
     return count;
 }
 
-void RecipeManagerSQLite::updateHelpfulVotesCount(const std::string& reviewId) {
-    int count = getHelpfulVoteCount(reviewId);
-
-    const char* sql = "UPDATE reviews SET helpful_votes = ? WHERE id = ?";
-
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(static_cast<sqlite3*>(db_), sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        return;
+// Review sorting and filtering
+std::vector<RecipeManagerSQLite::Review> RecipeManagerSQLite::getSortedReviewsByRecipe(const std::string& recipeId, ReviewSortBy sortBy, const std::string& status) {
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t recipePk = recipeIds_->pk(db, recipeId);
+    if (recipePk == 0) {
+        return {};
     }
-
-    sqlite3_bind_int(stmt, 1, count);
-    sqlite3_bind_text(stmt, 2, reviewId.c_str(), -1, SQLITE_TRANSIENT);
-
-    sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    std::vector<Review> reviews = selectReviews(db, recipePk, sortBy, status, nullptr, -1, *recipeIds_, *userIds_);
+    if (reviews.empty() && recipeIds_->refresh(db, recipeId) != recipePk) {
+        return getSortedReviewsByRecipe(recipeId, sortBy, status);  // The cached pk was stale
+    }
+    return reviews;
 }
 
-// Review sorting and filtering
-std::vector<RecipeManagerSQLite::Review> RecipeManagerSQLite::getSortedReviewsByRecipe(const std::string& recipeId, ReviewSortBy sortBy, const std::string& status) {
-    std::vector<Review> reviews = getReviewsByRecipe(recipeId, status);
-
-    std::sort(reviews.begin(), reviews.end(), [sortBy](const Review& a, const Review& b) {
-        switch (sortBy) {
-            case NEWEST:
-                return a.createdAt > b.createdAt; // Descending order for newest first
-            case OLDEST:
-                return a.createdAt < b.createdAt; // Ascending order for oldest first
-            case HIGHEST_RATED:
-                return a.rating > b.rating; // Descending order for highest rated
-            case MOST_HELPFUL:
-                return a.helpfulVotes > b.helpfulVotes; // Descending order for most helpful
-            default:
-                return a.createdAt > b.createdAt; // Default to newest
-        }
-    });
+std::optional<RecipeManagerSQLite::ReviewPage> RecipeManagerSQLite::getReviewPage(const std::string& recipeId, ReviewSortBy sortBy,
+                                                                                 size_t limit, const std::string& cursor,
+                                                                                 const std::string& status) {
+    ReviewCursor after;
+    if (!cursor.empty() && !decodeReviewCursor(cursor, sortBy, after)) {
+        return std::nullopt;
+    }
 
-    return reviews;
+    ReviewPage page;
+    sqlite3* db = static_cast<sqlite3*>(readDb());
+    int64_t recipePk = recipeIds_->pk(db, recipeId);
+    if (recipePk == 0) {
+        return page;
+    }
+
+    // One extra row tells whether another page follows
+    std::vector<int64_t> pks;
+    page.reviews = selectReviews(db, recipePk, sortBy, status, cursor.empty() ? nullptr : &after,
+                                 static_cast<int>(limit) + 1, *recipeIds_, *userIds_, &pks);
+    if (page.reviews.empty() && recipeIds_->refresh(db, recipeId) != recipePk) {
+        return getReviewPage(recipeId, sortBy, limit, cursor, status);  // The cached pk was stale
+    }
+    if (limit > 0 && page.reviews.size() > limit) {
+        page.reviews.resize(limit);
+        page.nextCursor = encodeReviewCursor(sortBy, page.reviews.back(), pks[limit - 1]);
+    }
+    return page;
 }
 
 recipe RecipeManagerSQLite::jsonToRecipe(const std::string& json) {
@@ -2,9 +2,29 @@
 #define RECIPE_MANAGER_SQLITE_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <atomic>
+#include <thread>
 #include "recipe.h"
+#include "recipeView.h"
+
+class IngredientIndex;
+class PantryMatcher;
+class TitleIndex;
+class SuggestIndex;
+class FacetIndex;
+class SimilarityIndex;
+class ItemRecommender;
+class TrendingIndex;
+class WriteQueue;
+class IdMap;
+class TextCompressor;
+class EntityVersions;
 
 // SQLite-based recipe manager (alternative to MongoDB)
 class RecipeManagerSQLite {
@@ -15,17 +35,33 @@ public:
     // Core CRUD operations
     bool addRecipe(const recipe& recipe);
     bool addRecipe(const recipe& recipe, const std::string& userId);
+    // Bulk insert (imports, seeding): one reused statement in one transaction, or in the caller's
+    // Transaction so several batches share a commit. Recipes whose id already exists are skipped;
+    // inserted receives the number written. The in-memory indexes are rebuilt on next use, not per row.
+    bool addRecipes(const std::vector<recipe>& recipes, size_t* inserted = nullptr);
     bool updateRecipe(const std::string& id, const recipe& recipe);
     bool updateRecipeByTitle(const std::string& title, const recipe& recipe);
+    // Also deletes the recipe's ratings, reviews and review votes, which reference it by key
     bool deleteRecipe(const std::string& id);
     bool deleteRecipeByTitle(const std::string& title);
     std::unique_ptr<recipe> getRecipe(const std::string& id);
+    // Answered from the in-memory id map once the id has been seen
+    bool recipeExists(const std::string& id);
+    // Strong ETags from in-memory change counters (see EntityVersions), for conditional GETs that can
+    // be answered without reading the recipe. recipeETag changes with every committed write to the
+    // recipe, reviewsETag with every write to one of its reviews or their votes. Take the tag before
+    // reading, so a write that lands in between makes it stale rather than the body.
+    std::string recipeETag(const std::string& id) const;
+    std::string reviewsETag(const std::string& recipeId) const;
     std::vector<recipe> getAllRecipes();
 
+    // Read-only listing that materializes rows straight into the caller's arena (no per-recipe heap allocations)
+    std::pmr::vector<RecipeView> getAllRecipeViews(RecipeArena& arena);
+
     // Search operations
-    std::vector<recipe> searchByTitle(const std::string& title);
-    std::vector<recipe> searchByCategory(const std::string& category);
-    std::vector<recipe> searchByType(const std::string& type);
+    std::vector<recipe> searchByTitle(const std::string& title); // Typo-tolerant, ranked by trigram similarity
+    std::vector<recipe> searchByCategory(const std::string& category); // Exact, case-insensitive
+    std::vector<recipe> searchByType(const std::string& type);         // Exact, case-insensitive
     
     // Advanced search with multiple criteria
     struct SearchCriteria {
@@ -36,10 +72,60 @@ public:
         std::string servingSizeMin;  // Min serving size
         std::string servingSizeMax;  // Max serving size
         std::string ingredient;      // Search by ingredient
+        std::vector<std::string> includeIngredients;  // Must contain all of these (ingredient index)
+        std::vector<std::string> excludeIngredients;  // Must contain none of these (ingredient index)
         std::string sortBy;          // Sort field (title, cookTime, createdAt)
         std::string sortOrder;       // Sort order (asc, desc)
     };
-    std::vector<recipe> advancedSearch(const SearchCriteria& criteria);
+
+    // Facet histograms for a result set: (value, count), most frequent first; cook times in bucket order
+    struct FacetValue {
+        std::string value;
+        int count;
+    };
+    struct SearchFacets {
+        std::vector<FacetValue> categories;
+        std::vector<FacetValue> types;
+        std::vector<FacetValue> cookTimes;  // "0-15", "16-30", "31-60", "60+", "unknown" (minutes)
+    };
+    // When facets is non-null it is filled in the same pass over the results
+    std::vector<recipe> advancedSearch(const SearchCriteria& criteria, SearchFacets* facets = nullptr);
+    SearchFacets getFacets(); // Over all recipes
+
+    // Pantry matching: recipes ranked by the fraction of their ingredients found in the pantry
+    struct PantryMatch {
+        std::string recipeId;
+        double coverage;            // matchedIngredients / totalIngredients
+        int matchedIngredients;
+        int totalIngredients;
+        std::vector<std::string> missingIngredients;
+    };
+    std::vector<PantryMatch> matchPantry(const std::vector<std::string>& pantry, size_t limit = 10, double minCoverage = 0.0);
+
+    // Recipes with similar ingredient sets (MinHash/LSH), best first; empty if the recipe is unknown
+    struct SimilarRecipe {
+        std::string recipeId;
+        double similarity;  // Estimated Jaccard similarity of ingredient sets
+    };
+    std::vector<SimilarRecipe> findSimilarRecipes(const std::string& recipeId, size_t limit = 10, double minSimilarity = 0.1);
+
+    // Recipes with the most recent activity (ratings, reviews, helpful votes), decayed with a one-day half-life
+    struct TrendingRecipe {
+        std::string recipeId;
+        double score;
+    };
+    std::vector<TrendingRecipe> getTrendingRecipes(size_t limit = 10);
+
+    // Prefix autocomplete over titles, categories and ingredient names, most used first
+    struct Suggestion {
+        std::string text;
+        std::string kind;   // "title", "category" or "ingredient"
+        int recipeCount;    // Popularity weight
+    };
+    std::vector<Suggestion> suggest(const std::string& prefix, size_t limit = 10);
+
+    // Builds the in-memory search indexes now instead of on first use (call at startup)
+    void warmSearchIndexes();
 
     // User-specific operations
     bool isRecipeOwnedByUser(const std::string& recipeId, const std::string& userId);
@@ -76,8 +162,18 @@ public:
         std::string createdAt;
     };
 
-    // Rating operations
-    bool addOrUpdateRating(const std::string& recipeId, const std::string& userId, int rating);
+    // When a rating or vote write returns: Committed waits for the group commit that holds it,
+    // Queued returns once it is queued (visible to reads within a few milliseconds)
+    enum class WriteDurability {
+        Queued,
+        Committed
+    };
+
+    // Rating operations; false for a recipe that does not exist
+    bool addOrUpdateRating(const std::string& recipeId, const std::string& userId, int rating,
+                           WriteDurability durability = WriteDurability::Committed);
+    // Blocks until every queued rating and vote write has been committed
+    void flushWrites();
     bool deleteRating(const std::string& recipeId, const std::string& userId);
     std::unique_ptr<Rating> getRating(const std::string& recipeId, const std::string& userId);
     double getAverageRating(const std::string& recipeId);
@@ -85,7 +181,17 @@ public:
     std::vector<Rating> getRatingsByRecipe(const std::string& recipeId);
     std::vector<Rating> getRatingsByUser(const std::string& userId);
 
-    // Review operations
+    // Item-item collaborative filtering over the ratings table: unrated recipes scored from the
+    // neighbours of what userId rated, best first. Neighbour lists persist next to the database.
+    struct Recommendation {
+        std::string recipeId;
+        double score;
+    };
+    std::vector<Recommendation> getRecommendations(const std::string& userId, size_t limit = 10);
+    // Batch job: recompute every neighbour list from scratch and rewrite the neighbour file
+    bool rebuildRecommendations();
+
+    // Review operations; addReview fails for a recipe that does not exist, deleteReview takes the votes too
     bool addReview(const Review& review);
     bool updateReview(const std::string& reviewId, const Review& review);
     bool deleteReview(const std::string& reviewId);
@@ -95,8 +201,9 @@ public:
     std::vector<Review> getPendingReviews(); // For moderation
     bool moderateReview(const std::string& reviewId, const std::string& status, const std::string& reason = "");
 
-    // Review voting operations
-    bool addOrUpdateReviewVote(const std::string& reviewId, const std::string& userId, const std::string& voteType);
+    // Review voting operations; voting on a review that does not exist fails
+    bool addOrUpdateReviewVote(const std::string& reviewId, const std::string& userId, const std::string& voteType,
+                               WriteDurability durability = WriteDurability::Committed);
     bool deleteReviewVote(const std::string& reviewId, const std::string& userId);
     std::unique_ptr<ReviewVote> getReviewVote(const std::string& reviewId, const std::string& userId);
     int getHelpfulVoteCount(const std::string& reviewId);
@@ -124,19 +231,139 @@ public:
 
     std::vector<Review> getSortedReviewsByRecipe(const std::string& recipeId, ReviewSortBy sortBy, const std::string& status = "approved");
 
+    // One page of a sorted review listing (keyset pagination, ordered by SQLite). nextCursor continues
+    // the listing and is empty on the last page. nullopt if cursor is malformed or from another sort.
+    struct ReviewPage {
+        std::vector<Review> reviews;
+        std::string nextCursor;
+    };
+    std::optional<ReviewPage> getReviewPage(const std::string& recipeId, ReviewSortBy sortBy, size_t limit,
+                                            const std::string& cursor = "", const std::string& status = "approved");
+
+    // Export (backups, incremental feeds to other stores): one JSON object per row, tagged with its table
+    enum class ExportTable { Recipes, Ratings, Reviews };
+    struct ExportPage {
+        size_t rows = 0;
+        int64_t nextCursor = 0;  // Pass back as cursor to continue; 0 once the table is exhausted
+    };
+    // Hands sink up to limit rows after cursor (0 = from the start), in rowid order, each as one JSON line
+    // without the newline. since ("" = all rows) keeps rows created or updated at or after that timestamp.
+    // Each page is its own query, so no read transaction is held between pages. nullopt if since is not
+    // a timestamp SQLite understands or the query fails; sink returning false stops the page early.
+    std::optional<ExportPage> exportPage(ExportTable table, const std::string& since, int64_t cursor, size_t limit,
+                                         const std::function<bool(std::string_view line)>& sink);
+
+    // Ingredients and instructions can be stored zstd-compressed against a dictionary trained on the
+    // recipes themselves. Reads decompress a field only when a query returns or filters on it.
+    struct CompressionStats {
+        int dictionaryVersion = 0;
+        size_t rows = 0;         // Recipes rewritten
+        size_t textBytes = 0;    // Their ingredients and instructions, uncompressed
+        size_t storedBytes = 0;  // The same text as stored now
+    };
+    // Trains a dictionary on the text of up to sampleLimit recipes, saves it as the next dictionary version and
+    // rewrites every recipe with it, in batches; later writes compress with it too. Text that does not
+    // shrink stays in data. nullopt if there is too little text to train on or a write fails.
+    std::optional<CompressionStats> compressRecipeText(size_t sampleLimit = 5000);
+
+    // Scoped write transaction on the manager's connection, so a multi-step operation commits once.
+    // The outermost scope on a thread runs BEGIN IMMEDIATE (retrying while another connection holds the
+    // write lock) and COMMIT; scopes opened inside it, directly or by the manager methods it calls,
+    // become savepoints. A scope destroyed without commit() rolls its work back. Writes from other
+    // threads wait until the outermost scope ends. Their reads go to read-only connections of their own,
+    // so they see the last committed state and never the scope's rows before it commits.
+    class Transaction {
+    public:
+        explicit Transaction(RecipeManagerSQLite& manager);
+        ~Transaction();
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        // False if BEGIN or SAVEPOINT failed; the scope then does nothing
+        explicit operator bool() const { return open_; }
+        bool commit();
+        void rollback();
+
+    private:
+        RecipeManagerSQLite& manager_;
+        std::unique_lock<std::recursive_mutex> lock_;
+        std::string savepoint_;  // Empty for the outermost scope
+        size_t firstAction_ = 0;  // afterCommit actions registered inside this scope start here
+        bool open_ = false;
+
+        void close();
+    };
+
     // Utility
     bool isConnected() const;
+    // WAL frames after which a committing connection checkpoints on its own (SQLite's default is 1000).
+    // 0 leaves checkpoints to a DatabaseMaintenance thread, off the request path. Covers the write queue too.
+    void setAutoCheckpoint(int frames);
     void initializeDatabase();
 
 private:
     std::string dbPath_;
     void* db_; // sqlite3* (avoid including sqlite3.h in header)
+    // Read-only connections, one per reading thread (see readDb); null for an in-memory database
+    class ReadConnections;
+    std::shared_ptr<ReadConnections> readers_;
+    // Write transactions on the shared connection, one thread at a time (see Transaction)
+    std::recursive_mutex writeMutex_;
+    int transactionDepth_ = 0;                         // Open scopes; guarded by writeMutex_
+    std::atomic<std::thread::id> transactionOwner_{};  // Thread holding the outermost scope
+    std::vector<std::function<void()>> afterCommit_;   // Guarded by writeMutex_
+    std::unique_ptr<WriteQueue> writeQueue_; // Group commit for ratings and votes
+    // Public ids <-> integer primary keys; rows reference each other by pk
+    std::unique_ptr<IdMap> recipeIds_;
+    std::unique_ptr<IdMap> reviewIds_;
+    std::unique_ptr<IdMap> userIds_;  // Interned into user_ids on first write
+    // Dictionaries from compression_dicts; backs the unpack_text() SQL function on db_
+    std::unique_ptr<TextCompressor> textCompressor_;
+    // Bumped after commit: by recipe id, and by recipe id for the reviews listed under it
+    std::unique_ptr<EntityVersions> recipeVersions_;
+    std::unique_ptr<EntityVersions> reviewListVersions_;
+    // In-memory recipe indexes: built on first use, then kept current by the write paths
+    std::unique_ptr<IngredientIndex> ingredientIndex_;
+    std::unique_ptr<PantryMatcher> pantryMatcher_;
+    std::unique_ptr<TitleIndex> titleIndex_;
+    std::unique_ptr<SuggestIndex> suggestIndex_;
+    std::unique_ptr<FacetIndex> facetIndex_;
+    std::unique_ptr<SimilarityIndex> similarityIndex_;
+    std::unique_ptr<ItemRecommender> itemRecommender_;
+    std::unique_ptr<TrendingIndex> trendingIndex_;
 
     // Helper methods
     std::string generateId();
-    std::string recipeToJson(const recipe& recipe);
     recipe jsonToRecipe(const std::string& json);
-    void updateHelpfulVotesCount(const std::string& reviewId);
+    // db_ when the calling thread holds the open Transaction (it must see its own writes), else the
+    // thread's own read-only connection, opened on its first read. A connection keeps its snapshot while
+    // any statement on it is still stepping, so sharing one between threads would serve stale reads.
+    void* readDb() const;
+    // Runs action once the enclosing transaction commits (dropped if it rolls back), or now if there is none
+    void afterCommit(std::function<void()> action);
+    bool submitWrite(std::function<bool(void*)> operation, std::function<void()> onCommitted, WriteDurability durability);
+    IngredientIndex& ingredientIndex();
+    PantryMatcher& pantryMatcher();
+    TitleIndex& titleIndex();
+    SuggestIndex& suggestIndex();
+    FacetIndex& facetIndex();
+    SimilarityIndex& similarityIndex();
+    ItemRecommender& itemRecommender();
+    std::vector<std::vector<std::string>> loadAllRatings();
+    std::string neighborsPath() const;
+    TrendingIndex& trendingIndex();
+    std::vector<std::pair<std::string, std::string>> loadRecipeColumn(const std::string& expression);
+    std::vector<std::vector<std::string>> loadRecipeColumns(const std::vector<std::string>& expressions);
+    std::vector<recipe> getRecipesByIds(const std::vector<std::string>& ids);
+    void onRecipeWritten(const std::string& id, const recipe& recipe);
+    void onRecipeDeleted(const std::string& id);
+    // Inside a review write: if the last statement changed a row, the listing of the review's recipe
+    // gets a new version once the transaction commits
+    void onReviewChanged(const std::string& reviewId);
+    // Drops the indexes built from recipe content after a bulk content write. Trending scores and the
+    // item-item recommender depend only on activity, so a content write leaves them alone.
+    void invalidateRecipeIndexes();
 };
 
 #endif // RECIPE_MANAGER_SQLITE_H
\ No newline at end of file
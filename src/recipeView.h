@@ -0,0 +1,50 @@
+#ifndef RECIPE_VIEW_H
+#define RECIPE_VIEW_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+// Non-owning, read-only projection of a stored recipe.
+// The string_views point into a per-request arena (std::pmr::memory_resource) owned by the caller,
+// so a RecipeView must not outlive the arena it was materialized into.
+struct RecipeView {
+    std::string_view id;
+    std::string_view title;
+    std::string_view ingredients;
+    std::string_view instructions;
+    std::string_view servingSize;
+    std::string_view cookTime;
+    std::string_view category;
+    std::string_view type;
+};
+
+// Per-request arena for listing paths. Memory is released in one go when the arena goes out of scope.
+// The initial buffer lives on the stack, so small listings never touch the heap.
+class RecipeArena {
+public:
+    static constexpr std::size_t kInlineBytes = 16 * 1024;
+
+    RecipeArena() : resource_(buffer_, sizeof(buffer_)) {}
+    RecipeArena(const RecipeArena&) = delete;
+    RecipeArena& operator=(const RecipeArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+    // Copy bytes into the arena and return a view of the copy
+    std::string_view store(const char* data, std::size_t size) {
+        if (!data || size == 0) {
+            return {};
+        }
+        char* dst = static_cast<char*>(resource_.allocate(size, alignof(char)));
+        std::char_traits<char>::copy(dst, data, size);
+        return std::string_view(dst, size);
+    }
+
+private:
+    alignas(std::max_align_t) char buffer_[kInlineBytes];
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+#endif // RECIPE_VIEW_H
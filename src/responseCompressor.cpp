@@ -0,0 +1,253 @@
+#include "responseCompressor.h"
+#include "gzipWriter.h"
+#include <zstd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <future>
+#include <memory>
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+std::string lower(std::string_view text) {
+    std::string out(text);
+    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return std::tolower(c); });
+    return out;
+}
+
+// q-value of one Accept-Encoding element ("gzip;q=0.5"); 1 when absent, clamped to [0, 1]
+double qValue(std::string_view parameters) {
+    while (!parameters.empty()) {
+        size_t semicolon = parameters.find(';');
+        std::string_view parameter = trim(parameters.substr(0, semicolon));
+        parameters = semicolon == std::string_view::npos ? std::string_view() : parameters.substr(semicolon + 1);
+        if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+            double q = std::strtod(std::string(parameter.substr(2)).c_str(), nullptr);
+            return std::clamp(q, 0.0, 1.0);
+        }
+    }
+    return 1.0;
+}
+
+struct CompressionContextDeleter {
+    void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+};
+
+ZSTD_CCtx* compressionContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, CompressionContextDeleter> context(ZSTD_createCCtx());
+    return context.get();
+}
+
+} // namespace
+
+ResponseCompressor::ResponseCompressor(Options options) : options_(options) {
+    for (size_t i = 0; i < options_.threads; ++i) {
+        workers_.emplace_back(&ResponseCompressor::run, this);
+    }
+}
+
+ResponseCompressor::~ResponseCompressor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+ResponseCompressor::Encoding ResponseCompressor::negotiate(std::string_view acceptEncoding) {
+    std::optional<double> zstd, gzip, any;
+    while (!acceptEncoding.empty()) {
+        size_t comma = acceptEncoding.find(',');
+        std::string_view element = acceptEncoding.substr(0, comma);
+        acceptEncoding = comma == std::string_view::npos ? std::string_view() : acceptEncoding.substr(comma + 1);
+
+        size_t semicolon = element.find(';');
+        std::string coding = lower(trim(element.substr(0, semicolon)));
+        double q = semicolon == std::string_view::npos ? 1.0 : qValue(element.substr(semicolon + 1));
+        if (coding == "zstd") {
+            zstd = q;
+        } else if (coding == "gzip" || coding == "x-gzip") {
+            gzip = q;
+        } else if (coding == "*") {
+            any = q;
+        }
+    }
+    // A coding the client did not name is acceptable only through "*"
+    double zstdQ = zstd.value_or(any.value_or(0.0));
+    double gzipQ = gzip.value_or(any.value_or(0.0));
+    if (zstdQ > 0.0 && zstdQ >= gzipQ) {
+        return Encoding::Zstd;
+    }
+    return gzipQ > 0.0 ? Encoding::Gzip : Encoding::Identity;
+}
+
+const char* ResponseCompressor::name(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::Gzip: return "gzip";
+        case Encoding::Zstd: return "zstd";
+        case Encoding::Identity: break;
+    }
+    return "identity";
+}
+
+bool ResponseCompressor::compressible(std::string_view contentType) {
+    std::string type = lower(trim(contentType.substr(0, contentType.find(';'))));
+    return type.rfind("text/", 0) == 0 || type == "application/json" || type == "application/x-ndjson" ||
+           type == "application/javascript" || type.ends_with("+json") || type.ends_with("xml");
+}
+
+std::string ResponseCompressor::encode(std::string_view body, Encoding encoding, int level) {
+    switch (encoding) {
+        case Encoding::Gzip:
+            return GzipWriter::compress(body, level);
+        case Encoding::Zstd: {
+            std::string frame(ZSTD_compressBound(body.size()), '\0');
+            size_t size = ZSTD_compressCCtx(compressionContext(), frame.data(), frame.size(), body.data(), body.size(),
+                                            level);
+            if (ZSTD_isError(size)) {
+                return {};
+            }
+            frame.resize(size);
+            return frame;
+        }
+        case Encoding::Identity:
+            break;
+    }
+    return std::string(body);
+}
+
+std::optional<std::string> ResponseCompressor::compress(const std::string& body, Encoding encoding, bool cacheable) {
+    if (encoding == Encoding::Identity || body.size() < options_.minBytes) {
+        return std::nullopt;
+    }
+    cacheable = cacheable && options_.cacheBytes > 0;
+    size_t hash = cacheable ? std::hash<std::string_view>{}(body) : 0;
+    if (cacheable) {
+        if (auto encoded = lookup(hash, body, encoding)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.cacheHits;
+            stats_.bytesIn += body.size();
+            stats_.bytesOut += encoded->size();
+            return encoded;
+        }
+    }
+
+    std::string encoded;
+    if (workers_.empty()) {
+        encoded = encode(body, encoding, level(encoding));
+    } else {
+        auto task = std::make_shared<std::packaged_task<std::string()>>(
+            [&body, encoding, this] { return encode(body, encoding, level(encoding)); });
+        std::future<std::string> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.size() >= options_.maxQueued) {
+                ++stats_.shed;
+                return std::nullopt;
+            }
+            queue_.emplace_back([task] { (*task)(); });
+        }
+        wake_.notify_one();
+        encoded = result.get();
+    }
+    if (encoded.empty() || encoded.size() >= body.size()) {
+        return std::nullopt;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.compressed;
+        stats_.bytesIn += body.size();
+        stats_.bytesOut += encoded.size();
+    }
+    if (cacheable) {
+        store(hash, body, encoding, encoded);
+    }
+    return encoded;
+}
+
+ResponseCompressor::Stats ResponseCompressor::stats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats = stats_;
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    stats.cachedBytes = cachedBytes_;
+    stats.cacheEntries = cache_.size();
+    return stats;
+}
+
+void ResponseCompressor::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;  // Stopping, and every queued body has been compressed
+        }
+        std::function<void()> job = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+int ResponseCompressor::level(Encoding encoding) const {
+    return encoding == Encoding::Zstd ? options_.zstdLevel : options_.gzipLevel;
+}
+
+std::optional<std::string> ResponseCompressor::lookup(size_t hash, const std::string& body, Encoding encoding) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto [begin, end] = cacheIndex_.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        CacheEntry& entry = *it->second;
+        if (entry.encoding == encoding && entry.body == body) {
+            cache_.splice(cache_.begin(), cache_, it->second);
+            return entry.encoded;
+        }
+    }
+    return std::nullopt;
+}
+
+void ResponseCompressor::store(size_t hash, const std::string& body, Encoding encoding, const std::string& encoded) {
+    size_t bytes = body.size() + encoded.size();
+    if (bytes > options_.cacheBytes / 4) {
+        return;  // One huge body would push out everything else
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto [begin, end] = cacheIndex_.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second->encoding == encoding && it->second->body == body) {
+            return;  // Another request compressed the same body meanwhile
+        }
+    }
+    cache_.push_front(CacheEntry{hash, encoding, body, encoded});
+    cacheIndex_.emplace(hash, cache_.begin());
+    cachedBytes_ += bytes;
+    while (cachedBytes_ > options_.cacheBytes) {
+        CacheEntry& oldest = cache_.back();
+        auto [first, last] = cacheIndex_.equal_range(oldest.hash);
+        for (auto it = first; it != last; ++it) {
+            if (&*it->second == &oldest) {
+                cacheIndex_.erase(it);
+                break;
+            }
+        }
+        cachedBytes_ -= oldest.body.size() + oldest.encoded.size();
+        cache_.pop_back();
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef RESPONSE_COMPRESSOR_H
+#define RESPONSE_COMPRESSOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Content-Encoding for HTTP responses: Accept-Encoding negotiation (zstd or gzip) and compression of
+// bodies of at least minBytes on a fixed pool of worker threads, so at most `threads` requests spend CPU
+// compressing at a time. When maxQueued bodies are already waiting for a worker the response goes out
+// uncompressed instead of queueing behind them.
+// Cacheable bodies are kept compressed, least recently used first out once the cache holds cacheBytes;
+// a later response with the same bytes and encoding is served from there without compressing again. The
+// cache is keyed by content, so it never serves a stale body. With threads = 0 compression runs on the
+// caller's thread.
+class ResponseCompressor {
+public:
+    enum class Encoding { Identity, Gzip, Zstd };
+
+    struct Options {
+        size_t minBytes = 1024;                  // Smaller bodies are sent as is
+        size_t threads = 2;
+        size_t maxQueued = 64;
+        size_t cacheBytes = 32 * 1024 * 1024;    // Compressed and original bytes together; 0 = no cache
+        int gzipLevel = 6;
+        int zstdLevel = 3;
+    };
+
+    struct Stats {
+        uint64_t compressed = 0;    // Bodies compressed by the pool (or inline)
+        uint64_t cacheHits = 0;
+        uint64_t shed = 0;          // Sent uncompressed because the queue was full
+        uint64_t bytesIn = 0;       // Compressed or served from the cache: original size
+        uint64_t bytesOut = 0;      // ... and size on the wire
+        size_t cachedBytes = 0;
+        size_t cacheEntries = 0;
+    };
+
+    explicit ResponseCompressor(Options options);
+    ~ResponseCompressor();
+
+    ResponseCompressor(const ResponseCompressor&) = delete;
+    ResponseCompressor& operator=(const ResponseCompressor&) = delete;
+
+    // Best encoding the client accepts, by its q-values and then ours (zstd over gzip); Identity when none
+    static Encoding negotiate(std::string_view acceptEncoding);
+    static const char* name(Encoding encoding);  // Content-Encoding token, "identity" for Identity
+    // Text-like types (JSON, NDJSON, text/*, JavaScript, XML, SVG) that are worth compressing
+    static bool compressible(std::string_view contentType);
+    // body in encoding on the caller's thread, "" on failure
+    static std::string encode(std::string_view body, Encoding encoding, int level);
+
+    // body encoded for the client, or nullopt to send it as is: Identity, shorter than minBytes, the queue
+    // is full, or compressing did not make it smaller. Blocks until a worker has compressed it.
+    std::optional<std::string> compress(const std::string& body, Encoding encoding, bool cacheable);
+
+    Stats stats() const;
+
+private:
+    struct CacheEntry {
+        size_t hash;
+        Encoding encoding;
+        std::string body;
+        std::string encoded;
+    };
+    using CacheList = std::list<CacheEntry>;
+
+    const Options options_;
+
+    mutable std::mutex cacheMutex_;
+    CacheList cache_;  // Most recently used first
+    std::unordered_multimap<size_t, CacheList::iterator> cacheIndex_;  // By body hash
+    size_t cachedBytes_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> queue_;
+    bool stopping_ = false;
+    Stats stats_;
+    std::vector<std::thread> workers_;
+
+    void run();
+    int level(Encoding encoding) const;
+    std::optional<std::string> lookup(size_t hash, const std::string& body, Encoding encoding);
+    void store(size_t hash, const std::string& body, Encoding encoding, const std::string& encoded);
+};
+
+#endif // RESPONSE_COMPRESSOR_H
@@ -0,0 +1,232 @@
+#include "roaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+
+bool RoaringBitmap::Container::contains(uint16_t low) const {
+    if (isBitmap()) {
+        return (bits[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+void RoaringBitmap::Container::toBitmap() {
+    bits.assign(kBitmapWords, 0);
+    for (uint16_t low : array) {
+        bits[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::toArrayIfSparse() {
+    if (!isBitmap() || cardinality > kArrayMaxSize) {
+        return;
+    }
+    array.clear();
+    array.reserve(cardinality);
+    for (size_t word = 0; word < kBitmapWords; ++word) {
+        uint64_t w = bits[word];
+        while (w) {
+            array.push_back(static_cast<uint16_t>(word * 64 + std::countr_zero(w)));
+            w &= w - 1;
+        }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) {
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    return (it != containers_.end() && it->key == key) ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) const {
+    return const_cast<RoaringBitmap*>(this)->find(key);
+}
+
+void RoaringBitmap::add(uint32_t value) {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) {
+        it = containers_.insert(it, Container{});
+        it->key = key;
+    }
+
+    Container& container = *it;
+    if (container.isBitmap()) {
+        uint64_t& word = container.bits[low >> 6];
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (!(word & mask)) {
+            word |= mask;
+            ++container.cardinality;
+        }
+        return;
+    }
+
+    auto pos = std::lower_bound(container.array.begin(), container.array.end(), low);
+    if (pos != container.array.end() && *pos == low) {
+        return;
+    }
+    container.array.insert(pos, low);
+    ++container.cardinality;
+    if (container.cardinality > kArrayMaxSize) {
+        container.toBitmap();
+    }
+}
+
+bool RoaringBitmap::remove(uint32_t value) {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    Container* container = find(key);
+    if (!container || !container->contains(low)) {
+        return false;
+    }
+
+    if (container->isBitmap()) {
+        container->bits[low >> 6] &= ~(uint64_t{1} << (low & 63));
+        --container->cardinality;
+        container->toArrayIfSparse();
+    } else {
+        container->array.erase(std::lower_bound(container->array.begin(), container->array.end(), low));
+        --container->cardinality;
+    }
+
+    if (container->cardinality == 0) {
+        containers_.erase(containers_.begin() + (container - containers_.data()));
+    }
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const Container* container = find(static_cast<uint16_t>(value >> 16));
+    return container && container->contains(static_cast<uint16_t>(value & 0xFFFF));
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const auto& container : containers_) {
+        total += container.cardinality;
+    }
+    return total;
+}
+
+void RoaringBitmap::intersect(Container& target, const Container& other) {
+    if (target.isBitmap() && other.isBitmap()) {
+        uint32_t cardinality = 0;
+        for (size_t i = 0; i < kBitmapWords; ++i) {
+            target.bits[i] &= other.bits[i];
+            cardinality += static_cast<uint32_t>(std::popcount(target.bits[i]));
+        }
+        target.cardinality = cardinality;
+        target.toArrayIfSparse();
+        return;
+    }
+
+    if (target.isBitmap()) {
+        // Result is at most other's (array) size
+        std::vector<uint16_t> result;
+        result.reserve(other.array.size());
+        for (uint16_t low : other.array) {
+            if (target.contains(low)) {
+                result.push_back(low);
+            }
+        }
+        target.bits.clear();
+        target.bits.shrink_to_fit();
+        target.array = std::move(result);
+    } else if (other.isBitmap()) {
+        target.array.erase(std::remove_if(target.array.begin(), target.array.end(),
+                                          [&other](uint16_t low) { return !other.contains(low); }),
+                           target.array.end());
+    } else {
+        std::vector<uint16_t> result;
+        result.reserve(std::min(target.array.size(), other.array.size()));
+        std::set_intersection(target.array.begin(), target.array.end(), other.array.begin(), other.array.end(),
+                              std::back_inserter(result));
+        target.array = std::move(result);
+    }
+    target.cardinality = static_cast<uint32_t>(target.array.size());
+}
+
+void RoaringBitmap::subtract(Container& target, const Container& other) {
+    if (target.isBitmap()) {
+        uint32_t cardinality = 0;
+        if (other.isBitmap()) {
+            for (size_t i = 0; i < kBitmapWords; ++i) {
+                target.bits[i] &= ~other.bits[i];
+                cardinality += static_cast<uint32_t>(std::popcount(target.bits[i]));
+            }
+        } else {
+            for (uint16_t low : other.array) {
+                target.bits[low >> 6] &= ~(uint64_t{1} << (low & 63));
+            }
+            for (size_t i = 0; i < kBitmapWords; ++i) {
+                cardinality += static_cast<uint32_t>(std::popcount(target.bits[i]));
+            }
+        }
+        target.cardinality = cardinality;
+        target.toArrayIfSparse();
+        return;
+    }
+
+    if (other.isBitmap()) {
+        target.array.erase(std::remove_if(target.array.begin(), target.array.end(),
+                                          [&other](uint16_t low) { return other.contains(low); }),
+                           target.array.end());
+    } else {
+        std::vector<uint16_t> result;
+        result.reserve(target.array.size());
+        std::set_difference(target.array.begin(), target.array.end(), other.array.begin(), other.array.end(),
+                            std::back_inserter(result));
+        target.array = std::move(result);
+    }
+    target.cardinality = static_cast<uint32_t>(target.array.size());
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other) {
+    std::vector<Container> result;
+    auto it = other.containers_.begin();
+    for (auto& container : containers_) {
+        while (it != other.containers_.end() && it->key < container.key) {
+            ++it;
+        }
+        if (it == other.containers_.end()) {
+            break;
+        }
+        if (it->key == container.key) {
+            intersect(container, *it);
+            if (container.cardinality > 0) {
+                result.push_back(std::move(container));
+            }
+        }
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::andNot(const RoaringBitmap& other) {
+    auto it = other.containers_.begin();
+    for (auto& container : containers_) {
+        while (it != other.containers_.end() && it->key < container.key) {
+            ++it;
+        }
+        if (it != other.containers_.end() && it->key == container.key) {
+            subtract(container, *it);
+        }
+    }
+    containers_.erase(std::remove_if(containers_.begin(), containers_.end(),
+                                     [](const Container& c) { return c.cardinality == 0; }),
+                      containers_.end());
+    return *this;
+}
+
+std::vector<uint32_t> RoaringBitmap::toVector() const {
+    std::vector<uint32_t> values;
+    values.reserve(static_cast<size_t>(cardinality()));
+    forEach([&values](uint32_t value) { values.push_back(value); });
+    return values;
+}
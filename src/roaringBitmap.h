@@ -0,0 +1,74 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed bitmap of 32-bit ordinals (roaring layout).
+// Values are partitioned by their high 16 bits into containers; each container stores the low 16 bits
+// either as a sorted array (sparse, <= 4096 values) or as a 65536-bit bitmap (dense). Bitmap/bitmap
+// AND and ANDNOT run as straight loops over 64-bit words, which the compiler vectorizes.
+class RoaringBitmap {
+public:
+    void add(uint32_t value);
+    bool remove(uint32_t value);
+    bool contains(uint32_t value) const;
+    uint64_t cardinality() const;
+    bool empty() const { return containers_.empty(); }
+    void clear() { containers_.clear(); }
+
+    // In-place intersection / difference
+    RoaringBitmap& operator&=(const RoaringBitmap& other);
+    RoaringBitmap& andNot(const RoaringBitmap& other);
+
+    // Invoke fn(value) for every value in ascending order
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& container : containers_) {
+            uint32_t high = static_cast<uint32_t>(container.key) << 16;
+            if (container.isBitmap()) {
+                for (size_t word = 0; word < kBitmapWords; ++word) {
+                    uint64_t bits = container.bits[word];
+                    while (bits) {
+                        unsigned bit = static_cast<unsigned>(std::countr_zero(bits));
+                        fn(high | static_cast<uint32_t>(word * 64 + bit));
+                        bits &= bits - 1;
+                    }
+                }
+            } else {
+                for (uint16_t low : container.array) {
+                    fn(high | low);
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> toVector() const;
+
+private:
+    static constexpr size_t kArrayMaxSize = 4096;
+    static constexpr size_t kBitmapWords = 65536 / 64;
+
+    struct Container {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> array;  // Sorted low bits while sparse
+        std::vector<uint64_t> bits;   // kBitmapWords words once dense
+
+        bool isBitmap() const { return !bits.empty(); }
+        bool contains(uint16_t low) const;
+        void toBitmap();
+        void toArrayIfSparse();
+    };
+
+    std::vector<Container> containers_; // Sorted by key
+
+    Container* find(uint16_t key);
+    const Container* find(uint16_t key) const;
+    static void intersect(Container& target, const Container& other);
+    static void subtract(Container& target, const Container& other);
+};
+
+#endif // ROARING_BITMAP_H
@@ -0,0 +1,145 @@
+#include "schemaMigrator.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+bool exec(sqlite3* db, const std::string& sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Migration failed to execute \"" << sql << "\": " << (errMsg ? errMsg : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int SchemaMigrator::version(sqlite3* db) {
+    sqlite3_stmt* stmt = nullptr;
+    int value = -1;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        value = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+int SchemaMigrator::latestVersion(const std::vector<Migration>& migrations) {
+    return migrations.empty() ? 0 : migrations.back().version;
+}
+
+bool SchemaMigrator::migrate(sqlite3* db, const std::string& name, const std::vector<Migration>& migrations) {
+    return migrate(db, name, migrations, Options{});
+}
+
+bool SchemaMigrator::migrate(sqlite3* db, const std::string& name, const std::vector<Migration>& migrations,
+                             const Options& options) {
+    for (size_t i = 1; i < migrations.size(); ++i) {
+        if (migrations[i].version <= migrations[i - 1].version) {
+            std::cerr << "Migrations for " << name << " are out of order at version " << migrations[i].version << std::endl;
+            return false;
+        }
+    }
+    int current = version(db);
+    if (current < 0) {
+        std::cerr << "Failed to read the " << name << " schema version: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    int latest = latestVersion(migrations);
+    if (current >= latest) {
+        if (current > latest) {
+            std::cerr << "Warning: " << name << " database is at schema version " << current
+                      << ", newer than this build knows (" << latest << ")" << std::endl;
+        }
+        return true;
+    }
+
+    for (const auto& migration : migrations) {
+        if (migration.version <= current) {
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = migration.backfillTable ? backfill(db, name, migration, options) && commitVersion(db, migration, false)
+                                          : commitVersion(db, migration, true);
+        if (!ok) {
+            std::cerr << "Failed to migrate the " << name << " database to version " << migration.version << " ("
+                      << migration.description << ")" << std::endl;
+            return false;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cerr << "Migrated the " << name << " database to version " << migration.version << ": "
+                  << migration.description << " (" << elapsed.count() << " ms)" << std::endl;
+        current = migration.version;
+    }
+    return true;
+}
+
+// Runs the migration's statements (unless a backfill already did its work) and bumps user_version, atomically
+bool SchemaMigrator::commitVersion(sqlite3* db, const Migration& migration, bool runSql) {
+    if (!exec(db, "BEGIN IMMEDIATE;")) {
+        return false;
+    }
+    if (version(db) >= migration.version) {
+        return exec(db, "COMMIT;");  // Another process got here first
+    }
+    bool ok = (!runSql || exec(db, migration.sql)) &&
+              exec(db, "PRAGMA user_version = " + std::to_string(migration.version) + ";") && exec(db, "COMMIT;");
+    if (!ok) {
+        exec(db, "ROLLBACK;");
+    }
+    return ok;
+}
+
+bool SchemaMigrator::backfill(sqlite3* db, const std::string& name, const Migration& migration, const Options& options) {
+    // Rows added while the backfill runs are written by code that already knows the new schema
+    sqlite3_stmt* stmt = nullptr;
+    std::string maxSql = std::string("SELECT COALESCE(MAX(rowid), 0) FROM ") + migration.backfillTable + ";";
+    if (sqlite3_prepare_v2(db, maxSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK || sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    sqlite3_int64 maxRowid = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+
+    if (sqlite3_prepare_v2(db, migration.sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    const sqlite3_int64 batch = static_cast<sqlite3_int64>(std::max<size_t>(options.backfillBatchRows, 1));
+    sqlite3_int64 changed = 0;
+    bool ok = true;
+    for (sqlite3_int64 low = 0; ok && low < maxRowid; low += batch) {
+        if (!exec(db, "BEGIN IMMEDIATE;")) {
+            ok = false;
+            break;
+        }
+        sqlite3_bind_int64(stmt, 1, low);
+        sqlite3_bind_int64(stmt, 2, low + batch);
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        }
+        if (rc != SQLITE_DONE) {
+            std::cerr << "Backfill of " << migration.backfillTable << " failed: " << sqlite3_errmsg(db) << std::endl;
+            ok = false;
+        }
+        changed += sqlite3_changes(db);
+        sqlite3_reset(stmt);
+        ok = ok && exec(db, "COMMIT;");
+        if (!ok) {
+            exec(db, "ROLLBACK;");
+        } else if (options.backfillPause.count() > 0) {
+            std::this_thread::sleep_for(options.backfillPause);
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (ok) {
+        std::cerr << "Backfilled " << changed << " " << name << "." << migration.backfillTable << " rows" << std::endl;
+    }
+    return ok;
+}
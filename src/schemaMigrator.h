@@ -0,0 +1,52 @@
+#ifndef SCHEMA_MIGRATOR_H
+#define SCHEMA_MIGRATOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct sqlite3;
+
+// Versioned schema changes keyed on PRAGMA user_version.
+// Migrations are applied in ascending version order, each in its own BEGIN IMMEDIATE transaction that
+// also bumps user_version, so a database is always at exactly one version and an interrupted upgrade
+// resumes where it stopped. Inside the transaction the version is read again, so two processes starting
+// against the same file apply each migration once.
+// A backfill migration rewrites existing rows in batches: its statement is run once per rowid range of
+// backfillTable (bound as ?1 < rowid <= ?2), each range committed on its own so readers and writers get
+// in between, and the version is bumped after the last range. Backfills must be idempotent: one cut
+// short is run again from the start.
+// Keep one schema change per migration. An index gets its own, so building it holds the write lock only
+// for the build (readers are not blocked in WAL mode).
+// A database that is already current costs one PRAGMA read.
+class SchemaMigrator {
+public:
+    struct Migration {
+        int version;
+        const char* description;
+        const char* sql;
+        const char* backfillTable = nullptr;  // Set for a batched backfill
+    };
+
+    struct Options {
+        size_t backfillBatchRows = 5000;
+        std::chrono::milliseconds backfillPause{0};  // Between backfill batches
+    };
+
+    // name labels log messages ("recipes", "users"); false if a migration failed, leaving the database
+    // at the last version that succeeded
+    static bool migrate(sqlite3* db, const std::string& name, const std::vector<Migration>& migrations);
+    static bool migrate(sqlite3* db, const std::string& name, const std::vector<Migration>& migrations,
+                        const Options& options);
+
+    // -1 if it cannot be read
+    static int version(sqlite3* db);
+    static int latestVersion(const std::vector<Migration>& migrations);
+
+private:
+    static bool backfill(sqlite3* db, const std::string& name, const Migration& migration, const Options& options);
+    static bool commitVersion(sqlite3* db, const Migration& migration, bool runSql);
+};
+
+#endif // SCHEMA_MIGRATOR_H
@@ -0,0 +1,228 @@
+#include "similarityIndex.h"
+#include "ingredientIndex.h"
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+uint64_t mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t fnv1a(std::string_view text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// One seed per hash function, fixed so signatures are stable across restarts
+const std::array<uint64_t, SimilarityIndex::kHashes>& hashSeeds() {
+    static const auto seeds = [] {
+        std::array<uint64_t, SimilarityIndex::kHashes> values{};
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = mix64(0x5eed0000ULL + i);
+        }
+        return values;
+    }();
+    return seeds;
+}
+
+} // namespace
+
+SimilarityIndex::Signature SimilarityIndex::signature(const std::vector<std::string>& terms) {
+    Signature minima;
+    minima.fill(UINT32_MAX);
+    const auto& seeds = hashSeeds();
+    for (const auto& term : terms) {
+        uint64_t base = fnv1a(term);
+        for (size_t i = 0; i < kHashes; ++i) {
+            minima[i] = std::min(minima[i], static_cast<uint32_t>(mix64(base ^ seeds[i]) >> 32));
+        }
+    }
+    return minima;
+}
+
+size_t SimilarityIndex::agreement(const uint32_t* a, const uint32_t* b) {
+    static_assert(kHashes % 4 == 0, "signatures are compared four lanes at a time");
+#if defined(__SSE2__)
+    // cmpeq yields -1 per agreeing lane; subtracting accumulates +1
+    __m128i counts = _mm_setzero_si128();
+    for (size_t i = 0; i < kHashes; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        counts = _mm_sub_epi32(counts, _mm_cmpeq_epi32(x, y));
+    }
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__ARM_NEON)
+    uint32x4_t counts = vdupq_n_u32(0);
+    for (size_t i = 0; i < kHashes; i += 4) {
+        counts = vsubq_u32(counts, vceqq_u32(vld1q_u32(a + i), vld1q_u32(b + i)));
+    }
+    uint32_t lanes[4];
+    vst1q_u32(lanes, counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#else
+    size_t count = 0;
+    for (size_t i = 0; i < kHashes; ++i) {
+        count += a[i] == b[i];
+    }
+    return count;
+#endif
+}
+
+uint64_t SimilarityIndex::bandKey(const uint32_t* signature, size_t band) {
+    uint64_t key = band;
+    for (size_t r = 0; r < kRowsPerBand; ++r) {
+        key = mix64(key ^ signature[band * kRowsPerBand + r]);
+    }
+    return key;
+}
+
+bool SimilarityIndex::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+size_t SimilarityIndex::size() const {
+    std::shared_lock lock(mutex_);
+    return ordinals_.size();
+}
+
+void SimilarityIndex::upsert(const std::string& id, std::string_view ingredients) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        upsertLocked(id, ingredients);
+    }
+}
+
+void SimilarityIndex::remove(const std::string& id) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        removeLocked(id);
+    }
+}
+
+void SimilarityIndex::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    signatures_.clear();
+    ids_.clear();
+    ordinals_.clear();
+    freeOrdinals_.clear();
+    for (auto& table : buckets_) {
+        table.clear();
+    }
+}
+
+void SimilarityIndex::upsertLocked(const std::string& id, std::string_view ingredients) {
+    removeLocked(id);
+    std::vector<std::string> terms = IngredientIndex::tokenize(ingredients);
+    if (terms.empty()) {
+        return; // Nothing to be similar on
+    }
+
+    uint32_t ordinal;
+    if (!freeOrdinals_.empty()) {
+        ordinal = freeOrdinals_.back();
+        freeOrdinals_.pop_back();
+        ids_[ordinal] = id;
+    } else {
+        ordinal = static_cast<uint32_t>(ids_.size());
+        ids_.push_back(id);
+        signatures_.resize(signatures_.size() + kHashes);
+    }
+    ordinals_.emplace(id, ordinal);
+
+    Signature minima = signature(terms);
+    uint32_t* row = signatures_.data() + static_cast<size_t>(ordinal) * kHashes;
+    std::copy(minima.begin(), minima.end(), row);
+    for (size_t band = 0; band < kBands; ++band) {
+        buckets_[band][bandKey(row, band)].push_back(ordinal);
+    }
+}
+
+void SimilarityIndex::removeLocked(const std::string& id) {
+    auto it = ordinals_.find(id);
+    if (it == ordinals_.end()) {
+        return;
+    }
+    uint32_t ordinal = it->second;
+    const uint32_t* row = signatures_.data() + static_cast<size_t>(ordinal) * kHashes;
+    for (size_t band = 0; band < kBands; ++band) {
+        auto bucket = buckets_[band].find(bandKey(row, band));
+        if (bucket == buckets_[band].end()) {
+            continue;
+        }
+        auto& members = bucket->second;
+        auto member = std::find(members.begin(), members.end(), ordinal);
+        if (member != members.end()) {
+            *member = members.back();
+            members.pop_back();
+        }
+        if (members.empty()) {
+            buckets_[band].erase(bucket);
+        }
+    }
+    ids_[ordinal].clear();
+    freeOrdinals_.push_back(ordinal);
+    ordinals_.erase(it);
+}
+
+std::vector<SimilarityIndex::Match> SimilarityIndex::similarTo(const std::string& recipeId, size_t limit,
+                                                               double minSimilarity) const {
+    std::shared_lock lock(mutex_);
+    std::vector<Match> matches;
+    auto it = ordinals_.find(recipeId);
+    if (it == ordinals_.end() || limit == 0) {
+        return matches;
+    }
+    const uint32_t self = it->second;
+    const uint32_t* query = signatures_.data() + static_cast<size_t>(self) * kHashes;
+
+    // Candidate generation: anything sharing at least one band bucket
+    std::vector<uint32_t> candidates;
+    for (size_t band = 0; band < kBands; ++band) {
+        auto bucket = buckets_[band].find(bandKey(query, band));
+        if (bucket != buckets_[band].end()) {
+            candidates.insert(candidates.end(), bucket->second.begin(), bucket->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Rerank on the full signatures
+    std::vector<std::pair<uint32_t, uint32_t>> scored;  // (agreeing positions, ordinal)
+    scored.reserve(candidates.size());
+    for (uint32_t candidate : candidates) {
+        if (candidate == self) {
+            continue;
+        }
+        size_t agree = agreement(query, signatures_.data() + static_cast<size_t>(candidate) * kHashes);
+        if (static_cast<double>(agree) / kHashes >= minSimilarity) {
+            scored.emplace_back(static_cast<uint32_t>(agree), candidate);
+        }
+    }
+
+    auto ranksAhead = [this](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : ids_[a.second] < ids_[b.second];
+    };
+    size_t kept = std::min(limit, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + kept, scored.end(), ranksAhead);
+    for (size_t i = 0; i < kept; ++i) {
+        matches.push_back({ids_[scored[i].second], static_cast<double>(scored[i].first) / kHashes});
+    }
+    return matches;
+}
@@ -0,0 +1,87 @@
+#ifndef SIMILARITY_INDEX_H
+#define SIMILARITY_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Finds recipes with similar ingredient sets without comparing against every recipe.
+// Each recipe's ingredient terms (IngredientIndex::tokenize) are summarized by a MinHash signature of
+// kHashes 32-bit minima. The signature is cut into kBands bands of kRowsPerBand values, and each band
+// is hashed into its own bucket table (LSH): two recipes become candidates when any band matches,
+// which happens with high probability above a Jaccard similarity of about (1/kBands)^(1/kRowsPerBand)
+// (0.125 here: recipes share few ingredients, so pairs around 0.3 must still be found reliably).
+// Candidates are reranked by comparing full signatures with SIMD, and the fraction of agreeing
+// positions estimates their Jaccard similarity.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class SimilarityIndex {
+public:
+    static constexpr size_t kHashes = 128;
+    static constexpr size_t kBands = 64;
+    static constexpr size_t kRowsPerBand = kHashes / kBands;
+
+    using Signature = std::array<uint32_t, kHashes>;
+
+    struct Match {
+        std::string recipeId;
+        double similarity;  // Estimated Jaccard similarity of the ingredient sets
+    };
+
+    static Signature signature(const std::vector<std::string>& terms);
+    // Positions where both signatures agree (vectorized)
+    static size_t agreement(const uint32_t* a, const uint32_t* b);
+
+    bool isBuilt() const;
+
+    // Build once from loadRows() -> vector<pair<id, ingredients>>; no-op if already built
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadRows) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (built_) {
+            return;
+        }
+        for (const auto& [id, ingredients] : loadRows()) {
+            upsertLocked(id, ingredients);
+        }
+        built_ = true;
+    }
+
+    // Incremental maintenance; ignored until the index has been built
+    void upsert(const std::string& id, std::string_view ingredients);
+    void remove(const std::string& id);
+    void invalidate();
+
+    // Most similar recipes to recipeId (excluding itself), best first; empty if the recipe is unknown
+    std::vector<Match> similarTo(const std::string& recipeId, size_t limit, double minSimilarity = 0.0) const;
+
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    std::vector<uint32_t> signatures_;  // Row-major, kHashes values per ordinal
+    std::vector<std::string> ids_;      // ordinal -> recipe id ("" once deleted)
+    std::unordered_map<std::string, uint32_t> ordinals_;
+    std::vector<uint32_t> freeOrdinals_;
+    std::array<std::unordered_map<uint64_t, std::vector<uint32_t>>, kBands> buckets_;
+
+    void upsertLocked(const std::string& id, std::string_view ingredients);
+    void removeLocked(const std::string& id);
+    static uint64_t bandKey(const uint32_t* signature, size_t band);
+};
+
+#endif // SIMILARITY_INDEX_H
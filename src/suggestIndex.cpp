@@ -0,0 +1,302 @@
+#include "suggestIndex.h"
+#include "ingredientIndex.h"
+#include "titleIndex.h"
+#include <algorithm>
+#include <queue>
+#include <unordered_set>
+
+namespace {
+
+// Trims surrounding whitespace from the display form
+std::string_view trimmed(std::string_view text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+} // namespace
+
+const char* SuggestIndex::kindName(Kind kind) {
+    switch (kind) {
+        case Kind::Title: return "title";
+        case Kind::Category: return "category";
+        case Kind::Ingredient: return "ingredient";
+    }
+    return "";
+}
+
+bool SuggestIndex::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+size_t SuggestIndex::nodeCount() const {
+    std::shared_lock lock(mutex_);
+    return nodes_.size();
+}
+
+void SuggestIndex::upsert(const Document& document) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        upsertLocked(document);
+    }
+}
+
+void SuggestIndex::remove(const std::string& recipeId) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        removeLocked(recipeId);
+    }
+}
+
+void SuggestIndex::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    nodes_.assign(1, Node{});
+    entries_.clear();
+    entryIds_.clear();
+    recipeEntries_.clear();
+}
+
+void SuggestIndex::buildLocked(const std::vector<Document>& documents) {
+    // Count first and settle the trie annotations in one pass, instead of walking to the root per increment
+    for (const auto& document : documents) {
+        auto previous = recipeEntries_.find(document.recipeId);
+        if (previous != recipeEntries_.end()) {
+            for (uint32_t id : previous->second) {
+                --entries_[id].weight;
+            }
+        }
+        std::vector<uint32_t> ids = entriesForLocked(document);
+        for (uint32_t id : ids) {
+            ++entries_[id].weight;
+        }
+        recipeEntries_[document.recipeId] = std::move(ids);
+    }
+
+    // Children are always created after their parent, so a reverse sweep sees every subtree first
+    for (size_t i = nodes_.size(); i-- > 0;) {
+        Node& node = nodes_[i];
+        for (auto& [entryId, weight] : node.entries) {
+            weight = entries_[entryId].weight;
+        }
+        std::stable_sort(node.entries.begin(), node.entries.end(),
+                         [](const auto& a, const auto& b) { return a.second > b.second; });
+        uint32_t best = node.entries.empty() ? 0 : node.entries.front().second;
+        for (const auto& [c, child] : node.children) {
+            best = std::max(best, nodes_[child].best);
+        }
+        node.best = best;
+    }
+    built_ = true;
+}
+
+std::vector<uint32_t> SuggestIndex::entriesForLocked(const Document& document) {
+    std::vector<uint32_t> ids;
+    std::string title = TitleIndex::normalize(document.title);
+    if (!title.empty()) {
+        ids.push_back(entryLocked(Kind::Title, title, trimmed(document.title)));
+    }
+    std::string category = TitleIndex::normalize(document.category);
+    if (!category.empty()) {
+        ids.push_back(entryLocked(Kind::Category, category, trimmed(document.category)));
+    }
+    for (const auto& term : IngredientIndex::tokenize(document.ingredients)) {
+        ids.push_back(entryLocked(Kind::Ingredient, term, term));
+    }
+    return ids;
+}
+
+void SuggestIndex::upsertLocked(const Document& document) {
+    removeLocked(document.recipeId);
+    std::vector<uint32_t> ids = entriesForLocked(document);
+    for (uint32_t id : ids) {
+        addWeightLocked(id, 1);
+    }
+    recipeEntries_[document.recipeId] = std::move(ids);
+}
+
+void SuggestIndex::removeLocked(const std::string& recipeId) {
+    auto it = recipeEntries_.find(recipeId);
+    if (it == recipeEntries_.end()) {
+        return;
+    }
+    for (uint32_t id : it->second) {
+        addWeightLocked(id, -1);
+    }
+    recipeEntries_.erase(it);
+}
+
+uint32_t SuggestIndex::entryLocked(Kind kind, const std::string& key, std::string_view display) {
+    std::string mapKey(1, static_cast<char>(kind));
+    mapKey += key;
+    auto [it, inserted] = entryIds_.emplace(std::move(mapKey), static_cast<uint32_t>(entries_.size()));
+    if (!inserted) {
+        return it->second;
+    }
+
+    uint32_t entryId = it->second;
+    entries_.push_back(Entry{std::string(display), kind, 0, {}});
+    // Reachable from the start of every word, so "chip" also suggests "Chocolate Chip Cookies"
+    size_t start = 0;
+    while (true) {
+        uint32_t node = insertKeyLocked(std::string_view(key).substr(start));
+        nodes_[node].entries.emplace_back(entryId, 0);
+        entries_[entryId].terminals.push_back(node);
+        size_t space = key.find(' ', start);
+        if (space == std::string::npos) {
+            break;
+        }
+        start = space + 1;
+    }
+    return entryId;
+}
+
+uint32_t SuggestIndex::insertKeyLocked(std::string_view key) {
+    uint32_t node = 0;
+    for (char c : key) {
+        auto& children = nodes_[node].children;
+        auto child = std::lower_bound(children.begin(), children.end(), c,
+                                      [](const auto& edge, char value) { return edge.first < value; });
+        if (child != children.end() && child->first == c) {
+            node = child->second;
+            continue;
+        }
+        uint32_t next = static_cast<uint32_t>(nodes_.size());
+        children.insert(child, {c, next});
+        nodes_.push_back(Node{});  // May reallocate; `children` is not used past this point
+        nodes_[next].parent = node;
+        nodes_[next].depth = nodes_[node].depth + 1;
+        node = next;
+    }
+    return node;
+}
+
+void SuggestIndex::addWeightLocked(uint32_t entryId, int delta) {
+    Entry& entry = entries_[entryId];
+    uint32_t oldWeight = entry.weight;
+    entry.weight = static_cast<uint32_t>(static_cast<int64_t>(oldWeight) + delta);
+
+    for (uint32_t node : entry.terminals) {
+        // Keep the node's list sorted by swapping with the edge of the old weight's run
+        auto& entries = nodes_[node].entries;
+        auto slot = std::find_if(entries.begin(), entries.end(), [entryId](const auto& e) { return e.first == entryId; });
+        auto heavierFirst = [](const auto& e, uint32_t weight) { return e.second > weight; };
+        auto lighter = [](uint32_t weight, const auto& e) { return weight > e.second; };
+        auto edge = entry.weight > oldWeight
+                        ? std::lower_bound(entries.begin(), slot, oldWeight, heavierFirst)
+                        : std::prev(std::upper_bound(slot, entries.end(), oldWeight, lighter));
+        std::iter_swap(slot, edge);
+        edge->second = entry.weight;
+        refreshLocked(node);
+    }
+}
+
+void SuggestIndex::refreshLocked(uint32_t node) {
+    // Recompute subtree maxima up to the root, stopping once an ancestor is unaffected
+    while (node != kNoNode) {
+        Node& current = nodes_[node];
+        uint32_t best = current.entries.empty() ? 0 : current.entries.front().second;
+        for (const auto& [c, child] : current.children) {
+            best = std::max(best, nodes_[child].best);
+        }
+        if (best == current.best) {
+            return;
+        }
+        current.best = best;
+        node = current.parent;
+    }
+}
+
+uint32_t SuggestIndex::findLocked(std::string_view prefix) const {
+    uint32_t node = 0;
+    for (char c : prefix) {
+        const auto& children = nodes_[node].children;
+        auto child = std::lower_bound(children.begin(), children.end(), c,
+                                      [](const auto& edge, char value) { return edge.first < value; });
+        if (child == children.end() || child->first != c) {
+            return kNoNode;
+        }
+        node = child->second;
+    }
+    return node;
+}
+
+std::vector<SuggestIndex::Suggestion> SuggestIndex::suggest(std::string_view prefix, size_t limit) const {
+    std::vector<Suggestion> suggestions;
+    std::string key = TitleIndex::normalize(prefix);
+    if (key.empty() || limit == 0) {
+        return suggestions;
+    }
+
+    std::shared_lock lock(mutex_);
+    uint32_t start = findLocked(key);
+    if (start == kNoNode || nodes_[start].best == 0) {
+        return suggestions;
+    }
+
+    // Best-first over subtrees and per-node entry lists. A node's entries are consumed through a cursor,
+    // since common title endings ("... cake") can list thousands of them. At equal weight, entries are
+    // emitted before any subtree is expanded and deeper subtrees go first, so a tier of equally weighted
+    // suggestions is walked depth-first instead of being expanded in full.
+    struct Item {
+        uint32_t weight;
+        uint32_t node;
+        uint32_t cursor;  // Position in the node's entries, or kNoNode to expand the node itself
+    };
+    auto after = [this](const Item& a, const Item& b) {
+        if (a.weight != b.weight) {
+            return a.weight < b.weight;
+        }
+        bool aEntry = a.cursor != kNoNode;
+        bool bEntry = b.cursor != kNoNode;
+        if (aEntry != bEntry) {
+            return bEntry;
+        }
+        if (!aEntry) {
+            uint32_t depthA = nodes_[a.node].depth;
+            uint32_t depthB = nodes_[b.node].depth;
+            return depthA != depthB ? depthA < depthB : a.node > b.node;
+        }
+        const Entry& x = entries_[nodes_[a.node].entries[a.cursor].first];
+        const Entry& y = entries_[nodes_[b.node].entries[b.cursor].first];
+        if (x.text.size() != y.text.size()) {
+            return x.text.size() > y.text.size();
+        }
+        return x.text > y.text;
+    };
+    std::priority_queue<Item, std::vector<Item>, decltype(after)> frontier(after);
+    frontier.push({nodes_[start].best, start, kNoNode});
+
+    std::unordered_set<uint32_t> emitted;
+    while (!frontier.empty() && suggestions.size() < limit) {
+        Item item = frontier.top();
+        frontier.pop();
+        const Node& node = nodes_[item.node];
+        if (item.cursor != kNoNode) {
+            // Titles are listed under each word, so the same entry can surface more than once
+            uint32_t entryId = node.entries[item.cursor].first;
+            if (emitted.insert(entryId).second) {
+                const Entry& entry = entries_[entryId];
+                suggestions.push_back({entry.text, entry.kind, entry.weight});
+            }
+            uint32_t next = item.cursor + 1;
+            if (next < node.entries.size() && node.entries[next].second > 0) {
+                frontier.push({node.entries[next].second, item.node, next});
+            }
+            continue;
+        }
+        if (!node.entries.empty() && node.entries.front().second > 0) {
+            frontier.push({node.entries.front().second, item.node, 0});
+        }
+        for (const auto& [c, child] : node.children) {
+            if (nodes_[child].best > 0) {
+                frontier.push({nodes_[child].best, child, kNoNode});
+            }
+        }
+    }
+    return suggestions;
+}
@@ -0,0 +1,103 @@
+#ifndef SUGGEST_INDEX_H
+#define SUGGEST_INDEX_H
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Prefix autocomplete over recipe titles, categories and ingredient names.
+// Suggestions live in a byte trie stored as a flat node arena. Every node caches the best weight in its
+// subtree and keeps its own suggestions sorted by weight, so a top-K query descends to the prefix node
+// and then runs a best-first walk that only visits branches able to beat the current K-th result. Titles are reachable from the start of any of their
+// words ("carb" -> "Pasta Carbonara"). A suggestion's weight is the number of recipes using it and is
+// kept current on every write by walking the affected paths back to the root.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class SuggestIndex {
+public:
+    enum class Kind : uint8_t { Title, Category, Ingredient };
+
+    struct Document {
+        std::string recipeId;
+        std::string title;
+        std::string category;
+        std::string ingredients;
+    };
+
+    struct Suggestion {
+        std::string text;
+        Kind kind;
+        uint32_t weight;  // Recipes using this suggestion
+    };
+
+    static const char* kindName(Kind kind);
+
+    bool isBuilt() const;
+
+    // Build once from loadDocuments() -> vector<Document>; no-op if already built
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadDocuments) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (built_) {
+            return;
+        }
+        buildLocked(loadDocuments());
+    }
+
+    // Incremental maintenance; ignored until the index has been built
+    void upsert(const Document& document);
+    void remove(const std::string& recipeId);
+    void invalidate();
+
+    // Up to `limit` suggestions starting with prefix (case-insensitive), heaviest first
+    std::vector<Suggestion> suggest(std::string_view prefix, size_t limit = 10) const;
+
+    size_t nodeCount() const;
+
+private:
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+
+    struct Node {
+        uint32_t parent = kNoNode;
+        uint32_t depth = 0;
+        uint32_t best = 0;                              // Max entry weight in this subtree
+        std::vector<std::pair<char, uint32_t>> children; // Sorted by byte
+        std::vector<std::pair<uint32_t, uint32_t>> entries; // (entry, weight) ending here, heaviest first
+    };
+
+    struct Entry {
+        std::string text;  // Display form (first spelling seen)
+        Kind kind;
+        uint32_t weight = 0;
+        std::vector<uint32_t> terminals;  // Nodes listing this entry
+    };
+
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    std::vector<Node> nodes_{Node{}};  // nodes_[0] is the root
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, uint32_t> entryIds_;                      // kind + normalized text -> entry
+    std::unordered_map<std::string, std::vector<uint32_t>> recipeEntries_;    // recipe -> entries it counts toward
+
+    void buildLocked(const std::vector<Document>& documents);
+    std::vector<uint32_t> entriesForLocked(const Document& document);
+    void upsertLocked(const Document& document);
+    void removeLocked(const std::string& recipeId);
+    uint32_t entryLocked(Kind kind, const std::string& key, std::string_view display);
+    uint32_t insertKeyLocked(std::string_view key);
+    void addWeightLocked(uint32_t entryId, int delta);
+    void refreshLocked(uint32_t node);
+    uint32_t findLocked(std::string_view prefix) const;
+};
+
+#endif // SUGGEST_INDEX_H
@@ -0,0 +1,209 @@
+#include "textCompressor.h"
+#include <sqlite3.h>
+#include <zdict.h>
+#include <zstd.h>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+// Compression state is reused across calls on the same thread; it holds nothing between them
+struct ContextDeleter {
+    void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+    void operator()(ZSTD_DCtx* context) const { ZSTD_freeDCtx(context); }
+};
+
+ZSTD_CCtx* compressionContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, ContextDeleter> context(ZSTD_createCCtx());
+    return context.get();
+}
+
+ZSTD_DCtx* decompressionContext() {
+    thread_local std::unique_ptr<ZSTD_DCtx, ContextDeleter> context(ZSTD_createDCtx());
+    return context.get();
+}
+
+void unpackText(sqlite3_context* context, int, sqlite3_value** argv) {
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+    auto* compressor = static_cast<TextCompressor*>(sqlite3_user_data(context));
+    std::string_view frame(static_cast<const char*>(sqlite3_value_blob(argv[0])),
+                           static_cast<size_t>(sqlite3_value_bytes(argv[0])));
+    std::optional<std::string> text = compressor->decompress(frame);
+    if (!text && compressor->load(sqlite3_context_db_handle(context))) {
+        text = compressor->decompress(frame);
+    }
+    if (!text) {
+        sqlite3_result_error(context, "unpack_text: corrupt frame or unknown dictionary", -1);
+        return;
+    }
+    sqlite3_result_text(context, text->data(), static_cast<int>(text->size()), SQLITE_TRANSIENT);
+}
+
+} // namespace
+
+struct TextCompressor::Dictionary {
+    unsigned id = 0;
+    ZSTD_CDict* compress = nullptr;
+    ZSTD_DDict* decompress = nullptr;
+
+    ~Dictionary() {
+        ZSTD_freeCDict(compress);
+        ZSTD_freeDDict(decompress);
+    }
+};
+
+TextCompressor::TextCompressor(std::string table) : table_(std::move(table)) {}
+TextCompressor::~TextCompressor() = default;
+
+std::string TextCompressor::train(const std::vector<std::string>& samples, size_t capacity) {
+    std::string buffer;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer += sample;
+        sizes.push_back(sample.size());
+    }
+    std::string dictionary(capacity, '\0');
+    size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(), sizes.data(),
+                                        static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        std::cerr << "Failed to train compression dictionary: " << ZDICT_getErrorName(size) << std::endl;
+        return "";
+    }
+    dictionary.resize(size);
+    return dictionary;
+}
+
+bool TextCompressor::load(sqlite3* db) {
+    const std::string sql = "SELECT dict_id, dictionary FROM " + table_ + " ORDER BY version;";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    bool ok = true;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        auto id = static_cast<unsigned>(sqlite3_column_int64(stmt, 0));
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            auto it = dictionaries_.find(id);
+            if (it != dictionaries_.end()) {
+                current_ = it->second.get();
+                continue;
+            }
+        }
+        std::string_view dictionary(static_cast<const char*>(sqlite3_column_blob(stmt, 1)),
+                                    static_cast<size_t>(sqlite3_column_bytes(stmt, 1)));
+        ok = addDictionary(dictionary) && ok;
+    }
+    sqlite3_finalize(stmt);
+    return ok && rc == SQLITE_DONE;
+}
+
+int TextCompressor::save(sqlite3* db, std::string_view dictionary, size_t samples) {
+    unsigned id = dictionaryId(dictionary);
+    if (id == 0) {
+        return 0;
+    }
+    const std::string sql = "INSERT INTO " + table_ + " (dict_id, dictionary, samples) VALUES (?, ?, ?);";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return 0;
+    }
+    sqlite3_bind_int64(stmt, 1, id);
+    sqlite3_bind_blob(stmt, 2, dictionary.data(), static_cast<int>(dictionary.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(samples));
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to save compression dictionary: " << sqlite3_errmsg(db) << std::endl;
+        return 0;
+    }
+    return static_cast<int>(sqlite3_last_insert_rowid(db));
+}
+
+unsigned TextCompressor::dictionaryId(std::string_view dictionary) {
+    return ZDICT_getDictID(dictionary.data(), dictionary.size());
+}
+
+bool TextCompressor::addDictionary(std::string_view dictionary, bool makeCurrent) {
+    unsigned id = dictionaryId(dictionary);
+    if (id == 0) {
+        return false;
+    }
+    auto loaded = std::make_unique<Dictionary>();
+    loaded->id = id;
+    loaded->compress = ZSTD_createCDict(dictionary.data(), dictionary.size(), kLevel);
+    loaded->decompress = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    if (!loaded->compress || !loaded->decompress) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& slot = dictionaries_[id];
+    if (!slot) {
+        slot = std::move(loaded);
+    }
+    if (makeCurrent) {
+        current_ = slot.get();
+    }
+    return true;
+}
+
+unsigned TextCompressor::currentDictionaryId() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return current_ ? current_->id : 0;
+}
+
+std::optional<std::string> TextCompressor::compress(std::string_view text) const {
+    if (text.size() < kMinLength || text.size() > kMaxLength) {
+        return std::nullopt;
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!current_) {
+        return std::nullopt;
+    }
+    std::string frame(ZSTD_compressBound(text.size()), '\0');
+    size_t size = ZSTD_compress_usingCDict(compressionContext(), frame.data(), frame.size(), text.data(), text.size(),
+                                           current_->compress);
+    if (ZSTD_isError(size) || size >= text.size()) {
+        return std::nullopt;
+    }
+    frame.resize(size);
+    return frame;
+}
+
+std::optional<std::string> TextCompressor::decompress(std::string_view frame) const {
+    unsigned long long size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN || size > kMaxLength) {
+        return std::nullopt;
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = dictionaries_.find(ZSTD_getDictID_fromFrame(frame.data(), frame.size()));
+    if (it == dictionaries_.end()) {
+        return std::nullopt;
+    }
+    std::string text(static_cast<size_t>(size), '\0');
+    size_t written = ZSTD_decompress_usingDDict(decompressionContext(), text.data(), text.size(), frame.data(),
+                                                frame.size(), it->second->decompress);
+    if (ZSTD_isError(written) || written != text.size()) {
+        return std::nullopt;
+    }
+    return text;
+}
+
+bool TextCompressor::registerSqlFunction(sqlite3* db) {
+    // Deterministic: a dictionary id always names the same dictionary
+    int rc = sqlite3_create_function_v2(db, "unpack_text", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC, this, unpackText,
+                                        nullptr, nullptr, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to register unpack_text: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef TEXT_COMPRESSOR_H
+#define TEXT_COMPRESSOR_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct sqlite3;
+
+// zstd compression of short, repetitive text (recipe ingredients and instructions) against dictionaries
+// trained on the corpus. A frame names the dictionary it was compressed with, so every dictionary that
+// ever compressed a stored row is kept in the database, in a table with the columns
+// "version INTEGER PRIMARY KEY AUTOINCREMENT, dict_id INTEGER NOT NULL UNIQUE, dictionary BLOB NOT NULL,
+// samples INTEGER NOT NULL"; writes use the newest one. Without any dictionary compress() declines and
+// text is stored as is. Safe to share between threads.
+class TextCompressor {
+public:
+    static constexpr size_t kDictionaryBytes = 16 * 1024;
+    static constexpr size_t kMinLength = 64;          // Shorter text rarely shrinks enough to pay for the frame
+    static constexpr size_t kMaxLength = 64 * 1024;   // Largest text decompress() will produce
+    static constexpr int kLevel = 9;
+
+    explicit TextCompressor(std::string table);
+    ~TextCompressor();
+
+    TextCompressor(const TextCompressor&) = delete;
+    TextCompressor& operator=(const TextCompressor&) = delete;
+
+    // Dictionary trained on samples, "" if zstd could not train one (too few or too small samples)
+    static std::string train(const std::vector<std::string>& samples, size_t capacity = kDictionaryBytes);
+    // zstd's id for a dictionary, 0 if it is not one
+    static unsigned dictionaryId(std::string_view dictionary);
+
+    // Loads the dictionaries db has and this compressor does not; the newest version becomes current
+    bool load(sqlite3* db);
+    // Saves a trained dictionary as the next version and returns that version, 0 on failure. It is not
+    // used until load() runs after the enclosing transaction, if any, has committed.
+    int save(sqlite3* db, std::string_view dictionary, size_t samples);
+
+    // Loads a dictionary; with makeCurrent, compress() uses it from now on. false if it is not a dictionary.
+    bool addDictionary(std::string_view dictionary, bool makeCurrent = true);
+    unsigned currentDictionaryId() const;  // 0 when there is none
+
+    // Frame for text if compressing it saves space, otherwise nullopt
+    std::optional<std::string> compress(std::string_view text) const;
+    // nullopt for a corrupt frame or one whose dictionary is not loaded
+    std::optional<std::string> decompress(std::string_view frame) const;
+
+    // Registers unpack_text(frame) on db, decompressing through this compressor, which must outlive db.
+    // A frame from a dictionary another process saved since load() makes it load again.
+    bool registerSqlFunction(sqlite3* db);
+
+private:
+    struct Dictionary;
+
+    std::string table_;
+    mutable std::shared_mutex mutex_;
+    std::map<unsigned, std::unique_ptr<Dictionary>> dictionaries_;  // By zstd dictionary id
+    const Dictionary* current_ = nullptr;
+};
+
+#endif // TEXT_COMPRESSOR_H
@@ -0,0 +1,172 @@
+#include "titleIndex.h"
+#include <algorithm>
+#include <cctype>
+
+std::string TitleIndex::normalize(std::string_view title) {
+    std::string normalized;
+    normalized.reserve(title.size());
+    bool pendingSpace = false;
+    for (char ch : title) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        // Bytes >= 0x80 belong to UTF-8 letters and are kept verbatim
+        if (std::isalnum(c) || c >= 0x80) {
+            if (pendingSpace && !normalized.empty()) {
+                normalized += ' ';
+            }
+            pendingSpace = false;
+            normalized += static_cast<char>(std::tolower(c));
+        } else {
+            pendingSpace = true;
+        }
+    }
+    return normalized;
+}
+
+std::vector<uint32_t> TitleIndex::trigrams(std::string_view title) {
+    std::string normalized = normalize(title);
+    std::vector<uint32_t> grams;
+
+    size_t start = 0;
+    while (start < normalized.size()) {
+        size_t end = normalized.find(' ', start);
+        if (end == std::string::npos) {
+            end = normalized.size();
+        }
+        // Two leading pads and one trailing pad, as in pg_trgm, so word starts weigh more than ends
+        std::string padded = "  " + normalized.substr(start, end - start) + " ";
+        for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+            grams.push_back(static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16 |
+                            static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8 |
+                            static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 2])));
+        }
+        start = end + 1;
+    }
+
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+bool TitleIndex::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+void TitleIndex::upsert(const std::string& id, std::string_view title) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        upsertLocked(id, title);
+    }
+}
+
+void TitleIndex::remove(const std::string& id) {
+    std::unique_lock lock(mutex_);
+    auto it = ordinals_.find(id);
+    if (!built_ || it == ordinals_.end()) {
+        return;
+    }
+    uint32_t ordinal = it->second;
+    removeGramsLocked(ordinal);
+    ids_[ordinal].clear();
+    freeOrdinals_.push_back(ordinal);
+    ordinals_.erase(it);
+}
+
+void TitleIndex::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    postings_.clear();
+    ordinals_.clear();
+    ids_.clear();
+    grams_.clear();
+    freeOrdinals_.clear();
+}
+
+void TitleIndex::upsertLocked(const std::string& id, std::string_view title) {
+    uint32_t ordinal;
+    auto it = ordinals_.find(id);
+    if (it != ordinals_.end()) {
+        ordinal = it->second;
+        removeGramsLocked(ordinal);
+    } else if (!freeOrdinals_.empty()) {
+        ordinal = freeOrdinals_.back();
+        freeOrdinals_.pop_back();
+        ids_[ordinal] = id;
+        ordinals_.emplace(id, ordinal);
+    } else {
+        ordinal = static_cast<uint32_t>(ids_.size());
+        ids_.push_back(id);
+        grams_.emplace_back();
+        ordinals_.emplace(id, ordinal);
+    }
+
+    grams_[ordinal] = trigrams(title);
+    for (uint32_t gram : grams_[ordinal]) {
+        postings_[gram].add(ordinal);
+    }
+}
+
+void TitleIndex::removeGramsLocked(uint32_t ordinal) {
+    for (uint32_t gram : grams_[ordinal]) {
+        auto posting = postings_.find(gram);
+        if (posting != postings_.end()) {
+            posting->second.remove(ordinal);
+            if (posting->second.empty()) {
+                postings_.erase(posting);
+            }
+        }
+    }
+    grams_[ordinal].clear();
+}
+
+std::vector<TitleIndex::Match> TitleIndex::search(std::string_view query, size_t limit, double minScore) const {
+    std::vector<uint32_t> queryGrams = trigrams(query);
+    std::vector<Match> matches;
+    if (queryGrams.empty()) {
+        return matches;
+    }
+
+    std::shared_lock lock(mutex_);
+
+    // Candidate generation: only titles sharing at least one trigram are ever touched
+    std::vector<uint32_t> shared(ids_.size(), 0);
+    std::vector<uint32_t> candidates;
+    for (uint32_t gram : queryGrams) {
+        auto posting = postings_.find(gram);
+        if (posting == postings_.end()) {
+            continue;
+        }
+        posting->second.forEach([&shared, &candidates](uint32_t ordinal) {
+            if (shared[ordinal]++ == 0) {
+                candidates.push_back(ordinal);
+            }
+        });
+    }
+
+    const double queryCount = static_cast<double>(queryGrams.size());
+    for (uint32_t ordinal : candidates) {
+        double score = shared[ordinal] / queryCount;
+        if (score < minScore) {
+            continue;
+        }
+        double similarity = shared[ordinal] / (queryCount + grams_[ordinal].size() - shared[ordinal]);
+        matches.push_back({ids_[ordinal], score, similarity});
+    }
+
+    auto ranksAhead = [](const Match& a, const Match& b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        if (a.similarity != b.similarity) {
+            return a.similarity > b.similarity;
+        }
+        return a.recipeId < b.recipeId;
+    };
+    if (limit > 0 && matches.size() > limit) {
+        std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), ranksAhead);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), ranksAhead);
+    }
+    return matches;
+}
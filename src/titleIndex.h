@@ -0,0 +1,74 @@
+#ifndef TITLE_INDEX_H
+#define TITLE_INDEX_H
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "roaringBitmap.h"
+
+// Trigram index over normalized recipe titles for typo-tolerant search.
+// Titles are lowercased, split into words and padded ("  c", " ca", "car", ..., "ra "), and each trigram
+// maps to a RoaringBitmap of title ordinals. A query counts trigram overlap per candidate through the
+// postings and ranks by the fraction of query trigrams found in the title (so substrings score 1.0 and
+// "carbonera" still finds "Carbonara"), then by overall trigram similarity.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class TitleIndex {
+public:
+    struct Match {
+        std::string recipeId;
+        double score;       // Fraction of query trigrams present in the title
+        double similarity;  // Shared / union trigrams, used to break ties
+    };
+
+    static std::string normalize(std::string_view title);
+    static std::vector<uint32_t> trigrams(std::string_view title);
+
+    bool isBuilt() const;
+
+    // Build once from loadRows() -> vector<pair<id, title>>; no-op if already built
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadRows) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (built_) {
+            return;
+        }
+        for (const auto& [id, title] : loadRows()) {
+            upsertLocked(id, title);
+        }
+        built_ = true;
+    }
+
+    // Incremental maintenance; ignored until the index has been built
+    void upsert(const std::string& id, std::string_view title);
+    void remove(const std::string& id);
+    void invalidate();
+
+    // Titles scoring at least minScore, best first; limit 0 returns every match
+    std::vector<Match> search(std::string_view query, size_t limit = 0, double minScore = 0.5) const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    std::unordered_map<uint32_t, RoaringBitmap> postings_;
+    std::unordered_map<std::string, uint32_t> ordinals_;
+    std::vector<std::string> ids_;                 // ordinal -> recipe id ("" once deleted)
+    std::vector<std::vector<uint32_t>> grams_;     // ordinal -> title trigrams, for removal and scoring
+    std::vector<uint32_t> freeOrdinals_;
+
+    void upsertLocked(const std::string& id, std::string_view title);
+    void removeGramsLocked(uint32_t ordinal);
+};
+
+#endif // TITLE_INDEX_H
@@ -0,0 +1,136 @@
+#include "trendingIndex.h"
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+// Rebase before 2^exponent gets anywhere near the double range (about 1.4 years at a one-day half-life)
+constexpr double kMaxExponent = 512.0;
+// Rescaled scores below this are dropped when rebasing
+constexpr double kNegligibleScore = 1e-9;
+
+// Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's days_from_civil)
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+} // namespace
+
+double TrendingIndex::weight(Signal signal) {
+    switch (signal) {
+        case Signal::Rating: return 1.0;
+        case Signal::Review: return 3.0;       // Writing a review is a stronger signal than a star click
+        case Signal::HelpfulVote: return 0.5;
+    }
+    return 0.0;
+}
+
+int64_t TrendingIndex::parseTimestamp(std::string_view timestamp) {
+    // Positions of the digits in "YYYY-MM-DD HH:MM:SS"
+    if (timestamp.size() < 19) {
+        return -1;
+    }
+    auto number = [timestamp](size_t begin, size_t length) -> int {
+        int value = 0;
+        for (size_t i = begin; i < begin + length; ++i) {
+            if (!std::isdigit(static_cast<unsigned char>(timestamp[i]))) {
+                return -1;
+            }
+            value = value * 10 + (timestamp[i] - '0');
+        }
+        return value;
+    };
+    int year = number(0, 4), month = number(5, 2), day = number(8, 2);
+    int hour = number(11, 2), minute = number(14, 2), second = number(17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 || minute < 0 ||
+        minute > 59 || second < 0 || second > 60) {
+        return -1;
+    }
+    return daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400 + hour * 3600 +
+           minute * 60 + second;
+}
+
+bool TrendingIndex::isBuilt() const {
+    std::shared_lock lock(mutex_);
+    return built_;
+}
+
+size_t TrendingIndex::size() const {
+    std::shared_lock lock(mutex_);
+    return scores_.size();
+}
+
+void TrendingIndex::record(const std::string& recipeId, Signal signal, int64_t time) {
+    std::unique_lock lock(mutex_);
+    if (built_) {
+        recordLocked(recipeId, weight(signal), time);
+    }
+}
+
+void TrendingIndex::remove(const std::string& recipeId) {
+    std::unique_lock lock(mutex_);
+    auto it = scores_.find(recipeId);
+    if (!built_ || it == scores_.end()) {
+        return;
+    }
+    ranking_.erase({it->second, recipeId});
+    scores_.erase(it);
+}
+
+void TrendingIndex::invalidate() {
+    std::unique_lock lock(mutex_);
+    built_ = false;
+    hasBase_ = false;
+    baseTime_ = 0;
+    scores_.clear();
+    ranking_.clear();
+}
+
+void TrendingIndex::recordLocked(const std::string& recipeId, double weight, int64_t time) {
+    if (!hasBase_) {
+        baseTime_ = time;
+        hasBase_ = true;
+    }
+    double exponent = static_cast<double>(time - baseTime_) / kHalfLifeSeconds;
+    if (exponent > kMaxExponent) {
+        rebaseLocked(time);
+        exponent = 0.0;
+    }
+
+    auto [it, inserted] = scores_.emplace(recipeId, 0.0);
+    if (!inserted) {
+        ranking_.erase({it->second, recipeId});
+    }
+    it->second += weight * std::exp2(exponent);
+    ranking_.emplace(it->second, recipeId);
+}
+
+void TrendingIndex::rebaseLocked(int64_t time) {
+    const double factor = std::exp2(-static_cast<double>(time - baseTime_) / kHalfLifeSeconds);
+    baseTime_ = time;
+    ranking_.clear();
+    for (auto it = scores_.begin(); it != scores_.end();) {
+        it->second *= factor;
+        if (it->second < kNegligibleScore) {
+            it = scores_.erase(it);
+        } else {
+            ranking_.emplace(it->second, it->first);
+            ++it;
+        }
+    }
+}
+
+std::vector<TrendingIndex::Entry> TrendingIndex::top(size_t limit, int64_t now) const {
+    std::shared_lock lock(mutex_);
+    std::vector<Entry> entries;
+    const double decay = std::exp2(-static_cast<double>(now - baseTime_) / kHalfLifeSeconds);
+    for (auto it = ranking_.begin(); it != ranking_.end() && entries.size() < limit; ++it) {
+        entries.push_back({it->second, it->first * decay});
+    }
+    return entries;
+}
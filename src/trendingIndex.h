@@ -0,0 +1,93 @@
+#ifndef TRENDING_INDEX_H
+#define TRENDING_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// "Trending now": an exponentially time-decayed activity score per recipe, maintained as events arrive.
+// A recipe's score is the sum of weight * 2^(-age / kHalfLifeSeconds) over its ratings, reviews and
+// helpful votes. Scores are stored scaled to a fixed base time, so decay never rewrites them: all
+// scores shrink by the same factor as time passes and their order does not change. The ordered set
+// over the scaled scores is therefore always the current ranking, and top(K) reads K entries.
+// The base is moved forward (and every score rescaled once) before the scale factor could overflow.
+// Thread-safe: queries take a shared lock, writes an exclusive one.
+class TrendingIndex {
+public:
+    static constexpr double kHalfLifeSeconds = 24 * 3600.0;
+    static constexpr int kReplayDays = 14;  // Older events have decayed below 1/16000 of their weight
+
+    enum class Signal { Rating, Review, HelpfulVote };
+
+    struct Event {
+        std::string recipeId;
+        Signal signal;
+        int64_t time;  // Unix seconds
+    };
+
+    struct Entry {
+        std::string recipeId;
+        double score;  // Decayed to the time passed to top()
+    };
+
+    static double weight(Signal signal);
+    // SQLite CURRENT_TIMESTAMP text ("YYYY-MM-DD HH:MM:SS", UTC) -> Unix seconds, or -1 if malformed
+    static int64_t parseTimestamp(std::string_view timestamp);
+
+    bool isBuilt() const;
+
+    // Build once by replaying loadEvents() -> vector<Event>; no-op if already built
+    template <typename Loader>
+    void ensureBuilt(Loader&& loadEvents) {
+        {
+            std::shared_lock lock(mutex_);
+            if (built_) {
+                return;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        if (built_) {
+            return;
+        }
+        for (const auto& event : loadEvents()) {
+            recordLocked(event.recipeId, weight(event.signal), event.time);
+        }
+        built_ = true;
+    }
+
+    // Incremental maintenance; ignored until the index has been built
+    void record(const std::string& recipeId, Signal signal, int64_t time);
+    void remove(const std::string& recipeId);
+    void invalidate();
+
+    // Highest scores at time now, best first
+    std::vector<Entry> top(size_t limit, int64_t now) const;
+
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    bool built_ = false;
+
+    int64_t baseTime_ = 0;
+    bool hasBase_ = false;
+    std::unordered_map<std::string, double> scores_;  // Scaled by 2^((t - baseTime_) / half-life)
+    struct RanksAhead {
+        bool operator()(const std::pair<double, std::string>& a, const std::pair<double, std::string>& b) const {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        }
+    };
+    std::set<std::pair<double, std::string>, RanksAhead> ranking_;  // (scaled score, recipe id)
+
+    void recordLocked(const std::string& recipeId, double weight, int64_t time);
+    void rebaseLocked(int64_t time);
+};
+
+#endif // TRENDING_INDEX_H
@@ -1,10 +1,10 @@
 #include "user.h"
+#include "idGenerator.h"
 #include <regex>
 #include <openssl/evp.h>
 #include <openssl/sha.h>
 #include <iomanip>
 #include <sstream>
-#include <random>
 #include <chrono>
 
 User::User()
@@ -141,16 +141,5 @@ User User::fromJson(const nlohmann::json& json) {
 }
 
 std::string User::generateId() {
-    // Generate a simple UUID-like string
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 15);
-
-    std::stringstream ss;
-    ss << std::hex;
-    for (int i = 0; i < 32; i++) {
-        if (i == 8 || i == 12 || i == 16 || i == 20) ss << "-";
-        ss << dis(gen);
-    }
-    return ss.str();
+    return IdGenerator::next();
 }
\ No newline at end of file
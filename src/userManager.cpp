@@ -1,7 +1,61 @@
 #include "userManager.h"
+#include "schemaMigrator.h"
 #include <iostream>
 #include <sstream>
 
+// Schema history of the users database; append new versions, never edit applied ones.
+// Version 1 is the schema from before versioning, so it must stay IF NOT EXISTS for databases created then.
+static const std::vector<SchemaMigrator::Migration>& userMigrations() {
+    static const std::vector<SchemaMigrator::Migration> migrations{
+        {1, "users table", R"(
+            CREATE TABLE IF NOT EXISTS users (
+                id TEXT PRIMARY KEY,
+                email TEXT UNIQUE NOT NULL,
+                password_hash TEXT NOT NULL,
+                created_at TEXT NOT NULL,
+                updated_at TEXT NOT NULL,
+                is_active INTEGER NOT NULL DEFAULT 1,
+                name TEXT,
+                bio TEXT,
+                avatar_url TEXT,
+                preferences TEXT,
+                privacy_settings TEXT
+            )
+        )"},
+        // CollectionManager shares this database; nothing created its tables before
+        {2, "collections and collection_recipes tables", R"(
+            CREATE TABLE IF NOT EXISTS collections (
+                id TEXT PRIMARY KEY,
+                name TEXT NOT NULL,
+                description TEXT,
+                user_id TEXT NOT NULL,
+                privacy_settings TEXT,
+                created_at TEXT NOT NULL,
+                updated_at TEXT NOT NULL
+            );
+            CREATE INDEX IF NOT EXISTS idx_collections_user ON collections(user_id);
+            CREATE TABLE IF NOT EXISTS collection_recipes (
+                collection_id TEXT NOT NULL,
+                recipe_id TEXT NOT NULL,
+                added_at TEXT NOT NULL,
+                PRIMARY KEY(collection_id, recipe_id)
+            );
+            CREATE INDEX IF NOT EXISTS idx_collection_recipes_recipe ON collection_recipes(recipe_id);
+        )"},
+    };
+    return migrations;
+}
+
+bool UserManager::initializeSchema(sqlite3* db) {
+    if (SchemaMigrator::version(db) >= SchemaMigrator::latestVersion(userMigrations())) {
+        return true;
+    }
+    // Same storage settings as the recipes database; neither can change inside a migration's transaction
+    sqlite3_exec(db, "PRAGMA auto_vacuum = INCREMENTAL;", nullptr, nullptr, nullptr);
+    sqlite3_exec(db, "PRAGMA journal_mode = WAL;", nullptr, nullptr, nullptr);
+    return SchemaMigrator::migrate(db, "users", userMigrations());
+}
+
 UserManager::UserManager(sqlite3* db) : db_(db) {
     if (!db_) {
         throw std::runtime_error("Database connection is null");
@@ -10,10 +10,17 @@
 #include "jwtService.h"
 #include "authService.h"
 #include "jwtMiddleware.h"
+#include "recipeFields.h"
+#include "recipeExporter.h"
+#include "responseCompressor.h"
+#include "entityVersions.h"
+#include "backupScheduler.h"
+#include "databaseMaintenance.h"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_set>
 #include <cstdlib>
 #include <filesystem>
 
@@ -43,6 +50,99 @@ std::string getDatabasePath(const std::string& envVar, const std::string& defaul
     return defaultFilename;
 }
 
+// Non-negative integer setting from the environment; fallback when unset or invalid
+long getEnvNumber(const char* name, long fallback) {
+    const char* value = std::getenv(name);
+    if (!value) {
+        return fallback;
+    }
+    try {
+        long number = std::stol(value);
+        if (number >= 0) {
+            return number;
+        }
+    } catch (...) {
+    }
+    std::cerr << "Warning: Invalid " << name << " value" << std::endl;
+    return fallback;
+}
+
+// Split a comma-separated query parameter ("egg,olive oil") into trimmed, non-empty entries
+std::vector<std::string> splitListParam(const char* value) {
+    std::vector<std::string> entries;
+    if (!value) {
+        return entries;
+    }
+    std::string current;
+    for (const char* p = value;; ++p) {
+        if (*p == ',' || *p == '\0') {
+            size_t start = current.find_first_not_of(" \t");
+            if (start != std::string::npos) {
+                entries.push_back(current.substr(start, current.find_last_not_of(" \t") - start + 1));
+            }
+            current.clear();
+            if (*p == '\0') {
+                break;
+            }
+        } else {
+            current += *p;
+        }
+    }
+    return entries;
+}
+
+// Build the API representation of a recipe (or RecipeView) from the RecipeFields table
+template <typename RecipeLike>
+crow::json::wvalue recipeToJsonValue(const RecipeLike& r, bool includeId = true) {
+    crow::json::wvalue json;
+    RecipeFields::forEach([&json, &r, includeId](const auto& field) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(field)>, std::decay_t<decltype(RecipeFields::id)>>) {
+            if (!includeId) {
+                return;
+            }
+        }
+        json[std::string(field.key)] = std::string(field.get(r));
+    });
+    return json;
+}
+
+// Conditional GET: when If-None-Match already names etag, turns res into a 304 and returns true. Take
+// etag before reading what the response is built from.
+bool notModified(const crow::request& req, crow::response& res, const std::string& etag,
+                 const char* cacheControl = "no-cache") {
+    std::string matched = EntityVersions::match(req.get_header_value("If-None-Match"), etag);
+    if (matched.empty()) {
+        return false;
+    }
+    res.code = 304;
+    res.set_header("ETag", matched);
+    res.set_header("Cache-Control", cacheControl);
+    return true;
+}
+
+// Validator for a 200: clients keep the body and revalidate it with If-None-Match before each reuse
+void setETag(crow::response& res, const std::string& etag, const char* cacheControl = "no-cache") {
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", cacheControl);
+}
+
+// {"categories": [{"value", "count"}...], "types": [...], "cookTimes": [...]}
+crow::json::wvalue facetsToJsonValue(const RecipeManagerSQLite::SearchFacets& facets) {
+    auto histogram = [](const std::vector<RecipeManagerSQLite::FacetValue>& values) {
+        crow::json::wvalue list = crow::json::wvalue::list();
+        for (size_t i = 0; i < values.size(); ++i) {
+            list[i]["value"] = values[i].value;
+            list[i]["count"] = values[i].count;
+        }
+        return list;
+    };
+    crow::json::wvalue json;
+    json["categories"] = histogram(facets.categories);
+    json["types"] = histogram(facets.types);
+    json["cookTimes"] = histogram(facets.cookTimes);
+    return json;
+}
+
 // Custom middleware for error handling
 struct ErrorHandler {
     struct context {};
@@ -56,6 +156,38 @@ struct ErrorHandler {
     }
 };
 
+// Content-Encoding negotiation for every response with a compressible type (see ResponseCompressor).
+// Responses to GETs without an Authorization header may be served again, so they go through the cache;
+// per-user responses are compressed each time. Bodies a route has already encoded are left alone.
+// A strong ETag names the identity body, so a compressed body gets its own: "<tag>-<coding>"
+// (EntityVersions::match accepts it back in If-None-Match).
+struct ResponseCompression {
+    struct context {};
+
+    ResponseCompressor* compressor = nullptr;
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx) {}
+
+    void after_handle(crow::request& req, crow::response& res, context& ctx) {
+        if (!compressor || res.body.empty() || !res.get_header_value("Content-Encoding").empty() ||
+            !ResponseCompressor::compressible(res.get_header_value("Content-Type"))) {
+            return;
+        }
+        res.set_header("Vary", "Accept-Encoding");
+        auto encoding = ResponseCompressor::negotiate(req.get_header_value("Accept-Encoding"));
+        bool cacheable = req.method == "GET"_method && res.code == 200 && req.get_header_value("Authorization").empty();
+        if (auto encoded = compressor->compress(res.body, encoding, cacheable)) {
+            res.body = std::move(*encoded);
+            res.set_header("Content-Encoding", ResponseCompressor::name(encoding));
+            std::string etag = res.get_header_value("ETag");
+            if (etag.size() >= 2 && etag.front() == '"' && etag.back() == '"') {
+                etag.insert(etag.size() - 1, std::string("-") + ResponseCompressor::name(encoding));
+                res.set_header("ETag", etag);
+            }
+        }
+    }
+};
+
 int main() {
     // Initialize recipe manager
     std::unique_ptr<RecipeManagerSQLite> managerPtr;
@@ -78,6 +210,9 @@ int main() {
 
     std::cout << "Connected to SQLite database successfully!" << std::endl;
 
+    // Build search and autocomplete indexes before serving traffic
+    manager.warmSearchIndexes();
+
     // Initialize AI service (optional - will be null if not configured)
     std::unique_ptr<AIService> aiService = nullptr;
     std::unique_ptr<VaultService> vaultService = nullptr;
@@ -147,40 +282,20 @@ int main() {
     std::shared_ptr<JwtService> jwtService = nullptr;
     std::shared_ptr<AuthService> authService = nullptr;
     std::shared_ptr<CollectionManager> collectionManager = nullptr;
+    sqlite3* usersDb = nullptr;
 
     try {
         // Open users database
         std::string usersDbPath = getDatabasePath("USERS_DB_PATH", "users.db");
         std::cout << "Using users database: " << usersDbPath << std::endl;
-        sqlite3* usersDb = nullptr;
         int rc = sqlite3_open(usersDbPath.c_str(), &usersDb);
         if (rc != SQLITE_OK) {
             throw std::runtime_error("Failed to open users database");
         }
-
-        // Create users table if it doesn't exist
-        const char* createTableSql = R"(
-            CREATE TABLE IF NOT EXISTS users (
-                id TEXT PRIMARY KEY,
-                email TEXT UNIQUE NOT NULL,
-                password_hash TEXT NOT NULL,
-                created_at TEXT NOT NULL,
-                updated_at TEXT NOT NULL,
-                is_active INTEGER NOT NULL DEFAULT 1,
-                name TEXT,
-                bio TEXT,
-                avatar_url TEXT,
-                preferences TEXT,
-                privacy_settings TEXT
-            )
-        )";
-        
-        char* errMsg = nullptr;
-        rc = sqlite3_exec(usersDb, createTableSql, nullptr, nullptr, &errMsg);
-        if (rc != SQLITE_OK) {
-            std::string error = errMsg ? errMsg : "Unknown error";
-            sqlite3_free(errMsg);
-            throw std::runtime_error("Failed to create users table: " + error);
+        // Users and collections tables, migrated to the current schema version
+        sqlite3_busy_timeout(usersDb, 5000);
+        if (!UserManager::initializeSchema(usersDb)) {
+            throw std::runtime_error("Failed to migrate users database");
         }
 
         userManager = std::make_shared<UserManager>(usersDb);
@@ -226,9 +341,8 @@ int main() {
         jwtService = std::make_shared<JwtService>(jwtConfig);
         authService = std::make_shared<AuthService>(userManager, jwtService);
 
-        // Initialize CollectionManager with the same database as UserManager
-        std::string recipesDbPath = getDatabasePath("RECIPES_DB_PATH", "recipes.db");
-        collectionManager = std::make_shared<CollectionManager>(usersDb, recipesDbPath);
+        // Initialize CollectionManager with the same database as UserManager; recipes come from the server's manager
+        collectionManager = std::make_shared<CollectionManager>(usersDb, manager);
 
         std::cout << "Authentication and collection services initialized successfully!" << std::endl;
 
@@ -237,8 +351,85 @@ int main() {
         std::cerr << "Authentication endpoints will be unavailable." << std::endl;
     }
 
-    // Create Crow app with CORS middleware
-    crow::App<crow::CORSHandler, ErrorHandler> app;
+    // Users allowed on the /api/admin routes: ADMIN_USER_IDS, a comma-separated list of user ids. Unset means
+    // nobody, so a fresh deployment does not hand exports and backups to every account.
+    std::unordered_set<std::string> adminUserIds;
+    for (auto& id : splitListParam(std::getenv("ADMIN_USER_IDS"))) {
+        adminUserIds.insert(std::move(id));
+    }
+    std::cout << adminUserIds.size() << " admin user(s) configured" << std::endl;
+
+    // Online backups of both databases through the SQLite backup API, safe while requests are writing.
+    // BACKUP_DIR (default: backups/ next to the recipes database), BACKUP_INTERVAL_MINUTES (default 1440,
+    // 0 = only when triggered through the admin endpoint), BACKUP_KEEP (snapshots per database, default 7)
+    std::unique_ptr<BackupScheduler> backupScheduler;
+    {
+        std::string recipesDbPath = getDatabasePath("RECIPES_DB_PATH", "recipes.db");
+        std::string usersDbPath = getDatabasePath("USERS_DB_PATH", "users.db");
+        BackupScheduler::Options backupOptions;
+        backupOptions.interval = std::chrono::minutes(getEnvNumber("BACKUP_INTERVAL_MINUTES", 1440));
+        backupOptions.keep = static_cast<size_t>(getEnvNumber("BACKUP_KEEP", 7));
+
+        const char* backupDir = std::getenv("BACKUP_DIR");
+        if (backupDir && *backupDir) {
+            backupOptions.directory = backupDir;
+        } else {
+            backupOptions.directory = (std::filesystem::path(recipesDbPath).parent_path() / "backups").string();
+        }
+
+        std::cout << "Backups go to " << backupOptions.directory;
+        if (backupOptions.interval.count() > 0) {
+            std::cout << " every " << backupOptions.interval.count() << " minutes";
+        } else {
+            std::cout << " when triggered";
+        }
+        std::cout << std::endl;
+        backupScheduler = std::make_unique<BackupScheduler>(std::vector<std::string>{recipesDbPath, usersDbPath},
+                                                            backupOptions);
+    }
+
+    // WAL checkpoints, PRAGMA optimize, ANALYZE and incremental vacuum for both databases on one background
+    // thread. While it runs the request connections stop checkpointing on commit, so a request never pays
+    // for one. WAL_CHECKPOINT_INTERVAL_MS (default 1000, 0 = off and SQLite checkpoints as usual),
+    // WAL_TRUNCATE_MB (default 64), DB_OPTIMIZE_INTERVAL_MINUTES (60), DB_ANALYZE_INTERVAL_HOURS (24),
+    // DB_VACUUM_FREE_PAGES (1024)
+    std::unique_ptr<DatabaseMaintenance> maintenance;
+    {
+        DatabaseMaintenance::Options maintenanceOptions;
+        maintenanceOptions.checkpointInterval = std::chrono::milliseconds(getEnvNumber("WAL_CHECKPOINT_INTERVAL_MS", 1000));
+        maintenanceOptions.truncateWalBytes = static_cast<uint64_t>(getEnvNumber("WAL_TRUNCATE_MB", 64)) * 1024 * 1024;
+        maintenanceOptions.optimizeInterval = std::chrono::minutes(getEnvNumber("DB_OPTIMIZE_INTERVAL_MINUTES", 60));
+        maintenanceOptions.analyzeInterval = std::chrono::hours(getEnvNumber("DB_ANALYZE_INTERVAL_HOURS", 24));
+        maintenanceOptions.vacuumFreePages = getEnvNumber("DB_VACUUM_FREE_PAGES", 1024);
+
+        if (maintenanceOptions.checkpointInterval.count() > 0) {
+            std::vector<std::string> databases{getDatabasePath("RECIPES_DB_PATH", "recipes.db")};
+            manager.setAutoCheckpoint(0);
+            if (usersDb) {
+                sqlite3_wal_autocheckpoint(usersDb, 0);
+                databases.push_back(getDatabasePath("USERS_DB_PATH", "users.db"));
+            }
+            maintenance = std::make_unique<DatabaseMaintenance>(databases, maintenanceOptions);
+            std::cout << "Database maintenance every " << maintenanceOptions.checkpointInterval.count() << " ms"
+                      << std::endl;
+        }
+    }
+
+    // zstd/gzip response compression for clients that reach the server directly rather than through nginx.
+    // COMPRESSION_MIN_BYTES (default 1024), COMPRESSION_THREADS (workers, default 2, 0 = on the request
+    // thread), COMPRESSION_CACHE_MB (compressed public responses kept for repeat hits, default 32, 0 = off)
+    ResponseCompressor::Options compressionOptions;
+    compressionOptions.minBytes = static_cast<size_t>(getEnvNumber("COMPRESSION_MIN_BYTES", 1024));
+    compressionOptions.threads = static_cast<size_t>(getEnvNumber("COMPRESSION_THREADS", 2));
+    compressionOptions.cacheBytes = static_cast<size_t>(getEnvNumber("COMPRESSION_CACHE_MB", 32)) * 1024 * 1024;
+    ResponseCompressor responseCompressor(compressionOptions);
+    std::cout << "Compressing responses of " << compressionOptions.minBytes << " bytes or more on "
+              << compressionOptions.threads << " threads" << std::endl;
+
+    // Create Crow app with CORS middleware. Middlewares finish in reverse order, so compression sees the
+    // response after the others have set their headers.
+    crow::App<ResponseCompression, crow::CORSHandler, ErrorHandler> app;
+    app.get_middleware<ResponseCompression>().compressor = &responseCompressor;
 
     // Configure CORS
     auto& cors = app.get_middleware<crow::CORSHandler>();
@@ -267,20 +458,14 @@ int main() {
     .methods("GET"_method)
     ([&manager, &createErrorResponse, &createSuccessResponse](const crow::request& req, crow::response& res) {
         try {
-            auto recipes = manager.getAllRecipes();
+            // Read-only listing: materialize views into a per-request arena instead of full recipe objects
+            RecipeArena arena;
+            auto recipes = manager.getAllRecipeViews(arena);
 
             crow::json::wvalue data;
             crow::json::wvalue recipes_json = crow::json::wvalue::list();
             for (size_t i = 0; i < recipes.size(); ++i) {
-                crow::json::wvalue recipe_json;
-                recipe_json["title"] = recipes[i].getTitle();
-                recipe_json["ingredients"] = recipes[i].getIngredients();
-                recipe_json["instructions"] = recipes[i].getInstructions();
-                recipe_json["servingSize"] = recipes[i].getServingSize();
-                recipe_json["cookTime"] = recipes[i].getCookTime();
-                recipe_json["category"] = recipes[i].getCategory();
-                recipe_json["type"] = recipes[i].getType();
-                recipes_json[i] = std::move(recipe_json);
+                recipes_json[i] = recipeToJsonValue(recipes[i], false);
             }
             data["recipes"] = std::move(recipes_json);
 
@@ -307,15 +492,7 @@ int main() {
             crow::json::wvalue data;
             crow::json::wvalue recipes_json = crow::json::wvalue::list();
             for (size_t i = 0; i < recipes.size(); ++i) {
-                crow::json::wvalue recipe_json;
-                recipe_json["title"] = recipes[i].getTitle();
-                recipe_json["ingredients"] = recipes[i].getIngredients();
-                recipe_json["instructions"] = recipes[i].getInstructions();
-                recipe_json["servingSize"] = recipes[i].getServingSize();
-                recipe_json["cookTime"] = recipes[i].getCookTime();
-                recipe_json["category"] = recipes[i].getCategory();
-                recipe_json["type"] = recipes[i].getType();
-                recipes_json[i] = std::move(recipe_json);
+                recipes_json[i] = recipeToJsonValue(recipes[i], false);
             }
             data["recipes"] = std::move(recipes_json);
 
@@ -355,6 +532,8 @@ int main() {
             if (req.url_params.get("ingredient")) {
                 criteria.ingredient = req.url_params.get("ingredient");
             }
+            criteria.includeIngredients = splitListParam(req.url_params.get("ingredients"));
+            criteria.excludeIngredients = splitListParam(req.url_params.get("excludeIngredients"));
             if (req.url_params.get("sortBy")) {
                 criteria.sortBy = req.url_params.get("sortBy");
             }
@@ -362,24 +541,17 @@ int main() {
                 criteria.sortOrder = req.url_params.get("sortOrder");
             }
 
-            auto recipes = manager.advancedSearch(criteria);
+            RecipeManagerSQLite::SearchFacets facets;
+            auto recipes = manager.advancedSearch(criteria, &facets);
 
             crow::json::wvalue data;
             crow::json::wvalue recipes_json = crow::json::wvalue::list();
             for (size_t i = 0; i < recipes.size(); ++i) {
-                crow::json::wvalue recipe_json;
-                recipe_json["id"] = recipes[i].getId();
-                recipe_json["title"] = recipes[i].getTitle();
-                recipe_json["ingredients"] = recipes[i].getIngredients();
-                recipe_json["instructions"] = recipes[i].getInstructions();
-                recipe_json["servingSize"] = recipes[i].getServingSize();
-                recipe_json["cookTime"] = recipes[i].getCookTime();
-                recipe_json["category"] = recipes[i].getCategory();
-                recipe_json["type"] = recipes[i].getType();
-                recipes_json[i] = std::move(recipe_json);
+                recipes_json[i] = recipeToJsonValue(recipes[i]);
             }
             data["recipes"] = std::move(recipes_json);
             data["count"] = recipes.size();
+            data["facets"] = facetsToJsonValue(facets);
 
             res = createSuccessResponse(data);
         } catch (const std::exception& e) {
@@ -418,6 +590,8 @@ int main() {
                 if (req.url_params.get("ingredient")) {
                     criteria.ingredient = req.url_params.get("ingredient");
                 }
+                criteria.includeIngredients = splitListParam(req.url_params.get("ingredients"));
+                criteria.excludeIngredients = splitListParam(req.url_params.get("excludeIngredients"));
                 if (req.url_params.get("sortBy")) {
                     criteria.sortBy = req.url_params.get("sortBy");
                 }
@@ -425,24 +599,17 @@ int main() {
                     criteria.sortOrder = req.url_params.get("sortOrder");
                 }
 
-                auto recipes = manager.advancedSearch(criteria);
+                RecipeManagerSQLite::SearchFacets facets;
+                auto recipes = manager.advancedSearch(criteria, &facets);
 
                 crow::json::wvalue data;
                 crow::json::wvalue recipes_json = crow::json::wvalue::list();
                 for (size_t i = 0; i < recipes.size(); ++i) {
-                    crow::json::wvalue recipe_json;
-                    recipe_json["id"] = recipes[i].getId();
-                    recipe_json["title"] = recipes[i].getTitle();
-                    recipe_json["ingredients"] = recipes[i].getIngredients();
-                    recipe_json["instructions"] = recipes[i].getInstructions();
-                    recipe_json["servingSize"] = recipes[i].getServingSize();
-                    recipe_json["cookTime"] = recipes[i].getCookTime();
-                    recipe_json["category"] = recipes[i].getCategory();
-                    recipe_json["type"] = recipes[i].getType();
-                    recipes_json[i] = std::move(recipe_json);
+                    recipes_json[i] = recipeToJsonValue(recipes[i]);
                 }
                 data["recipes"] = std::move(recipes_json);
                 data["count"] = recipes.size();
+                data["facets"] = facetsToJsonValue(facets);
 
                 local_res = createSuccessResponse(data);
             } catch (const std::exception& e) {
@@ -455,6 +622,168 @@ int main() {
         res.end();
     });
 
+    // POST /api/recipes/pantry-match - Rank recipes by how much of their ingredient list the pantry covers
+    CROW_ROUTE(app, "/api/recipes/pantry-match")
+    .methods("POST"_method)
+    ([&manager, &createErrorResponse, &createSuccessResponse](const crow::request& req, crow::response& res) {
+        try {
+            auto json_body = crow::json::load(req.body);
+            if (!json_body) {
+                res = createErrorResponse("Invalid JSON in request body", 400);
+                res.end();
+                return;
+            }
+
+            if (!json_body.has("pantry") || json_body["pantry"].t() != crow::json::type::List) {
+                res = createErrorResponse("Missing 'pantry' array in request body", 400);
+                res.end();
+                return;
+            }
+
+            std::vector<std::string> pantry;
+            for (const auto& item : json_body["pantry"]) {
+                if (item.t() == crow::json::type::String) {
+                    pantry.push_back(item.s());
+                }
+            }
+
+            int limit = 10;
+            if (json_body.has("limit")) {
+                limit = json_body["limit"].i();
+                if (limit < 1 || limit > 100) {
+                    res = createErrorResponse("Limit must be between 1 and 100", 400);
+                    res.end();
+                    return;
+                }
+            }
+            double minCoverage = json_body.has("minCoverage") ? json_body["minCoverage"].d() : 0.0;
+
+            auto matches = manager.matchPantry(pantry, static_cast<size_t>(limit), minCoverage);
+
+            crow::json::wvalue data;
+            crow::json::wvalue matches_json = crow::json::wvalue::list();
+            size_t index = 0;
+            for (const auto& match : matches) {
+                auto recipePtr = manager.getRecipe(match.recipeId);
+                if (!recipePtr) {
+                    continue;
+                }
+                crow::json::wvalue entry;
+                entry["recipe"] = recipeToJsonValue(*recipePtr);
+                entry["coverage"] = match.coverage;
+                entry["matchedIngredients"] = match.matchedIngredients;
+                entry["totalIngredients"] = match.totalIngredients;
+                crow::json::wvalue missing = crow::json::wvalue::list();
+                for (size_t i = 0; i < match.missingIngredients.size(); ++i) {
+                    missing[i] = match.missingIngredients[i];
+                }
+                entry["missingIngredients"] = std::move(missing);
+                matches_json[index++] = std::move(entry);
+            }
+            data["matches"] = std::move(matches_json);
+            data["count"] = index;
+
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse(std::string("Failed to match pantry: ") + e.what(), 500);
+        }
+        res.end();
+    });
+
+    // GET /api/recipes/suggest?prefix=... - Autocomplete titles, categories and ingredients
+    CROW_ROUTE(app, "/api/recipes/suggest")
+    .methods("GET"_method)
+    ([&manager, &createErrorResponse, &createSuccessResponse](const crow::request& req, crow::response& res) {
+        try {
+            const char* prefix = req.url_params.get("prefix");
+            if (!prefix) {
+                res = createErrorResponse("Missing 'prefix' query parameter", 400);
+                res.end();
+                return;
+            }
+
+            int limit = 10;
+            if (req.url_params.get("limit")) {
+                limit = std::atoi(req.url_params.get("limit"));
+                if (limit < 1 || limit > 50) {
+                    res = createErrorResponse("Limit must be between 1 and 50", 400);
+                    res.end();
+                    return;
+                }
+            }
+
+            auto suggestions = manager.suggest(prefix, static_cast<size_t>(limit));
+
+            crow::json::wvalue data;
+            crow::json::wvalue suggestions_json = crow::json::wvalue::list();
+            for (size_t i = 0; i < suggestions.size(); ++i) {
+                suggestions_json[i]["text"] = suggestions[i].text;
+                suggestions_json[i]["kind"] = suggestions[i].kind;
+                suggestions_json[i]["recipeCount"] = suggestions[i].recipeCount;
+            }
+            data["suggestions"] = std::move(suggestions_json);
+            data["count"] = suggestions.size();
+
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse(std::string("Failed to suggest: ") + e.what(), 500);
+        }
+        res.end();
+    });
+
+    // GET /api/recipes/facets - Category, type and cook-time counts over all recipes
+    CROW_ROUTE(app, "/api/recipes/facets")
+    .methods("GET"_method)
+    ([&manager, &createErrorResponse, &createSuccessResponse](const crow::request& req, crow::response& res) {
+        try {
+            crow::json::wvalue data;
+            data["facets"] = facetsToJsonValue(manager.getFacets());
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse(std::string("Failed to count facets: ") + e.what(), 500);
+        }
+        res.end();
+    });
+
+    // GET /api/recipes/trending - Recipes with the most recent activity (time-decayed)
+    CROW_ROUTE(app, "/api/recipes/trending")
+    .methods("GET"_method)
+    ([&manager, &createErrorResponse, &createSuccessResponse](const crow::request& req, crow::response& res) {
+        try {
+            int limit = 10;
+            if (req.url_params.get("limit")) {
+                limit = std::atoi(req.url_params.get("limit"));
+                if (limit < 1 || limit > 50) {
+                    res = createErrorResponse("Limit must be between 1 and 50", 400);
+                    res.end();
+                    return;
+                }
+            }
+
+            auto trending = manager.getTrendingRecipes(static_cast<size_t>(limit));
+
+            crow::json::wvalue data;
+            crow::json::wvalue trending_json = crow::json::wvalue::list();
+            size_t index = 0;
+            for (const auto& entry : trending) {
+                auto recipePtr = manager.getRecipe(entry.recipeId);
+                if (!recipePtr) {
+                    continue;
+                }
+                trending_json[index]["recipe"] = recipeToJsonValue(*recipePtr);
+                trending_json[index]["score"] = entry.score;
+                ++index;
+            }
+            data["trending"] = std::move(trending_json);
+            data["count"] = index;
+
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse("Failed to get trending recipes: " + std::string(e.what()), 500);
+        }
+        res.end();
+    });
+
     // POST /api/auth/login - User login
     CROW_ROUTE(app, "/api/auth/login")
     .methods("POST"_method)
@@ -772,15 +1101,7 @@ int main() {
             crow::json::wvalue data;
             crow::json::wvalue recipes_json = crow::json::wvalue::list();
             for (size_t i = 0; i < recipes.size(); ++i) {
-                crow::json::wvalue recipe_json;
-                recipe_json["title"] = recipes[i].getTitle();
-                recipe_json["ingredients"] = recipes[i].getIngredients();
-                recipe_json["instructions"] = recipes[i].getInstructions();
-                recipe_json["servingSize"] = recipes[i].getServingSize();
-                recipe_json["cookTime"] = recipes[i].getCookTime();
-                recipe_json["category"] = recipes[i].getCategory();
-                recipe_json["type"] = recipes[i].getType();
-                recipes_json[i] = std::move(recipe_json);
+                recipes_json[i] = recipeToJsonValue(recipes[i], false);
             }
             data["recipes"] = std::move(recipes_json);
 
@@ -801,15 +1122,7 @@ int main() {
             crow::json::wvalue data;
             crow::json::wvalue recipes_json = crow::json::wvalue::list();
             for (size_t i = 0; i < recipes.size(); ++i) {
-                crow::json::wvalue recipe_json;
-                recipe_json["title"] = recipes[i].getTitle();
-                recipe_json["ingredients"] = recipes[i].getIngredients();
-                recipe_json["instructions"] = recipes[i].getInstructions();
-                recipe_json["servingSize"] = recipes[i].getServingSize();
-                recipe_json["cookTime"] = recipes[i].getCookTime();
-                recipe_json["category"] = recipes[i].getCategory();
-                recipe_json["type"] = recipes[i].getType();
-                recipes_json[i] = std::move(recipe_json);
+                recipes_json[i] = recipeToJsonValue(recipes[i], false);
             }
             data["recipes"] = std::move(recipes_json);
 
@@ -873,6 +1186,35 @@ int main() {
         res.end();
     });
 
+    // GET /api/recipes/<id> - Get one recipe. Sends an ETag; If-None-Match with the current one gets a 304
+    // without reading the recipe.
+    CROW_ROUTE(app, "/api/recipes/<string>")
+    .methods("GET"_method)
+    ([&manager, &createErrorResponse, &createSuccessResponse](const crow::request& req, crow::response& res, const std::string& id) {
+        try {
+            std::string etag = manager.recipeETag(id);
+            if (notModified(req, res, etag)) {
+                res.end();
+                return;
+            }
+
+            auto found = manager.getRecipe(id);
+            if (!found) {
+                res = createErrorResponse("Recipe not found", 404);
+                res.end();
+                return;
+            }
+
+            crow::json::wvalue data;
+            data["recipe"] = recipeToJsonValue(*found);
+            res = createSuccessResponse(data);
+            setETag(res, etag);
+        } catch (const std::exception& e) {
+            res = createErrorResponse(std::string("Failed to get recipe: ") + e.what(), 500);
+        }
+        res.end();
+    });
+
     // PUT /api/recipes/<string> - Update a recipe (PROTECTED - requires authentication)
     CROW_ROUTE(app, "/api/recipes/<string>")
     .methods("PUT"_method)
@@ -1180,7 +1522,7 @@ int main() {
         res.end();
     });
 
-    // GET /api/collections/<id> - Get specific collection
+    // GET /api/collections/<id> - Get specific collection, with an ETag for If-None-Match revalidation
     CROW_ROUTE(app, "/api/collections/<string>")
     .methods("GET"_method)
     ([&collectionManager, &authService, &createSuccessResponse, &createErrorResponse](const crow::request& req, crow::response& res, std::string collectionIdStr) {
@@ -1205,6 +1547,7 @@ int main() {
 
             // Collection ID is already a string from the URL parameter
             std::string collectionId = collectionIdStr;
+            std::string etag = collectionManager->collectionETag(collectionId);
 
             // Get collection
             auto collection = collectionManager->getCollectionById(collectionId);
@@ -1221,6 +1564,12 @@ int main() {
                 return;
             }
 
+            // Access is checked first; only the recipe list and serialization are skipped
+            if (notModified(req, res, etag, "private, no-cache")) {
+                res.end();
+                return;
+            }
+
             crow::json::wvalue data;
             data["collection"]["id"] = collection->getId();
             data["collection"]["name"] = collection->getName();
@@ -1244,6 +1593,7 @@ int main() {
             data["collection"]["recipeCount"] = recipeIds.size();
 
             res = createSuccessResponse(data);
+            setETag(res, etag, "private, no-cache");
         } catch (const std::exception& e) {
             res = createErrorResponse("Failed to get collection: " + std::string(e.what()), 500);
         }
@@ -1587,6 +1937,12 @@ int main() {
                 return;
             }
 
+            if (!manager.recipeExists(recipeId)) {
+                res = createErrorResponse("Recipe not found", 404);
+                res.end();
+                return;
+            }
+
             // Add or update rating
             bool success = manager.addOrUpdateRating(recipeId, userId, rating);
             if (!success) {
@@ -1720,6 +2076,107 @@ int main() {
         res.end();
     });
 
+    // GET /api/recipes/<id>/similar - Recipes with similar ingredient sets
+    CROW_ROUTE(app, "/api/recipes/<string>/similar")
+    .methods("GET"_method)
+    ([&manager, &createSuccessResponse, &createErrorResponse](const crow::request& req, crow::response& res, std::string recipeId) {
+        try {
+            if (!manager.getRecipe(recipeId)) {
+                res = createErrorResponse("Recipe not found", 404);
+                res.end();
+                return;
+            }
+
+            int limit = 10;
+            if (req.url_params.get("limit")) {
+                limit = std::atoi(req.url_params.get("limit"));
+                if (limit < 1 || limit > 50) {
+                    res = createErrorResponse("Limit must be between 1 and 50", 400);
+                    res.end();
+                    return;
+                }
+            }
+
+            auto similar = manager.findSimilarRecipes(recipeId, static_cast<size_t>(limit));
+
+            crow::json::wvalue data;
+            crow::json::wvalue similar_json = crow::json::wvalue::list();
+            size_t index = 0;
+            for (const auto& match : similar) {
+                auto recipePtr = manager.getRecipe(match.recipeId);
+                if (!recipePtr) {
+                    continue;
+                }
+                similar_json[index]["recipe"] = recipeToJsonValue(*recipePtr);
+                similar_json[index]["similarity"] = match.similarity;
+                ++index;
+            }
+            data["recipeId"] = recipeId;
+            data["similar"] = std::move(similar_json);
+            data["count"] = index;
+
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse("Failed to find similar recipes: " + std::string(e.what()), 500);
+        }
+        res.end();
+    });
+
+    // GET /api/users/me/recommendations - Recipes recommended from the user's ratings
+    CROW_ROUTE(app, "/api/users/me/recommendations")
+    .methods("GET"_method)
+    ([&manager, &authService, &createSuccessResponse, &createErrorResponse](const crow::request& req, crow::response& res) {
+        try {
+            // Extract and validate JWT token
+            auto authHeader = req.get_header_value("Authorization");
+            if (authHeader.empty() || authHeader.substr(0, 7) != "Bearer ") {
+                res = createErrorResponse("Missing or invalid authorization header", 401);
+                res.end();
+                return;
+            }
+
+            std::string token = authHeader.substr(7);
+            auto authResult = authService->validateToken(token);
+            if (!authResult.authenticated) {
+                res = createErrorResponse(authResult.message, 401);
+                res.end();
+                return;
+            }
+
+            int limit = 10;
+            if (req.url_params.get("limit")) {
+                limit = std::atoi(req.url_params.get("limit"));
+                if (limit < 1 || limit > 50) {
+                    res = createErrorResponse("Limit must be between 1 and 50", 400);
+                    res.end();
+                    return;
+                }
+            }
+
+            auto recommendations = manager.getRecommendations(authResult.userId, static_cast<size_t>(limit));
+
+            crow::json::wvalue data;
+            crow::json::wvalue recommendations_json = crow::json::wvalue::list();
+            size_t index = 0;
+            for (const auto& recommendation : recommendations) {
+                auto recipePtr = manager.getRecipe(recommendation.recipeId);
+                if (!recipePtr) {
+                    continue;
+                }
+                recommendations_json[index]["recipe"] = recipeToJsonValue(*recipePtr);
+                recommendations_json[index]["score"] = recommendation.score;
+                ++index;
+            }
+            data["recommendations"] = std::move(recommendations_json);
+            data["count"] = index;
+
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse("Failed to get recommendations: " + std::string(e.what()), 500);
+        }
+        res.end();
+    });
+
     // POST /api/recipes/<id>/reviews - Add a review for a recipe
     CROW_ROUTE(app, "/api/recipes/<string>/reviews")
     .methods("POST"_method)
@@ -1780,6 +2237,12 @@ int main() {
             review.reviewText = reviewText;
             review.status = "pending"; // Reviews start as pending for moderation
 
+            if (!manager.recipeExists(recipeId)) {
+                res = createErrorResponse("Recipe not found", 404);
+                res.end();
+                return;
+            }
+
             // Add review
             bool success = manager.addReview(review);
             if (!success) {
@@ -1800,11 +2263,18 @@ int main() {
         res.end();
     });
 
-    // GET /api/recipes/<id>/reviews - Get reviews for a recipe
+    // GET /api/recipes/<id>/reviews - Get reviews for a recipe. The ETag covers every page and sort of the
+    // recipe's reviews; If-None-Match with the current one gets a 304 without querying them.
     CROW_ROUTE(app, "/api/recipes/<string>/reviews")
     .methods("GET"_method)
     ([&manager, &createSuccessResponse, &createErrorResponse](const crow::request& req, crow::response& res, std::string recipeId) {
         try {
+            std::string etag = manager.reviewsETag(recipeId);
+            if (notModified(req, res, etag)) {
+                res.end();
+                return;
+            }
+
             // Get query parameters
             std::string sortBy = req.url_params.get("sort") ? req.url_params.get("sort") : "newest";
             std::string status = req.url_params.get("status") ? req.url_params.get("status") : "approved";
@@ -1816,8 +2286,25 @@ int main() {
             else if (sortBy == "most_helpful") sortEnum = RecipeManagerSQLite::ReviewSortBy::MOST_HELPFUL;
             else sortEnum = RecipeManagerSQLite::ReviewSortBy::NEWEST;
 
-            // Get sorted reviews
-            auto reviews = manager.getSortedReviewsByRecipe(recipeId, sortEnum, status);
+            int limit = 20;
+            if (req.url_params.get("limit")) {
+                limit = std::atoi(req.url_params.get("limit"));
+                if (limit < 1 || limit > 100) {
+                    res = createErrorResponse("Limit must be between 1 and 100", 400);
+                    res.end();
+                    return;
+                }
+            }
+            std::string cursor = req.url_params.get("cursor") ? req.url_params.get("cursor") : "";
+
+            // Get one page of sorted reviews
+            auto page = manager.getReviewPage(recipeId, sortEnum, static_cast<size_t>(limit), cursor, status);
+            if (!page) {
+                res = createErrorResponse("Invalid cursor", 400);
+                res.end();
+                return;
+            }
+            const auto& reviews = page->reviews;
 
             crow::json::wvalue::list reviewList;
             for (const auto& review : reviews) {
@@ -1838,8 +2325,12 @@ int main() {
             data["reviews"] = std::move(reviewList);
             data["count"] = reviews.size();
             data["sortBy"] = sortBy;
+            if (!page->nextCursor.empty()) {
+                data["nextCursor"] = page->nextCursor;
+            }
 
             res = createSuccessResponse(data);
+            setETag(res, etag);
         } catch (const std::exception& e) {
             res = createErrorResponse("Failed to get reviews: " + std::string(e.what()), 500);
         }
@@ -1869,6 +2360,14 @@ int main() {
 
             std::string userId = authResult.userId;
 
+            // The ownership check and the write commit together, so the review can't change in between
+            RecipeManagerSQLite::Transaction transaction(manager);
+            if (!transaction) {
+                res = createErrorResponse("Database is busy, try again", 503);
+                res.end();
+                return;
+            }
+
             // Get existing review
             auto existingReview = manager.getReview(reviewId);
             if (!existingReview) {
@@ -1915,7 +2414,7 @@ int main() {
             }
 
             // Update review
-            bool success = manager.updateReview(reviewId, updatedReview);
+            bool success = manager.updateReview(reviewId, updatedReview) && transaction.commit();
             if (!success) {
                 res = createErrorResponse("Failed to update review", 500);
                 res.end();
@@ -1956,6 +2455,14 @@ int main() {
 
             std::string userId = authResult.userId;
 
+            // The ownership check and the write commit together, so the review can't change in between
+            RecipeManagerSQLite::Transaction transaction(manager);
+            if (!transaction) {
+                res = createErrorResponse("Database is busy, try again", 503);
+                res.end();
+                return;
+            }
+
             // Get existing review
             auto existingReview = manager.getReview(reviewId);
             if (!existingReview) {
@@ -1972,7 +2479,7 @@ int main() {
             }
 
             // Delete review
-            bool success = manager.deleteReview(reviewId);
+            bool success = manager.deleteReview(reviewId) && transaction.commit();
             if (!success) {
                 res = createErrorResponse("Failed to delete review", 500);
                 res.end();
@@ -2200,6 +2707,277 @@ int main() {
         res.end();
     });
 
+    // GET /api/admin/export/<table> - One page of an NDJSON export of recipes, ratings or reviews (admin only)
+    // Query: since (timestamp, incremental export), cursor (from X-Next-Cursor), limit (default 1000, max 10000).
+    // X-Next-Cursor is absent on the last page. The body is compressed like any other response.
+    CROW_ROUTE(app, "/api/admin/export/<string>")
+    .methods("GET"_method)
+    ([&manager, &authService, &adminUserIds, &createErrorResponse](const crow::request& req, crow::response& res, std::string tableName) {
+        if (!authService) {
+            res = createErrorResponse("Authentication service not available", 503);
+            res.end();
+            return;
+        }
+
+        try {
+            // Extract and validate JWT token
+            auto authHeader = req.get_header_value("Authorization");
+            if (authHeader.empty() || authHeader.substr(0, 7) != "Bearer ") {
+                res = createErrorResponse("Missing or invalid authorization header", 401);
+                res.end();
+                return;
+            }
+
+            std::string token = authHeader.substr(7);
+            auto authResult = authService->validateToken(token);
+            if (!authResult.authenticated) {
+                res = createErrorResponse(authResult.message, 401);
+                res.end();
+                return;
+            }
+
+            if (!adminUserIds.count(authResult.userId)) {
+                res = createErrorResponse("Admin access required", 403);
+                res.end();
+                return;
+            }
+
+            RecipeManagerSQLite::ExportTable table;
+            if (!RecipeExporter::parseTable(tableName, table)) {
+                res = createErrorResponse("Table must be 'recipes', 'ratings' or 'reviews'", 400);
+                res.end();
+                return;
+            }
+
+            int limit = 1000;
+            if (req.url_params.get("limit")) {
+                limit = std::atoi(req.url_params.get("limit"));
+                if (limit < 1 || limit > 10000) {
+                    res = createErrorResponse("limit must be between 1 and 10000", 400);
+                    res.end();
+                    return;
+                }
+            }
+
+            int64_t cursor = 0;
+            if (req.url_params.get("cursor")) {
+                char* end = nullptr;
+                const char* text = req.url_params.get("cursor");
+                cursor = std::strtoll(text, &end, 10);
+                if (end == text || *end != '\0' || cursor < 0) {
+                    res = createErrorResponse("Invalid cursor", 400);
+                    res.end();
+                    return;
+                }
+            }
+            std::string since = req.url_params.get("since") ? req.url_params.get("since") : "";
+
+            std::string body;
+            auto page = manager.exportPage(table, since, cursor, static_cast<size_t>(limit), [&body](std::string_view line) {
+                body.append(line);
+                body += '\n';
+                return true;
+            });
+            if (!page) {
+                res = createErrorResponse(since.empty() ? "Export failed" : "Invalid since timestamp or export failed", 400);
+                res.end();
+                return;
+            }
+
+            res.code = 200;
+            res.set_header("Content-Type", "application/x-ndjson");
+            if (page->nextCursor != 0) {
+                res.set_header("X-Next-Cursor", std::to_string(page->nextCursor));
+            }
+            res.body = std::move(body);
+        } catch (const std::exception& e) {
+            res = createErrorResponse("Failed to export: " + std::string(e.what()), 500);
+        }
+        res.end();
+    });
+
+    // POST /api/admin/backups - Start a backup of every database now (admin only)
+    CROW_ROUTE(app, "/api/admin/backups")
+    .methods("POST"_method)
+    ([&backupScheduler, &authService, &adminUserIds, &createErrorResponse](const crow::request& req, crow::response& res) {
+        if (!authService) {
+            res = createErrorResponse("Authentication service not available", 503);
+            res.end();
+            return;
+        }
+
+        try {
+            // Extract and validate JWT token
+            auto authHeader = req.get_header_value("Authorization");
+            if (authHeader.empty() || authHeader.substr(0, 7) != "Bearer ") {
+                res = createErrorResponse("Missing or invalid authorization header", 401);
+                res.end();
+                return;
+            }
+
+            std::string token = authHeader.substr(7);
+            auto authResult = authService->validateToken(token);
+            if (!authResult.authenticated) {
+                res = createErrorResponse(authResult.message, 401);
+                res.end();
+                return;
+            }
+
+            if (!adminUserIds.count(authResult.userId)) {
+                res = createErrorResponse("Admin access required", 403);
+                res.end();
+                return;
+            }
+
+            if (!backupScheduler->trigger()) {
+                res = createErrorResponse("A backup is already running", 409);
+                res.end();
+                return;
+            }
+
+            crow::json::wvalue response;
+            response["success"] = true;
+            response["message"] = "Backup started; poll GET /api/admin/backups for progress";
+            res = crow::response(202, response);
+        } catch (const std::exception& e) {
+            res = createErrorResponse("Failed to start backup: " + std::string(e.what()), 500);
+        }
+        res.end();
+    });
+
+    // GET /api/admin/backups - Progress of the running or last backup and the retained snapshots (admin only)
+    CROW_ROUTE(app, "/api/admin/backups")
+    .methods("GET"_method)
+    ([&backupScheduler, &authService, &adminUserIds, &createSuccessResponse, &createErrorResponse](const crow::request& req, crow::response& res) {
+        if (!authService) {
+            res = createErrorResponse("Authentication service not available", 503);
+            res.end();
+            return;
+        }
+
+        try {
+            // Extract and validate JWT token
+            auto authHeader = req.get_header_value("Authorization");
+            if (authHeader.empty() || authHeader.substr(0, 7) != "Bearer ") {
+                res = createErrorResponse("Missing or invalid authorization header", 401);
+                res.end();
+                return;
+            }
+
+            std::string token = authHeader.substr(7);
+            auto authResult = authService->validateToken(token);
+            if (!authResult.authenticated) {
+                res = createErrorResponse(authResult.message, 401);
+                res.end();
+                return;
+            }
+
+            if (!adminUserIds.count(authResult.userId)) {
+                res = createErrorResponse("Admin access required", 403);
+                res.end();
+                return;
+            }
+
+            auto progress = backupScheduler->progress();
+            crow::json::wvalue data;
+            data["running"] = progress.running;
+            if (progress.running) {
+                data["database"] = progress.database;
+                data["pagesDone"] = progress.pagesDone;
+                data["pagesTotal"] = progress.pagesTotal;
+            }
+            data["runs"] = progress.runs;
+            data["lastStarted"] = progress.lastStarted;
+            data["lastFinished"] = progress.lastFinished;
+            data["lastOk"] = progress.lastOk;
+            data["lastError"] = progress.lastError;
+            data["lastSnapshots"] = crow::json::wvalue::list();
+            for (size_t i = 0; i < progress.lastSnapshots.size(); ++i) {
+                data["lastSnapshots"][i] = progress.lastSnapshots[i];
+            }
+
+            data["snapshots"] = crow::json::wvalue::list();
+            auto snapshots = backupScheduler->snapshots();
+            for (size_t i = 0; i < snapshots.size(); ++i) {
+                std::error_code ec;
+                auto size = std::filesystem::file_size(snapshots[i], ec);
+                data["snapshots"][i]["file"] = snapshots[i];
+                data["snapshots"][i]["bytes"] = ec ? 0 : static_cast<uint64_t>(size);
+            }
+
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse("Failed to get backup status: " + std::string(e.what()), 500);
+        }
+        res.end();
+    });
+
+    // GET /api/admin/maintenance - WAL size, checkpoint timings and maintenance counters per database (admin only)
+    CROW_ROUTE(app, "/api/admin/maintenance")
+    .methods("GET"_method)
+    ([&maintenance, &authService, &adminUserIds, &createSuccessResponse, &createErrorResponse](const crow::request& req, crow::response& res) {
+        if (!authService) {
+            res = createErrorResponse("Authentication service not available", 503);
+            res.end();
+            return;
+        }
+
+        try {
+            // Extract and validate JWT token
+            auto authHeader = req.get_header_value("Authorization");
+            if (authHeader.empty() || authHeader.substr(0, 7) != "Bearer ") {
+                res = createErrorResponse("Missing or invalid authorization header", 401);
+                res.end();
+                return;
+            }
+
+            std::string token = authHeader.substr(7);
+            auto authResult = authService->validateToken(token);
+            if (!authResult.authenticated) {
+                res = createErrorResponse(authResult.message, 401);
+                res.end();
+                return;
+            }
+
+            if (!adminUserIds.count(authResult.userId)) {
+                res = createErrorResponse("Admin access required", 403);
+                res.end();
+                return;
+            }
+
+            crow::json::wvalue data;
+            data["enabled"] = maintenance != nullptr;
+            data["databases"] = crow::json::wvalue::list();
+            if (maintenance) {
+                auto stats = maintenance->stats();
+                for (size_t i = 0; i < stats.size(); ++i) {
+                    const auto& db = stats[i];
+                    crow::json::wvalue entry;
+                    entry["database"] = db.database;
+                    entry["walBytes"] = db.walBytes;
+                    entry["checkpoints"] = db.checkpoints;
+                    entry["truncations"] = db.truncations;
+                    entry["partialCheckpoints"] = db.partialCheckpoints;
+                    entry["busyCheckpoints"] = db.busyCheckpoints;
+                    entry["lastCheckpointFrames"] = db.lastCheckpointFrames;
+                    entry["lastCheckpointMs"] = db.lastCheckpointMs;
+                    entry["maxCheckpointMs"] = db.maxCheckpointMs;
+                    entry["avgCheckpointMs"] = db.checkpoints ? db.totalCheckpointMs / static_cast<double>(db.checkpoints) : 0.0;
+                    entry["optimizeRuns"] = db.optimizeRuns;
+                    entry["analyzeRuns"] = db.analyzeRuns;
+                    entry["vacuumedPages"] = db.vacuumedPages;
+                    entry["lastError"] = db.lastError;
+                    data["databases"][i] = std::move(entry);
+                }
+            }
+
+            res = createSuccessResponse(data);
+        } catch (const std::exception& e) {
+            res = createErrorResponse("Failed to get maintenance stats: " + std::string(e.what()), 500);
+        }
+        res.end();
+    });
+
     // GET /api/ai/status - Check AI service status
     CROW_ROUTE(app, "/api/ai/status")
     .methods("GET"_method)
@@ -2566,6 +3344,11 @@ int main() {
     std::cout << "  GET  /api/recipes/search?q=query - Search recipes" << std::endl;
     std::cout << "  GET  /api/recipes/categories/category - Get recipes by category" << std::endl;
     std::cout << "  GET  /api/recipes/types/type - Get recipes by type" << std::endl;
+    std::cout << "  POST /api/recipes/pantry-match - Rank recipes by pantry coverage" << std::endl;
+    std::cout << "  GET  /api/recipes/suggest?prefix=text - Autocomplete suggestions" << std::endl;
+    std::cout << "  GET  /api/recipes/facets - Category/type/cook-time counts" << std::endl;
+    std::cout << "  GET  /api/recipes/trending - Recipes trending now" << std::endl;
+    std::cout << "  GET  /api/recipes/<id> - Get one recipe (ETag, If-None-Match)" << std::endl;
     std::cout << "  POST /api/recipes - Add new recipe" << std::endl;
     std::cout << "  PUT  /api/recipes/title - Update recipe" << std::endl;
     std::cout << "  DELETE /api/recipes/title - Delete recipe" << std::endl;
@@ -2574,13 +3357,19 @@ int main() {
     std::cout << "  GET  /api/recipes/<id>/rating - Get user's rating" << std::endl;
     std::cout << "  DELETE /api/recipes/<id>/rating - Delete user's rating" << std::endl;
     std::cout << "  GET  /api/recipes/<id>/rating/stats - Get rating statistics" << std::endl;
+    std::cout << "  GET  /api/recipes/<id>/similar - Recipes with similar ingredients" << std::endl;
+    std::cout << "  GET  /api/users/me/recommendations - Recommendations from your ratings" << std::endl;
     std::cout << "  POST /api/recipes/<id>/reviews - Add review" << std::endl;
-    std::cout << "  GET  /api/recipes/<id>/reviews - Get reviews (with sorting)" << std::endl;
+    std::cout << "  GET  /api/recipes/<id>/reviews - Get reviews (sort, limit, cursor)" << std::endl;
     std::cout << "  PUT  /api/reviews/<id> - Update review" << std::endl;
     std::cout << "  DELETE /api/reviews/<id> - Delete review" << std::endl;
     std::cout << "  POST /api/reviews/<id>/vote - Vote on review" << std::endl;
     std::cout << "  GET  /api/reviews/pending - Get pending reviews (admin)" << std::endl;
     std::cout << "  POST /api/reviews/<id>/moderate - Moderate review (admin)" << std::endl;
+    std::cout << "  GET  /api/admin/export/<table> - NDJSON export page: recipes, ratings, reviews (admin)" << std::endl;
+    std::cout << "  POST /api/admin/backups - Start an online backup (admin)" << std::endl;
+    std::cout << "  GET  /api/admin/backups - Backup progress and snapshots (admin)" << std::endl;
+    std::cout << "  GET  /api/admin/maintenance - WAL checkpoint and maintenance metrics (admin)" << std::endl;
     std::cout << "  GET  /api/ai/status - Check AI service status" << std::endl;
     std::cout << "  GET  /api/health - Health check" << std::endl;
     std::cout << "Web interface: http://localhost:8080" << std::endl;
@@ -0,0 +1,195 @@
+#include "writeQueue.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kBusyRetries = 4;
+constexpr std::chrono::milliseconds kRequeueBackoff{250};
+
+bool exec(sqlite3* db, const char* sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Write queue failed to execute \"" << sql << "\": " << (errMsg ? errMsg : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+// BEGIN IMMEDIATE and COMMIT return SQLITE_BUSY once the busy timeout runs out while another connection
+// holds the write lock; back off and try a few more times. Returns the last result code.
+int execRetryingBusy(sqlite3* db, const char* sql) {
+    for (int attempt = 0;; ++attempt) {
+        int rc = sqlite3_exec(db, sql, nullptr, nullptr, nullptr);
+        if ((rc & 0xff) != SQLITE_BUSY || attempt == kBusyRetries) {
+            if (rc != SQLITE_OK) {
+                std::cerr << "Write queue failed to execute \"" << sql << "\": " << sqlite3_errmsg(db) << std::endl;
+            }
+            return rc;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 << attempt));
+    }
+}
+
+} // namespace
+
+WriteQueue::WriteQueue(const std::string& dbPath) : WriteQueue(dbPath, Options{}) {}
+
+WriteQueue::WriteQueue(const std::string& dbPath, Options options) : options_(options) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+        std::cerr << "Write queue can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return;
+    }
+    sqlite3_busy_timeout(db, static_cast<int>(options_.busyTimeout.count()));
+    db_ = db;
+    writer_ = std::thread(&WriteQueue::run, this);
+}
+
+WriteQueue::~WriteQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    if (db_) {
+        sqlite3_close(static_cast<sqlite3*>(db_));
+    }
+}
+
+bool WriteQueue::isOpen() const {
+    return db_ != nullptr;
+}
+
+std::future<bool> WriteQueue::submit(Operation operation, Durability durability, std::function<void()> onCommitted) {
+    Pending pending{std::move(operation), std::move(onCommitted), durability == Durability::Committed, {}};
+    std::future<bool> result = pending.result.get_future();
+    if (!db_) {
+        pending.result.set_value(false);
+        return result;
+    }
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) {
+            oldest_ = std::chrono::steady_clock::now();
+        }
+        // The writer only needs waking to start a batch's clock or to cut the linger short
+        wake = pending_.empty() || pending_.size() + 1 >= options_.maxBatch || (pending.awaited && awaited_ == 0);
+        awaited_ += pending.awaited;
+        pending_.push_back(std::move(pending));
+    }
+    if (wake) {
+        wake_.notify_one();
+    }
+    return result;
+}
+
+void WriteQueue::flush() {
+    // Operations run in order, so the barrier resolves after everything queued ahead of it
+    submit([](void*) { return true; }).wait();
+}
+
+WriteQueue::Stats WriteQueue::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void WriteQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;  // Stopping with nothing left to commit
+        }
+        // Let queued writes fill the batch until it is full or its oldest write has waited long enough
+        wake_.wait_until(lock, oldest_ + options_.maxDelay, [this]() {
+            return stopping_ || awaited_ > 0 || pending_.size() >= options_.maxBatch;
+        });
+
+        std::deque<Pending> batch;
+        size_t take = std::min(pending_.size(), options_.maxBatch);
+        for (size_t i = 0; i < take; ++i) {
+            awaited_ -= pending_.front().awaited;
+            batch.push_back(std::move(pending_.front()));
+            pending_.pop_front();
+        }
+        if (!pending_.empty()) {
+            oldest_ = std::chrono::steady_clock::now();
+        }
+
+        bool mayRequeue = !stopping_;
+        lock.unlock();
+        bool settled = commitBatch(batch, mayRequeue);
+        lock.lock();
+        if (!settled) {
+            // Ahead of anything queued meanwhile, so writes still commit in the order they were submitted
+            while (!batch.empty()) {
+                awaited_ += batch.back().awaited;
+                pending_.push_front(std::move(batch.back()));
+                batch.pop_back();
+            }
+            ++stats_.requeued;
+            wake_.wait_for(lock, kRequeueBackoff, [this]() { return stopping_; });
+            oldest_ = std::chrono::steady_clock::now() - options_.maxDelay;
+        }
+    }
+}
+
+bool WriteQueue::commitBatch(std::deque<Pending>& batch, bool mayRequeue) {
+    sqlite3* db = static_cast<sqlite3*>(db_);
+    std::vector<bool> applied(batch.size(), false);
+
+    int rc = execRetryingBusy(db, "BEGIN IMMEDIATE;");
+    bool committed = rc == SQLITE_OK;
+    if (committed) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!exec(db, "SAVEPOINT write_queue_op;")) {
+                continue;
+            }
+            try {
+                applied[i] = batch[i].operation(db);
+            } catch (const std::exception& e) {
+                std::cerr << "Write queue operation failed: " << e.what() << std::endl;
+            }
+            if (!applied[i]) {
+                exec(db, "ROLLBACK TO write_queue_op;");
+            }
+            exec(db, "RELEASE write_queue_op;");
+        }
+        rc = execRetryingBusy(db, "COMMIT;");
+        committed = rc == SQLITE_OK;
+        if (!committed) {
+            exec(db, "ROLLBACK;");
+        }
+    }
+    if ((rc & 0xff) == SQLITE_BUSY) {
+        if (mayRequeue) {
+            return false;  // Rolled back whole; the operations run again on the next attempt
+        }
+        std::cerr << "Write queue dropped " << batch.size() << " writes: the database stayed locked" << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.operations += batch.size();
+        ++stats_.batches;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        bool ok = committed && applied[i];
+        if (ok && batch[i].onCommitted) {
+            batch[i].onCommitted();
+        }
+        batch[i].result.set_value(ok);
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+#ifndef WRITE_QUEUE_H
+#define WRITE_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Group commit for small, frequent writes (ratings, review votes).
+// Operations submitted from any thread are queued and applied by one writer thread on its own SQLite
+// connection, many per transaction, so a burst of writes shares one fsync instead of paying one each.
+// Queued writes linger until the batch holds maxBatch operations or its oldest write has waited maxDelay.
+// A Committed write has a caller blocked on it, so it cuts the linger short: the batch commits as soon as
+// the writer is free, and writes arriving during that commit form the next batch.
+// Each operation runs inside its own savepoint, so a failing operation is rolled back alone. Its future
+// resolves after the batch has committed, and onCommitted callbacks run on the writer thread at that point.
+// When another connection holds the write lock past the busy timeout (an import, ANALYZE, a long
+// transaction), BEGIN and COMMIT are retried with backoff, and if the lock is still held the batch goes
+// back to the front of the queue rather than failing: Queued writes have already been acknowledged.
+// The destructor commits everything still queued, giving up on a batch only if the database stays locked.
+class WriteQueue {
+public:
+    // Runs on the writer connection (a sqlite3*) inside the batch transaction; false rolls it back
+    using Operation = std::function<bool(void* db)>;
+
+    // What a caller waits for before acknowledging a write
+    enum class Durability {
+        Queued,     // Acknowledged on enqueue; committed within maxDelay
+        Committed   // Acknowledged once the batch holding the write has committed
+    };
+
+    struct Options {
+        std::chrono::milliseconds maxDelay{5};
+        size_t maxBatch = 256;
+        std::chrono::milliseconds busyTimeout{5000};  // Per BEGIN or COMMIT attempt
+    };
+
+    struct Stats {
+        uint64_t operations = 0;
+        uint64_t batches = 0;
+        uint64_t requeued = 0;  // Batches put back because the database stayed locked
+    };
+
+    explicit WriteQueue(const std::string& dbPath);
+    WriteQueue(const std::string& dbPath, Options options);
+    ~WriteQueue();
+
+    WriteQueue(const WriteQueue&) = delete;
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    bool isOpen() const;
+
+    // The future resolves to whether the operation was committed, whatever the durability
+    std::future<bool> submit(Operation operation, Durability durability = Durability::Committed,
+                             std::function<void()> onCommitted = {});
+    // Blocks until everything submitted before the call has been committed
+    void flush();
+
+    Stats stats() const;
+
+private:
+    struct Pending {
+        Operation operation;
+        std::function<void()> onCommitted;
+        bool awaited;
+        std::promise<bool> result;
+    };
+
+    void* db_ = nullptr;  // sqlite3*, used only by the writer thread
+    const Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Pending> pending_;
+    std::chrono::steady_clock::time_point oldest_;
+    size_t awaited_ = 0;  // Pending Committed writes
+    bool stopping_ = false;
+    Stats stats_;
+    std::thread writer_;
+
+    void run();
+    // false, with the batch untouched and nothing resolved, when it should be tried again later
+    bool commitBatch(std::deque<Pending>& batch, bool mayRequeue);
+};
+
+#endif // WRITE_QUEUE_H
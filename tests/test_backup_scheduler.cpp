@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include "backupScheduler.h"
+#include "recipeManagerSQLite.h"
+
+namespace {
+
+int countRows(const std::string& path, const char* table) {
+    sqlite3* db = nullptr;
+    int count = -1;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK) {
+        sqlite3_stmt* stmt = nullptr;
+        std::string sql = std::string("SELECT COUNT(*) FROM ") + table;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+            count = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+    return count;
+}
+
+} // namespace
+
+class BackupSchedulerTest : public ::testing::Test {
+protected:
+    std::filesystem::path root;
+    std::string dbPath;
+    std::string backupDir;
+
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() / "test_backup_scheduler";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+        dbPath = (root / "recipes.db").string();
+        backupDir = (root / "backups").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+};
+
+TEST_F(BackupSchedulerTest, CopiesInStepsWhileWritersKeepWriting) {
+    RecipeManagerSQLite manager(dbPath);
+    for (int i = 0; i < 300; ++i) {
+        std::string id = "r" + std::to_string(i);
+        manager.addRecipe(recipe("Recipe " + std::to_string(i), std::string(900, 'x'), "cook", "2", "10 min",
+                                 "Dinner", "Main", id));
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> written{0};
+    std::thread writer([&]() {
+        for (int i = 0; !done; ++i) {
+            manager.addOrUpdateRating("r" + std::to_string(i % 300), "u" + std::to_string(i), 4);
+            ++written;
+        }
+    });
+
+    BackupScheduler::Options options;
+    options.pagesPerStep = 8;
+    options.pause = std::chrono::milliseconds(1);
+    options.maxRestarts = 2;
+    int steps = 0;
+    std::string error;
+    std::string snapshot = (root / "copy.db").string();
+    bool ok = BackupScheduler::backupDatabase(dbPath, snapshot, options, [&steps](int pagesDone, int pagesTotal) {
+        EXPECT_LE(pagesDone, pagesTotal);
+        ++steps;
+        return true;
+    }, error);
+    done = true;
+    writer.join();
+
+    ASSERT_TRUE(ok) << error;
+    EXPECT_GT(steps, 1);
+    EXPECT_GT(written.load(), 0);  // Writers were not shut out for the whole copy
+    EXPECT_EQ(countRows(snapshot, "recipes"), 300);
+    EXPECT_GE(countRows(snapshot, "ratings"), 0);
+
+    // A callback returning false abandons the copy
+    ok = BackupScheduler::backupDatabase(dbPath, snapshot, options, [](int, int) { return false; }, error);
+    EXPECT_FALSE(ok);
+    EXPECT_EQ(error, "backup cancelled");
+}
+
+TEST_F(BackupSchedulerTest, WritesTimestampedSnapshotsAndKeepsTheNewest) {
+    std::string usersPath = (root / "users.db").string();
+    {
+        RecipeManagerSQLite manager(dbPath);
+        manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+        sqlite3* users = nullptr;
+        ASSERT_EQ(sqlite3_open(usersPath.c_str(), &users), SQLITE_OK);
+        sqlite3_exec(users, "CREATE TABLE users (id TEXT PRIMARY KEY); INSERT INTO users VALUES ('u1');", nullptr,
+                     nullptr, nullptr);
+        sqlite3_close(users);
+    }
+
+    BackupScheduler::Options options;
+    options.directory = backupDir;
+    options.keep = 2;
+    BackupScheduler scheduler({dbPath, usersPath}, options);
+    for (int run = 0; run < 3; ++run) {
+        ASSERT_TRUE(scheduler.runNow());
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));  // Distinct millisecond stamps
+    }
+
+    auto progress = scheduler.progress();
+    EXPECT_FALSE(progress.running);
+    EXPECT_EQ(progress.runs, 3);
+    EXPECT_TRUE(progress.lastOk);
+    ASSERT_EQ(progress.lastSnapshots.size(), 2);
+    EXPECT_EQ(countRows(progress.lastSnapshots[0], "recipes"), 1);
+    EXPECT_EQ(countRows(progress.lastSnapshots[1], "users"), 1);
+
+    auto files = scheduler.snapshots();
+    ASSERT_EQ(files.size(), 4);  // Two per database
+    EXPECT_EQ(files[1], progress.lastSnapshots[0]);
+    EXPECT_EQ(files[3], progress.lastSnapshots[1]);
+    EXPECT_EQ(std::filesystem::path(files[0]).filename().string().rfind("recipes-", 0), 0);
+    for (const auto& entry : std::filesystem::directory_iterator(backupDir)) {
+        EXPECT_NE(entry.path().extension(), ".partial");
+    }
+
+    // trigger() runs on the background thread
+    ASSERT_TRUE(scheduler.trigger());
+    for (int i = 0; i < 500 && scheduler.progress().runs < 4; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(scheduler.progress().runs, 4);
+    EXPECT_EQ(scheduler.snapshots().size(), 4);
+
+    // A database that cannot be opened fails the run but not the others
+    BackupScheduler broken({(root / "missing.db").string(), dbPath}, options);
+    EXPECT_FALSE(broken.runNow());
+    EXPECT_FALSE(broken.progress().lastOk);
+    EXPECT_EQ(broken.progress().lastSnapshots.size(), 1);
+}
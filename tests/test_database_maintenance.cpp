@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include "databaseMaintenance.h"
+#include "recipeManagerSQLite.h"
+
+namespace {
+
+int64_t queryInt(const std::string& path, const char* sql) {
+    sqlite3* db = nullptr;
+    int64_t value = -1;
+    if (sqlite3_open(path.c_str(), &db) == SQLITE_OK) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+            value = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+    return value;
+}
+
+// Every task is switched off; tests turn on what they exercise
+DatabaseMaintenance::Options quietOptions() {
+    DatabaseMaintenance::Options options;
+    options.checkpointInterval = std::chrono::milliseconds(0);  // No background passes
+    options.optimizeInterval = std::chrono::milliseconds(0);
+    options.analyzeInterval = std::chrono::milliseconds(0);
+    options.vacuumInterval = std::chrono::milliseconds(0);
+    return options;
+}
+
+} // namespace
+
+class DatabaseMaintenanceTest : public ::testing::Test {
+protected:
+    std::filesystem::path root;
+    std::string dbPath;
+
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() / "test_database_maintenance";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+        dbPath = (root / "recipes.db").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    void addRecipes(RecipeManagerSQLite& manager, int from, int count) {
+        for (int i = from; i < from + count; ++i) {
+            manager.addRecipe(recipe("Recipe " + std::to_string(i), std::string(900, 'x'), "cook", "2", "10 min",
+                                     "Dinner", "Main", "r" + std::to_string(i)));
+        }
+    }
+
+    uint64_t walBytes() const {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(dbPath + "-wal", ec);
+        return ec ? 0 : size;
+    }
+};
+
+TEST_F(DatabaseMaintenanceTest, CheckpointsOnlyWhenTheWalChangedAndTruncatesPastTheLimit) {
+    RecipeManagerSQLite manager(dbPath);
+    manager.setAutoCheckpoint(0);
+    addRecipes(manager, 0, 200);
+    ASSERT_GT(walBytes(), 0);
+
+    DatabaseMaintenance::Options options = quietOptions();
+    options.truncateWalBytes = walBytes() * 4;
+    DatabaseMaintenance maintenance({dbPath}, options);
+
+    maintenance.runNow();
+    auto stats = maintenance.stats();
+    ASSERT_EQ(stats.size(), 1);
+    EXPECT_EQ(stats[0].database, dbPath);
+    EXPECT_EQ(stats[0].checkpoints, 1);
+    EXPECT_EQ(stats[0].truncations, 0);
+    EXPECT_GT(stats[0].lastCheckpointFrames, 0);
+    EXPECT_GE(stats[0].maxCheckpointMs, stats[0].lastCheckpointMs);
+    EXPECT_GT(stats[0].walBytes, 0);  // PASSIVE leaves the file for reuse
+
+    maintenance.runNow();  // Nothing written since
+    EXPECT_EQ(maintenance.stats()[0].checkpoints, 1);
+
+    // Without auto-checkpoints the WAL keeps growing until it crosses the limit
+    for (int next = 200; walBytes() < options.truncateWalBytes; next += 200) {
+        addRecipes(manager, next, 200);
+    }
+    maintenance.runNow();
+    stats = maintenance.stats();
+    EXPECT_EQ(stats[0].checkpoints, 2);
+    EXPECT_EQ(stats[0].truncations, 1);
+    EXPECT_EQ(stats[0].walBytes, 0);
+    EXPECT_EQ(walBytes(), 0);
+    EXPECT_EQ(manager.getAllRecipes().size(), static_cast<size_t>(queryInt(dbPath, "SELECT COUNT(*) FROM recipes")));
+}
+
+TEST_F(DatabaseMaintenanceTest, RunsOptimizeAnalyzeAndIncrementalVacuumWhenDue) {
+    RecipeManagerSQLite manager(dbPath);
+    addRecipes(manager, 0, 300);
+    for (int i = 0; i < 300; ++i) {
+        manager.deleteRecipe("r" + std::to_string(i));
+    }
+    EXPECT_EQ(queryInt(dbPath, "PRAGMA auto_vacuum;"), 2);  // New databases are created INCREMENTAL
+    ASSERT_GT(queryInt(dbPath, "PRAGMA freelist_count;"), 10);
+
+    DatabaseMaintenance::Options options = quietOptions();
+    options.optimizeInterval = std::chrono::milliseconds(1);
+    options.analyzeInterval = std::chrono::milliseconds(1);
+    options.vacuumInterval = std::chrono::milliseconds(1);
+    options.vacuumFreePages = 10;
+    DatabaseMaintenance maintenance({dbPath, (root / "missing.db").string()}, options);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    maintenance.runNow();
+
+    auto stats = maintenance.stats();
+    ASSERT_EQ(stats.size(), 2);
+    EXPECT_EQ(stats[0].optimizeRuns, 1);
+    EXPECT_EQ(stats[0].analyzeRuns, 1);
+    EXPECT_GT(stats[0].vacuumedPages, 10);
+    EXPECT_TRUE(stats[0].lastError.empty()) << stats[0].lastError;
+    EXPECT_EQ(queryInt(dbPath, "PRAGMA freelist_count;"), 0);
+    EXPECT_EQ(queryInt(dbPath, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'sqlite_stat1'"), 1);
+    EXPECT_FALSE(stats[1].lastError.empty());  // Unopenable database reported, others unaffected
+    EXPECT_EQ(stats[1].checkpoints, 0);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include "entityVersions.h"
+#include "recipeManagerSQLite.h"
+
+TEST(EntityVersionsTest, TagsChangeOnlyWithTheirKey) {
+    EntityVersions versions;
+    std::string initial = versions.etag("recipe_a");
+    EXPECT_EQ(versions.version("recipe_a"), 0u);
+    EXPECT_EQ(initial.front(), '"');
+    EXPECT_EQ(initial.back(), '"');
+    EXPECT_EQ(versions.etag("recipe_a"), initial);
+
+    versions.bump("recipe_a");
+    EXPECT_EQ(versions.version("recipe_a"), 1u);
+    EXPECT_NE(versions.etag("recipe_a"), initial);
+    EXPECT_EQ(versions.etag("recipe_b"), initial);  // Same version, same epoch
+
+    // Another instance (a restarted server) never reissues a tag
+    EntityVersions restarted;
+    EXPECT_NE(restarted.etag("recipe_b"), initial);
+}
+
+TEST(EntityVersionsTest, MatchesIfNoneMatchLists) {
+    const std::string etag = "\"0123456789abcdef-3\"";
+    EXPECT_EQ(EntityVersions::match("", etag), "");
+    EXPECT_EQ(EntityVersions::match(etag, etag), etag);
+    EXPECT_EQ(EntityVersions::match("W/" + etag, etag), "W/" + etag);  // Weak comparison
+    EXPECT_EQ(EntityVersions::match("\"other\", " + etag, etag), etag);
+    EXPECT_EQ(EntityVersions::match("*", etag), etag);
+    EXPECT_EQ(EntityVersions::match("\"0123456789abcdef-2\"", etag), "");
+    EXPECT_EQ(EntityVersions::match("\"0123456789abcdef-31\"", etag), "");
+
+    // The compressed representation's tag
+    EXPECT_EQ(EntityVersions::match("\"0123456789abcdef-3-zstd\"", etag), "\"0123456789abcdef-3-zstd\"");
+    EXPECT_EQ(EntityVersions::match("\"0123456789abcdef-3-1\"", etag), "\"0123456789abcdef-3-1\"");
+    EXPECT_EQ(EntityVersions::match("\"0123456789abcdef-3-1-gzip\"", etag), "");
+}
+
+class EntityVersionsManagerTest : public ::testing::Test {
+protected:
+    std::string testDbPath;
+
+    void SetUp() override {
+        testDbPath = (std::filesystem::temp_directory_path() / "test_entity_versions.db").string();
+        std::filesystem::remove(testDbPath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(testDbPath);
+        std::filesystem::remove(testDbPath + "-wal");
+        std::filesystem::remove(testDbPath + "-shm");
+    }
+};
+
+TEST_F(EntityVersionsManagerTest, WritesMoveTheTagsOfWhatTheyTouch) {
+    RecipeManagerSQLite manager(testDbPath);
+    ASSERT_TRUE(manager.isConnected());
+    ASSERT_TRUE(manager.addRecipe(recipe("Soup", "water", "boil", "2", "10 min", "Lunch", "Main"), "alice"));
+    ASSERT_TRUE(manager.addRecipe(recipe("Cake", "flour", "bake", "8", "1 hour", "Baking", "Dessert"), "alice"));
+    std::string soup = manager.searchByTitle("Soup").at(0).getId();
+    std::string cake = manager.searchByTitle("Cake").at(0).getId();
+
+    std::string soupTag = manager.recipeETag(soup);
+    std::string cakeTag = manager.recipeETag(cake);
+    ASSERT_TRUE(manager.updateRecipe(soup, recipe("Soup", "water, salt", "boil", "2", "10 min", "Lunch", "Main", soup)));
+    EXPECT_NE(manager.recipeETag(soup), soupTag);
+    EXPECT_EQ(manager.recipeETag(cake), cakeTag);
+    ASSERT_TRUE(manager.updateRecipeByTitle("Cake", recipe("Cake", "flour, eggs", "bake", "8", "1 hour", "Baking", "Dessert", cake)));
+    EXPECT_NE(manager.recipeETag(cake), cakeTag);
+
+    // Review listing: reviews and helpful votes move it, ratings do not
+    std::string reviewsTag = manager.reviewsETag(soup);
+    ASSERT_TRUE(manager.addOrUpdateRating(soup, "bob", 4));
+    EXPECT_EQ(manager.reviewsETag(soup), reviewsTag);
+
+    RecipeManagerSQLite::Review review;
+    review.recipeId = soup;
+    review.userId = "bob";
+    review.rating = 4;
+    review.reviewText = "Salty";
+    review.status = "pending";
+    ASSERT_TRUE(manager.addReview(review));
+    std::string afterAdd = manager.reviewsETag(soup);
+    EXPECT_NE(afterAdd, reviewsTag);
+    std::string reviewId = manager.getReviewsByRecipe(soup, "pending").at(0).id;
+
+    ASSERT_TRUE(manager.moderateReview(reviewId, "approved", ""));
+    std::string afterModeration = manager.reviewsETag(soup);
+    EXPECT_NE(afterModeration, afterAdd);
+
+    ASSERT_TRUE(manager.addOrUpdateReviewVote(reviewId, "carol", "helpful"));
+    manager.flushWrites();
+    std::string afterVote = manager.reviewsETag(soup);
+    EXPECT_NE(afterVote, afterModeration);
+    ASSERT_TRUE(manager.addOrUpdateReviewVote(reviewId, "carol", "helpful"));  // Count unchanged
+    manager.flushWrites();
+    EXPECT_EQ(manager.reviewsETag(soup), afterVote);
+    ASSERT_TRUE(manager.deleteReviewVote(reviewId, "carol"));
+    EXPECT_NE(manager.reviewsETag(soup), afterVote);
+    EXPECT_EQ(manager.reviewsETag(cake), reviewsTag);  // Version 0 for a recipe nobody reviewed
+
+    // Deleting the recipe takes its reviews: both tags move
+    soupTag = manager.recipeETag(soup);
+    reviewsTag = manager.reviewsETag(soup);
+    ASSERT_TRUE(manager.deleteRecipe(soup));
+    EXPECT_NE(manager.recipeETag(soup), soupTag);
+    EXPECT_NE(manager.reviewsETag(soup), reviewsTag);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "facetIndex.h"
+
+namespace {
+
+std::vector<FacetIndex::Document> sampleDocuments() {
+    return {
+        {"r1", "Dessert", "Cake", "60 minutes"},
+        {"r2", "dessert ", "Cookies", "15 min"},
+        {"r3", "Main", "Pasta", "20 minutes"},
+        {"r4", "Main", "Curry", "1 hour 30 minutes"},
+        {"r5", "Breakfast", "Eggs", "quick"},
+    };
+}
+
+} // namespace
+
+TEST(FacetIndexTest, CookTimeBuckets) {
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("10 min")), "0-15");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("15 minutes")), "0-15");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("30 minutes")), "16-30");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("45")), "31-60");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("2 hours")), "60+");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("1 hour 30 minutes")), "60+");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("20-30 minutes")), "16-30");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("overnight")), "unknown");
+    EXPECT_STREQ(FacetIndex::cookTimeLabel(FacetIndex::cookTimeBucket("")), "unknown");
+}
+
+TEST(FacetIndexTest, CountsResultSetsAndEverything) {
+    FacetIndex index;
+    index.ensureBuilt(sampleDocuments);
+
+    FacetIndex::Counts all = index.countAll();
+    // Categories are case-insensitive; the first spelling is displayed
+    EXPECT_EQ(all.categories, (FacetIndex::Histogram{{"Dessert", 2}, {"Main", 2}, {"Breakfast", 1}}));
+    EXPECT_EQ(all.types.size(), 5u);
+    EXPECT_EQ(all.cookTimes, (FacetIndex::Histogram{{"0-15", 1}, {"16-30", 1}, {"31-60", 1}, {"60+", 1}, {"unknown", 1}}));
+
+    FacetIndex::Counts subset;
+    {
+        FacetIndex::Counter counter = index.counter();
+        counter.add("r1");
+        counter.add("r3");
+        counter.add("missing");
+        subset = counter.finish();
+    }
+    EXPECT_EQ(subset.categories, (FacetIndex::Histogram{{"Dessert", 1}, {"Main", 1}}));
+    EXPECT_EQ(subset.types, (FacetIndex::Histogram{{"Cake", 1}, {"Pasta", 1}}));
+    EXPECT_EQ(subset.cookTimes, (FacetIndex::Histogram{{"16-30", 1}, {"31-60", 1}}));
+}
+
+TEST(FacetIndexTest, IncrementalUpdatesAndLookup) {
+    FacetIndex index;
+    index.ensureBuilt(sampleDocuments);
+
+    auto ids = index.recipesWith(FacetIndex::Dimension::Category, "DESSERT");
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids, (std::vector<std::string>{"r1", "r2"}));
+    EXPECT_TRUE(index.recipesWith(FacetIndex::Dimension::Type, "Soup").empty());
+
+    index.upsert({"r2", "Snack", "Cookies", "15 min"});
+    index.remove("r4");
+    index.upsert({"r6", "Soup", "Soup", "40 min"});
+    EXPECT_EQ(index.recipesWith(FacetIndex::Dimension::Category, "dessert"), std::vector<std::string>{"r1"});
+    EXPECT_EQ(index.recipesWith(FacetIndex::Dimension::Type, "soup"), std::vector<std::string>{"r6"});
+
+    FacetIndex::Counts all = index.countAll();
+    EXPECT_EQ(all.categories, (FacetIndex::Histogram{{"Breakfast", 1}, {"Dessert", 1}, {"Main", 1}, {"Snack", 1}, {"Soup", 1}}));
+    EXPECT_EQ(all.cookTimes, (FacetIndex::Histogram{{"0-15", 1}, {"16-30", 1}, {"31-60", 2}, {"unknown", 1}}));
+
+    index.invalidate();
+    EXPECT_FALSE(index.isBuilt());
+    EXPECT_TRUE(index.countAll().categories.empty());
+}
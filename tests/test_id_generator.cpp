@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "idGenerator.h"
+
+namespace {
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+TEST(IdGeneratorTest, IdsAreSortableAndCarryTheirTimestamp) {
+    int64_t before = nowMs();
+    std::string id = IdGenerator::next();
+    int64_t after = nowMs();
+
+    ASSERT_EQ(id.size(), IdGenerator::kLength);
+    EXPECT_EQ(id.find_first_not_of("0123456789ABCDEFGHJKMNPQRSTVWXYZ"), std::string::npos);
+    EXPECT_GE(IdGenerator::timestampMs(id), before);
+    EXPECT_LE(IdGenerator::timestampMs(id), after + 1);  // A burst may borrow the next millisecond
+
+    std::string prefixed = IdGenerator::next("recipe_");
+    EXPECT_EQ(prefixed.rfind("recipe_", 0), 0);
+    EXPECT_EQ(prefixed.size(), 7 + IdGenerator::kLength);
+    EXPECT_GE(IdGenerator::timestampMs(prefixed), IdGenerator::timestampMs(id));
+    EXPECT_LT(id, prefixed.substr(7));
+
+    EXPECT_EQ(IdGenerator::timestampMs("short"), -1);
+    EXPECT_EQ(IdGenerator::timestampMs("01J9ZZZZZZZZZZZZZZZZZZZZZU"), -1);  // U is not Crockford base32
+}
+
+TEST(IdGeneratorTest, ConcurrentIdsAreUniqueAndIncreasingPerThread) {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 20000;  // Far more than 65536 per millisecond in total
+    std::vector<std::vector<std::string>> ids(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&ids, t]() {
+            ids[t].reserve(kPerThread);
+            for (int i = 0; i < kPerThread; ++i) {
+                ids[t].push_back(IdGenerator::next());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::set<std::string> all;
+    for (const auto& mine : ids) {
+        EXPECT_TRUE(std::is_sorted(mine.begin(), mine.end()));
+        EXPECT_EQ(std::adjacent_find(mine.begin(), mine.end()), mine.end());
+        all.insert(mine.begin(), mine.end());
+    }
+    EXPECT_EQ(all.size(), static_cast<size_t>(kThreads * kPerThread));
+    // Borrowed milliseconds stay close to the clock
+    EXPECT_LE(IdGenerator::timestampMs(*all.rbegin()), nowMs() + 10);
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <filesystem>
+#include <string>
+#include "idMap.h"
+#include "recipeManagerSQLite.h"
+#include "schemaMigrator.h"
+
+namespace {
+
+int64_t queryInt(sqlite3* db, const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int64_t value = -1;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+// A database as version 3 left it: string primary keys everywhere
+const char* const kVersion3Schema =
+    "CREATE TABLE recipes (id TEXT PRIMARY KEY, data TEXT NOT NULL, user_id TEXT,"
+    " created_at DATETIME DEFAULT CURRENT_TIMESTAMP, updated_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+    "CREATE TABLE ratings (id TEXT PRIMARY KEY, recipe_id TEXT NOT NULL, user_id TEXT NOT NULL,"
+    " rating INTEGER NOT NULL, created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+    " updated_at DATETIME DEFAULT CURRENT_TIMESTAMP, UNIQUE(recipe_id, user_id));"
+    "CREATE TABLE reviews (id TEXT PRIMARY KEY, recipe_id TEXT NOT NULL, user_id TEXT NOT NULL,"
+    " rating INTEGER NOT NULL, review_text TEXT NOT NULL, status TEXT DEFAULT 'pending', moderation_reason TEXT,"
+    " helpful_votes INTEGER DEFAULT 0, created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+    " updated_at DATETIME DEFAULT CURRENT_TIMESTAMP, UNIQUE(recipe_id, user_id));"
+    "CREATE TABLE review_votes (review_id TEXT NOT NULL, user_id TEXT NOT NULL, vote_type TEXT NOT NULL,"
+    " created_at DATETIME DEFAULT CURRENT_TIMESTAMP, PRIMARY KEY(review_id, user_id));"
+    "PRAGMA user_version = 3;";
+
+} // namespace
+
+class IdMapTest : public ::testing::Test {
+protected:
+    std::string testDbPath;
+
+    void SetUp() override {
+        testDbPath = (std::filesystem::temp_directory_path() / "test_id_map.db").string();
+        std::filesystem::remove(testDbPath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(testDbPath);
+        std::filesystem::remove(testDbPath + "-wal");
+        std::filesystem::remove(testDbPath + "-shm");
+    }
+};
+
+TEST_F(IdMapTest, MapsIdsBothWaysAndCachesOnlyCommittedRows) {
+    sqlite3* db = nullptr;
+    ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, "CREATE TABLE names (pk INTEGER PRIMARY KEY AUTOINCREMENT, id TEXT NOT NULL UNIQUE);",
+                           nullptr, nullptr, nullptr),
+              SQLITE_OK);
+
+    IdMap names("names");
+    EXPECT_EQ(names.pk(db, "alice"), 0);
+    EXPECT_EQ(names.pk(db, ""), 0);
+    int64_t alice = names.intern(db, "alice");
+    ASSERT_GT(alice, 0);
+    EXPECT_EQ(names.intern(db, "alice"), alice);
+    EXPECT_EQ(names.id(db, alice), "alice");
+    EXPECT_EQ(names.id(db, alice + 100), "");
+
+    // Interned inside a transaction that rolls back: answered, but not remembered
+    ASSERT_EQ(sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_GT(names.intern(db, "bob"), alice);
+    ASSERT_EQ(sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr), SQLITE_OK);
+    EXPECT_EQ(names.size(), 1u);
+    EXPECT_EQ(names.pk(db, "bob"), 0);
+
+    // Deleted and added again: AUTOINCREMENT hands out a new pk and the cache follows it
+    ASSERT_EQ(sqlite3_exec(db, "DELETE FROM names WHERE id = 'alice'", nullptr, nullptr, nullptr), SQLITE_OK);
+    names.forget("alice");
+    int64_t again = names.intern(db, "alice");
+    EXPECT_GT(again, alice);
+    EXPECT_EQ(names.id(db, again), "alice");
+    EXPECT_EQ(names.id(db, alice), "");
+    sqlite3_close(db);
+}
+
+TEST_F(IdMapTest, UpgradesVersion3DatabaseAndDropsOrphans) {
+    sqlite3* db = nullptr;
+    ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db, kVersion3Schema, nullptr, nullptr, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(db,
+                           "INSERT INTO recipes (id, data, user_id) VALUES"
+                           " ('recipe_a', '{\"title\":\"A\"}', 'alice'), ('recipe_b', '{\"title\":\"B\"}', NULL);"
+                           "INSERT INTO ratings (id, recipe_id, user_id, rating) VALUES"
+                           " ('rating_recipe_a_bob', 'recipe_a', 'bob', 4), ('rating_gone_bob', 'recipe_gone', 'bob', 2);"
+                           "INSERT INTO reviews (id, recipe_id, user_id, rating, review_text, status) VALUES"
+                           " ('review_1', 'recipe_a', 'carol', 5, 'Great', 'approved'),"
+                           " ('review_2', 'recipe_gone', 'carol', 1, 'Orphan', 'approved');"
+                           "INSERT INTO review_votes (review_id, user_id, vote_type) VALUES"
+                           " ('review_1', 'alice', 'helpful'), ('review_2', 'alice', 'helpful');",
+                           nullptr, nullptr, nullptr),
+              SQLITE_OK);
+    int64_t recipeBRowid = queryInt(db, "SELECT rowid FROM recipes WHERE id = 'recipe_b'");
+    sqlite3_close(db);
+
+    {
+        RecipeManagerSQLite manager(testDbPath);
+        ASSERT_TRUE(manager.isConnected());
+        EXPECT_TRUE(manager.isRecipeOwnedByUser("recipe_a", "alice"));
+        EXPECT_FALSE(manager.isRecipeOwnedByUser("recipe_b", "alice"));
+
+        auto ratings = manager.getRatingsByRecipe("recipe_a");
+        ASSERT_EQ(ratings.size(), 1u);
+        EXPECT_EQ(ratings[0].id, "rating_recipe_a_bob");
+        EXPECT_EQ(ratings[0].userId, "bob");
+        EXPECT_EQ(ratings[0].rating, 4);
+
+        auto review = manager.getReview("review_1");
+        ASSERT_NE(review, nullptr);
+        EXPECT_EQ(review->recipeId, "recipe_a");
+        EXPECT_EQ(review->userId, "carol");
+        auto vote = manager.getReviewVote("review_1", "alice");
+        ASSERT_NE(vote, nullptr);
+        EXPECT_EQ(vote->voteType, "helpful");
+        EXPECT_EQ(manager.getReview("review_2"), nullptr);
+    }
+
+    ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+    EXPECT_GE(SchemaMigrator::version(db), 4);
+    EXPECT_EQ(queryInt(db, "SELECT pk FROM recipes WHERE id = 'recipe_b'"), recipeBRowid);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM ratings"), 1);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM reviews"), 1);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM review_votes"), 1);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM user_ids"), 3);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM pragma_table_info('ratings') WHERE name = 'recipe_id'"), 0);
+    sqlite3_close(db);
+}
+
+TEST_F(IdMapTest, DeletingARecipeTakesItsActivityAndItsPk) {
+    int64_t oldPk = 0;
+    {
+        RecipeManagerSQLite manager(testDbPath);
+        ASSERT_TRUE(manager.isConnected());
+        recipe dish("Soup", "water, salt", "boil", "2 servings", "30 min", "Lunch", "Main");
+        ASSERT_TRUE(manager.addRecipe(dish, "alice"));
+        std::string recipeId = manager.getRecipesByUser("alice").at(0).getId();
+        EXPECT_TRUE(manager.recipeExists(recipeId));
+
+        ASSERT_TRUE(manager.addOrUpdateRating(recipeId, "bob", 3));
+        ASSERT_TRUE(manager.addOrUpdateRating(recipeId, "bob", 5));  // Upsert on the same pair
+        RecipeManagerSQLite::Review review;
+        review.recipeId = recipeId;
+        review.userId = "carol";
+        review.rating = 4;
+        review.reviewText = "Warm";
+        review.status = "approved";
+        ASSERT_TRUE(manager.addReview(review));
+        std::string reviewId = manager.getReviewsByRecipe(recipeId).at(0).id;
+        ASSERT_TRUE(manager.addOrUpdateReviewVote(reviewId, "bob", "helpful"));
+        EXPECT_EQ(manager.getRatingCount(recipeId), 1);
+        EXPECT_EQ(manager.getRating(recipeId, "bob")->rating, 5);
+
+        sqlite3* db = nullptr;
+        ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+        oldPk = queryInt(db, "SELECT pk FROM recipes WHERE id = '" + recipeId + "'");
+        sqlite3_close(db);
+
+        ASSERT_TRUE(manager.deleteRecipe(recipeId));
+        EXPECT_FALSE(manager.recipeExists(recipeId));
+        EXPECT_EQ(manager.getRatingCount(recipeId), 0);
+        EXPECT_EQ(manager.getReview(reviewId), nullptr);
+        EXPECT_EQ(manager.getReviewVote(reviewId, "bob"), nullptr);
+        EXPECT_FALSE(manager.addOrUpdateRating(recipeId, "bob", 2));
+        EXPECT_FALSE(manager.addOrUpdateReviewVote(reviewId, "bob", "helpful"));
+        EXPECT_TRUE(manager.deleteReview(reviewId));
+
+        ASSERT_TRUE(manager.addRecipe(dish, "alice"));
+    }
+
+    sqlite3* db = nullptr;
+    ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM ratings"), 0);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM reviews"), 0);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM review_votes"), 0);
+    EXPECT_GT(queryInt(db, "SELECT MIN(pk) FROM recipes"), oldPk);  // Never handed out twice
+    sqlite3_close(db);
+}
+
+TEST_F(IdMapTest, FollowsARecipeThatAnotherProcessDeletedAndAddedAgain) {
+    RecipeManagerSQLite server(testDbPath);
+    ASSERT_TRUE(server.isConnected());
+    recipe dish("Stew", "beef, carrots", "simmer", "4 servings", "2 hours", "Dinner", "Main", "recipe_stew");
+    ASSERT_TRUE(server.addRecipe(dish, "alice"));
+    ASSERT_TRUE(server.addOrUpdateRating("recipe_stew", "bob", 4));
+    EXPECT_EQ(server.getRatingCount("recipe_stew"), 1);  // The server has the pk cached now
+
+    {
+        // An import in another process replaces the recipe under the same public id
+        RecipeManagerSQLite other(testDbPath);
+        ASSERT_TRUE(other.deleteRecipe("recipe_stew"));
+        ASSERT_TRUE(other.addRecipe(dish, "alice"));
+        ASSERT_TRUE(other.addOrUpdateRating("recipe_stew", "carol", 2));
+    }
+
+    EXPECT_EQ(server.getRatingCount("recipe_stew"), 1);
+    auto ratings = server.getRatingsByRecipe("recipe_stew");
+    ASSERT_EQ(ratings.size(), 1u);
+    EXPECT_EQ(ratings[0].userId, "carol");
+    EXPECT_TRUE(server.isRecipeOwnedByUser("recipe_stew", "alice"));
+    ASSERT_TRUE(server.addOrUpdateRating("recipe_stew", "bob", 5));
+    EXPECT_EQ(server.getRating("recipe_stew", "bob")->rating, 5);
+
+    // Deleted for good: nothing is left to find
+    {
+        RecipeManagerSQLite other(testDbPath);
+        ASSERT_TRUE(other.deleteRecipe("recipe_stew"));
+    }
+    EXPECT_TRUE(server.getRatingsByRecipe("recipe_stew").empty());
+    EXPECT_FALSE(server.recipeExists("recipe_stew"));
+}
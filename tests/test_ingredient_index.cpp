@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include "ingredientIndex.h"
+#include "roaringBitmap.h"
+
+namespace {
+
+RoaringBitmap bitmapOf(const std::set<uint32_t>& values) {
+    RoaringBitmap bitmap;
+    for (uint32_t value : values) {
+        bitmap.add(value);
+    }
+    return bitmap;
+}
+
+std::vector<uint32_t> toVector(const std::set<uint32_t>& values) {
+    return std::vector<uint32_t>(values.begin(), values.end());
+}
+
+std::vector<std::string> sorted(std::vector<std::string> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // namespace
+
+// AND / ANDNOT against std::set across sparse (array) and dense (bitmap) containers
+TEST(RoaringBitmapTest, MatchesSetSemantics) {
+    std::mt19937 rng(42);
+    for (int round = 0; round < 20; ++round) {
+        // Alternate between sparse and dense densities within the first few containers
+        uint32_t range = (round % 2) ? 200000 : 3 * 65536;
+        size_t countA = (round % 3 == 0) ? 30000 : 3000;
+        size_t countB = (round % 4 == 0) ? 30000 : 2000;
+        std::uniform_int_distribution<uint32_t> dist(0, range);
+
+        std::set<uint32_t> a, b;
+        while (a.size() < countA) a.insert(dist(rng));
+        while (b.size() < countB) b.insert(dist(rng));
+
+        std::set<uint32_t> expectedAnd, expectedAndNot;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expectedAnd, expectedAnd.end()));
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expectedAndNot, expectedAndNot.end()));
+
+        RoaringBitmap bitmapA = bitmapOf(a);
+        EXPECT_EQ(bitmapA.cardinality(), a.size());
+        EXPECT_EQ(bitmapA.toVector(), toVector(a));
+
+        RoaringBitmap intersection = bitmapA;
+        intersection &= bitmapOf(b);
+        EXPECT_EQ(intersection.toVector(), toVector(expectedAnd));
+        EXPECT_EQ(intersection.cardinality(), expectedAnd.size());
+
+        RoaringBitmap difference = bitmapA;
+        difference.andNot(bitmapOf(b));
+        EXPECT_EQ(difference.toVector(), toVector(expectedAndNot));
+    }
+}
+
+TEST(RoaringBitmapTest, AddRemoveAcrossContainerConversion) {
+    RoaringBitmap bitmap;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        bitmap.add(i * 2);
+    }
+    EXPECT_EQ(bitmap.cardinality(), 10000u);
+    EXPECT_TRUE(bitmap.contains(19998));
+    EXPECT_FALSE(bitmap.contains(19999));
+
+    for (uint32_t i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(bitmap.remove(i * 2));
+    }
+    EXPECT_FALSE(bitmap.remove(0));
+    EXPECT_TRUE(bitmap.empty());
+}
+
+TEST(IngredientIndexTest, TokenizeNormalizesIngredients) {
+    EXPECT_EQ(IngredientIndex::tokenize("2 cups chopped Tomatoes, 3 eggs; 1 tbsp Olive Oil"),
+              (std::vector<std::string>{"egg", "oil", "olive", "tomato"}));
+    EXPECT_EQ(IngredientIndex::tokenize("a pinch of salt\nfresh berries"),
+              (std::vector<std::string>{"berry", "salt"}));
+    EXPECT_TRUE(IngredientIndex::tokenize("200g, 2 cups").empty());
+}
+
+TEST(IngredientIndexTest, MatchAllAndNone) {
+    IngredientIndex index;
+    index.ensureBuilt([] {
+        return std::vector<std::pair<std::string, std::string>>{
+            {"pancakes", "200g flour, 2 eggs, 100ml milk"},
+            {"omelette", "3 eggs, butter, salt"},
+            {"salad", "tomatoes, olive oil, salt"},
+            {"cake", "flour, eggs, sugar, butter"}};
+    });
+
+    EXPECT_EQ(sorted(index.match({"egg", "flour"}, {})), (std::vector<std::string>{"cake", "pancakes"}));
+    EXPECT_EQ(sorted(index.match({"eggs"}, {"butter"})), (std::vector<std::string>{"pancakes"}));
+    EXPECT_EQ(sorted(index.match({}, {"egg"})), (std::vector<std::string>{"salad"}));
+    EXPECT_EQ(index.match({"olive oil"}, {}), (std::vector<std::string>{"salad"}));
+    EXPECT_TRUE(index.match({"saffron"}, {}).empty());
+}
+
+TEST(IngredientIndexTest, IncrementalUpdates) {
+    IngredientIndex index;
+    index.upsert("ignored", "eggs"); // Not built yet, the first query loads from the source of truth
+    index.ensureBuilt([] {
+        return std::vector<std::pair<std::string, std::string>>{{"a", "eggs, milk"}, {"b", "eggs"}};
+    });
+
+    index.upsert("c", "eggs, milk, sugar");
+    index.upsert("a", "flour");
+    index.remove("b");
+
+    EXPECT_EQ(sorted(index.match({"egg"}, {})), (std::vector<std::string>{"c"}));
+    EXPECT_EQ(index.match({"flour"}, {}), (std::vector<std::string>{"a"}));
+
+    // Deleted slots are reused without leaking old postings
+    index.upsert("d", "butter");
+    EXPECT_EQ(index.match({"butter"}, {}), (std::vector<std::string>{"d"}));
+    EXPECT_EQ(sorted(index.match({}, {})), (std::vector<std::string>{"a", "c", "d"}));
+
+    index.invalidate();
+    EXPECT_FALSE(index.isBuilt());
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "itemRecommender.h"
+
+namespace {
+
+const char* kEarly = "2026-01-01 00:00:00";
+
+// Two taste clusters: soup/stew and cake/pie
+std::vector<ItemRecommender::Rating> sampleRatings() {
+    return {
+        {"soup", "u1", 5, kEarly}, {"stew", "u1", 5, kEarly}, {"cake", "u1", 1, kEarly},
+        {"soup", "u2", 4, kEarly}, {"stew", "u2", 5, kEarly}, {"cake", "u2", 2, kEarly},
+        {"soup", "u3", 1, kEarly}, {"stew", "u3", 2, kEarly}, {"cake", "u3", 5, kEarly}, {"pie", "u3", 5, kEarly},
+        {"cake", "u4", 5, kEarly}, {"pie", "u4", 4, kEarly}, {"soup", "u4", 2, kEarly},
+        {"soup", "u5", 5, kEarly},
+    };
+}
+
+std::map<std::string, double> neighborMap(ItemRecommender& recommender, const std::string& recipeId) {
+    std::map<std::string, double> result;
+    for (const auto& neighbor : recommender.neighbors(recipeId)) {
+        result[neighbor.recipeId] = neighbor.similarity;
+    }
+    return result;
+}
+
+void expectSameNeighbors(ItemRecommender& actual, ItemRecommender& expected, const std::string& recipeId) {
+    auto a = neighborMap(actual, recipeId);
+    auto e = neighborMap(expected, recipeId);
+    ASSERT_EQ(a.size(), e.size()) << recipeId;
+    for (const auto& [id, similarity] : e) {
+        ASSERT_TRUE(a.count(id)) << recipeId << " -> " << id;
+        EXPECT_NEAR(a[id], similarity, 1e-4) << recipeId << " -> " << id;
+    }
+}
+
+std::filesystem::path tempNeighborsPath() {
+    return std::filesystem::temp_directory_path() / "test_item_recommender.neighbors";
+}
+
+} // namespace
+
+TEST(ItemRecommenderTest, NeighborsFollowCoRatedTastes) {
+    ItemRecommender recommender;
+    recommender.ensureBuilt(sampleRatings, "");
+    ASSERT_TRUE(recommender.isBuilt());
+    EXPECT_EQ(recommender.recipeCount(), 4);
+
+    auto soup = recommender.neighbors("soup");
+    ASSERT_FALSE(soup.empty());
+    EXPECT_EQ(soup[0].recipeId, "stew");
+    EXPECT_GT(soup[0].similarity, 0.0);
+    for (const auto& neighbor : soup) {
+        EXPECT_NE(neighbor.recipeId, "cake");  // Opposite tastes are not neighbours
+    }
+    auto cake = neighborMap(recommender, "cake");
+    EXPECT_TRUE(cake.count("pie"));
+    EXPECT_TRUE(recommender.neighbors("missing").empty());
+}
+
+TEST(ItemRecommenderTest, RecommendsUnratedNeighborsOfLikedRecipes) {
+    ItemRecommender recommender;
+    recommender.ensureBuilt(sampleRatings, "");
+
+    auto forU5 = recommender.recommend("u5", 10);
+    ASSERT_EQ(forU5.size(), 1);
+    EXPECT_EQ(forU5[0].recipeId, "stew");
+    EXPECT_GT(forU5[0].score, 0.0);
+
+    // u1 has rated everything near what they like; pie only resembles the cake they disliked
+    EXPECT_TRUE(recommender.recommend("u1", 10).empty());
+    EXPECT_TRUE(recommender.recommend("nobody", 10).empty());
+    EXPECT_TRUE(recommender.recommend("u5", 0).empty());
+}
+
+TEST(ItemRecommenderTest, NewRatingsRefreshRows) {
+    ItemRecommender recommender;
+    recommender.setRating("soup", "u9", 5);  // Ignored before the build
+    recommender.ensureBuilt(sampleRatings, "");
+    EXPECT_TRUE(recommender.recommend("u9", 10).empty());
+
+    // u7 arrives after the build: liking cake should surface pie
+    recommender.setRating("cake", "u7", 5);
+    recommender.setRating("stew", "u7", 2);
+    auto before = recommender.recommend("u7", 10);
+    bool hadPie = std::any_of(before.begin(), before.end(), [](const auto& r) { return r.recipeId == "pie"; });
+    EXPECT_TRUE(hadPie);
+    EXPECT_TRUE(std::none_of(before.begin(), before.end(), [](const auto& r) { return r.recipeId == "cake"; }));
+
+    recommender.removeRecipe("pie");
+    auto after = recommender.recommend("u7", 10);
+    EXPECT_TRUE(std::none_of(after.begin(), after.end(), [](const auto& r) { return r.recipeId == "pie"; }));
+    EXPECT_TRUE(recommender.neighbors("pie").empty());
+}
+
+TEST(ItemRecommenderTest, IncrementalUpdatesMatchFullRebuild) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> item(0, 29), user(0, 39), stars(1, 5);
+    std::map<std::pair<std::string, std::string>, int> current;
+    for (int i = 0; i < 300; ++i) {
+        current[{"r" + std::to_string(item(rng)), "u" + std::to_string(user(rng))}] = stars(rng);
+    }
+    auto toRatings = [&current]() {
+        std::vector<ItemRecommender::Rating> ratings;
+        for (const auto& [key, value] : current) {
+            ratings.push_back({key.first, key.second, value, kEarly});
+        }
+        return ratings;
+    };
+
+    ItemRecommender incremental;
+    incremental.ensureBuilt(toRatings, "");
+    incremental.recommend("u0", 5);
+
+    std::vector<std::string> touched;
+    for (int i = 0; i < 40; ++i) {
+        std::string recipeId = "r" + std::to_string(item(rng));
+        std::string userId = "u" + std::to_string(user(rng));
+        int rating = stars(rng);
+        current[{recipeId, userId}] = rating;
+        incremental.setRating(recipeId, userId, rating);
+        touched.push_back(recipeId);
+    }
+    for (int i = 0; i < 10; ++i) {
+        auto it = std::next(current.begin(), static_cast<long>(rng() % current.size()));
+        incremental.removeRating(it->first.first, it->first.second);
+        touched.push_back(it->first.first);
+        current.erase(it);
+    }
+
+    ItemRecommender rebuilt;
+    rebuilt.ensureBuilt(toRatings, "");
+    for (const auto& recipeId : touched) {
+        expectSameNeighbors(incremental, rebuilt, recipeId);
+    }
+}
+
+TEST(ItemRecommenderTest, NeighborFileIsReusedUntilRatingsChange) {
+    const auto path = tempNeighborsPath().string();
+    std::filesystem::remove(path);
+
+    // The latest rating (the file's watermark) lands on an unrelated recipe
+    auto base = sampleRatings();
+    base.push_back({"bread", "u9", 3, "2026-01-15 00:00:00"});
+    ItemRecommender first;
+    ASSERT_TRUE(first.rebuild(base, path));
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    // Older than the watermark: rows come from the file, even though the ratings disagree with it
+    auto stale = base;
+    for (auto& rating : stale) {
+        if (rating.recipeId == "stew") {
+            rating.rating = 6 - rating.rating;
+        }
+    }
+    ItemRecommender fromFile;
+    fromFile.ensureBuilt([&stale]() { return stale; }, path);
+    expectSameNeighbors(fromFile, first, "soup");
+
+    // A newer rating marks its recipe for recomputation
+    auto newer = base;
+    newer.push_back({"pie", "u1", 1, "2026-02-01 00:00:00"});
+    ItemRecommender fresh;
+    fresh.ensureBuilt([&newer]() { return newer; }, "");
+    ItemRecommender reloaded;
+    reloaded.ensureBuilt([&newer]() { return newer; }, path);
+    expectSameNeighbors(reloaded, fresh, "pie");
+
+    // A damaged file is ignored and rewritten
+    { std::ofstream(path, std::ios::binary | std::ios::trunc) << "garbage"; }
+    ItemRecommender recovered;
+    recovered.ensureBuilt([&base]() { return base; }, path);
+    expectSameNeighbors(recovered, first, "soup");
+    expectSameNeighbors(recovered, first, "cake");
+
+    std::filesystem::remove(path);
+}
+
+TEST(ItemRecommenderTest, ParallelBuildMatchesBruteForce) {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> item(0, 1999), user(0, 499), stars(1, 5);
+    std::map<std::pair<int, int>, int> unique;
+    for (int i = 0; i < 20000; ++i) {
+        unique[{item(rng), user(rng)}] = stars(rng);
+    }
+    std::vector<ItemRecommender::Rating> ratings;
+    std::map<int, std::map<int, double>> byItem;  // item -> user -> rating
+    std::map<int, std::pair<double, int>> userTotals;
+    for (const auto& [key, value] : unique) {
+        ratings.push_back({"r" + std::to_string(key.first), "u" + std::to_string(key.second), value, kEarly});
+        byItem[key.first][key.second] = value;
+        userTotals[key.second].first += value;
+        userTotals[key.second].second += 1;
+    }
+
+    ItemRecommender recommender;
+    ASSERT_FALSE(recommender.rebuild(ratings, ""));  // Nothing to write to, but the rows are built
+    ASSERT_TRUE(recommender.isBuilt());
+
+    auto centred = [&userTotals](int u, double r) { return r - userTotals[u].first / userTotals[u].second; };
+    auto norm = [&](int i) {
+        double sum = 0.0;
+        for (const auto& [u, r] : byItem[i]) {
+            sum += centred(u, r) * centred(u, r);
+        }
+        return std::sqrt(sum);
+    };
+    for (int i = 0; i < 2000; i += 97) {
+        std::vector<double> expected;
+        for (const auto& [j, raters] : byItem) {
+            if (j == i) {
+                continue;
+            }
+            double dot = 0.0;
+            int common = 0;
+            for (const auto& [u, r] : byItem[i]) {
+                auto other = raters.find(u);
+                if (other != raters.end()) {
+                    dot += centred(u, r) * centred(u, other->second);
+                    ++common;
+                }
+            }
+            double norms = norm(i) * norm(j);
+            if (common > 0 && dot > 0.0 && norms > 0.0) {
+                expected.push_back(dot / norms * common / (common + ItemRecommender::kShrinkage));
+            }
+        }
+        std::sort(expected.rbegin(), expected.rend());
+        expected.resize(std::min(expected.size(), ItemRecommender::kNeighbors));
+
+        auto actual = recommender.neighbors("r" + std::to_string(i));
+        ASSERT_EQ(actual.size(), expected.size()) << "r" << i;
+        for (size_t k = 0; k < expected.size(); ++k) {
+            EXPECT_NEAR(actual[k].similarity, expected[k], 1e-4) << "r" << i << " #" << k;
+        }
+    }
+}
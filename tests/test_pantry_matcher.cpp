@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "pantryMatcher.h"
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> sampleRecipes() {
+    return {
+        {"omelette", "3 eggs, butter, salt"},
+        {"pancakes", "200g flour, 2 eggs, 100ml milk, butter, sugar"},
+        {"salad", "tomatoes, olive oil, salt"},
+        {"toast", "bread, butter"}};
+}
+
+} // namespace
+
+TEST(PantryMatcherTest, RanksByCoverage) {
+    PantryMatcher matcher;
+    matcher.ensureBuilt(sampleRecipes);
+
+    auto matches = matcher.topMatches({"eggs", "butter", "salt", "bread"}, 3);
+
+    ASSERT_EQ(matches.size(), 3u);
+    // Full coverage first; ties broken by the number of matched ingredients
+    EXPECT_EQ(matches[0].recipeId, "omelette");
+    EXPECT_EQ(matches[0].matched, 3u);
+    EXPECT_DOUBLE_EQ(matches[0].coverage, 1.0);
+    EXPECT_EQ(matches[1].recipeId, "toast");
+    EXPECT_EQ(matches[2].recipeId, "pancakes");
+    EXPECT_EQ(matches[2].total, 5u);
+    EXPECT_EQ(matches[2].missing, (std::vector<std::string>{"flour", "milk", "sugar"}));
+}
+
+TEST(PantryMatcherTest, MinCoverageAndUnknownPantry) {
+    PantryMatcher matcher;
+    matcher.ensureBuilt(sampleRecipes);
+
+    auto matches = matcher.topMatches({"salt", "olive oil"}, 10, 0.5);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].recipeId, "salad");
+
+    EXPECT_TRUE(matcher.topMatches({"saffron"}, 10).empty());
+    EXPECT_TRUE(matcher.topMatches({"salt"}, 0).empty());
+}
+
+TEST(PantryMatcherTest, IncrementalUpdatesAndCompaction) {
+    PantryMatcher matcher;
+    matcher.ensureBuilt(sampleRecipes);
+
+    matcher.upsert("toast", "bread, jam");
+    matcher.remove("omelette");
+    matcher.upsert("porridge", "oats, milk");
+
+    auto matches = matcher.topMatches({"butter"}, 10);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].recipeId, "pancakes");
+    EXPECT_EQ(matcher.topMatches({"oats", "milk"}, 1)[0].recipeId, "porridge");
+
+    // Enough rewrites to trigger compaction; results must be unaffected
+    for (int i = 0; i < 3000; ++i) {
+        matcher.upsert("porridge", i % 2 ? "oats, milk" : "oats, water");
+    }
+    EXPECT_EQ(matcher.size(), 4u);
+    auto afterCompaction = matcher.topMatches({"oats", "milk"}, 10);
+    ASSERT_EQ(afterCompaction.size(), 2u);
+    EXPECT_EQ(afterCompaction[0].recipeId, "porridge");
+    EXPECT_EQ(afterCompaction[1].recipeId, "pancakes");
+}
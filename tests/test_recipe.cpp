@@ -114,4 +114,32 @@ TEST_F(RecipeTest, ValidationEmptyInstructions) {
     EXPECT_THROW({
         recipe invalidRecipe("Title", "ingredients", "", "servings", "time", "category", "type");
     }, recipe::ValidationError);
-}
\ No newline at end of file
+}
+
+// Test JSON round trip through the field table, including escaped characters
+TEST_F(RecipeTest, JsonRoundTripWithEscapes) {
+    recipe original("Quote \"Test\"", "salt\\pepper", "line1\nline2\ttab", "2 servings", "5 min", "Snack", "Dip", "recipe_42");
+
+    recipe parsed = recipe::fromJson(original.toJson());
+
+    EXPECT_EQ(parsed.getId(), "recipe_42");
+    EXPECT_EQ(parsed.getTitle(), "Quote \"Test\"");
+    EXPECT_EQ(parsed.getIngredients(), "salt\\pepper");
+    EXPECT_EQ(parsed.getInstructions(), "line1\nline2\ttab");
+    EXPECT_EQ(recipe::fromJson(original.toJsonWithId("other")).getId(), "other");
+}
+
+// Test setters validate against the field limits
+TEST_F(RecipeTest, SetterValidationMessages) {
+    recipe testRecipe("Title", "ingredients", "instructions", "4 servings", "30 min", "Main", "Test");
+
+    try {
+        testRecipe.setTitle(std::string(101, 'a'));
+        FAIL() << "Expected ValidationError";
+    } catch (const recipe::ValidationError& e) {
+        EXPECT_STREQ(e.what(), "Recipe title cannot exceed 100 characters");
+    }
+    EXPECT_THROW(testRecipe.setIngredients("   "), recipe::ValidationError);
+    EXPECT_THROW(testRecipe.setCategory(""), recipe::ValidationError);
+    EXPECT_EQ(testRecipe.getTitle(), "Title");
+}
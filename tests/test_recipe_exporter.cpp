@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <sqlite3.h>
+#include <zlib.h>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gzipWriter.h"
+#include "recipeExporter.h"
+
+namespace {
+
+std::string gunzip(const std::string& data) {
+    z_stream stream{};
+    inflateInit2(&stream, 15 + 16);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    std::string out;
+    char buffer[4096];
+    int rc;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        rc = inflate(&stream, Z_NO_FLUSH);
+        out.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (rc == Z_OK);
+    inflateEnd(&stream);
+    return rc == Z_STREAM_END ? out : "<corrupt>";
+}
+
+std::vector<nlohmann::json> parseLines(const std::string& ndjson) {
+    std::vector<nlohmann::json> rows;
+    std::istringstream input(ndjson);
+    std::string line;
+    while (std::getline(input, line)) {
+        rows.push_back(nlohmann::json::parse(line));
+    }
+    return rows;
+}
+
+} // namespace
+
+class RecipeExporterTest : public ::testing::Test {
+protected:
+    std::string testDbPath;
+
+    void SetUp() override {
+        testDbPath = (std::filesystem::temp_directory_path() / "test_recipe_export.db").string();
+        std::filesystem::remove(testDbPath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(testDbPath);
+    }
+
+    void populate(RecipeManagerSQLite& manager) {
+        manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+        manager.addRecipe(recipe("Stew \"Classic\"", "beef, onion", "braise", "6 servings", "3 hours", "Dinner", "Savory", "stew"));
+        manager.addRecipe(recipe("Cake", "flour, sugar", "bake", "8 slices", "1 hour", "Baking", "Dessert", "cake"));
+        manager.addOrUpdateRating("soup", "u1", 4);
+        manager.addOrUpdateRating("cake", "u2", 5);
+        RecipeManagerSQLite::Review review;
+        review.recipeId = "soup";
+        review.userId = "u1";
+        review.rating = 4;
+        review.reviewText = "Warming\nand cheap";
+        review.status = "approved";
+        manager.addReview(review);
+    }
+
+    std::string exportAll(RecipeManagerSQLite& manager, const RecipeExporter::Options& options, bool& ok) {
+        std::string out;
+        auto result = RecipeExporter::run(manager, options, [&out](std::string_view data) {
+            out.append(data);
+            return true;
+        });
+        ok = result.ok;
+        return out;
+    }
+};
+
+TEST_F(RecipeExporterTest, PagesThroughEveryTable) {
+    RecipeManagerSQLite manager(testDbPath);
+    populate(manager);
+
+    std::vector<std::string> ids;
+    auto collect = [&ids](std::string_view line) {
+        ids.push_back(nlohmann::json::parse(line)["id"]);
+        return true;
+    };
+    auto first = manager.exportPage(RecipeManagerSQLite::ExportTable::Recipes, "", 0, 2, collect);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->rows, 2);
+    ASSERT_NE(first->nextCursor, 0);
+    auto second = manager.exportPage(RecipeManagerSQLite::ExportTable::Recipes, "", first->nextCursor, 2, collect);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->rows, 1);
+    EXPECT_EQ(second->nextCursor, 0);
+    EXPECT_EQ(ids, (std::vector<std::string>{"soup", "stew", "cake"}));
+
+    RecipeExporter::Options options;
+    options.pageRows = 1;
+    bool ok = false;
+    auto rows = parseLines(exportAll(manager, options, ok));
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(rows.size(), 6);
+    EXPECT_EQ(rows[1]["table"], "recipes");
+    EXPECT_EQ(rows[1]["recipe"]["title"], "Stew \"Classic\"");  // Stored recipe JSON embedded as an object
+    EXPECT_EQ(rows[3]["table"], "ratings");
+    EXPECT_EQ(rows[4]["rating"], 5);
+    EXPECT_EQ(rows[5]["table"], "reviews");
+    EXPECT_EQ(rows[5]["reviewText"], "Warming\nand cheap");
+    EXPECT_EQ(rows[5]["helpfulVotes"], 0);
+}
+
+TEST_F(RecipeExporterTest, SinceSelectsChangedRows) {
+    {
+        RecipeManagerSQLite manager(testDbPath);
+        populate(manager);
+    }
+    sqlite3* db = nullptr;
+    ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+    sqlite3_exec(db, "UPDATE recipes SET updated_at = '2020-01-01 00:00:00' WHERE id != 'cake';"
+                     "UPDATE ratings SET updated_at = '2020-01-01 00:00:00';"
+                     "UPDATE reviews SET updated_at = '2020-01-01 00:00:00';",
+                 nullptr, nullptr, nullptr);
+    sqlite3_close(db);
+
+    RecipeManagerSQLite manager(testDbPath);
+    RecipeExporter::Options options;
+    options.since = "2024-06-01T12:00:00Z";
+    bool ok = false;
+    auto rows = parseLines(exportAll(manager, options, ok));
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0]["id"], "cake");
+
+    options.since = "2019-12-31";
+    EXPECT_EQ(parseLines(exportAll(manager, options, ok)).size(), 6);
+    options.since = "last tuesday";
+    exportAll(manager, options, ok);
+    EXPECT_FALSE(ok);
+}
+
+TEST_F(RecipeExporterTest, GzipOutputMatchesPlainOutput) {
+    RecipeManagerSQLite manager(testDbPath);
+    populate(manager);
+
+    RecipeExporter::Options options;
+    bool ok = false;
+    std::string plain = exportAll(manager, options, ok);
+    ASSERT_TRUE(ok);
+    options.gzip = true;
+    std::string compressed = exportAll(manager, options, ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(gunzip(compressed), plain);
+
+    // Larger than one output chunk, in many small writes
+    std::string big;
+    std::string out;
+    GzipWriter writer([&out](std::string_view data) {
+        EXPECT_LE(data.size(), GzipWriter::kChunkBytes);
+        out.append(data);
+        return true;
+    }, 1);
+    for (int i = 0; i < 50000; ++i) {
+        std::string line = std::to_string(i * 7919) + "\n";
+        big += line;
+        ASSERT_TRUE(writer.write(line));
+    }
+    ASSERT_TRUE(writer.finish());
+    EXPECT_EQ(gunzip(out), big);
+    EXPECT_EQ(gunzip(GzipWriter::compress(big)), big);
+}
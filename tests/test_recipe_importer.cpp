@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include "recipeImporter.h"
+#include "recipeManagerSQLite.h"
+
+class RecipeImporterTest : public ::testing::Test {
+protected:
+    std::string testDbPath;
+
+    void SetUp() override {
+        testDbPath = (std::filesystem::temp_directory_path() / "test_recipe_import.db").string();
+        std::filesystem::remove(testDbPath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(testDbPath);
+    }
+
+    static RecipeImporter::Options options(RecipeImporter::Format format) {
+        RecipeImporter::Options options;
+        options.format = format;
+        options.threads = 3;
+        options.chunkRows = 2;   // Several chunks in flight at once
+        options.commitRows = 3;  // Commits land between chunks
+        return options;
+    }
+};
+
+TEST_F(RecipeImporterTest, ImportsJsonLinesInOrderAndReportsBadRows) {
+    RecipeManagerSQLite manager(testDbPath);
+    manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+    manager.warmSearchIndexes();
+
+    std::stringstream input;
+    for (int i = 0; i < 10; ++i) {
+        input << R"({"id": "r)" << i << R"(", "title": "Pie )" << i
+              << R"(", "ingredients": "flour, butter", "instructions": "bake", "servingSize": "8 slices", )"
+              << R"("cookTime": "1 hour", "category": "Baking", "type": "Dessert"})" << "\n";
+        if (i == 4) {
+            input << "\n" << R"({"id": "broken", "title": )" << "\n";                  // Line 7: malformed
+            input << R"({"id": "blank", "title": "   ", "ingredients": "x", "instructions": "y", "servingSize": "1", )"
+                  << R"("cookTime": "1 min", "category": "c", "type": "t"})" << "\n";
+            input << R"({"id": "soup", "title": "Soup again", "ingredients": "x", "instructions": "y", "servingSize": "1", )"
+                  << R"("cookTime": "1 min", "category": "c", "type": "t"})" << "\n";
+        }
+    }
+
+    RecipeImporter::Result result = RecipeImporter(manager, options(RecipeImporter::Format::JsonLines)).run(input);
+    ASSERT_TRUE(result.ok) << result.failure;
+    EXPECT_EQ(result.rows, 13);
+    EXPECT_EQ(result.imported, 10);
+    EXPECT_EQ(result.duplicates, 1);
+    EXPECT_EQ(result.invalid, 2);
+    ASSERT_EQ(result.errors.size(), 2);
+    EXPECT_EQ(result.errors[0].rfind("line 7: ", 0), 0) << result.errors[0];
+    EXPECT_EQ(result.errors[1].rfind("line 8: ", 0), 0) << result.errors[1];
+
+    EXPECT_EQ(manager.getAllRecipes().size(), 11);
+    EXPECT_EQ(manager.getRecipe("soup")->getTitle(), "Soup");  // Existing ids are left alone
+    EXPECT_EQ(manager.getRecipe("r9")->getCategory(), "Baking");
+    EXPECT_FALSE(manager.suggest("pie").empty());  // Indexes rebuilt after the import
+}
+
+TEST_F(RecipeImporterTest, ImportsCsvWithQuotedFields) {
+    RecipeManagerSQLite manager(testDbPath);
+    std::stringstream input;
+    input << "type, title,ingredients,instructions,servingSize,cookTime,category,unused,id\r\n"
+          << "Main,Stew,\"beef, onion\",\"Brown the beef.\nAdd \"\"stock\"\".\",6,3 hours,Dinner,x,stew\r\n"
+          << "Side,Salad,lettuce,toss,2,5 min,Salad,x\n"
+          << "Side,,lettuce,toss,2,5 min,Salad,x,untitled\n";
+
+    RecipeImporter::Result result = RecipeImporter(manager, options(RecipeImporter::Format::Csv)).run(input);
+    ASSERT_TRUE(result.ok) << result.failure;
+    EXPECT_EQ(result.rows, 3);
+    EXPECT_EQ(result.imported, 2);
+    EXPECT_EQ(result.invalid, 1);
+    ASSERT_EQ(result.errors.size(), 1);
+    EXPECT_EQ(result.errors[0].rfind("line 5: ", 0), 0) << result.errors[0];
+
+    auto stew = manager.getRecipe("stew");
+    ASSERT_NE(stew, nullptr);
+    EXPECT_EQ(stew->getIngredients(), "beef, onion");
+    EXPECT_EQ(stew->getInstructions(), "Brown the beef.\nAdd \"stock\".");
+    EXPECT_EQ(stew->getType(), "Main");
+    EXPECT_EQ(manager.searchByTitle("Salad").size(), 1);  // No id column value: one was generated
+
+    std::stringstream noFields("name,rating\nStew,5\n");
+    result = RecipeImporter(manager, options(RecipeImporter::Format::Csv)).run(noFields);
+    EXPECT_FALSE(result.ok);
+    EXPECT_EQ(RecipeImporter::formatForPath("/data/Recipes.CSV"), RecipeImporter::Format::Csv);
+    EXPECT_EQ(RecipeImporter::formatForPath("recipes.jsonl"), RecipeImporter::Format::JsonLines);
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "recipe.h"
+#include "recipeFields.h"
+#include "recipeJsonParser.h"
+
+namespace {
+
+// The previous DOM-based recipe::fromJson, kept as the reference implementation
+std::optional<recipe> parseWithDom(const std::string& json) {
+    try {
+        nlohmann::json j = nlohmann::json::parse(json);
+        return RecipeFields::build([&j](const auto& field) {
+            return j.value(std::string(field.key), std::string());
+        });
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+std::optional<recipe> parseWithStreaming(const std::string& json) {
+    try {
+        return RecipeJsonParser(json).parseRecipe();
+    } catch (const recipe::ValidationError&) {
+        return std::nullopt;
+    }
+}
+
+void expectSameRecipe(const recipe& expected, const recipe& actual, const std::string& input) {
+    RecipeFields::forEach([&](const auto& field) {
+        EXPECT_EQ(field.get(expected), field.get(actual)) << "field " << field.key << " for input: " << input;
+    });
+}
+
+class RecipeJsonGenerator {
+public:
+    explicit RecipeJsonGenerator(uint32_t seed) : rng_(seed) {}
+
+    std::string document() {
+        std::string json = chance(10) ? "\xEF\xBB\xBF" : "";
+        json += ws() + "{";
+        bool first = true;
+        auto member = [&](const std::string& key, const std::string& value) {
+            json += (first ? "" : ",") + ws() + "\"" + key + "\"" + ws() + ":" + ws() + value + ws();
+            first = false;
+        };
+
+        RecipeFields::forEach([&](const auto& field) {
+            if (chance(2)) {
+                return; // missing field
+            }
+            if (chance(10)) {
+                member(std::string(field.key), string(4)); // duplicate, overwritten below
+            }
+            if (chance(2)) {
+                member(std::string(field.key), scalar()); // wrong type
+                if (chance(50)) {
+                    return;
+                }
+            }
+            member(escapedKey(field.key), string(field.maxLength ? field.maxLength / 8 : 4));
+        });
+        if (chance(40)) {
+            member("extra" + std::to_string(next(100)), value(3));
+        }
+
+        json += "}" + ws();
+        return json;
+    }
+
+    // Byte-level mutation: flip, insert, delete or truncate
+    std::string mutate(std::string json) {
+        if (json.empty()) {
+            return json;
+        }
+        size_t pos = next(json.size());
+        switch (next(4)) {
+            case 0: json[pos] = static_cast<char>(next(256)); break;
+            case 1: json.insert(pos, 1, "{}[]\",:\\0e-.tfn \x80\xC3\xED\xF4"[next(22)]); break;
+            case 2: json.erase(pos, 1); break;
+            default: json.resize(pos); break;
+        }
+        return json;
+    }
+
+private:
+    std::mt19937 rng_;
+
+    size_t next(size_t bound) { return std::uniform_int_distribution<size_t>(0, bound - 1)(rng_); }
+    bool chance(int percent) { return static_cast<int>(next(100)) < percent; }
+
+    std::string ws() {
+        static const char* choices[] = {"", "", " ", "\n", "\t ", "\r\n  "};
+        return choices[next(6)];
+    }
+
+    std::string escapedKey(std::string_view key) {
+        std::string out(key);
+        if (chance(10)) {
+            out.replace(0, 1, "\\u00" + hexByte(static_cast<unsigned char>(out[0])));
+        }
+        return out;
+    }
+
+    static std::string hexByte(unsigned char c) {
+        static const char* digits = "0123456789abcdef";
+        return {digits[c >> 4], digits[c & 0xF]};
+    }
+
+    std::string string(size_t maxLength) {
+        static const char* pieces[] = {
+            "a", "Pasta", " ", "2 cups", "\\\"", "\\\\", "\\/", "\\n", "\\t", "\\r", "\\b", "\\f",
+            "\\u00e9", "\\u20AC", "\\uD83C\\uDF55", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x8D\x95", "30 minutes"};
+        std::string out = "\"";
+        size_t pieceCount = 1 + next(maxLength);
+        for (size_t i = 0; i < pieceCount; ++i) {
+            out += pieces[next(sizeof(pieces) / sizeof(pieces[0]))];
+        }
+        return out + "\"";
+    }
+
+    std::string scalar() {
+        static const char* choices[] = {"null", "true", "false", "0", "-12", "3.5e2", "1e400", "1E-400",
+                                        "123456789012345678901234567890", "[]", "{}"};
+        return choices[next(sizeof(choices) / sizeof(choices[0]))];
+    }
+
+    std::string value(int depth) {
+        if (depth == 0 || chance(50)) {
+            return chance(50) ? scalar() : string(3);
+        }
+        std::string out;
+        if (chance(50)) {
+            out = "[";
+            size_t items = next(4);
+            for (size_t i = 0; i < items; ++i) {
+                out += (i ? "," : "") + ws() + value(depth - 1) + ws();
+            }
+            return out + "]";
+        }
+        out = "{";
+        size_t members = next(4);
+        for (size_t i = 0; i < members; ++i) {
+            out += (i ? "," : "") + ws() + string(2) + ":" + value(depth - 1);
+        }
+        return out + "}";
+    }
+};
+
+} // namespace
+
+TEST(RecipeJsonParserTest, ParsesStoredRecipe) {
+    recipe original("Cr\xC3\xA8me \"Br\xC3\xBBl\xC3\xA9\xE2\x80\x9D", "cream\\sugar", "heat\nchill\ttorch",
+                    "4 servings", "45 minutes", "Dessert", "Custard", "recipe_7");
+
+    recipe parsed = RecipeJsonParser(original.toJson()).parseRecipe();
+
+    expectSameRecipe(original, parsed, original.toJson());
+}
+
+TEST(RecipeJsonParserTest, DecodesEscapesAndSkipsUnknownValues) {
+    std::string json = R"({"meta":{"tags":["a",{"b":[1,2.5e3,null]}],"ok":true},)"
+                       R"("title":"Café 🍕","ingredients":"x","instructions":"y","servingSize":"2","cookTime":"5 min",)"
+                       R"("category":"Main","type":"Pizza","title":"Pizza \u20AC"})";
+
+    recipe parsed = RecipeJsonParser(json).parseRecipe();
+
+    EXPECT_EQ(parsed.getTitle(), "Pizza \xE2\x82\xAC");
+    EXPECT_EQ(parsed.getId(), "");
+}
+
+TEST(RecipeJsonParserTest, RejectsMalformedInput) {
+    const char* inputs[] = {
+        "", "[]", R"({"title":"a")", R"({"title":"a",})", R"({"title":"a"} x)",
+        R"({"title":"\ud83c","ingredients":"x","instructions":"y"})",
+        R"({"title":"a","ingredients":"x","instructions":"y","extra":01})",
+        R"({"title":5,"ingredients":"x","instructions":"y"})",
+        "{\"title\":\"tab\there\",\"ingredients\":\"x\",\"instructions\":\"y\"}",
+    };
+    for (const char* input : inputs) {
+        EXPECT_THROW(RecipeJsonParser(input).parseRecipe(), recipe::ValidationError) << input;
+    }
+}
+
+TEST(RecipeJsonParserTest, ParsesRecipeArray) {
+    recipe a("A", "x", "y", "1", "1 min", "c", "t", "id_a");
+    recipe b("B", "x", "y", "2", "2 min", "c", "t", "id_b");
+
+    std::vector<recipe> parsed = RecipeJsonParser("[" + a.toJson() + ", " + b.toJson() + "]").parseRecipeArray();
+
+    ASSERT_EQ(parsed.size(), 2u);
+    EXPECT_EQ(parsed[1].getId(), "id_b");
+    EXPECT_TRUE(RecipeJsonParser(" [ ] ").parseRecipeArray().empty());
+    EXPECT_THROW(RecipeJsonParser("[" + a.toJson() + ",]").parseRecipeArray(), recipe::ValidationError);
+}
+
+// Fuzz equivalence against the DOM parser: both must accept the same inputs and produce identical recipes
+TEST(RecipeJsonParserTest, FuzzEquivalenceWithDomParser) {
+    RecipeJsonGenerator generator(20240611);
+    size_t accepted = 0;
+
+    for (int i = 0; i < 20000; ++i) {
+        std::string input = generator.document();
+        for (int mutations = i % 4; mutations > 0 && i % 2; --mutations) {
+            input = generator.mutate(input);
+        }
+
+        std::optional<recipe> expected = parseWithDom(input);
+        std::optional<recipe> actual = parseWithStreaming(input);
+
+        ASSERT_EQ(expected.has_value(), actual.has_value()) << "acceptance differs for input: " << input;
+        if (expected) {
+            expectSameRecipe(*expected, *actual, input);
+            ++accepted;
+        }
+    }
+
+    // Make sure the corpus exercises both the accepting and the rejecting paths
+    EXPECT_GT(accepted, 1000u);
+    EXPECT_LT(accepted, 19000u);
+}
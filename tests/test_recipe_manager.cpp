@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <thread>
 #include "recipeManagerSQLite.h"
 
 // Test fixture for RecipeManager tests
@@ -17,6 +20,7 @@ protected:
         if (std::filesystem::exists(testDbPath)) {
             std::filesystem::remove(testDbPath);
         }
+        std::filesystem::remove(testDbPath + ".neighbors");
     }
 
     void TearDown() override {
@@ -24,6 +28,7 @@ protected:
         if (std::filesystem::exists(testDbPath)) {
             std::filesystem::remove(testDbPath);
         }
+        std::filesystem::remove(testDbPath + ".neighbors");
     }
 };
 
@@ -165,6 +170,12 @@ TEST_F(RecipeManagerTest, SearchRecipes) {
     EXPECT_EQ(chocolateResults.size(), 1);
     EXPECT_EQ(chocolateResults[0].getTitle(), "Chocolate Cake");
 
+    // Title search ignores case and tolerates typos, and no longer matches other fields
+    std::vector<recipe> typoResults = manager.searchByTitle("carbonera");
+    ASSERT_EQ(typoResults.size(), 1);
+    EXPECT_EQ(typoResults[0].getTitle(), "Pasta Carbonara");
+    EXPECT_TRUE(manager.searchByTitle("Dessert").empty());
+
     // Search for recipes by category "Dessert"
     std::vector<recipe> dessertResults = manager.searchByCategory("Dessert");
     EXPECT_EQ(dessertResults.size(), 2); // Chocolate Cake and Vanilla Cookies
@@ -195,4 +206,422 @@ TEST_F(RecipeManagerTest, GetRecipesByCategory) {
     std::vector<recipe> mains = manager.searchByCategory("Main");
     EXPECT_EQ(mains.size(), 1);
     EXPECT_EQ(mains[0].getTitle(), "Pasta");
-}
\ No newline at end of file
+}
+
+// Test arena-backed recipe views match the owning listing
+TEST_F(RecipeManagerTest, GetAllRecipeViews) {
+    RecipeManagerSQLite manager(testDbPath);
+
+    recipe testRecipe("View Recipe", "eggs, \"fresh\" herbs", "whisk\nfry", "2 servings", "10 min", "Breakfast", "Omelette");
+    manager.addRecipe(testRecipe);
+
+    RecipeArena arena;
+    auto views = manager.getAllRecipeViews(arena);
+    ASSERT_EQ(views.size(), 1);
+    EXPECT_EQ(views[0].title, "View Recipe");
+    EXPECT_EQ(views[0].ingredients, "eggs, \"fresh\" herbs");
+    EXPECT_EQ(views[0].instructions, "whisk\nfry");
+    EXPECT_EQ(views[0].type, "Omelette");
+    EXPECT_FALSE(views[0].id.empty());
+}
+
+// Test pantry matching follows recipe writes
+TEST_F(RecipeManagerTest, MatchPantry) {
+    RecipeManagerSQLite manager(testDbPath);
+
+    manager.addRecipe(recipe("Omelette", "3 eggs, butter, salt", "whisk, fry", "1 serving", "5 min", "Breakfast", "Eggs", "omelette"));
+    manager.addRecipe(recipe("Pancakes", "flour, eggs, milk, butter", "mix, fry", "4 servings", "20 min", "Breakfast", "Sweet", "pancakes"));
+
+    auto matches = manager.matchPantry({"eggs", "butter", "salt"});
+    ASSERT_EQ(matches.size(), 2);
+    EXPECT_EQ(matches[0].recipeId, "omelette");
+    EXPECT_DOUBLE_EQ(matches[0].coverage, 1.0);
+    EXPECT_EQ(matches[1].missingIngredients, (std::vector<std::string>{"flour", "milk"}));
+
+    // Writes after the first query keep the matcher current
+    manager.updateRecipe("pancakes", recipe("Pancakes", "eggs, butter", "mix, fry", "4 servings", "20 min", "Breakfast", "Sweet", "pancakes"));
+    manager.deleteRecipe("omelette");
+    matches = manager.matchPantry({"eggs", "butter"});
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].recipeId, "pancakes");
+    EXPECT_EQ(matches[0].totalIngredients, 2);
+}
+
+// Autocomplete is built from the table and follows later writes
+TEST_F(RecipeManagerTest, Suggest) {
+    RecipeManagerSQLite manager(testDbPath);
+
+    manager.addRecipe(recipe("Pancakes", "flour, eggs, milk", "mix, fry", "4 servings", "20 min", "Breakfast", "Sweet", "pancakes"));
+    manager.addRecipe(recipe("Panzanella", "bread, tomatoes", "toss", "2 servings", "10 min", "Salad", "Side", "panzanella"));
+    manager.warmSearchIndexes();
+
+    auto suggestions = manager.suggest("pan");
+    ASSERT_EQ(suggestions.size(), 2);
+    EXPECT_EQ(suggestions[0].text, "Pancakes");
+    EXPECT_EQ(suggestions[0].kind, "title");
+    EXPECT_EQ(suggestions[0].recipeCount, 1);
+
+    manager.addRecipe(recipe("Banana Bread", "bananas, flour", "mix, bake", "1 loaf", "60 min", "Baking", "Bread", "banana-bread"));
+    manager.deleteRecipe("panzanella");
+    suggestions = manager.suggest("flo");
+    ASSERT_EQ(suggestions.size(), 1);
+    EXPECT_EQ(suggestions[0].text, "flour");
+    EXPECT_EQ(suggestions[0].recipeCount, 2);
+    EXPECT_TRUE(manager.suggest("panz").empty());
+}
+
+// Facets come back from the same advancedSearch call and from the whole table
+TEST_F(RecipeManagerTest, SearchFacets) {
+    RecipeManagerSQLite manager(testDbPath);
+
+    manager.addRecipe(recipe("Chocolate Cake", "flour, chocolate", "mix, bake", "8 servings", "60 min", "Dessert", "Cake", "cake"));
+    manager.addRecipe(recipe("Vanilla Cookies", "flour, vanilla", "mix, bake", "24 cookies", "15 min", "Dessert", "Cookies", "cookies"));
+    manager.addRecipe(recipe("Pasta Carbonara", "pasta, eggs, bacon", "boil, mix", "4 servings", "20 min", "Main", "Pasta", "carbonara"));
+
+    RecipeManagerSQLite::SearchCriteria criteria;
+    criteria.category = "dessert";
+    RecipeManagerSQLite::SearchFacets facets;
+    auto results = manager.advancedSearch(criteria, &facets);
+    ASSERT_EQ(results.size(), 2);
+    ASSERT_EQ(facets.categories.size(), 1);
+    EXPECT_EQ(facets.categories[0].value, "Dessert");
+    EXPECT_EQ(facets.categories[0].count, 2);
+    EXPECT_EQ(facets.types.size(), 2);
+    ASSERT_EQ(facets.cookTimes.size(), 2);
+    EXPECT_EQ(facets.cookTimes[0].value, "0-15");
+    EXPECT_EQ(facets.cookTimes[1].value, "31-60");
+
+    manager.deleteRecipe("cookies");
+    auto all = manager.getFacets();
+    ASSERT_EQ(all.categories.size(), 2);
+    EXPECT_EQ(all.categories[0].count, 1);
+    EXPECT_EQ(manager.searchByCategory("DESSERT").size(), 1);
+    EXPECT_EQ(manager.searchByType("pasta").size(), 1);
+}
+
+// Similar recipes follow ingredient edits through the write hooks
+TEST_F(RecipeManagerTest, FindSimilarRecipes) {
+    RecipeManagerSQLite manager(testDbPath);
+
+    manager.addRecipe(recipe("Pancakes", "flour, eggs, milk, butter, sugar", "mix, fry", "4 servings", "20 min", "Breakfast", "Sweet", "pancakes"));
+    manager.addRecipe(recipe("Crepes", "flour, eggs, milk, butter", "mix, fry", "6 crepes", "20 min", "Breakfast", "Sweet", "crepes"));
+    manager.addRecipe(recipe("Salsa", "tomato, onion, lime, cilantro", "chop", "4 servings", "10 min", "Snack", "Dip", "salsa"));
+
+    auto similar = manager.findSimilarRecipes("pancakes");
+    ASSERT_EQ(similar.size(), 1);
+    EXPECT_EQ(similar[0].recipeId, "crepes");
+    EXPECT_GT(similar[0].similarity, 0.5);
+
+    manager.updateRecipe("crepes", recipe("Crepes", "buckwheat, water, salt", "mix, fry", "6 crepes", "20 min", "Breakfast", "Savory", "crepes"));
+    EXPECT_TRUE(manager.findSimilarRecipes("pancakes").empty());
+    EXPECT_TRUE(manager.findSimilarRecipes("missing").empty());
+}
+
+TEST_F(RecipeManagerTest, GetRecommendations) {
+    RecipeManagerSQLite manager(testDbPath);
+
+    manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+    manager.addRecipe(recipe("Stew", "beef, onion", "braise", "4 servings", "2 hours", "Dinner", "Savory", "stew"));
+    manager.addRecipe(recipe("Cake", "flour, sugar", "bake", "8 slices", "1 hour", "Dessert", "Sweet", "cake"));
+    manager.addOrUpdateRating("soup", "u1", 5);
+    manager.addOrUpdateRating("stew", "u1", 5);
+    manager.addOrUpdateRating("cake", "u1", 1);
+    manager.addOrUpdateRating("soup", "u2", 4);
+    manager.addOrUpdateRating("stew", "u2", 5);
+    manager.addOrUpdateRating("cake", "u2", 2);
+    manager.addOrUpdateRating("soup", "u3", 1);
+    manager.addOrUpdateRating("stew", "u3", 2);
+    manager.addOrUpdateRating("cake", "u3", 5);
+    EXPECT_TRUE(manager.getRecommendations("u4").empty());
+
+    // Ratings written after the first build are folded in incrementally
+    manager.addOrUpdateRating("soup", "u4", 5);
+    auto recommendations = manager.getRecommendations("u4");
+    ASSERT_EQ(recommendations.size(), 1);
+    EXPECT_EQ(recommendations[0].recipeId, "stew");
+    EXPECT_GT(recommendations[0].score, 0.0);
+
+    EXPECT_TRUE(manager.rebuildRecommendations());
+    EXPECT_TRUE(std::filesystem::exists(testDbPath + ".neighbors"));
+    EXPECT_EQ(manager.getRecommendations("u4").size(), 1);
+
+    manager.deleteRecipe("stew");
+    EXPECT_TRUE(manager.getRecommendations("u4").empty());
+}
+
+TEST_F(RecipeManagerTest, GetTrendingRecipes) {
+    RecipeManagerSQLite manager(testDbPath);
+
+    manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+    manager.addRecipe(recipe("Stew", "beef, onion", "braise", "4 servings", "2 hours", "Dinner", "Savory", "stew"));
+    manager.addRecipe(recipe("Cake", "flour, sugar", "bake", "8 slices", "1 hour", "Dessert", "Sweet", "cake"));
+    EXPECT_TRUE(manager.getTrendingRecipes().empty());
+
+    manager.addOrUpdateRating("soup", "u1", 5);
+    manager.addOrUpdateRating("soup", "u2", 4);
+    RecipeManagerSQLite::Review review;
+    review.recipeId = "cake";
+    review.userId = "u1";
+    review.rating = 5;
+    review.reviewText = "Lovely";
+    review.status = "approved";
+    ASSERT_TRUE(manager.addReview(review));
+
+    auto trending = manager.getTrendingRecipes();
+    ASSERT_EQ(trending.size(), 2);
+    EXPECT_EQ(trending[0].recipeId, "cake");
+    EXPECT_EQ(trending[1].recipeId, "soup");
+    EXPECT_GT(trending[1].score, 1.9);
+
+    // A fresh manager replays the same activity from the tables
+    RecipeManagerSQLite reopened(testDbPath);
+    auto replayed = reopened.getTrendingRecipes();
+    ASSERT_EQ(replayed.size(), 2);
+    EXPECT_EQ(replayed[0].recipeId, "cake");
+
+    manager.deleteRecipe("cake");
+    trending = manager.getTrendingRecipes(1);
+    ASSERT_EQ(trending.size(), 1);
+    EXPECT_EQ(trending[0].recipeId, "soup");
+}
+
+TEST_F(RecipeManagerTest, ReviewPagesFollowSortOrder) {
+    RecipeManagerSQLite manager(testDbPath);
+    manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+
+    const int ratings[] = {3, 5, 1, 5, 4, 2, 5, 3};
+    for (int i = 0; i < 8; ++i) {
+        RecipeManagerSQLite::Review review;
+        review.recipeId = "soup";
+        review.userId = "u" + std::to_string(i);
+        review.rating = ratings[i];
+        review.reviewText = "Review " + std::to_string(i);
+        review.status = i == 7 ? "pending" : "approved";
+        ASSERT_TRUE(manager.addReview(review));
+    }
+    auto all = manager.getReviewsByRecipe("soup");
+    ASSERT_EQ(all.size(), 7);
+    manager.addOrUpdateReviewVote(all[2].id, "v1", "helpful");
+    manager.addOrUpdateReviewVote(all[2].id, "v2", "helpful");
+    manager.addOrUpdateReviewVote(all[5].id, "v1", "helpful");
+
+    using Sort = RecipeManagerSQLite::ReviewSortBy;
+    for (Sort sort : {Sort::NEWEST, Sort::OLDEST, Sort::HIGHEST_RATED, Sort::MOST_HELPFUL}) {
+        auto expected = manager.getSortedReviewsByRecipe("soup", sort);
+        ASSERT_EQ(expected.size(), 7);
+
+        std::vector<std::string> paged;
+        std::string cursor;
+        int pages = 0;
+        do {
+            auto page = manager.getReviewPage("soup", sort, 3, cursor);
+            ASSERT_TRUE(page.has_value());
+            for (const auto& review : page->reviews) {
+                paged.push_back(review.id);
+            }
+            cursor = page->nextCursor;
+            ++pages;
+        } while (!cursor.empty() && pages < 10);
+        EXPECT_EQ(pages, 3);
+
+        ASSERT_EQ(paged.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(paged[i], expected[i].id) << "sort " << sort << " position " << i;
+        }
+    }
+
+    auto byRating = manager.getSortedReviewsByRecipe("soup", Sort::HIGHEST_RATED);
+    for (size_t i = 1; i < byRating.size(); ++i) {
+        EXPECT_GE(byRating[i - 1].rating, byRating[i].rating);
+    }
+    auto byHelpful = manager.getSortedReviewsByRecipe("soup", Sort::MOST_HELPFUL);
+    EXPECT_EQ(byHelpful[0].id, all[2].id);
+    EXPECT_EQ(byHelpful[1].id, all[5].id);
+
+    // Cursors only continue the listing they came from
+    auto first = manager.getReviewPage("soup", Sort::NEWEST, 3);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_FALSE(manager.getReviewPage("soup", Sort::OLDEST, 3, first->nextCursor).has_value());
+    EXPECT_FALSE(manager.getReviewPage("soup", Sort::NEWEST, 3, "not-a-cursor").has_value());
+    EXPECT_EQ(manager.getSortedReviewsByRecipe("soup", Sort::NEWEST, "").size(), 8);
+}
+
+TEST_F(RecipeManagerTest, HelpfulVoteCounterFollowsVoteChanges) {
+    RecipeManagerSQLite manager(testDbPath);
+    manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+    RecipeManagerSQLite::Review review;
+    review.recipeId = "soup";
+    review.userId = "author";
+    review.rating = 4;
+    review.reviewText = "Warming";
+    review.status = "approved";
+    ASSERT_TRUE(manager.addReview(review));
+    std::string reviewId = manager.getReviewsByRecipe("soup")[0].id;
+
+    auto stored = [&manager, &reviewId]() { return manager.getReview(reviewId)->helpfulVotes; };
+
+    EXPECT_TRUE(manager.addOrUpdateReviewVote(reviewId, "v1", "helpful"));
+    EXPECT_EQ(stored(), 1);
+    EXPECT_TRUE(manager.addOrUpdateReviewVote(reviewId, "v1", "helpful"));  // Repeat: no change
+    EXPECT_EQ(stored(), 1);
+    EXPECT_TRUE(manager.addOrUpdateReviewVote(reviewId, "v2", "helpful"));
+    EXPECT_TRUE(manager.addOrUpdateReviewVote(reviewId, "v3", "not_helpful"));
+    EXPECT_EQ(stored(), 2);
+    EXPECT_TRUE(manager.addOrUpdateReviewVote(reviewId, "v1", "not_helpful"));  // Flip down
+    EXPECT_EQ(stored(), 1);
+    EXPECT_TRUE(manager.addOrUpdateReviewVote(reviewId, "v3", "helpful"));  // Flip up
+    EXPECT_EQ(stored(), 2);
+    EXPECT_TRUE(manager.deleteReviewVote(reviewId, "v1"));  // Was not_helpful
+    EXPECT_EQ(stored(), 2);
+    EXPECT_TRUE(manager.deleteReviewVote(reviewId, "v2"));
+    EXPECT_EQ(stored(), 1);
+    EXPECT_TRUE(manager.deleteReviewVote(reviewId, "nobody"));
+    EXPECT_FALSE(manager.addOrUpdateReviewVote(reviewId, "v4", "maybe"));
+    EXPECT_EQ(stored(), manager.getHelpfulVoteCount(reviewId));
+}
+
+TEST_F(RecipeManagerTest, QueuedRatingsAreCommittedOnFlush) {
+    RecipeManagerSQLite manager(testDbPath);
+    manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_TRUE(manager.addOrUpdateRating("soup", "u" + std::to_string(i), 1 + i % 5,
+                                              RecipeManagerSQLite::WriteDurability::Queued));
+    }
+    EXPECT_FALSE(manager.addOrUpdateRating("soup", "u0", 6, RecipeManagerSQLite::WriteDurability::Queued));
+    manager.flushWrites();
+    EXPECT_EQ(manager.getRatingCount("soup"), 50);
+    EXPECT_DOUBLE_EQ(manager.getAverageRating("soup"), 3.0);
+}
+
+TEST_F(RecipeManagerTest, TransactionScopesCommitOnceAndRollBackTogether) {
+    RecipeManagerSQLite manager(testDbPath);
+    manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+    manager.warmSearchIndexes();
+
+    {
+        RecipeManagerSQLite::Transaction transaction(manager);
+        ASSERT_TRUE(transaction);
+        EXPECT_TRUE(manager.addRecipe(recipe("Stew", "beef, onion", "braise", "6 servings", "3 hours", "Dinner", "Savory", "stew")));
+        EXPECT_TRUE(manager.addOrUpdateRating("soup", "u1", 5));  // Joins the open transaction
+        EXPECT_EQ(manager.getAllRecipes().size(), 2);
+        // Not committed: no commit(), so the destructor rolls back
+    }
+    EXPECT_EQ(manager.getAllRecipes().size(), 1);
+    EXPECT_EQ(manager.getRatingCount("soup"), 0);
+    EXPECT_TRUE(manager.suggest("ste").empty());  // The index never saw the rolled-back recipe
+
+    RecipeManagerSQLite::Review review;
+    review.recipeId = "soup";
+    review.userId = "author";
+    review.rating = 4;
+    review.reviewText = "Warming";
+    review.status = "approved";
+    {
+        RecipeManagerSQLite::Transaction transaction(manager);
+        ASSERT_TRUE(transaction);
+        EXPECT_TRUE(manager.addReview(review));
+        {
+            RecipeManagerSQLite::Transaction inner(manager);
+            ASSERT_TRUE(inner);
+            EXPECT_TRUE(manager.addRecipe(recipe("Stew", "beef, onion", "braise", "6 servings", "3 hours", "Dinner", "Savory", "stew")));
+            inner.rollback();  // Undoes only the savepoint
+        }
+        EXPECT_TRUE(manager.addOrUpdateRating("soup", "u1", 5));
+        EXPECT_TRUE(transaction.commit());
+    }
+    EXPECT_EQ(manager.getAllRecipes().size(), 1);
+    EXPECT_EQ(manager.getReviewsByRecipe("soup").size(), 1);
+    EXPECT_EQ(manager.getRatingCount("soup"), 1);
+    EXPECT_EQ(manager.getTrendingRecipes(1)[0].recipeId, "soup");
+}
+
+TEST_F(RecipeManagerTest, TransactionHoldsOffOtherWriters) {
+    RecipeManagerSQLite manager(testDbPath);
+    std::atomic<bool> started{false}, written{false};
+    std::thread writer;
+    {
+        RecipeManagerSQLite::Transaction transaction(manager);
+        ASSERT_TRUE(transaction);
+        ASSERT_TRUE(manager.addRecipe(recipe("Stew", "beef, onion", "braise", "6 servings", "3 hours", "Dinner", "Savory", "stew")));
+        writer = std::thread([&]() {
+            started = true;
+            written = manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup"));
+        });
+        while (!started) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(written);  // Waits instead of joining this transaction
+    }
+    writer.join();
+    EXPECT_TRUE(written);
+    auto recipes = manager.getAllRecipes();
+    ASSERT_EQ(recipes.size(), 1);
+    EXPECT_EQ(recipes[0].getTitle(), "Soup");
+}
+
+TEST_F(RecipeManagerTest, OtherThreadsNeverReadAnOpenTransaction) {
+    RecipeManagerSQLite manager(testDbPath);
+    ASSERT_TRUE(manager.addRecipe(recipe("Soup", "water, onion", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup")));
+    std::string etag = manager.recipeETag("soup");
+
+    auto titleOnAnotherThread = [&manager]() {
+        std::string title;
+        std::thread reader([&]() {
+            auto found = manager.getRecipe("soup");
+            title = found ? found->getTitle() : "";
+        });
+        reader.join();
+        return title;
+    };
+    {
+        RecipeManagerSQLite::Transaction transaction(manager);
+        ASSERT_TRUE(transaction);
+        ASSERT_TRUE(manager.updateRecipe("soup", recipe("Uncommitted", "water", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup")));
+        EXPECT_EQ(manager.getRecipe("soup")->getTitle(), "Uncommitted");  // Its own thread sees its writes
+        EXPECT_EQ(titleOnAnotherThread(), "Soup");
+        // Rolled back
+    }
+    EXPECT_EQ(titleOnAnotherThread(), "Soup");
+    EXPECT_EQ(manager.recipeETag("soup"), etag);
+
+    {
+        RecipeManagerSQLite::Transaction transaction(manager);
+        ASSERT_TRUE(manager.updateRecipe("soup", recipe("Broth", "water", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup")));
+        EXPECT_EQ(titleOnAnotherThread(), "Soup");
+        ASSERT_TRUE(transaction.commit());
+    }
+    EXPECT_EQ(titleOnAnotherThread(), "Broth");
+    EXPECT_NE(manager.recipeETag("soup"), etag);
+}
+
+TEST_F(RecipeManagerTest, AStatementLeftSteppingOnOneThreadDoesNotStaleAnother) {
+    RecipeManagerSQLite manager(testDbPath);
+    ASSERT_TRUE(manager.addRecipe(recipe("Soup", "water", "simmer", "4 servings", "30 min", "Dinner", "Savory", "soup")));
+    ASSERT_TRUE(manager.addRecipe(recipe("Stew", "beef", "braise", "6 servings", "3 hours", "Dinner", "Savory", "stew")));
+
+    // An export that stops after its first row keeps its statement, and its snapshot, open
+    std::atomic<bool> paused{false}, resume{false};
+    std::thread exporter([&]() {
+        manager.exportPage(RecipeManagerSQLite::ExportTable::Recipes, "", 0, 10, [&](std::string_view) {
+            paused = true;
+            while (!resume) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        });
+    });
+    while (!paused) {
+        std::this_thread::yield();
+    }
+
+    ASSERT_TRUE(manager.addRecipe(recipe("Cake", "flour", "bake", "8 servings", "1 hour", "Baking", "Sweet", "cake")));
+    EXPECT_TRUE(manager.recipeExists("cake"));
+    ASSERT_TRUE(manager.addOrUpdateRating("cake", "u1", 4));
+    EXPECT_EQ(manager.getRatingCount("cake"), 1);
+    EXPECT_EQ(manager.getAllRecipes().size(), 3u);
+
+    resume = true;
+    exporter.join();
+}
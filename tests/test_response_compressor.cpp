@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <zstd.h>
+#include <string>
+#include "responseCompressor.h"
+
+namespace {
+
+using Encoding = ResponseCompressor::Encoding;
+
+std::string gunzip(const std::string& data) {
+    z_stream stream{};
+    inflateInit2(&stream, 15 + 16);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    std::string out;
+    char buffer[4096];
+    int rc;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        rc = inflate(&stream, Z_NO_FLUSH);
+        out.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (rc == Z_OK);
+    inflateEnd(&stream);
+    return rc == Z_STREAM_END ? out : "<corrupt>";
+}
+
+std::string unzstd(const std::string& frame) {
+    unsigned long long size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN) {
+        return "<corrupt>";
+    }
+    std::string out(static_cast<size_t>(size), '\0');
+    size_t written = ZSTD_decompress(out.data(), out.size(), frame.data(), frame.size());
+    return ZSTD_isError(written) ? "<corrupt>" : out;
+}
+
+std::string jsonBody(int recipes) {
+    std::string body = "{\"success\":true,\"data\":{\"recipes\":[";
+    for (int i = 0; i < recipes; ++i) {
+        body += std::string(i ? "," : "") + "{\"id\":\"recipe_" + std::to_string(i) +
+                "\",\"title\":\"Dish\",\"category\":\"Dinner\",\"type\":\"Main\"}";
+    }
+    return body + "]}}";
+}
+
+} // namespace
+
+TEST(ResponseCompressorTest, NegotiatesByClientQualityThenServerPreference) {
+    EXPECT_EQ(ResponseCompressor::negotiate(""), Encoding::Identity);
+    EXPECT_EQ(ResponseCompressor::negotiate("gzip, deflate, br"), Encoding::Gzip);
+    EXPECT_EQ(ResponseCompressor::negotiate("gzip, deflate, br, zstd"), Encoding::Zstd);
+    EXPECT_EQ(ResponseCompressor::negotiate("zstd;q=0.5, gzip"), Encoding::Gzip);
+    EXPECT_EQ(ResponseCompressor::negotiate("GZIP;Q=0.8, zstd;q=0.8"), Encoding::Zstd);
+    EXPECT_EQ(ResponseCompressor::negotiate("gzip;q=0, zstd;q=0"), Encoding::Identity);
+    EXPECT_EQ(ResponseCompressor::negotiate("x-gzip"), Encoding::Gzip);
+    EXPECT_EQ(ResponseCompressor::negotiate("*"), Encoding::Zstd);
+    EXPECT_EQ(ResponseCompressor::negotiate("zstd;q=0, *"), Encoding::Gzip);
+    EXPECT_EQ(ResponseCompressor::negotiate("identity, br"), Encoding::Identity);
+
+    EXPECT_TRUE(ResponseCompressor::compressible("application/json"));
+    EXPECT_TRUE(ResponseCompressor::compressible("Text/HTML; charset=utf-8"));
+    EXPECT_TRUE(ResponseCompressor::compressible("application/x-ndjson"));
+    EXPECT_TRUE(ResponseCompressor::compressible("application/problem+json"));
+    EXPECT_FALSE(ResponseCompressor::compressible("image/png"));
+    EXPECT_FALSE(ResponseCompressor::compressible(""));
+}
+
+TEST(ResponseCompressorTest, CompressesOnThePoolAboveTheThreshold) {
+    ResponseCompressor::Options options;
+    options.minBytes = 256;
+    options.cacheBytes = 0;
+    ResponseCompressor compressor(options);
+
+    std::string body = jsonBody(200);
+    auto gzip = compressor.compress(body, Encoding::Gzip, false);
+    ASSERT_TRUE(gzip.has_value());
+    EXPECT_LT(gzip->size(), body.size());
+    EXPECT_EQ(gunzip(*gzip), body);
+
+    auto zstd = compressor.compress(body, Encoding::Zstd, true);
+    ASSERT_TRUE(zstd.has_value());
+    EXPECT_EQ(unzstd(*zstd), body);
+
+    EXPECT_FALSE(compressor.compress(body, Encoding::Identity, false).has_value());
+    EXPECT_FALSE(compressor.compress("{\"success\":true}", Encoding::Gzip, false).has_value());
+
+    auto stats = compressor.stats();
+    EXPECT_EQ(stats.compressed, 2u);
+    EXPECT_EQ(stats.cacheHits, 0u);  // No cache configured
+    EXPECT_EQ(stats.bytesIn, 2 * body.size());
+}
+
+TEST(ResponseCompressorTest, ServesRepeatBodiesFromTheCacheAndEvictsTheOldest) {
+    ResponseCompressor::Options options;
+    options.minBytes = 64;
+    options.threads = 0;
+    std::string first = jsonBody(100);
+    options.cacheBytes = 5 * first.size();  // Four of these bodies with their frames, not five
+    ResponseCompressor compressor(options);
+
+    auto encoded = compressor.compress(first, Encoding::Zstd, true);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(compressor.compress(first, Encoding::Zstd, true), encoded);
+    EXPECT_EQ(compressor.stats().cacheHits, 1u);
+    EXPECT_EQ(compressor.stats().compressed, 1u);
+
+    // Same bytes in another encoding, or not cacheable: compressed afresh
+    ASSERT_TRUE(compressor.compress(first, Encoding::Gzip, true).has_value());
+    ASSERT_TRUE(compressor.compress(jsonBody(101), Encoding::Zstd, false).has_value());
+    EXPECT_EQ(compressor.stats().cacheHits, 1u);
+    EXPECT_EQ(compressor.stats().cacheEntries, 2u);
+
+    // Fill the cache, touch the zstd entry, and one more body pushes out the gzip one
+    ASSERT_TRUE(compressor.compress(jsonBody(101), Encoding::Gzip, true).has_value());
+    ASSERT_TRUE(compressor.compress(jsonBody(102), Encoding::Gzip, true).has_value());
+    EXPECT_EQ(compressor.stats().cacheEntries, 4u);
+    ASSERT_TRUE(compressor.compress(first, Encoding::Zstd, true).has_value());
+    ASSERT_TRUE(compressor.compress(jsonBody(103), Encoding::Gzip, true).has_value());
+    auto stats = compressor.stats();
+    EXPECT_EQ(stats.cacheEntries, 4u);
+    EXPECT_LE(stats.cachedBytes, options.cacheBytes);
+    EXPECT_EQ(stats.cacheHits, 2u);
+
+    ASSERT_TRUE(compressor.compress(first, Encoding::Zstd, true).has_value());
+    EXPECT_EQ(compressor.stats().cacheHits, 3u);
+    ASSERT_TRUE(compressor.compress(first, Encoding::Gzip, true).has_value());
+    EXPECT_EQ(compressor.stats().cacheHits, 3u);  // Evicted
+}
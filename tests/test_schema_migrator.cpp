@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "recipeManagerSQLite.h"
+#include "schemaMigrator.h"
+#include "userManager.h"
+
+namespace {
+
+int64_t queryInt(sqlite3* db, const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int64_t value = -1;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+bool hasIndex(sqlite3* db, const std::string& name) {
+    return queryInt(db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name = '" + name + "'") == 1;
+}
+
+} // namespace
+
+class SchemaMigratorTest : public ::testing::Test {
+protected:
+    std::string testDbPath;
+    sqlite3* db = nullptr;
+
+    void SetUp() override {
+        testDbPath = (std::filesystem::temp_directory_path() / "test_schema_migrator.db").string();
+        std::filesystem::remove(testDbPath);
+        ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+    }
+
+    void TearDown() override {
+        sqlite3_close(db);
+        std::filesystem::remove(testDbPath);
+    }
+};
+
+TEST_F(SchemaMigratorTest, AppliesEachVersionOnceAndStopsAtAFailure) {
+    std::vector<SchemaMigrator::Migration> migrations{
+        {1, "items", "CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);"},
+        {2, "items by name", "CREATE INDEX idx_items_name ON items(name);"},
+    };
+    ASSERT_TRUE(SchemaMigrator::migrate(db, "test", migrations));
+    EXPECT_EQ(SchemaMigrator::version(db), 2);
+    EXPECT_TRUE(hasIndex(db, "idx_items_name"));
+    // Already current: the non-idempotent statements are not run again
+    ASSERT_TRUE(SchemaMigrator::migrate(db, "test", migrations));
+
+    migrations.push_back({3, "bad column and more", "ALTER TABLE items ADD COLUMN price REAL; SELECT * FROM nowhere;"});
+    migrations.push_back({4, "never reached", "CREATE TABLE later (id INTEGER);"});
+    EXPECT_FALSE(SchemaMigrator::migrate(db, "test", migrations));
+    EXPECT_EQ(SchemaMigrator::version(db), 2);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM pragma_table_info('items') WHERE name = 'price'"), 0);  // Rolled back
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'later'"), 0);
+
+    // Fixed migration 3 resumes from version 2
+    migrations[2].sql = "ALTER TABLE items ADD COLUMN price REAL;";
+    ASSERT_TRUE(SchemaMigrator::migrate(db, "test", migrations));
+    EXPECT_EQ(SchemaMigrator::version(db), 4);
+
+    // A database from a newer build is left alone; a list out of order is refused
+    EXPECT_TRUE(SchemaMigrator::migrate(db, "test", {migrations[0]}));
+    EXPECT_EQ(SchemaMigrator::version(db), 4);
+    std::vector<SchemaMigrator::Migration> unordered{migrations[0], {6, "six", "SELECT 1;"}, {5, "five", "SELECT 1;"}};
+    EXPECT_FALSE(SchemaMigrator::migrate(db, "test", unordered));
+    EXPECT_EQ(SchemaMigrator::version(db), 4);
+}
+
+TEST_F(SchemaMigratorTest, BackfillsInBatchesByRowid) {
+    ASSERT_EQ(sqlite3_exec(db,
+                           "CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);"
+                           "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 2500) "
+                           "INSERT INTO items (name) SELECT 'Item ' || i FROM n;"
+                           "DELETE FROM items WHERE id BETWEEN 1000 AND 1999;",  // A gap wider than a batch
+                           nullptr, nullptr, nullptr),
+              SQLITE_OK);
+    std::vector<SchemaMigrator::Migration> migrations{
+        {1, "lower-case name column", "ALTER TABLE items ADD COLUMN name_lower TEXT;"},
+        {2, "fill name_lower", "UPDATE items SET name_lower = lower(name) WHERE rowid > ?1 AND rowid <= ?2;", "items"},
+        {3, "name_lower index", "CREATE INDEX idx_items_name_lower ON items(name_lower);"},
+    };
+    SchemaMigrator::Options options;
+    options.backfillBatchRows = 300;
+    ASSERT_TRUE(SchemaMigrator::migrate(db, "test", migrations, options));
+
+    EXPECT_EQ(SchemaMigrator::version(db), 3);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM items WHERE name_lower IS NULL"), 0);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM items WHERE name_lower = 'item 2500'"), 1);
+    EXPECT_TRUE(hasIndex(db, "idx_items_name_lower"));
+}
+
+TEST_F(SchemaMigratorTest, UpgradesUnversionedDatabasesAndSkipsCurrentOnes) {
+    // The recipes schema as created before versioning, with data in it
+    ASSERT_EQ(sqlite3_exec(db,
+                           "CREATE TABLE recipes (id TEXT PRIMARY KEY, data TEXT NOT NULL, user_id TEXT,"
+                           " created_at DATETIME DEFAULT CURRENT_TIMESTAMP, updated_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+                           "INSERT INTO recipes (id, data) VALUES ('soup', '{\"id\":\"soup\",\"title\":\"Soup\","
+                           "\"ingredients\":\"water\",\"instructions\":\"boil\",\"servingSize\":\"1\",\"cookTime\":\"5 min\","
+                           "\"category\":\"Dinner\",\"type\":\"Main\"}');",
+                           nullptr, nullptr, nullptr),
+              SQLITE_OK);
+    EXPECT_EQ(SchemaMigrator::version(db), 0);
+
+    int latest;
+    {
+        RecipeManagerSQLite manager(testDbPath);
+        ASSERT_TRUE(manager.isConnected());
+        ASSERT_NE(manager.getRecipe("soup"), nullptr);
+        latest = SchemaMigrator::version(db);
+        EXPECT_GE(latest, 3);
+        EXPECT_TRUE(hasIndex(db, "idx_reviews_pending"));
+        EXPECT_TRUE(hasIndex(db, "idx_ratings_user"));
+        EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'review_votes'"), 1);
+    }
+
+    // A current database is not touched: a table dropped behind the manager's back stays dropped
+    sqlite3_exec(db, "DROP TABLE review_votes;", nullptr, nullptr, nullptr);
+    {
+        RecipeManagerSQLite manager(testDbPath);
+        EXPECT_EQ(SchemaMigrator::version(db), latest);
+        EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'review_votes'"), 0);
+    }
+
+    // The users database gets its collections tables
+    sqlite3* users = nullptr;
+    std::string usersPath = testDbPath + ".users";
+    ASSERT_EQ(sqlite3_open(usersPath.c_str(), &users), SQLITE_OK);
+    EXPECT_TRUE(UserManager::initializeSchema(users));
+    EXPECT_TRUE(UserManager::initializeSchema(users));
+    EXPECT_EQ(queryInt(users, "SELECT COUNT(*) FROM sqlite_master WHERE name IN ('users', 'collections', 'collection_recipes')"), 3);
+    sqlite3_close(users);
+    std::filesystem::remove(usersPath);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "similarityIndex.h"
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> sampleRecipes() {
+    return {
+        {"pancakes", "flour, eggs, milk, butter, sugar, baking powder"},
+        {"crepes", "flour, eggs, milk, butter, sugar"},
+        {"waffles", "flour, eggs, milk, butter, baking powder, vanilla"},
+        {"guacamole", "avocado, lime, onion, cilantro, salt"},
+        {"salsa", "tomato, onion, cilantro, lime, jalapeno"},
+        {"water", ""},
+    };
+}
+
+} // namespace
+
+TEST(SimilarityIndexTest, AgreementMatchesScalarCount) {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<uint32_t> value(0, 3);
+    SimilarityIndex::Signature a, b;
+    for (int round = 0; round < 50; ++round) {
+        size_t expected = 0;
+        for (size_t i = 0; i < SimilarityIndex::kHashes; ++i) {
+            a[i] = value(rng);
+            b[i] = value(rng);
+            expected += a[i] == b[i];
+        }
+        EXPECT_EQ(SimilarityIndex::agreement(a.data(), b.data()), expected);
+    }
+}
+
+// Signature agreement estimates Jaccard similarity of the underlying sets
+TEST(SimilarityIndexTest, SignaturesEstimateJaccard) {
+    std::vector<std::string> base, other;
+    for (int i = 0; i < 40; ++i) {
+        base.push_back("term" + std::to_string(i));
+    }
+    for (int i = 20; i < 60; ++i) {
+        other.push_back("term" + std::to_string(i));
+    }
+    // |A ∩ B| = 20, |A ∪ B| = 60
+    auto a = SimilarityIndex::signature(base);
+    auto b = SimilarityIndex::signature(other);
+    double estimate = static_cast<double>(SimilarityIndex::agreement(a.data(), b.data())) / SimilarityIndex::kHashes;
+    EXPECT_NEAR(estimate, 1.0 / 3.0, 0.12);
+    EXPECT_EQ(SimilarityIndex::signature(base), SimilarityIndex::signature(base));
+}
+
+TEST(SimilarityIndexTest, FindsNearDuplicatesOnly) {
+    SimilarityIndex index;
+    index.ensureBuilt(sampleRecipes);
+    EXPECT_EQ(index.size(), 5u);  // No ingredients, no signature
+
+    auto similar = index.similarTo("pancakes", 10, 0.3);
+    ASSERT_EQ(similar.size(), 2u);
+    std::set<std::string> ids{similar[0].recipeId, similar[1].recipeId};
+    EXPECT_EQ(ids, (std::set<std::string>{"crepes", "waffles"}));
+    EXPECT_GE(similar[0].similarity, similar[1].similarity);
+
+    auto dips = index.similarTo("guacamole", 10, 0.2);
+    ASSERT_FALSE(dips.empty());
+    EXPECT_EQ(dips[0].recipeId, "salsa");
+
+    EXPECT_TRUE(index.similarTo("water", 10).empty());
+    EXPECT_TRUE(index.similarTo("missing", 10).empty());
+}
+
+TEST(SimilarityIndexTest, IncrementalUpdates) {
+    SimilarityIndex index;
+    index.ensureBuilt(sampleRecipes);
+
+    index.upsert("crepes", "rice, beans, cumin");
+    index.remove("waffles");
+    EXPECT_TRUE(index.similarTo("pancakes", 10, 0.3).empty());
+
+    index.upsert("dutch-baby", "flour, eggs, milk, butter, sugar, baking powder");
+    auto similar = index.similarTo("pancakes", 10, 0.3);
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0].recipeId, "dutch-baby");
+    EXPECT_DOUBLE_EQ(similar[0].similarity, 1.0);
+
+    index.invalidate();
+    EXPECT_FALSE(index.isBuilt());
+    EXPECT_TRUE(index.similarTo("pancakes", 10).empty());
+}
+
+// LSH recall: near neighbours above the banding threshold are almost always candidates
+TEST(SimilarityIndexTest, RecallAboveThreshold) {
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> pick(0, 4999);
+    // Ingredient tokens cannot contain digits, so numbers are spelled in letters
+    auto word = [](int n) {
+        std::string text = "w";
+        for (; n > 0; n /= 26) text += static_cast<char>('a' + n % 26);
+        return text;
+    };
+    std::vector<std::pair<std::string, std::string>> rows;
+    for (int r = 0; r < 500; ++r) {
+        std::set<int> terms;
+        while (terms.size() < 10) terms.insert(pick(rng));
+        std::string base, variant;
+        int kept = 0;
+        for (int term : terms) {
+            base += word(term) + ", ";
+            // The variant swaps two of ten terms: Jaccard 8/12
+            variant += (kept++ < 8 ? word(term) : "v" + word(r) + "x" + word(kept)) + ", ";
+        }
+        rows.emplace_back("a" + std::to_string(r), base);
+        rows.emplace_back("b" + std::to_string(r), variant);
+    }
+    SimilarityIndex index;
+    index.ensureBuilt([&rows]() { return rows; });
+
+    int found = 0;
+    for (int r = 0; r < 500; ++r) {
+        auto similar = index.similarTo("a" + std::to_string(r), 1);
+        found += !similar.empty() && similar[0].recipeId == "b" + std::to_string(r);
+    }
+    EXPECT_GE(found, 490);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "suggestIndex.h"
+
+namespace {
+
+std::vector<SuggestIndex::Document> sampleDocuments() {
+    return {
+        {"r1", "Chocolate Cake", "Dessert", "flour, chocolate, eggs, sugar"},
+        {"r2", "Chocolate Chip Cookies", "Dessert", "flour, chocolate chips, butter"},
+        {"r3", "Chicken Curry", "Main Course", "chicken, curry paste, coconut milk"},
+        {"r4", "Cheese Omelette", "Breakfast", "eggs, cheese, butter"},
+    };
+}
+
+std::vector<std::string> texts(const std::vector<SuggestIndex::Suggestion>& suggestions) {
+    std::vector<std::string> result;
+    for (const auto& suggestion : suggestions) {
+        result.push_back(suggestion.text);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(SuggestIndexTest, RanksByPopularity) {
+    SuggestIndex index;
+    index.ensureBuilt(sampleDocuments);
+
+    auto suggestions = index.suggest("ch");
+    ASSERT_GE(suggestions.size(), 3u);
+    // "chocolate" is an ingredient of two recipes; everything else under "ch" appears once
+    EXPECT_EQ(suggestions[0].text, "chocolate");
+    EXPECT_EQ(suggestions[0].kind, SuggestIndex::Kind::Ingredient);
+    EXPECT_EQ(suggestions[0].weight, 2u);
+    for (size_t i = 1; i < suggestions.size(); ++i) {
+        EXPECT_LE(suggestions[i].weight, suggestions[i - 1].weight);
+    }
+
+    auto dessert = index.suggest("DES", 1);
+    ASSERT_EQ(dessert.size(), 1u);
+    EXPECT_EQ(dessert[0].text, "Dessert");
+    EXPECT_EQ(dessert[0].kind, SuggestIndex::Kind::Category);
+    EXPECT_EQ(dessert[0].weight, 2u);
+
+    EXPECT_TRUE(index.suggest("zz").empty());
+    EXPECT_TRUE(index.suggest("  ").empty());
+}
+
+TEST(SuggestIndexTest, MatchesTitlesFromAnyWord) {
+    SuggestIndex index;
+    index.ensureBuilt(sampleDocuments);
+
+    EXPECT_EQ(texts(index.suggest("omel")), std::vector<std::string>{"Cheese Omelette"});
+    EXPECT_EQ(texts(index.suggest("chocolate ch")), std::vector<std::string>{"Chocolate Chip Cookies"});
+    // Listed under both "chip" and "cookies", returned once
+    EXPECT_EQ(texts(index.suggest("c", 50)).size(), texts(index.suggest("c", 100)).size());
+    auto all = texts(index.suggest("c", 50));
+    EXPECT_EQ(std::count(all.begin(), all.end(), "Chocolate Chip Cookies"), 1);
+}
+
+TEST(SuggestIndexTest, IncrementalUpdates) {
+    SuggestIndex index;
+    index.ensureBuilt(sampleDocuments);
+
+    index.upsert({"r5", "Carrot Cake", "Dessert", "carrots, flour"});
+    EXPECT_EQ(texts(index.suggest("carr")), (std::vector<std::string>{"carrot", "Carrot Cake"}));
+    EXPECT_EQ(index.suggest("dessert")[0].weight, 3u);
+
+    // Rewriting a recipe moves its weight; removing it drops suggestions nobody else uses
+    index.upsert({"r1", "Lemon Cake", "Dessert", "flour, lemon"});
+    EXPECT_EQ(index.suggest("chocolate")[0].weight, 1u);
+    index.remove("r5");
+    EXPECT_TRUE(index.suggest("carr").empty());
+    EXPECT_EQ(index.suggest("dessert")[0].weight, 2u);
+
+    index.invalidate();
+    EXPECT_FALSE(index.isBuilt());
+    EXPECT_TRUE(index.suggest("lemon").empty());
+}
+
+// Random writes against a brute-force count: weights and their order must match after every batch
+TEST(SuggestIndexTest, MatchesBruteForceUnderChurn) {
+    const std::vector<std::string> vocabulary = {"basil", "bacon", "banana", "barley", "beef", "beet", "bread",
+                                                 "brie", "broth", "butter", "cabbage", "caper", "carrot", "celery"};
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<size_t> pickWord(0, vocabulary.size() - 1);
+    std::uniform_int_distribution<int> pickRecipe(0, 199);
+
+    SuggestIndex index;
+    index.ensureBuilt([]() { return std::vector<SuggestIndex::Document>{}; });
+    std::map<int, std::set<std::string>> recipes;
+
+    for (int round = 0; round < 40; ++round) {
+        for (int op = 0; op < 50; ++op) {
+            int id = pickRecipe(rng);
+            if (op % 5 == 0) {
+                index.remove("r" + std::to_string(id));
+                recipes.erase(id);
+                continue;
+            }
+            std::set<std::string> words;
+            std::string ingredients;
+            for (int i = 0; i < 4; ++i) {
+                words.insert(vocabulary[pickWord(rng)]);
+            }
+            for (const auto& word : words) {
+                ingredients += word + ", ";
+            }
+            index.upsert({"r" + std::to_string(id), "", "", ingredients});
+            recipes[id] = words;
+        }
+
+        for (const std::string prefix : {"b", "ba", "be", "br", "c", "ca"}) {
+            std::map<std::string, uint32_t> counts;
+            for (const auto& [id, words] : recipes) {
+                for (const auto& word : words) {
+                    if (word.compare(0, prefix.size(), prefix) == 0) {
+                        ++counts[word];
+                    }
+                }
+            }
+            std::vector<uint32_t> expected;
+            for (const auto& [word, count] : counts) {
+                expected.push_back(count);
+            }
+            std::sort(expected.rbegin(), expected.rend());
+            expected.resize(std::min<size_t>(expected.size(), 5));
+
+            std::vector<uint32_t> actual;
+            for (const auto& suggestion : index.suggest(prefix, 5)) {
+                EXPECT_EQ(suggestion.weight, counts[suggestion.text]) << suggestion.text;
+                actual.push_back(suggestion.weight);
+            }
+            EXPECT_EQ(actual, expected) << "prefix " << prefix;
+        }
+    }
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include "recipeManagerSQLite.h"
+#include "textCompressor.h"
+
+namespace {
+
+const char* const kIngredients[] = {"2 cups all-purpose flour", "1 teaspoon baking soda", "3 large eggs, beaten",
+                                    "1/2 cup unsalted butter, melted", "1 pinch of kosher salt",
+                                    "2 tablespoons olive oil", "1 medium yellow onion, diced",
+                                    "3 cloves garlic, minced", "1 cup whole milk", "400 g canned tomatoes"};
+const char* const kSteps[] = {"Preheat the oven to 180C and line a baking tray with parchment paper.",
+                              "Whisk the dry ingredients together in a large mixing bowl.",
+                              "Heat the olive oil in a heavy pan over medium heat until shimmering.",
+                              "Stir in the onion and garlic and cook until soft and golden, about 5 minutes.",
+                              "Season to taste with salt and pepper and serve warm."};
+
+// Deterministic, corpus-like text: the same phrases in different combinations
+std::string ingredientsFor(int n) {
+    std::string text;
+    for (int i = 0; i < 5; ++i) {
+        text += std::string(i ? ", " : "") + kIngredients[(n * 7 + i * 3) % 10];
+    }
+    return text;
+}
+
+std::string instructionsFor(int n) {
+    std::string text;
+    for (int i = 0; i < 4; ++i) {
+        text += std::string(i ? " " : "") + kSteps[(n + i * 2) % 5];
+    }
+    return text + " Recipe number " + std::to_string(n) + ".";
+}
+
+int64_t queryInt(sqlite3* db, const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int64_t value = -1;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+} // namespace
+
+class TextCompressorTest : public ::testing::Test {
+protected:
+    std::string testDbPath;
+
+    void SetUp() override {
+        testDbPath = (std::filesystem::temp_directory_path() / "test_text_compressor.db").string();
+        std::filesystem::remove(testDbPath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(testDbPath);
+        std::filesystem::remove(testDbPath + "-wal");
+        std::filesystem::remove(testDbPath + "-shm");
+    }
+};
+
+TEST_F(TextCompressorTest, RoundTripsThroughTheDictionaryNamedInTheFrame) {
+    std::vector<std::string> samples;
+    for (int n = 0; n < 300; ++n) {
+        samples.push_back(ingredientsFor(n));
+        samples.push_back(instructionsFor(n));
+    }
+    std::string dictionary = TextCompressor::train(samples, 4096);
+    ASSERT_FALSE(dictionary.empty());
+    ASSERT_NE(TextCompressor::dictionaryId(dictionary), 0u);
+
+    TextCompressor compressor("unused");
+    std::string text = instructionsFor(1000);
+    EXPECT_FALSE(compressor.compress(text).has_value());  // No dictionary yet
+    ASSERT_TRUE(compressor.addDictionary(dictionary));
+    EXPECT_EQ(compressor.currentDictionaryId(), TextCompressor::dictionaryId(dictionary));
+    EXPECT_FALSE(compressor.compress("2 eggs").has_value());  // Too short to pay for a frame
+
+    auto frame = compressor.compress(text);
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_LT(frame->size(), text.size() / 2);
+    EXPECT_EQ(compressor.decompress(*frame), text);
+
+    // Only a compressor that has the frame's dictionary can read it
+    TextCompressor other("unused");
+    EXPECT_FALSE(other.decompress(*frame).has_value());
+    EXPECT_FALSE(compressor.decompress("not a frame").has_value());
+    ASSERT_TRUE(other.addDictionary(dictionary, false));
+    EXPECT_EQ(other.currentDictionaryId(), 0u);
+    EXPECT_EQ(other.decompress(*frame), text);
+}
+
+TEST_F(TextCompressorTest, ManagerStoresCompressedTextAndReadsItBack) {
+    RecipeManagerSQLite manager(testDbPath);
+    ASSERT_TRUE(manager.isConnected());
+    RecipeManagerSQLite reader(testDbPath);  // Opened before any dictionary exists, like another process
+    ASSERT_TRUE(reader.isConnected());
+
+    std::vector<recipe> recipes;
+    for (int n = 0; n < 300; ++n) {
+        recipes.emplace_back("Dish " + std::to_string(n), ingredientsFor(n), instructionsFor(n), "4 servings",
+                             "30 min", n % 2 ? "Dinner" : "Lunch", "Main");
+    }
+    ASSERT_TRUE(manager.addRecipes(recipes));
+
+    auto stats = manager.compressRecipeText();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->dictionaryVersion, 1);
+    EXPECT_EQ(stats->rows, 300u);
+    EXPECT_LT(stats->storedBytes, stats->textBytes / 2);
+
+    // Written after the dictionary exists: compressed on the way in
+    recipe late("Late Dish", ingredientsFor(301), instructionsFor(301), "2 servings", "15 min", "Lunch", "Main");
+    ASSERT_TRUE(manager.addRecipe(late));
+
+    std::map<std::string, std::string> instructionsByTitle;
+    std::string id42;
+    for (const auto& r : reader.getAllRecipes()) {
+        instructionsByTitle[r.getTitle()] = r.getInstructions();
+        if (r.getTitle() == "Dish 42") {
+            id42 = r.getId();
+        }
+    }
+    ASSERT_EQ(instructionsByTitle.size(), 301u);
+    EXPECT_EQ(instructionsByTitle["Dish 42"], instructionsFor(42));
+    EXPECT_EQ(instructionsByTitle["Late Dish"], instructionsFor(301));
+
+    auto full = manager.getRecipe(id42);
+    ASSERT_NE(full, nullptr);
+    EXPECT_EQ(full->getIngredients(), ingredientsFor(42));
+
+    // Filters see the uncompressed text too
+    RecipeManagerSQLite::SearchCriteria criteria;
+    criteria.query = "Recipe number 123.";
+    auto matches = manager.advancedSearch(criteria);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].getTitle(), "Dish 123");
+
+    size_t exported = 0;
+    bool complete = true;
+    auto page = manager.exportPage(RecipeManagerSQLite::ExportTable::Recipes, "", 0, 500,
+                                   [&](std::string_view line) {
+                                       ++exported;
+                                       complete = complete && line.find("Recipe number") != std::string_view::npos;
+                                       return true;
+                                   });
+    ASSERT_TRUE(page.has_value());
+    EXPECT_EQ(exported, 301u);
+    EXPECT_TRUE(complete);
+
+    sqlite3* db = nullptr;
+    ASSERT_EQ(sqlite3_open(testDbPath.c_str(), &db), SQLITE_OK);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM recipes WHERE instructions_z IS NULL"), 0);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM recipes WHERE json_extract(data, '$.instructions') <> ''"), 0);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM compression_dicts"), 1);
+    sqlite3_close(db);
+}
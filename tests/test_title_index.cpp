@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "titleIndex.h"
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> sampleTitles() {
+    return {
+        {"r1", "Pasta Carbonara"},
+        {"r2", "Chocolate Cake"},
+        {"r3", "Chocolate Chip Cookies"},
+        {"r4", "Vegetable Stir Fry"},
+        {"r5", "Crème Brûlée"},
+    };
+}
+
+std::vector<std::string> ids(const std::vector<TitleIndex::Match>& matches) {
+    std::vector<std::string> result;
+    for (const auto& match : matches) {
+        result.push_back(match.recipeId);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(TitleIndexTest, NormalizesCaseAndPunctuation) {
+    EXPECT_EQ(TitleIndex::normalize("  Mac & Cheese!! (Baked) "), "mac cheese baked");
+    EXPECT_EQ(TitleIndex::normalize("Crème Brûlée"), "crème brûlée");
+    EXPECT_EQ(TitleIndex::normalize("--"), "");
+    EXPECT_TRUE(TitleIndex::trigrams("!!").empty());
+    // "  a", " ab", "ab " for a two-letter word
+    EXPECT_EQ(TitleIndex::trigrams("AB").size(), 3u);
+}
+
+TEST(TitleIndexTest, ToleratesTyposAndCase) {
+    TitleIndex index;
+    index.ensureBuilt(sampleTitles);
+
+    auto matches = index.search("carbonera");
+    ASSERT_FALSE(matches.empty());
+    EXPECT_EQ(matches.front().recipeId, "r1");
+
+    EXPECT_EQ(ids(index.search("PASTA")), std::vector<std::string>{"r1"});
+    EXPECT_EQ(ids(index.search("creme brulee", 0, 0.3)).front(), "r5");
+    EXPECT_TRUE(index.search("lasagne").empty());
+}
+
+TEST(TitleIndexTest, RanksExactWordsAheadOfPartialOverlap) {
+    TitleIndex index;
+    index.ensureBuilt(sampleTitles);
+
+    // Both chocolate titles contain every query trigram; the shorter title is more similar
+    auto matches = index.search("chocolate");
+    EXPECT_EQ(ids(matches), (std::vector<std::string>{"r2", "r3"}));
+    EXPECT_DOUBLE_EQ(matches[0].score, 1.0);
+    EXPECT_GT(matches[0].similarity, matches[1].similarity);
+
+    EXPECT_EQ(ids(index.search("chocolate", 1)), std::vector<std::string>{"r2"});
+    EXPECT_EQ(ids(index.search("chocolate cookies")).front(), "r3");
+}
+
+TEST(TitleIndexTest, IncrementalUpdates) {
+    TitleIndex index;
+    index.upsert("ignored", "Pasta Primavera"); // Not built yet
+    index.ensureBuilt(sampleTitles);
+    EXPECT_EQ(ids(index.search("primavera")), std::vector<std::string>{});
+
+    index.upsert("r6", "Pasta Primavera");
+    EXPECT_EQ(ids(index.search("primavera")), std::vector<std::string>{"r6"});
+
+    index.upsert("r1", "Spaghetti Bolognese");
+    EXPECT_TRUE(index.search("carbonara").empty());
+    EXPECT_EQ(ids(index.search("bolognese")), std::vector<std::string>{"r1"});
+
+    index.remove("r2");
+    EXPECT_EQ(ids(index.search("chocolate")), std::vector<std::string>{"r3"});
+
+    // Freed ordinals are reused without leaking the old title
+    index.upsert("r7", "Lemon Tart");
+    EXPECT_EQ(ids(index.search("lemon tart")), std::vector<std::string>{"r7"});
+    EXPECT_EQ(ids(index.search("chocolate")), std::vector<std::string>{"r3"});
+
+    index.invalidate();
+    EXPECT_FALSE(index.isBuilt());
+    EXPECT_TRUE(index.search("lemon").empty());
+}
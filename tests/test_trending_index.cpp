@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "trendingIndex.h"
+
+namespace {
+
+constexpr int64_t kDay = 24 * 3600;
+constexpr int64_t kStart = 1767225600;  // 2026-01-01 00:00:00 UTC
+
+std::vector<TrendingIndex::Event> noEvents() {
+    return {};
+}
+
+} // namespace
+
+TEST(TrendingIndexTest, ParsesSqliteTimestamps) {
+    EXPECT_EQ(TrendingIndex::parseTimestamp("1970-01-01 00:00:00"), 0);
+    EXPECT_EQ(TrendingIndex::parseTimestamp("2026-01-01 00:00:00"), kStart);
+    EXPECT_EQ(TrendingIndex::parseTimestamp("2024-02-29 12:34:56"), 1709210096);
+    EXPECT_EQ(TrendingIndex::parseTimestamp("2026-13-01 00:00:00"), -1);
+    EXPECT_EQ(TrendingIndex::parseTimestamp("yesterday"), -1);
+    EXPECT_EQ(TrendingIndex::parseTimestamp(""), -1);
+}
+
+TEST(TrendingIndexTest, ScoresHalveEveryHalfLife) {
+    TrendingIndex index;
+    index.record("soup", TrendingIndex::Signal::Rating, kStart);  // Ignored before the build
+    index.ensureBuilt(noEvents);
+    EXPECT_TRUE(index.top(10, kStart).empty());
+
+    index.record("soup", TrendingIndex::Signal::Review, kStart);
+    index.record("soup", TrendingIndex::Signal::Rating, kStart);
+    auto now = index.top(10, kStart);
+    ASSERT_EQ(now.size(), 1);
+    EXPECT_DOUBLE_EQ(now[0].score, 4.0);
+    EXPECT_NEAR(index.top(10, kStart + kDay)[0].score, 2.0, 1e-9);
+    EXPECT_NEAR(index.top(10, kStart + 3 * kDay)[0].score, 0.5, 1e-9);
+}
+
+TEST(TrendingIndexTest, RecentActivityOvertakesOlderActivity) {
+    TrendingIndex index;
+    index.ensureBuilt([]() {
+        return std::vector<TrendingIndex::Event>{
+            {"cake", TrendingIndex::Signal::Review, kStart},
+            {"cake", TrendingIndex::Signal::Review, kStart},
+            {"stew", TrendingIndex::Signal::Rating, kStart},
+        };
+    });
+    EXPECT_EQ(index.top(1, kStart)[0].recipeId, "cake");
+
+    // Four days later two fresh ratings beat six points of four-day-old reviews
+    index.record("stew", TrendingIndex::Signal::Rating, kStart + 4 * kDay);
+    index.record("stew", TrendingIndex::Signal::HelpfulVote, kStart + 4 * kDay);
+    auto top = index.top(10, kStart + 4 * kDay);
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top[0].recipeId, "stew");
+    EXPECT_EQ(top[1].recipeId, "cake");
+
+    index.remove("stew");
+    top = index.top(10, kStart + 4 * kDay);
+    ASSERT_EQ(top.size(), 1);
+    EXPECT_EQ(top[0].recipeId, "cake");
+    EXPECT_EQ(index.size(), 1);
+}
+
+TEST(TrendingIndexTest, TopMatchesBruteForceAcrossRebases) {
+    TrendingIndex index;
+    index.ensureBuilt(noEvents);
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> recipe(0, 199), signal(0, 2);
+    std::uniform_int_distribution<int64_t> step(0, 6 * 3600);
+    std::vector<std::pair<std::string, std::pair<double, int64_t>>> events;
+
+    // Spans about four years, so the base is moved forward several times
+    int64_t time = kStart;
+    for (int i = 0; i < 6000; ++i) {
+        time += step(rng) * (i % 1000 == 999 ? 400 : 1);
+        std::string id = "r" + std::to_string(recipe(rng));
+        auto kind = static_cast<TrendingIndex::Signal>(signal(rng));
+        index.record(id, kind, time);
+        events.push_back({id, {TrendingIndex::weight(kind), time}});
+    }
+
+    std::map<std::string, double> expected;
+    for (const auto& [id, event] : events) {
+        expected[id] += event.first * std::exp2(-static_cast<double>(time - event.second) / TrendingIndex::kHalfLifeSeconds);
+    }
+    std::vector<std::pair<double, std::string>> ranked;
+    for (const auto& [id, score] : expected) {
+        ranked.emplace_back(score, id);
+    }
+    std::sort(ranked.rbegin(), ranked.rend());
+
+    auto top = index.top(20, time);
+    ASSERT_EQ(top.size(), 20);
+    for (size_t i = 0; i < top.size(); ++i) {
+        EXPECT_NEAR(top[i].score, ranked[i].first, 1e-9 * std::max(1.0, ranked[i].first)) << i;
+        EXPECT_NEAR(expected[top[i].recipeId], ranked[i].first, 1e-9 * std::max(1.0, ranked[i].first)) << i;
+    }
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "writeQueue.h"
+
+namespace {
+
+class WriteQueueTest : public ::testing::Test {
+protected:
+    std::string dbPath;
+
+    void SetUp() override {
+        dbPath = (std::filesystem::temp_directory_path() / "test_write_queue.db").string();
+        std::filesystem::remove(dbPath);
+        sqlite3* db = nullptr;
+        ASSERT_EQ(sqlite3_open(dbPath.c_str(), &db), SQLITE_OK);
+        sqlite3_exec(db, "CREATE TABLE items (id INTEGER PRIMARY KEY);", nullptr, nullptr, nullptr);
+        sqlite3_close(db);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(dbPath);
+    }
+
+    int rowCount() {
+        sqlite3* db = nullptr;
+        sqlite3_open(dbPath.c_str(), &db);
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM items;", -1, &stmt, nullptr);
+        int count = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return count;
+    }
+};
+
+WriteQueue::Operation insertItem(int id) {
+    return [id](void* db) {
+        std::string sql = "INSERT INTO items (id) VALUES (" + std::to_string(id) + ");";
+        return sqlite3_exec(static_cast<sqlite3*>(db), sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+    };
+}
+
+} // namespace
+
+TEST_F(WriteQueueTest, CoalescesConcurrentWritesIntoBatches) {
+    WriteQueue queue(dbPath);
+    ASSERT_TRUE(queue.isOpen());
+
+    std::atomic<int> committed{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 8; ++t) {
+        writers.emplace_back([&queue, &committed, t]() {
+            for (int i = 0; i < 100; ++i) {
+                auto result = queue.submit(insertItem(t * 1000 + i), WriteQueue::Durability::Committed,
+                                           [&committed]() { ++committed; });
+                EXPECT_TRUE(result.get());
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(rowCount(), 800);
+    EXPECT_EQ(committed.load(), 800);
+    auto stats = queue.stats();
+    EXPECT_EQ(stats.operations, 800);
+    EXPECT_LT(stats.batches, stats.operations);
+}
+
+TEST_F(WriteQueueTest, FailedOperationRollsBackAlone) {
+    WriteQueue queue(dbPath, {std::chrono::milliseconds(50), 16});
+    std::atomic<int> callbacks{0};
+    auto first = queue.submit(insertItem(1), WriteQueue::Durability::Queued, [&callbacks]() { ++callbacks; });
+    auto failing = queue.submit(
+        [](void* db) {
+            sqlite3_exec(static_cast<sqlite3*>(db), "INSERT INTO items (id) VALUES (2);", nullptr, nullptr, nullptr);
+            return false;  // Its insert must not survive
+        },
+        WriteQueue::Durability::Queued, [&callbacks]() { ++callbacks; });
+    auto duplicate = queue.submit(insertItem(1), WriteQueue::Durability::Queued);
+    auto last = queue.submit(insertItem(3), WriteQueue::Durability::Queued);
+
+    EXPECT_TRUE(first.get());
+    EXPECT_FALSE(failing.get());
+    EXPECT_FALSE(duplicate.get());
+    EXPECT_TRUE(last.get());
+    EXPECT_EQ(callbacks.load(), 1);
+    EXPECT_EQ(rowCount(), 2);
+}
+
+TEST_F(WriteQueueTest, FlushAndShutdownCommitQueuedWrites) {
+    {
+        WriteQueue queue(dbPath, {std::chrono::milliseconds(1000), 10000});
+        for (int i = 0; i < 50; ++i) {
+            queue.submit(insertItem(i), WriteQueue::Durability::Queued);
+        }
+        queue.flush();
+        EXPECT_EQ(rowCount(), 50);
+        for (int i = 50; i < 100; ++i) {
+            queue.submit(insertItem(i), WriteQueue::Durability::Queued);
+        }
+    }
+    EXPECT_EQ(rowCount(), 100);
+
+    WriteQueue missing((std::filesystem::temp_directory_path() / "no_such_dir" / "x.db").string());
+    EXPECT_FALSE(missing.isOpen());
+    EXPECT_FALSE(missing.submit(insertItem(1)).get());
+}
+
+TEST_F(WriteQueueTest, RequeuesBatchesWhileAnotherConnectionHoldsTheWriteLock) {
+    WriteQueue::Options options;
+    options.busyTimeout = std::chrono::milliseconds(10);
+    WriteQueue queue(dbPath, options);
+
+    sqlite3* blocker = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &blocker), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(blocker, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr), SQLITE_OK);
+
+    queue.submit(insertItem(1), WriteQueue::Durability::Queued);
+    auto committed = queue.submit(insertItem(2));
+    // Every BEGIN attempt times out; the batch keeps going back to the queue instead of failing
+    for (int i = 0; i < 500 && queue.stats().requeued < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GE(queue.stats().requeued, 2u);
+    EXPECT_EQ(committed.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+    ASSERT_EQ(sqlite3_exec(blocker, "COMMIT;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(blocker);
+    EXPECT_TRUE(committed.get());
+    EXPECT_EQ(rowCount(), 2);
+}